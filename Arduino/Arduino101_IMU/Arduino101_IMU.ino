@@ -1,10 +1,15 @@
 #include "CurieImu.h"
 
+// OrientationFusion integrates the gyroscope at a fixed rate, so readings
+// are taken every 10 ms (100 Hz) rather than as fast as the loop runs.
+const unsigned long kSamplePeriodMicros = 10000;
+
 int16_t ax, ay, az;
 int16_t gx, gy, gz;
+unsigned long next_sample;
 
 void setup() {
-  Serial.begin(9600);
+  Serial.begin(115200);
   while (!Serial);
 
   CurieImu.initialize();
@@ -12,9 +17,14 @@ void setup() {
   if (!CurieImu.testConnection()) {
     Serial.println("CurieImu connection failed");
   }
+
+  next_sample = micros();
 }
 
 void loop() {
+  while ((long) (micros() - next_sample) < 0);
+  next_sample += kSamplePeriodMicros;
+
   CurieImu.getMotion6(&ax, &ay, &az, &gx, &gy, &gz);
   Serial.print(ax);
   Serial.print("\t");
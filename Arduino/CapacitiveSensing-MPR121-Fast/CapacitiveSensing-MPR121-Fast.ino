@@ -0,0 +1,49 @@
+// Streams the 12 MPR121 electrodes as fast as the sensor and serial port
+// allow. Unlike CapacitiveSensing-MPR121, all electrodes are read in a single
+// I2C transaction (at 400 kHz) and each reading is sent as a binary packet
+// rather than a line of text. Use with a BinaryIntArraySerialStream of 12
+// dimensions at 115200 baud (see user_capacitive_sensing_fast.cpp).
+
+#include <Wire.h>
+#include "Adafruit_MPR121.h"
+
+const int N = 12;
+
+Adafruit_MPR121 cap = Adafruit_MPR121();
+uint16_t filtered[N];
+int results[N];
+
+void setup() {
+  Serial.begin(115200);
+
+  if (!cap.begin(0x5A)) {
+    Serial.println("Error: couldn't connect to MPR121.");
+    while (1);
+  }
+  Wire.setClock(400000); // the MPR121 supports fast-mode I2C
+}
+
+void loop() {
+  if (!cap.filteredDataAll(filtered)) return; // skip incomplete readings
+
+  for (int i = 0; i < N; i++) results[i] = filtered[i];
+  SendData(results, N);
+}
+
+// Same framing as the Touche sketch: a zero byte, the number of values, the
+// values, and a checksum, each as two bytes of seven bits.
+void SendData(int data[], int n) {
+  byte checksum, LSB, MSB;
+  Serial.write(byte(0)); checksum = 0;
+  LSB = lowByte(n) | 0x80; // send low seven bits, with one in high bit to ensure a non-zero byte
+  MSB = highByte(n << 1) | 0x80; // send bits 8 to 14, with one in high bit to ensure a non-zero byte
+  Serial.write(LSB); checksum += LSB;
+  Serial.write(MSB); checksum += MSB;
+  for (int i = 0; i < n; i++) {
+    LSB = lowByte(data[i]) | 0x80; // send low seven bits, with one in high bit to ensure a non-zero byte
+    MSB = highByte(data[i] << 1) | 0x80; // send bits 8 to 14, with one in high bit to ensure a non-zero byte
+    Serial.write(LSB); checksum += LSB;
+    Serial.write(MSB); checksum += MSB;
+  }
+  Serial.write(checksum | 0x80); // seven bit checksum, with one in the high bit to ensure a non-zero byte
+}
@@ -31,7 +31,20 @@
 
 #define N 160  //How many frequencies
 
+// How to reduce the sweep before sending it, so that more sweeps per second
+// fit through the serial port. The packet header announces how many values
+// are sent, and ESP's BinaryIntArraySerialStream adapts to it.
+#define REDUCE_NONE 0      // send all N bins
+#define REDUCE_DECIMATE 1  // sweep (and send) only every FACTOR-th frequency
+#define REDUCE_POOL 2      // send the average of each band of FACTOR bins
+#define REDUCE_PEAK 3      // send the peak's bin, then the bins around it
+
+#define REDUCTION REDUCE_NONE
+#define FACTOR 4           // for REDUCE_DECIMATE and REDUCE_POOL
+#define NEIGHBOURHOOD 8    // for REDUCE_PEAK: bins on each side of the peak
+
 int results[N];
+int reduced[N];
 
 
 
@@ -60,7 +73,16 @@ void loop()
   unsigned int d;
 
   int counter = 0;
+#if REDUCTION == REDUCE_DECIMATE
+  // Only every FACTOR-th bin is swept and sent. The reading taken before
+  // switching to frequency d is the response to the swept frequency before
+  // it, so it's stored there: otherwise each sent bin would hold the response
+  // to a frequency FACTOR bins away, rather than one.
+  static unsigned int previous = 0;
+  for (unsigned int d = 0; d < N; d += FACTOR)
+#else
   for (unsigned int d = 0; d < N; d++)
+#endif
   {
     int v = analogRead(0);  //-Read response signal
     CLR(TCCR1B, 0);         //-Stop generator
@@ -68,16 +90,52 @@ void loop()
     ICR1 = d;               // |
     OCR1A = d / 2;          //-+
     SET(TCCR1B, 0);         //-Restart generator
+#if REDUCTION == REDUCE_DECIMATE
+    results[previous] = v;
+    previous = d;
+#else
     results[d] = v;
+#endif
   }
 
 
-  SendData(results, N);
+  SendData(reduced, Reduce(results, reduced));
 
 
   TOG(PORTB, 0);           //-Toggle pin 8 after each sweep (good for scope)
 }
 
+// Reduce the sweep in `data` into `out`, and return the number of values.
+int Reduce(int data[], int out[]) {
+#if REDUCTION == REDUCE_DECIMATE
+  int n = 0;
+  for (int d = 0; d < N; d += FACTOR) out[n++] = data[d];
+  return n;
+#elif REDUCTION == REDUCE_POOL
+  int n = 0;
+  for (int d = 0; d + FACTOR <= N; d += FACTOR) {
+    long sum = 0;
+    for (int i = 0; i < FACTOR; i++) sum += data[d + i];
+    out[n++] = sum / FACTOR;
+  }
+  return n;
+#elif REDUCTION == REDUCE_PEAK
+  int peak = 0;
+  for (int d = 1; d < N; d++) {
+    if (data[d] > data[peak]) peak = d;
+  }
+  int n = 0;
+  out[n++] = peak;
+  for (int d = peak - NEIGHBOURHOOD; d <= peak + NEIGHBOURHOOD; d++) {
+    out[n++] = data[constrain(d, 0, N - 1)]; // repeat the edge bins
+  }
+  return n;
+#else
+  for (int d = 0; d < N; d++) out[d] = data[d];
+  return N;
+#endif
+}
+
 void SendData(int data[], int n) {
   byte checksum, LSB, MSB;
   Serial.write(byte(0)); checksum = 0;
@@ -87,6 +87,15 @@ uint16_t  Adafruit_MPR121::filteredData(uint8_t t) {
   return readRegister16(MPR121_FILTDATA_0L + t*2);
 }
 
+boolean Adafruit_MPR121::filteredDataAll(uint16_t data[12]) {
+  uint8_t buffer[24];
+  if (!readRegisters(MPR121_FILTDATA_0L, buffer, 24)) return false;
+  for (uint8_t i=0; i<12; i++) {
+    data[i] = buffer[2*i] | ((uint16_t) buffer[2*i+1]) << 8;
+  }
+  return true;
+}
+
 uint16_t  Adafruit_MPR121::baselineData(uint8_t t) {
   if (t > 12) return 0;
   uint16_t bl = readRegister8(MPR121_BASELINE_0 + t);
@@ -119,6 +128,19 @@ uint16_t Adafruit_MPR121::readRegister16(uint8_t reg) {
     return v;
 }
 
+boolean Adafruit_MPR121::readRegisters(uint8_t reg, uint8_t *buffer, uint8_t n) {
+    Wire.beginTransmission(_i2caddr);
+    Wire.write(reg);
+    Wire.endTransmission(false);
+    // The MPR121 advances the register address after every byte it sends.
+    if (Wire.requestFrom((uint8_t) _i2caddr, n) != n) {
+      while (Wire.available()) Wire.read();
+      return false;
+    }
+    for (uint8_t i=0; i<n; i++) buffer[i] = Wire.read();
+    return true;
+}
+
 /**************************************************************************/
 /*!
     @brief  Writes 8-bits to the specified destination register
@@ -78,9 +78,16 @@ class Adafruit_MPR121 {
 
   uint16_t filteredData(uint8_t t);
   uint16_t  baselineData(uint8_t t);
+  // Reads the filtered data of all 12 electrodes in one I2C transaction,
+  // which is much faster than 12 calls to filteredData(). Returns false if
+  // the sensor didn't send all 24 bytes.
+  boolean filteredDataAll(uint16_t data[12]);
 
   uint8_t readRegister8(uint8_t reg);
   uint16_t readRegister16(uint8_t reg);
+  // Reads `n` consecutive registers, starting at `reg`, in one transaction.
+  // `n` must fit in the Wire buffer (32 bytes on AVR).
+  boolean readRegisters(uint8_t reg, uint8_t *buffer, uint8_t n);
   void writeRegister(uint8_t reg, uint8_t value);
   uint16_t touched(void);
   // Add deprecated attribute so that the compiler shows a warning
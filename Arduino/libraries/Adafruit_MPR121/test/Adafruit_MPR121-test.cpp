@@ -0,0 +1,50 @@
+#include "Adafruit_MPR121.h"
+#include "gtest/gtest.h"
+
+class Adafruit_MPR121Test : public ::testing::Test {
+  protected:
+    void SetUp() override {
+        Wire = TwoWire();
+        // After a reset, CONFIG2 reads 0x24; begin() checks for that.
+        Wire.registers[MPR121_CONFIG2] = 0x24;
+        ASSERT_TRUE(cap_.begin(0x5A));
+
+        // 10-bit filtered data, low byte first.
+        for (uint8_t i = 0; i < 12; i++) {
+            uint16_t value = 700 + 25 * i;
+            Wire.registers[MPR121_FILTDATA_0L + 2 * i] = value & 0xFF;
+            Wire.registers[MPR121_FILTDATA_0H + 2 * i] = value >> 8;
+        }
+        Wire.num_requests = 0;
+    }
+
+    Adafruit_MPR121 cap_;
+};
+
+TEST_F(Adafruit_MPR121Test, BeginFailsWithoutSensor) {
+    Wire.registers[MPR121_CONFIG2] = 0x00;
+    Adafruit_MPR121 cap;
+    ASSERT_FALSE(cap.begin(0x5A));
+}
+
+TEST_F(Adafruit_MPR121Test, FilteredData) {
+    ASSERT_EQ(700, cap_.filteredData(0));
+    ASSERT_EQ(975, cap_.filteredData(11));
+    ASSERT_EQ(2, Wire.num_requests);
+}
+
+TEST_F(Adafruit_MPR121Test, BurstMatchesSingleReads) {
+    uint16_t data[12];
+    ASSERT_TRUE(cap_.filteredDataAll(data));
+    ASSERT_EQ(1, Wire.num_requests);
+    for (uint8_t i = 0; i < 12; i++) {
+        ASSERT_EQ(cap_.filteredData(i), data[i]);
+    }
+}
+
+TEST_F(Adafruit_MPR121Test, BurstFailsOnShortRead) {
+    uint16_t data[12];
+    Wire.bytes_before_failure = 23;
+    ASSERT_FALSE(cap_.filteredDataAll(data));
+    ASSERT_EQ(0, Wire.available());
+}
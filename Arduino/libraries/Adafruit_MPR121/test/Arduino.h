@@ -0,0 +1,11 @@
+// A minimal Arduino.h for compiling the library on the host, for tests.
+#pragma once
+
+#include <stdint.h>
+
+#define ARDUINO 100
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+inline void delay(unsigned long) {}
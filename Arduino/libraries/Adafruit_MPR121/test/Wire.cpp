@@ -0,0 +1,37 @@
+#include "Wire.h"
+
+TwoWire Wire;
+
+void TwoWire::beginTransmission(uint8_t address) {
+    writing_ = address == device_address;
+    first_byte_ = true;
+}
+
+size_t TwoWire::write(uint8_t value) {
+    if (!writing_) return 0;
+    if (first_byte_) {
+        register_address_ = value;
+        first_byte_ = false;
+    } else {
+        registers[register_address_++] = value;
+    }
+    return 1;
+}
+
+uint8_t TwoWire::endTransmission(bool) {
+    bool acknowledged = writing_;
+    writing_ = false;
+    return acknowledged ? 0 : 2;  // 2: address not acknowledged
+}
+
+uint8_t TwoWire::requestFrom(uint8_t address, uint8_t quantity) {
+    num_requests++;
+    rx_index_ = rx_length_ = 0;
+    if (address != device_address) return 0;
+    if (quantity > kBufferLength) quantity = kBufferLength;
+    while (rx_length_ < quantity && bytes_before_failure != 0) {
+        rx_[rx_length_++] = registers[register_address_++];
+        if (bytes_before_failure > 0) bytes_before_failure--;
+    }
+    return rx_length_;
+}
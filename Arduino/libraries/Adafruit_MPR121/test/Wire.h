@@ -0,0 +1,49 @@
+// A host-side mock of the Arduino Wire (I2C) library that behaves like a
+// single device with a bank of registers, for testing the MPR121 library.
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+class TwoWire {
+  public:
+    // The AVR Wire buffer size; longer requests are truncated.
+    static const uint8_t kBufferLength = 32;
+
+    void begin() {}
+    void setClock(uint32_t) {}
+
+    // A transmission's first byte sets the register address; any further
+    // bytes are written to consecutive registers.
+    void beginTransmission(uint8_t address);
+    void beginTransmission(int address) { beginTransmission((uint8_t) address); }
+    size_t write(uint8_t value);
+    uint8_t endTransmission(bool stop = true);
+
+    // Reads consecutive registers, starting at the register address, into
+    // the receive buffer.
+    uint8_t requestFrom(uint8_t address, uint8_t quantity);
+    uint8_t requestFrom(int address, int quantity) {
+        return requestFrom((uint8_t) address, (uint8_t) quantity);
+    }
+    int available() { return rx_length_ - rx_index_; }
+    int read() { return rx_index_ < rx_length_ ? rx_[rx_index_++] : -1; }
+
+    // Test controls.
+    uint8_t registers[256] = {};
+    uint8_t device_address = 0x5A;
+    // Number of bytes the device sends before going quiet; -1 for no limit.
+    int bytes_before_failure = -1;
+    // Number of read transactions.
+    int num_requests = 0;
+
+  private:
+    uint8_t register_address_ = 0;
+    bool writing_ = false;
+    bool first_byte_ = false;
+    uint8_t rx_[kBufferLength];
+    uint8_t rx_length_ = 0;
+    uint8_t rx_index_ = 0;
+};
+
+extern TwoWire Wire;
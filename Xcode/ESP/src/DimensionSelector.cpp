@@ -0,0 +1,191 @@
+#include "DimensionSelector.h"
+
+#include <algorithm>
+
+namespace GRT {
+
+RegisterPreProcessingModule<DimensionSelector>
+    DimensionSelector::registerModule("DimensionSelector");
+
+DimensionSelector::DimensionSelector(const vector<uint32_t>& dimensions,
+                                     uint32_t num_input_dimensions) {
+    classType = "DimensionSelector";
+    preProcessingType = classType;
+    debugLog.setProceedingText("[DEBUG DimensionSelector]");
+    errorLog.setProceedingText("[ERROR DimensionSelector]");
+    warningLog.setProceedingText("[WARNING DimensionSelector]");
+
+    if (!dimensions.empty()) init(dimensions, num_input_dimensions);
+}
+
+DimensionSelector::DimensionSelector(const DimensionSelector& rhs) {
+    classType = "DimensionSelector";
+    preProcessingType = classType;
+    debugLog.setProceedingText("[DEBUG DimensionSelector]");
+    errorLog.setProceedingText("[ERROR DimensionSelector]");
+    warningLog.setProceedingText("[WARNING DimensionSelector]");
+
+    *this = rhs;
+}
+
+DimensionSelector& DimensionSelector::operator=(const DimensionSelector& rhs) {
+    if (this != &rhs) {
+        dimensions_ = rhs.dimensions_;
+        copyBaseVariables((PreProcessing*)&rhs);
+    }
+    return *this;
+}
+
+bool DimensionSelector::deepCopyFrom(const PreProcessing* preProcessing) {
+    if (preProcessing == nullptr) {
+        return false;
+    }
+
+    if (this->getPreProcessingType() ==
+        preProcessing->getPreProcessingType()) {
+        *this = *(DimensionSelector*)preProcessing;
+        return true;
+    }
+
+    errorLog << "deepCopyFrom(const PreProcessing *preProcessing)"
+             << " - PreProcessing Types Do Not Match!" << std::endl;
+    return false;
+}
+
+bool DimensionSelector::init(const vector<uint32_t>& dimensions,
+                             uint32_t num_input_dimensions) {
+    initialized = false;
+
+    if (dimensions.empty()) {
+        errorLog << "init(const vector<uint32_t>& dimensions, "
+                 << "uint32_t num_input_dimensions)"
+                 << " - At least one dimension must be selected!" << std::endl;
+        return false;
+    }
+
+    uint32_t largest = *std::max_element(dimensions.begin(), dimensions.end());
+    if (num_input_dimensions == 0) num_input_dimensions = largest + 1;
+    if (largest >= num_input_dimensions) {
+        errorLog << "init(const vector<uint32_t>& dimensions, "
+                 << "uint32_t num_input_dimensions)"
+                 << " - Dimension " << largest << " is out of range for "
+                 << num_input_dimensions << " input dimensions!" << std::endl;
+        return false;
+    }
+
+    dimensions_ = dimensions;
+    numInputDimensions = num_input_dimensions;
+    numOutputDimensions = dimensions.size();
+    initialized = reset();
+    return true;
+}
+
+bool DimensionSelector::setDimensions(const vector<uint32_t>& dimensions,
+                                      uint32_t num_input_dimensions) {
+    return init(dimensions, num_input_dimensions);
+}
+
+bool DimensionSelector::reset() {
+    processedData.clear();
+    processedData.resize(numOutputDimensions, 0);
+    return true;
+}
+
+bool DimensionSelector::process(const VectorDouble& inputVector) {
+    if (!initialized) {
+        errorLog << "process(const VectorDouble &inputVector)"
+                 << " - Not initialized!" << std::endl;
+        return false;
+    }
+
+    if (inputVector.size() != numInputDimensions) {
+        errorLog << "process(const VectorDouble &inputVector)"
+                 << " - The size of the inputVector (" << inputVector.size()
+                 << ") does not match that of the selector ("
+                 << numInputDimensions << ")!" << std::endl;
+        return false;
+    }
+
+    for (uint32_t i = 0; i < dimensions_.size(); i++) {
+        processedData[i] = inputVector[dimensions_[i]];
+    }
+    return true;
+}
+
+bool DimensionSelector::saveModelToFile(string filename) const {
+    std::fstream file;
+    file.open(filename.c_str(), std::ios::out);
+
+    return saveModelToFile(file);
+}
+
+bool DimensionSelector::loadModelFromFile(string filename) {
+    std::fstream file;
+    file.open(filename.c_str(), std::ios::in);
+
+    return loadModelFromFile(file);
+}
+
+bool DimensionSelector::saveModelToFile(fstream &file) const {
+    if (!file.is_open()) {
+        errorLog << "saveModelToFile(fstream &file) - The file is not open!"
+                 << std::endl;
+        return false;
+    }
+
+    file << "GRT_DIMENSION_SELECTOR_FILE_V1.0" << std::endl;
+
+    if (!savePreProcessingSettingsToFile(file)) {
+        errorLog << "saveModelToFile(fstream &file)"
+                 << " - Failed to save base pre processing settings to file!"
+                 << std::endl;
+        return false;
+    }
+
+    file << "Dimensions: " << dimensions_.size();
+    for (uint32_t d : dimensions_) file << " " << d;
+    file << std::endl;
+
+    return true;
+}
+
+bool DimensionSelector::loadModelFromFile(fstream &file) {
+    if (!file.is_open()) {
+        errorLog << "loadModelFromFile(fstream &file) - The file is not open!"
+                 << std::endl;
+        return false;
+    }
+
+    string word;
+
+    // Load the header
+    file >> word;
+    if (word != "GRT_DIMENSION_SELECTOR_FILE_V1.0") {
+        errorLog << "loadModelFromFile(fstream &file) - Invalid file format!"
+                 << std::endl;
+        return false;
+    }
+
+    if (!loadPreProcessingSettingsFromFile(file)) {
+        errorLog << "loadModelFromFile(fstream &file)"
+                 << " - Failed to load base pre processing settings from file!"
+                 << std::endl;
+        return false;
+    }
+
+    // Load the Dimensions
+    file >> word;
+    if (word != "Dimensions:") {
+        errorLog << "loadModelFromFile(fstream &file) "
+                 << "- Failed to read Dimensions header!" << std::endl;
+        return false;
+    }
+    uint32_t num_dimensions = 0;
+    file >> num_dimensions;
+    vector<uint32_t> dimensions(num_dimensions);
+    for (uint32_t& d : dimensions) file >> d;
+
+    return init(dimensions, numInputDimensions);
+}
+
+} // namespace GRT
@@ -0,0 +1,60 @@
+#ifndef ESP_DIMENSION_SELECTOR_H_
+#define ESP_DIMENSION_SELECTOR_H_
+
+#include "GRT/CoreModules/PreProcessing.h"
+
+#include <stdint.h>
+#include <vector>
+
+namespace GRT {
+
+using std::vector;
+
+/* @brief DimensionSelector passes on a subset of the dimensions of its input,
+ * in the given order, and drops the rest. Put it first in a pipeline to prune
+ * the dimensions that FeatureAblation found the classifier doesn't need, so
+ * that no later module spends time on them:
+ *
+ *    pipeline.addPreProcessingModule(DimensionSelector({0, 2, 5}, 12));
+ *
+ * A dimension may be selected more than once.
+ */
+class DimensionSelector : public PreProcessing {
+  public:
+    // `num_input_dimensions` defaults to one more than the largest selected
+    // dimension.
+    DimensionSelector(const vector<uint32_t>& dimensions = vector<uint32_t>(),
+                      uint32_t num_input_dimensions = 0);
+
+    DimensionSelector(const DimensionSelector& rhs);
+    DimensionSelector& operator=(const DimensionSelector& rhs);
+    bool deepCopyFrom(const PreProcessing* preProcessing) override;
+    ~DimensionSelector() override {}
+
+    bool process(const VectorDouble& inputVector) override;
+    bool reset() override;
+
+    const vector<uint32_t>& getDimensions() const { return dimensions_; }
+
+    // Fails if a dimension isn't below `num_input_dimensions`.
+    bool setDimensions(const vector<uint32_t>& dimensions,
+                       uint32_t num_input_dimensions = 0);
+
+    // Save and Load from file
+    bool saveModelToFile(string filename) const override;
+    bool loadModelFromFile(string filename) override;
+    bool saveModelToFile(fstream &file) const override;
+    bool loadModelFromFile(fstream &file) override;
+
+  protected:
+    bool init(const vector<uint32_t>& dimensions,
+              uint32_t num_input_dimensions);
+
+    vector<uint32_t> dimensions_;
+
+    static RegisterPreProcessingModule<DimensionSelector> registerModule;
+};
+
+} // namespace GRT
+
+#endif // ESP_DIMENSION_SELECTOR_H_
@@ -25,6 +25,8 @@
  useTrainingSampleChecker().
  \li Whether or not to use leave-one-out scoring of training samples,
  specified using useLeaveOneOutScoring().
+ \li An optional cap on the number of training samples per class that the
+ classifier is trained on, specified using useTemplateCondensation().
  \li Optional thresholds to use for deciding whether or not to warn the user
  about the quality of their training samples (based on their confusion with
  other classes), specified using setTruePositiveWarningThreshold() and
@@ -91,6 +93,7 @@ void useStream(IOStreamVector &stream);
  */
 void useOutputStream(OStream &stream);
 void useOutputStream(OStreamVector &stream);
+void useOutputStream(PredictionOStream &stream);
 
 /**
  Tells the ESP system which machine learning pipeline to use. Call from your
@@ -173,11 +176,114 @@ void useTrainingSampleChecker(TrainingSampleChecker checker);
   */
 void useLeaveOneOutScoring(bool enable = true);
 
+/**
+  @brief Train the classifier on at most this many samples per class.
+
+  Template-based classifiers like DTW and KNN do work proportional to the
+  number of training samples, and leave-one-out scoring retrains the model
+  once per sample. With condensation enabled, the samples of each class are
+  clustered and only one representative sample per cluster is used for
+  training; the rest of the training data is kept (and can still be edited)
+  but doesn't reach the classifier.
+
+  Condensation is disabled by default. Pass 0 to disable it again. The cap
+  can be bound to a tuneable, in which case it takes effect the next time
+  the model is trained.
+
+  @param max_templates_per_class the maximum number of samples per class
+  */
+void useTemplateCondensation(uint32_t max_templates_per_class);
+
+/**
+  @brief Automatically trim idle lead-in and lead-out from newly recorded
+  training samples.
+
+  Activity is measured as the change between consecutive data points, summed
+  over all dimensions. The trimmed sample spans from the first to the last
+  point whose activity reaches `threshold` times the largest activity in the
+  sample, plus `padding` points on each side. Trimming only hides the idle
+  points: they are kept until the training data is saved.
+
+  @param threshold fraction of the peak activity that counts as activity; 0
+  disables automatic trimming
+  @param padding the number of extra data points to keep on each side
+  */
+void useAutomaticTrimming(double threshold = 0.1, uint32_t padding = 5);
+
+/**
+  @brief Resample every training sample to this many data points before
+  training.
+
+  The cost of comparing samples with DTW grows with the product of their
+  lengths, so bounding the length bounds the cost. Samples are linearly
+  interpolated. The samples shown in the training tab are not affected.
+
+  @param length the number of data points per sample, or 0 (the default) to
+  train on the samples as recorded
+  */
+void setTrainingSampleLength(uint32_t length);
+
 /**
  This will be linked against ofApp::setGUIBufferSize
  */
 void setGUIBufferSize(uint32_t buffer_size);
 
+/**
+ @brief Set the number of input frames kept for extracting training samples
+ from the live history (pause the input and select a range on the plot).
+
+ The history is kept at full precision and independently of the plots, so it
+ can hold minutes of data. While paused, the left and right arrow keys scroll
+ the input plot back through it. By default its size is chosen so that it takes
+ about 64 MB of memory. It is never smaller than the GUI buffer size.
+
+ @param num_frames the number of frames to keep
+ */
+void setRewindBufferSize(uint32_t num_frames);
+
+/**
+ @brief Set the time each frame (processing new input plus drawing) may take
+ before ESP starts skipping work to keep up.
+
+ When the average frame time stays over budget, ESP stops updating, in order,
+ the live feature plots, the PIPELINE tab plots and the prediction plots, and
+ then redraws the window less often. The skipped work is resumed once frames
+ are well under budget again. Prediction and output streams are never
+ skipped. The current frame time and the number of frames over budget are
+ shown at the bottom right of the window.
+
+ @param milliseconds the budget per frame (the default is 33 ms, i.e. 30 fps),
+ or 0 to never skip any work
+ */
+void setFrameBudget(double milliseconds);
+
+/**
+ @brief Set the columns of logs imported with "Import training log..." and
+ "Import test log..." that hold the class label and the time stamp.
+
+ Logs are text files with one data point per line, like the output parsed by
+ ASCIISerialStream: numbers separated by tabs, spaces or commas. The other
+ columns must match the input stream. When importing training data, each run
+ of consecutive lines with the same label becomes a training sample; lines
+ labelled 0 are skipped. By default the label is in the first column and
+ there is no time column.
+
+ @param label_column index of the label column, or -1 for none
+ @param time_column index of the time column, or -1 to use the line number
+ */
+void setLogImportColumns(int label_column, int time_column = -1);
+
+/**
+ @brief Turn the lines of imported training logs whose time stamp is in
+ [start, end) into a training sample with the given label. Once a time range
+ is given, the label column is ignored.
+
+ @param start the first time stamp of the sample
+ @param end the time stamp just past the sample
+ @param label the class label of the sample
+ */
+void addLogImportTimeRange(double start, double end, uint32_t label);
+
 /**
  @brief Only warn (highlight the confusion score) if the true positive rate is
  smaller than the threshold. True positive rate is the probability that this
@@ -0,0 +1,70 @@
+// Compares GoertzelBank with the GRT::FFT it replaces for a few frequencies:
+// both get the same audio, one sample at a time, and output a 1024-sample
+// block's spectrum every 256 samples. Build with -Dtest=ON and run
+// runBenchmarks (preferably an optimized build).
+#include "GRT/GRT.h"
+#include "GoertzelBank.h"
+#include "gtest/gtest.h"
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+
+namespace {
+
+const double kSampleRate = 44100;
+const uint32_t kBlockSize = 1024;
+const uint32_t kHopSize = 256;
+const uint32_t kNumSamples = 44100 * 10;
+
+std::vector<double> makeSignal() {
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<double> sample(-1, 1);
+    std::vector<double> signal(kNumSamples);
+    for (double& x : signal) x = sample(rng);
+    return signal;
+}
+
+// Microseconds per spectrum for `module` over `signal`.
+double timeModule(GRT::FeatureExtraction& module,
+                  const std::vector<double>& signal) {
+    uint32_t num_spectra = 0;
+    GRT::VectorDouble input(1);
+    auto start = std::chrono::steady_clock::now();
+    for (double x : signal) {
+        input[0] = x;
+        module.computeFeatures(input);
+        if (module.getFeatureDataReady()) num_spectra++;
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    EXPECT_GT(num_spectra, 0);
+    return std::chrono::duration<double, std::micro>(elapsed).count() /
+           num_spectra;
+}
+
+}  // namespace
+
+TEST(GoertzelBankBenchmark, AgainstFFT) {
+    std::vector<double> signal = makeSignal();
+
+    GRT::FFT fft(kBlockSize, kHopSize, 1, GRT::FFT::RECTANGULAR_WINDOW, true,
+                 false);
+    double fft_us = timeModule(fft, signal);
+    std::printf("FFT, %u bins: %.2f us per spectrum\n", kBlockSize / 2,
+                fft_us);
+
+    for (uint32_t num_frequencies : { 8, 32, 128 }) {
+        // Spread over the bins, as for a swept-frequency sensor.
+        std::vector<double> frequencies;
+        for (uint32_t i = 0; i < num_frequencies; i++) {
+            frequencies.push_back(kSampleRate / kBlockSize *
+                                  (1 + i * (kBlockSize / 2 - 1) /
+                                       num_frequencies));
+        }
+        GRT::GoertzelBank bank(kSampleRate, frequencies, kBlockSize, kHopSize);
+        double bank_us = timeModule(bank, signal);
+        std::printf("GoertzelBank, %u frequencies: %.2f us per spectrum "
+                    "(%.1fx the FFT's speed)\n",
+                    num_frequencies, bank_us, fft_us / bank_us);
+    }
+}
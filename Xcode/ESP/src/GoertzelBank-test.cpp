@@ -0,0 +1,128 @@
+#include "GoertzelBank.h"
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+// |sum of taper[m] x[m] e^(-j w m)| for w = 2 pi frequency / sample_rate.
+static double dftMagnitude(const std::vector<double>& block, double frequency,
+                           double sample_rate,
+                           const std::vector<double>& taper) {
+    double re = 0, im = 0;
+    double w = 2 * PI * frequency / sample_rate;
+    for (uint32_t m = 0; m < block.size(); m++) {
+        re += block[m] * taper[m] * cos(w * m);
+        im -= block[m] * taper[m] * sin(w * m);
+    }
+    return sqrt(re * re + im * im);
+}
+
+static std::vector<double> randomSignal(uint32_t length) {
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<double> sample(-1, 1);
+    std::vector<double> signal(length);
+    for (double& x : signal) x = sample(rng);
+    return signal;
+}
+
+TEST(GoertzelBankTest, MatchesTheDFTOfTheBlock) {
+    const uint32_t N = 128;
+    const double fs = 8000;
+    // On bins (k * fs / N), off them, and at both ends.
+    std::vector<double> frequencies = { 0, 62.5, 440, 1000, 1234.5, 4000 };
+    GRT::GoertzelBank bank(fs, frequencies, N, 32);
+    ASSERT_EQ(frequencies.size(), bank.getNumOutputDimensions());
+
+    std::vector<double> signal = randomSignal(5 * N);
+    std::vector<double> rectangular(N, 1.0);
+    int num_blocks = 0;
+    for (uint32_t n = 0; n < signal.size(); n++) {
+        ASSERT_TRUE(bank.computeFeatures({ signal[n] }));
+        // Every hop once the block has filled.
+        ASSERT_EQ(n + 1 >= N && (n + 1 - N) % 32 == 0,
+                  bank.getFeatureDataReady());
+        if (!bank.getFeatureDataReady()) continue;
+        num_blocks++;
+
+        std::vector<double> block(signal.begin() + n + 1 - N,
+                                  signal.begin() + n + 1);
+        for (uint32_t i = 0; i < frequencies.size(); i++) {
+            ASSERT_NEAR(dftMagnitude(block, frequencies[i], fs, rectangular),
+                        bank.getFeatureVector()[i], 1e-9);
+        }
+    }
+    ASSERT_EQ(4 * N / 32 + 1, num_blocks);
+}
+
+TEST(GoertzelBankTest, WindowedPowerPerDimension) {
+    const uint32_t N = 64;
+    const double fs = 1000;
+    std::vector<double> frequencies = { 50, 125, 300 };
+    GRT::GoertzelBank bank(fs, frequencies, N, N, 2,
+                           GRT::GoertzelBank::HANNING_WINDOW,
+                           GRT::GoertzelBank::POWER);
+
+    std::vector<double> hann(N);
+    for (uint32_t m = 0; m < N; m++) {
+        hann[m] = 0.5 * (1 - cos(2 * PI * m / (N - 1)));
+    }
+
+    std::vector<double> signal = randomSignal(3 * N);
+    for (uint32_t n = 0; n < signal.size(); n++) {
+        // The second dimension is the first one doubled.
+        ASSERT_TRUE(bank.computeFeatures({ signal[n], 2 * signal[n] }));
+        if (!bank.getFeatureDataReady()) continue;
+
+        std::vector<double> block(signal.begin() + n + 1 - N,
+                                  signal.begin() + n + 1);
+        for (uint32_t i = 0; i < frequencies.size(); i++) {
+            double magnitude = dftMagnitude(block, frequencies[i], fs, hann);
+            ASSERT_NEAR(magnitude * magnitude, bank.getFeatureVector()[i],
+                        1e-9);
+            ASSERT_NEAR(4 * magnitude * magnitude,
+                        bank.getFeatureVector()[3 + i], 1e-9);
+        }
+    }
+}
+
+TEST(GoertzelBankTest, FindsATone) {
+    const double fs = 8000;
+    GRT::GoertzelBank bank(fs, { 697, 770, 852, 941 }, 256, 256);
+    for (uint32_t n = 0; n < 256; n++) {
+        bank.computeFeatures({ sin(2 * PI * 852 * n / fs) });
+    }
+    ASSERT_TRUE(bank.getFeatureDataReady());
+    const GRT::VectorDouble& magnitudes = bank.getFeatureVector();
+    ASSERT_EQ(2, std::max_element(magnitudes.begin(), magnitudes.end()) -
+                 magnitudes.begin());
+}
+
+TEST(GoertzelBankTest, CopiesAndResets) {
+    GRT::GoertzelBank bank(100, { 10, 20 }, 16, 3);
+    std::vector<double> signal = randomSignal(60);
+    for (uint32_t n = 0; n < 20; n++) bank.computeFeatures({ signal[n] });
+
+    GRT::GoertzelBank copy(bank);
+    for (uint32_t n = 20; n < 60; n++) {
+        ASSERT_TRUE(bank.computeFeatures({ signal[n] }));
+        ASSERT_TRUE(copy.computeFeatures({ signal[n] }));
+        ASSERT_EQ(bank.getFeatureDataReady(), copy.getFeatureDataReady());
+        ASSERT_EQ(bank.getFeatureVector(), copy.getFeatureVector());
+    }
+
+    ASSERT_TRUE(copy.reset());
+    ASSERT_TRUE(copy.computeFeatures({ 1.0 }));
+    ASSERT_FALSE(copy.getFeatureDataReady());
+}
+
+TEST(GoertzelBankTest, RejectsBadSettings) {
+    GRT::GoertzelBank uninitialized;
+    ASSERT_FALSE(uninitialized.computeFeatures({ 1.0 }));
+
+    GRT::GoertzelBank above_nyquist(1000, { 600 });
+    ASSERT_FALSE(above_nyquist.computeFeatures({ 1.0 }));
+
+    GRT::GoertzelBank bank(1000, { 100 }, 16, 16, 2);
+    ASSERT_FALSE(bank.computeFeatures({ 1.0 }));
+}
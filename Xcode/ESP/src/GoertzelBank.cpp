@@ -0,0 +1,308 @@
+#include "GoertzelBank.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace GRT {
+
+RegisterFeatureExtractionModule<GoertzelBank>
+    GoertzelBank::registerModule("GoertzelBank");
+
+GoertzelBank::GoertzelBank(double sample_rate,
+                           const vector<double>& frequencies,
+                           uint32_t block_size, uint32_t hop_size,
+                           uint32_t num_dimensions, uint32_t window_function,
+                           uint32_t output)
+    : sample_rate_(0), block_size_(0), hop_size_(0),
+      window_function_(RECTANGULAR_WINDOW), output_(MAGNITUDE), position_(0),
+      num_samples_(0) {
+    classType = "GoertzelBank";
+    featureExtractionType = classType;
+    debugLog.setProceedingText("[DEBUG GoertzelBank]");
+    errorLog.setProceedingText("[ERROR GoertzelBank]");
+    warningLog.setProceedingText("[WARNING GoertzelBank]");
+
+    if (!frequencies.empty()) {
+        init(sample_rate, frequencies, block_size, hop_size, num_dimensions,
+             window_function, output);
+    }
+}
+
+GoertzelBank::GoertzelBank(const GoertzelBank& rhs) {
+    classType = "GoertzelBank";
+    featureExtractionType = classType;
+    debugLog.setProceedingText("[DEBUG GoertzelBank]");
+    errorLog.setProceedingText("[ERROR GoertzelBank]");
+    warningLog.setProceedingText("[WARNING GoertzelBank]");
+
+    *this = rhs;
+}
+
+GoertzelBank& GoertzelBank::operator=(const GoertzelBank& rhs) {
+    if (this != &rhs) {
+        sample_rate_ = rhs.sample_rate_;
+        frequencies_ = rhs.frequencies_;
+        block_size_ = rhs.block_size_;
+        hop_size_ = rhs.hop_size_;
+        window_function_ = rhs.window_function_;
+        output_ = rhs.output_;
+        coefficients_ = rhs.coefficients_;
+        window_ = rhs.window_;
+        samples_ = rhs.samples_;
+        position_ = rhs.position_;
+        num_samples_ = rhs.num_samples_;
+        state1_ = rhs.state1_;
+        state2_ = rhs.state2_;
+        copyBaseVariables((FeatureExtraction*)&rhs);
+    }
+    return *this;
+}
+
+bool GoertzelBank::deepCopyFrom(const FeatureExtraction* featureExtraction) {
+    if (featureExtraction == nullptr) {
+        return false;
+    }
+
+    if (this->getFeatureExtractionType() ==
+        featureExtraction->getFeatureExtractionType()) {
+        *this = *(GoertzelBank*)featureExtraction;
+        return true;
+    }
+
+    errorLog << "deepCopyFrom(const FeatureExtraction *featureExtraction)"
+             << " - FeatureExtraction Types Do Not Match!" << std::endl;
+    return false;
+}
+
+bool GoertzelBank::init(double sample_rate, const vector<double>& frequencies,
+                        uint32_t block_size, uint32_t hop_size,
+                        uint32_t num_dimensions, uint32_t window_function,
+                        uint32_t output) {
+    initialized = false;
+
+    if (frequencies.empty() || !(sample_rate > 0)) {
+        errorLog << "init(...) - At least one frequency and a sample rate "
+                 << "must be given!" << std::endl;
+        return false;
+    }
+    if (block_size < 2 || hop_size == 0 || num_dimensions == 0) {
+        errorLog << "init(...) - The block size must be at least 2, and the "
+                 << "hop size and number of dimensions at least 1!"
+                 << std::endl;
+        return false;
+    }
+    if (window_function > HANNING_WINDOW || output > POWER) {
+        errorLog << "init(...) - Unknown window function or output!"
+                 << std::endl;
+        return false;
+    }
+    for (double f : frequencies) {
+        if (!(f >= 0 && f <= sample_rate / 2)) {
+            errorLog << "init(...) - Frequency " << f << " Hz is out of range "
+                     << "for a sample rate of " << sample_rate << " Hz!"
+                     << std::endl;
+            return false;
+        }
+    }
+
+    sample_rate_ = sample_rate;
+    frequencies_ = frequencies;
+    block_size_ = block_size;
+    hop_size_ = hop_size;
+    window_function_ = window_function;
+    output_ = output;
+
+    coefficients_.resize(frequencies_.size());
+    for (uint32_t i = 0; i < frequencies_.size(); i++) {
+        coefficients_[i] = 2 * cos(2 * PI * frequencies_[i] / sample_rate_);
+    }
+
+    // The windows GRT::FFT uses.
+    window_.resize(block_size_);
+    for (uint32_t n = 0; n < block_size_; n++) {
+        double c = cos(2 * PI * n / (block_size_ - 1));
+        switch (window_function_) {
+            case HAMMING_WINDOW: window_[n] = 0.54 - 0.46 * c; break;
+            case HANNING_WINDOW: window_[n] = 0.5 * (1 - c); break;
+            default: window_[n] = 1; break;
+        }
+    }
+
+    numInputDimensions = num_dimensions;
+    numOutputDimensions = num_dimensions * frequencies_.size();
+    initialized = reset();
+    return true;
+}
+
+bool GoertzelBank::reset() {
+    samples_.assign(numInputDimensions * block_size_, 0);
+    position_ = 0;
+    num_samples_ = 0;
+    state1_.assign(frequencies_.size(), 0);
+    state2_.assign(frequencies_.size(), 0);
+    featureVector.assign(numOutputDimensions, 0);
+    featureDataReady = false;
+    return true;
+}
+
+void GoertzelBank::filterBlock(uint32_t d) {
+    const uint32_t num_filters = coefficients_.size();
+    const double* block = &samples_[d * block_size_];
+    const double* coefficients = coefficients_.data();
+    double* s1 = state1_.data();
+    double* s2 = state2_.data();
+
+    std::fill(state1_.begin(), state1_.end(), 0);
+    std::fill(state2_.begin(), state2_.end(), 0);
+
+    // s[n] = x[n] + 2 cos(w) s[n - 1] - s[n - 2], from the oldest sample on.
+    // The inner loop has no dependencies between filters.
+    for (uint32_t m = 0; m < block_size_; m++) {
+        uint32_t n = position_ + m;
+        if (n >= block_size_) n -= block_size_;
+        const double x = block[n] * window_[m];
+        for (uint32_t i = 0; i < num_filters; i++) {
+            double s = x + coefficients[i] * s1[i] - s2[i];
+            s2[i] = s1[i];
+            s1[i] = s;
+        }
+    }
+
+    // |X(w)|^2 = s[N - 1]^2 + s[N - 2]^2 - 2 cos(w) s[N - 1] s[N - 2]
+    double* out = &featureVector[d * num_filters];
+    for (uint32_t i = 0; i < num_filters; i++) {
+        double power = s1[i] * s1[i] + s2[i] * s2[i] -
+                       coefficients[i] * s1[i] * s2[i];
+        // Rounding can take the power of a silent frequency just below 0.
+        if (power < 0) power = 0;
+        out[i] = output_ == POWER ? power : sqrt(power);
+    }
+}
+
+bool GoertzelBank::computeFeatures(const VectorDouble& inputVector) {
+    if (!initialized) {
+        errorLog << "computeFeatures(const VectorDouble &inputVector)"
+                 << " - Not initialized!" << std::endl;
+        return false;
+    }
+
+    if (inputVector.size() != numInputDimensions) {
+        errorLog << "computeFeatures(const VectorDouble &inputVector)"
+                 << " - The size of the inputVector (" << inputVector.size()
+                 << ") does not match that of the GoertzelBank ("
+                 << numInputDimensions << ")!" << std::endl;
+        return false;
+    }
+
+    for (uint32_t d = 0; d < numInputDimensions; d++) {
+        samples_[d * block_size_ + position_] = inputVector[d];
+    }
+    position_ = (position_ + 1) % block_size_;
+    num_samples_++;
+
+    featureDataReady = num_samples_ >= block_size_ &&
+                       (num_samples_ - block_size_) % hop_size_ == 0;
+    if (!featureDataReady) return true;
+
+    featureVector.resize(numOutputDimensions);
+    for (uint32_t d = 0; d < numInputDimensions; d++) {
+        filterBlock(d);
+    }
+    return true;
+}
+
+bool GoertzelBank::saveModelToFile(string filename) const {
+    std::fstream file;
+    file.open(filename.c_str(), std::ios::out);
+
+    return saveModelToFile(file);
+}
+
+bool GoertzelBank::loadModelFromFile(string filename) {
+    std::fstream file;
+    file.open(filename.c_str(), std::ios::in);
+
+    return loadModelFromFile(file);
+}
+
+bool GoertzelBank::saveModelToFile(fstream &file) const {
+    if (!file.is_open()) {
+        errorLog << "saveModelToFile(fstream &file) - The file is not open!"
+                 << std::endl;
+        return false;
+    }
+
+    file << "GRT_GOERTZEL_BANK_FILE_V1.0" << std::endl;
+
+    if (!saveFeatureExtractionSettingsToFile(file)) {
+        errorLog << "saveModelToFile(fstream &file)"
+                 << " - Failed to save base feature extraction settings to file!"
+                 << std::endl;
+        return false;
+    }
+
+    file.precision(17);
+    file << "SampleRate: " << sample_rate_ << std::endl;
+    file << "BlockSize: " << block_size_ << std::endl;
+    file << "HopSize: " << hop_size_ << std::endl;
+    file << "WindowFunction: " << window_function_ << std::endl;
+    file << "Output: " << output_ << std::endl;
+    file << "Frequencies: " << frequencies_.size();
+    for (double f : frequencies_) file << " " << f;
+    file << std::endl;
+
+    return true;
+}
+
+bool GoertzelBank::loadModelFromFile(fstream &file) {
+    if (!file.is_open()) {
+        errorLog << "loadModelFromFile(fstream &file) - The file is not open!"
+                 << std::endl;
+        return false;
+    }
+
+    string word;
+
+    // Load the header
+    file >> word;
+    if (word != "GRT_GOERTZEL_BANK_FILE_V1.0") {
+        errorLog << "loadModelFromFile(fstream &file) - Invalid file format!"
+                 << std::endl;
+        return false;
+    }
+
+    if (!loadFeatureExtractionSettingsFromFile(file)) {
+        errorLog << "loadModelFromFile(fstream &file)"
+                 << " - Failed to load base feature extraction settings from file!"
+                 << std::endl;
+        return false;
+    }
+
+    double sample_rate;
+    uint32_t block_size, hop_size, window_function, output;
+    const char* headers[] = { "SampleRate:", "BlockSize:", "HopSize:",
+                              "WindowFunction:", "Output:", "Frequencies:" };
+    for (const char* header : headers) {
+        file >> word;
+        if (word != header) {
+            errorLog << "loadModelFromFile(fstream &file) "
+                     << "- Failed to read " << header << " header!"
+                     << std::endl;
+            return false;
+        }
+        if (word == "SampleRate:") file >> sample_rate;
+        else if (word == "BlockSize:") file >> block_size;
+        else if (word == "HopSize:") file >> hop_size;
+        else if (word == "WindowFunction:") file >> window_function;
+        else if (word == "Output:") file >> output;
+    }
+    uint32_t num_frequencies = 0;
+    file >> num_frequencies;
+    vector<double> frequencies(num_frequencies);
+    for (double& f : frequencies) file >> f;
+
+    return init(sample_rate, frequencies, block_size, hop_size,
+                numInputDimensions, window_function, output);
+}
+
+} // namespace GRT
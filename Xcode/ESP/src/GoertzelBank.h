@@ -0,0 +1,117 @@
+#ifndef ESP_GOERTZEL_BANK_H_
+#define ESP_GOERTZEL_BANK_H_
+
+#include "GRT/CoreModules/FeatureExtraction.h"
+
+#include <stdint.h>
+#include <vector>
+
+namespace GRT {
+
+using std::vector;
+
+/* @brief GoertzelBank measures the spectrum of each input dimension at a
+ * given list of frequencies only, with one Goertzel filter per frequency,
+ * instead of computing every bin with an FFT. A block of `block_size`
+ * samples costs O(block_size) per frequency, against O(block_size log
+ * block_size) for the whole FFT, so it's faster when there are a few dozen
+ * frequencies of interest (e.g. the tones of a presence detector). The
+ * frequencies needn't fall on FFT bins.
+ *
+ * Its cost grows with the number of frequencies and the FFT's doesn't: with
+ * 1024-sample blocks, at 128 frequencies it's slower than GRT::FFT. For that
+ * many frequencies, or the whole spectrum, use FFT. runBenchmarks times both
+ * on the machine at hand.
+ *
+ * Like GRT::FFT, it takes one sample (per dimension) at a time and, once
+ * `block_size` samples have come in, outputs the magnitude (or power) at
+ * each frequency of the last `block_size` samples every `hop_size` samples;
+ * featureDataReady is false in between. The output holds all frequencies of
+ * the first dimension, then of the second, and so on. Magnitudes aren't
+ * normalized, so at a bin frequency (k * sample_rate / block_size) they match
+ * GRT::FFT's with the same window:
+ *
+ *    GRT::GoertzelBank bank(44100, { 697, 770, 852, 941 }, 1024, 256);
+ *
+ * The filters' state is kept as one array per variable rather than one
+ * struct per filter, so that the update of all the filters for a sample
+ * vectorizes.
+ */
+class GoertzelBank : public FeatureExtraction {
+  public:
+    enum WindowFunctionOptions {
+        RECTANGULAR_WINDOW = 0,
+        HAMMING_WINDOW,
+        HANNING_WINDOW
+    };
+
+    enum OutputOptions {
+        MAGNITUDE = 0,
+        POWER
+    };
+
+    GoertzelBank(double sample_rate = 0,
+                 const vector<double>& frequencies = vector<double>(),
+                 uint32_t block_size = 1024, uint32_t hop_size = 1024,
+                 uint32_t num_dimensions = 1,
+                 uint32_t window_function = RECTANGULAR_WINDOW,
+                 uint32_t output = MAGNITUDE);
+
+    GoertzelBank(const GoertzelBank& rhs);
+    GoertzelBank& operator=(const GoertzelBank& rhs);
+    bool deepCopyFrom(const FeatureExtraction* featureExtraction) override;
+    ~GoertzelBank() override {}
+
+    bool computeFeatures(const VectorDouble& inputVector) override;
+    bool reset() override;
+
+    double getSampleRate() const { return sample_rate_; }
+    const vector<double>& getFrequencies() const { return frequencies_; }
+    uint32_t getBlockSize() const { return block_size_; }
+    uint32_t getHopSize() const { return hop_size_; }
+    uint32_t getWindowFunction() const { return window_function_; }
+    uint32_t getOutput() const { return output_; }
+
+    // Save and Load from file
+    bool saveModelToFile(string filename) const override;
+    bool loadModelFromFile(string filename) override;
+    bool saveModelToFile(fstream &file) const override;
+    bool loadModelFromFile(fstream &file) override;
+
+  protected:
+    bool init(double sample_rate, const vector<double>& frequencies,
+              uint32_t block_size, uint32_t hop_size, uint32_t num_dimensions,
+              uint32_t window_function, uint32_t output);
+
+    // Run the filters over the block of dimension `d`, writing its part of
+    // the feature vector.
+    void filterBlock(uint32_t d);
+
+    double sample_rate_;
+    vector<double> frequencies_;
+    uint32_t block_size_;
+    uint32_t hop_size_;
+    uint32_t window_function_;
+    uint32_t output_;
+
+    // 2 cos(w) for each frequency w (in radians per sample), and the window,
+    // applied to the block before filtering.
+    vector<double> coefficients_;
+    vector<double> window_;
+
+    // The last block_size samples of each dimension; `position_` is the
+    // oldest (next to be replaced).
+    vector<double> samples_;
+    uint32_t position_;
+    uint64_t num_samples_;
+
+    // The filters' state, s[n - 1] and s[n - 2], for each frequency.
+    vector<double> state1_;
+    vector<double> state2_;
+
+    static RegisterFeatureExtractionModule<GoertzelBank> registerModule;
+};
+
+} // namespace GRT
+
+#endif // ESP_GOERTZEL_BANK_H_
@@ -0,0 +1,96 @@
+#include "IncrementalANBC.h"
+#include "gtest/gtest.h"
+
+#include <random>
+
+static const uint32_t kDim = 4;
+static const uint32_t kNumClasses = 3;
+
+static GRT::ClassificationData makeData(uint32_t samples_per_class,
+                                        uint32_t num_classes, uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::normal_distribution<double> noise(0, 1.0);
+    GRT::ClassificationData data;
+    data.setNumDimensions(kDim);
+    for (uint32_t i = 0; i < samples_per_class; i++) {
+        for (uint32_t label = 1; label <= num_classes; label++) {
+            GRT::VectorDouble x(kDim);
+            for (uint32_t d = 0; d < kDim; d++) {
+                x[d] = 5.0 * label * (d % num_classes == label - 1) +
+                       noise(rng);
+            }
+            data.addSample(label, x);
+        }
+    }
+    return data;
+}
+
+// Training on some samples and adding the rest with updateModel() gives the
+// same model as training on all of them.
+TEST(IncrementalANBCTest, UpdateMatchesRetraining) {
+    GRT::ClassificationData all = makeData(30, kNumClasses, 1);
+    GRT::ClassificationData initial;
+    initial.setNumDimensions(kDim);
+    for (uint32_t i = 0; i < all.getNumSamples() / 2; i++) {
+        initial.addSample(all[i].getClassLabel(), all[i].getSample());
+    }
+
+    GRT::ANBC reference;
+    GRT::IncrementalANBC anbc;
+    ASSERT_TRUE(reference.train(all));
+    ASSERT_TRUE(anbc.train(initial));
+    for (uint32_t i = all.getNumSamples() / 2; i < all.getNumSamples(); i++) {
+        ASSERT_TRUE(anbc.updateModel(all[i].getClassLabel(),
+                                     all[i].getSample()));
+    }
+
+    GRT::ClassificationData test = makeData(10, kNumClasses, 2);
+    for (uint32_t i = 0; i < test.getNumSamples(); i++) {
+        GRT::VectorDouble x = test[i].getSample();
+        ASSERT_TRUE(reference.predict(x));
+        ASSERT_TRUE(anbc.predict(x));
+        ASSERT_EQ(reference.getPredictedClassLabel(),
+                  anbc.getPredictedClassLabel());
+        GRT::VectorDouble expected = reference.getClassLikelihoods();
+        GRT::VectorDouble actual = anbc.getClassLikelihoods();
+        ASSERT_EQ(expected.size(), actual.size());
+        for (uint32_t k = 0; k < expected.size(); k++) {
+            ASSERT_NEAR(expected[k], actual[k], 1e-9);
+        }
+    }
+}
+
+TEST(IncrementalANBCTest, UpdateAddsNewClass) {
+    GRT::ClassificationData all = makeData(20, kNumClasses, 3);
+    GRT::ClassificationData initial;
+    initial.setNumDimensions(kDim);
+    for (uint32_t i = 0; i < all.getNumSamples(); i++) {
+        if (all[i].getClassLabel() != kNumClasses) {
+            initial.addSample(all[i].getClassLabel(), all[i].getSample());
+        }
+    }
+
+    GRT::IncrementalANBC anbc;
+    ASSERT_TRUE(anbc.train(initial));
+    ASSERT_EQ(kNumClasses - 1, anbc.getNumClasses());
+    for (uint32_t i = 0; i < all.getNumSamples(); i++) {
+        if (all[i].getClassLabel() == kNumClasses) {
+            ASSERT_TRUE(anbc.updateModel(kNumClasses, all[i].getSample()));
+        }
+    }
+    ASSERT_EQ(kNumClasses, anbc.getNumClasses());
+
+    GRT::ClassificationData test = makeData(10, kNumClasses, 4);
+    uint32_t correct = 0;
+    for (uint32_t i = 0; i < test.getNumSamples(); i++) {
+        GRT::VectorDouble x = test[i].getSample();
+        ASSERT_TRUE(anbc.predict(x));
+        correct += anbc.getPredictedClassLabel() == test[i].getClassLabel();
+    }
+    EXPECT_GT(correct, test.getNumSamples() * 9 / 10);
+}
+
+TEST(IncrementalANBCTest, UpdateRequiresTraining) {
+    GRT::IncrementalANBC anbc;
+    ASSERT_FALSE(anbc.updateModel(1, GRT::VectorDouble(kDim, 0)));
+}
@@ -0,0 +1,142 @@
+#include "IncrementalANBC.h"
+
+namespace GRT {
+
+RegisterClassifierModule<IncrementalANBC> IncrementalANBC::registerModule(
+    "IncrementalANBC");
+
+IncrementalANBC::IncrementalANBC(bool useScaling, bool useNullRejection,
+                                 double nullRejectionCoeff)
+        : ANBC(useScaling, useNullRejection, nullRejectionCoeff) {
+    classType = "IncrementalANBC";
+    classifierType = classType;
+    debugLog.setProceedingText("[DEBUG IncrementalANBC]");
+    errorLog.setProceedingText("[ERROR IncrementalANBC]");
+    trainingLog.setProceedingText("[TRAINING IncrementalANBC]");
+    warningLog.setProceedingText("[WARNING IncrementalANBC]");
+}
+
+IncrementalANBC::IncrementalANBC(const IncrementalANBC& rhs) {
+    classType = "IncrementalANBC";
+    classifierType = classType;
+    debugLog.setProceedingText("[DEBUG IncrementalANBC]");
+    errorLog.setProceedingText("[ERROR IncrementalANBC]");
+    trainingLog.setProceedingText("[TRAINING IncrementalANBC]");
+    warningLog.setProceedingText("[WARNING IncrementalANBC]");
+
+    *this = rhs;
+}
+
+IncrementalANBC& IncrementalANBC::operator=(const IncrementalANBC& rhs) {
+    if (this != &rhs) {
+        ANBC::operator=(rhs);
+        // ANBC's assignment copies the base variables, type included.
+        classType = "IncrementalANBC";
+        classifierType = classType;
+        class_samples_ = rhs.class_samples_;
+    }
+    return *this;
+}
+
+bool IncrementalANBC::deepCopyFrom(const Classifier* classifier) {
+    if (classifier == nullptr) {
+        return false;
+    }
+
+    if (this->getClassifierType() == classifier->getClassifierType()) {
+        *this = *(IncrementalANBC*)classifier;
+        return true;
+    }
+
+    errorLog << "deepCopyFrom(const Classifier *classifier)"
+             << " - Classifier Types Do Not Match!" << std::endl;
+    return false;
+}
+
+bool IncrementalANBC::train_(ClassificationData& trainingData) {
+    // ANBC may scale and partition the data it's given.
+    ClassificationData data = trainingData;
+    if (!ANBC::train_(trainingData)) return false;
+
+    class_samples_.clear();
+    for (UINT i = 0; i < data.getNumSamples(); i++) {
+        class_samples_[data[i].getClassLabel()].push_back(
+            scaleSample(data[i].getSample()));
+    }
+    return true;
+}
+
+bool IncrementalANBC::clear() {
+    ANBC::clear();
+    class_samples_.clear();
+    return true;
+}
+
+VectorDouble IncrementalANBC::scaleSample(const VectorDouble& sample) const {
+    if (!useScaling) return sample;
+    VectorDouble scaled(sample.size());
+    for (UINT n = 0; n < sample.size(); n++) {
+        scaled[n] = scale(sample[n], ranges[n].minValue, ranges[n].maxValue,
+                          0, 1);
+    }
+    return scaled;
+}
+
+bool IncrementalANBC::updateModel(UINT classLabel, const VectorDouble& sample) {
+    if (!trained) {
+        errorLog << "updateModel(UINT classLabel, const VectorDouble &sample)"
+                 << " - Model Not Trained!" << std::endl;
+        return false;
+    }
+    if (sample.size() != numInputDimensions) {
+        errorLog << "updateModel(UINT classLabel, const VectorDouble &sample)"
+                 << " - The size of the sample (" << sample.size()
+                 << ") does not match the num features in the model ("
+                 << numInputDimensions << ")" << std::endl;
+        return false;
+    }
+
+    UINT k = 0;
+    while (k < classLabels.size() && classLabels[k] != classLabel) k++;
+    const bool is_new_class = k == classLabels.size();
+    if (!is_new_class && class_samples_.count(classLabel) == 0) {
+        // The model was loaded from a file, without its samples.
+        warningLog << "updateModel(UINT classLabel, const VectorDouble &sample)"
+                   << " - The samples of class " << classLabel
+                   << " are unknown; retrain the model instead." << std::endl;
+        return false;
+    }
+
+    MatrixDouble samples;
+    if (!is_new_class) samples = class_samples_[classLabel];
+    samples.push_back(scaleSample(sample));
+
+    // Train the class's model as ANBC::train_() does, with unit weights for a
+    // new class.
+    ANBC_Model model;
+    VectorDouble weights(numInputDimensions, 1.0);
+    if (!is_new_class) weights = models[k].weights;
+    model.gamma = nullRejectionCoeff;
+    if (!model.train(classLabel, samples, weights)) {
+        errorLog << "updateModel(UINT classLabel, const VectorDouble &sample)"
+                 << " - Failed to train the model of class " << classLabel
+                 << std::endl;
+        return false;
+    }
+
+    class_samples_[classLabel] = samples;
+    if (is_new_class) {
+        models.push_back(model);
+        classLabels.push_back(classLabel);
+        nullRejectionThresholds.push_back(model.threshold);
+        numClasses = classLabels.size();
+        classLikelihoods.resize(numClasses, 0);
+        classDistances.resize(numClasses, 0);
+    } else {
+        models[k] = model;
+        nullRejectionThresholds[k] = model.threshold;
+    }
+    return true;
+}
+
+} // namespace GRT
@@ -0,0 +1,56 @@
+#ifndef ESP_INCREMENTAL_ANBC_H_
+#define ESP_INCREMENTAL_ANBC_H_
+
+#include "GRT/GRT.h"
+#include "IncrementalClassifier.h"
+
+#include <map>
+
+namespace GRT {
+
+// IncrementalANBC is GRT's ANBC with updateModel(): a new sample only
+// retrains the Gaussian model of its own class, instead of every class.
+//
+// ANBC's models keep a mean and deviation per dimension, and a null
+// rejection threshold from the likelihoods of the class's samples, but not
+// the samples themselves. IncrementalANBC keeps a (scaled) copy of the
+// training samples of each class, so that the class's model can be trained
+// again with one more sample, exactly as ANBC would train it. A new label
+// gets a model of its own.
+//
+// New samples are scaled with the ranges of the last training data. The
+// copies aren't saved with the model: after loading a model from a file,
+// only samples of labels the model doesn't know yet can be added until it's
+// retrained.
+class IncrementalANBC : public ANBC, public IncrementalClassifier {
+  public:
+    IncrementalANBC(bool useScaling = false, bool useNullRejection = false,
+                    double nullRejectionCoeff = 10.0);
+
+    IncrementalANBC(const IncrementalANBC& rhs);
+    IncrementalANBC& operator=(const IncrementalANBC& rhs);
+    bool deepCopyFrom(const Classifier* classifier) override;
+    ~IncrementalANBC() override {}
+
+    bool train_(ClassificationData& trainingData) override;
+    bool clear() override;
+
+    // Add `sample` to the model of `classLabel`, in time proportional to the
+    // number of samples of that class.
+    bool updateModel(UINT classLabel, const VectorDouble& sample) override;
+
+    using MLBase::train;
+    using MLBase::predict;
+
+  protected:
+    VectorDouble scaleSample(const VectorDouble& sample) const;
+
+    // The scaled training samples of each class, one per row.
+    std::map<UINT, MatrixDouble> class_samples_;
+
+    static RegisterClassifierModule<IncrementalANBC> registerModule;
+};
+
+} // namespace GRT
+
+#endif // ESP_INCREMENTAL_ANBC_H_
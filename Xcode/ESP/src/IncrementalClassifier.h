@@ -0,0 +1,34 @@
+#ifndef ESP_INCREMENTAL_CLASSIFIER_H_
+#define ESP_INCREMENTAL_CLASSIFIER_H_
+
+#include "GRT/GRT.h"
+
+namespace GRT {
+
+// IncrementalClassifier is implemented by classifiers that can add a training
+// sample to a trained model in time proportional to the size of the sample,
+// instead of retraining on all of the training data.
+//
+// ESP checks for this interface with dynamic_cast when the user records a new
+// training sample: if the pipeline's classifier implements it, the sample is
+// run through the pipeline's pre-processing and feature extraction and each
+// resulting feature vector is passed to updateModel(). Other classifiers are
+// only updated when the model is retrained.
+//
+// QuantizedKNN, IncrementalANBC and IncrementalKNN implement it; the last two
+// are drop-in replacements for GRT's ANBC and KNN. DTW isn't updated: it picks
+// each class's template by comparing all of its samples with each other, so
+// a new sample can change which one is picked, and retraining is as cheap as
+// updating.
+class IncrementalClassifier {
+  public:
+    virtual ~IncrementalClassifier() {}
+
+    // Add one feature vector, labelled `classLabel`, to the trained model.
+    // The label may be one the model hasn't seen yet.
+    virtual bool updateModel(UINT classLabel, const VectorDouble& sample) = 0;
+};
+
+} // namespace GRT
+
+#endif // ESP_INCREMENTAL_CLASSIFIER_H_
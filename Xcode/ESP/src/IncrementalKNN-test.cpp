@@ -0,0 +1,63 @@
+#include "IncrementalKNN.h"
+#include "gtest/gtest.h"
+
+#include <random>
+
+static const uint32_t kDim = 4;
+static const uint32_t kNumClasses = 3;
+
+static GRT::ClassificationData makeData(uint32_t samples_per_class,
+                                        uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::normal_distribution<double> noise(0, 1.0);
+    GRT::ClassificationData data;
+    data.setNumDimensions(kDim);
+    for (uint32_t i = 0; i < samples_per_class; i++) {
+        for (uint32_t label = 1; label <= kNumClasses; label++) {
+            GRT::VectorDouble x(kDim);
+            for (uint32_t d = 0; d < kDim; d++) {
+                x[d] = 3.0 * label * (d % kNumClasses == label - 1) +
+                       noise(rng);
+            }
+            data.addSample(label, x);
+        }
+    }
+    return data;
+}
+
+// Training on some samples and adding the rest with updateModel() gives the
+// same predictions as training on all of them.
+TEST(IncrementalKNNTest, UpdateMatchesRetraining) {
+    GRT::ClassificationData all = makeData(30, 1);
+    GRT::ClassificationData initial;
+    initial.setNumDimensions(kDim);
+    for (uint32_t i = 0; i < all.getNumSamples() / 2; i++) {
+        initial.addSample(all[i].getClassLabel(), all[i].getSample());
+    }
+
+    GRT::KNN reference(5);
+    GRT::IncrementalKNN knn(5);
+    ASSERT_TRUE(reference.train(all));
+    ASSERT_TRUE(knn.train(initial));
+    for (uint32_t i = all.getNumSamples() / 2; i < all.getNumSamples(); i++) {
+        ASSERT_TRUE(knn.updateModel(all[i].getClassLabel(),
+                                    all[i].getSample()));
+    }
+
+    GRT::ClassificationData test = makeData(10, 2);
+    for (uint32_t i = 0; i < test.getNumSamples(); i++) {
+        GRT::VectorDouble x = test[i].getSample();
+        ASSERT_TRUE(reference.predict(x));
+        ASSERT_TRUE(knn.predict(x));
+        ASSERT_EQ(reference.getPredictedClassLabel(),
+                  knn.getPredictedClassLabel());
+    }
+}
+
+TEST(IncrementalKNNTest, NewClassNeedsRetrainingWithNullRejection) {
+    GRT::ClassificationData all = makeData(10, 5);
+    GRT::IncrementalKNN knn(3, false, true);
+    ASSERT_TRUE(knn.train(all));
+    ASSERT_TRUE(knn.updateModel(1, all[0].getSample()));
+    ASSERT_FALSE(knn.updateModel(kNumClasses + 1, all[0].getSample()));
+}
@@ -0,0 +1,107 @@
+#include "IncrementalKNN.h"
+
+#include <algorithm>
+
+namespace GRT {
+
+RegisterClassifierModule<IncrementalKNN> IncrementalKNN::registerModule(
+    "IncrementalKNN");
+
+IncrementalKNN::IncrementalKNN(UINT K, bool useScaling, bool useNullRejection,
+                               double nullRejectionCoeff,
+                               bool searchForBestKValue, UINT minKSearchValue,
+                               UINT maxKSearchValue)
+        : KNN(K, useScaling, useNullRejection, nullRejectionCoeff,
+              searchForBestKValue, minKSearchValue, maxKSearchValue) {
+    classType = "IncrementalKNN";
+    classifierType = classType;
+    debugLog.setProceedingText("[DEBUG IncrementalKNN]");
+    errorLog.setProceedingText("[ERROR IncrementalKNN]");
+    trainingLog.setProceedingText("[TRAINING IncrementalKNN]");
+    warningLog.setProceedingText("[WARNING IncrementalKNN]");
+}
+
+IncrementalKNN::IncrementalKNN(const IncrementalKNN& rhs) {
+    classType = "IncrementalKNN";
+    classifierType = classType;
+    debugLog.setProceedingText("[DEBUG IncrementalKNN]");
+    errorLog.setProceedingText("[ERROR IncrementalKNN]");
+    trainingLog.setProceedingText("[TRAINING IncrementalKNN]");
+    warningLog.setProceedingText("[WARNING IncrementalKNN]");
+
+    *this = rhs;
+}
+
+IncrementalKNN& IncrementalKNN::operator=(const IncrementalKNN& rhs) {
+    if (this != &rhs) {
+        KNN::operator=(rhs);
+        // KNN's assignment copies the base variables, type included.
+        classType = "IncrementalKNN";
+        classifierType = classType;
+    }
+    return *this;
+}
+
+bool IncrementalKNN::deepCopyFrom(const Classifier* classifier) {
+    if (classifier == nullptr) {
+        return false;
+    }
+
+    if (this->getClassifierType() == classifier->getClassifierType()) {
+        *this = *(IncrementalKNN*)classifier;
+        return true;
+    }
+
+    errorLog << "deepCopyFrom(const Classifier *classifier)"
+             << " - Classifier Types Do Not Match!" << std::endl;
+    return false;
+}
+
+bool IncrementalKNN::updateModel(UINT classLabel, const VectorDouble& sample) {
+    if (!trained) {
+        errorLog << "updateModel(UINT classLabel, const VectorDouble &sample)"
+                 << " - Model Not Trained!" << std::endl;
+        return false;
+    }
+
+    if (sample.size() != numInputDimensions) {
+        errorLog << "updateModel(UINT classLabel, const VectorDouble &sample)"
+                 << " - The size of the sample (" << sample.size()
+                 << ") does not match the num features in the model ("
+                 << numInputDimensions << ")" << std::endl;
+        return false;
+    }
+
+    auto it = std::lower_bound(classLabels.begin(), classLabels.end(),
+                               classLabel);
+    const bool is_new_class = it == classLabels.end() || *it != classLabel;
+    if (is_new_class && useNullRejection) {
+        warningLog << "updateModel(UINT classLabel, const VectorDouble &sample)"
+                   << " - Class " << classLabel << " has no null rejection"
+                   << " threshold; retrain the model instead." << std::endl;
+        return false;
+    }
+
+    VectorDouble x = sample;
+    if (useScaling) {
+        for (UINT n = 0; n < numInputDimensions; n++) {
+            x[n] = scale(x[n], ranges[n].minValue, ranges[n].maxValue, 0, 1);
+        }
+    }
+    if (!trainingData.addSample(classLabel, x)) {
+        errorLog << "updateModel(UINT classLabel, const VectorDouble &sample)"
+                 << " - Failed to add the sample to the training data!"
+                 << std::endl;
+        return false;
+    }
+
+    if (is_new_class) {
+        classLabels.insert(it, classLabel);
+        numClasses = classLabels.size();
+        classLikelihoods.assign(numClasses, 0);
+        classDistances.assign(numClasses, 0);
+    }
+    return true;
+}
+
+} // namespace GRT
@@ -0,0 +1,40 @@
+#ifndef ESP_INCREMENTAL_KNN_H_
+#define ESP_INCREMENTAL_KNN_H_
+
+#include "GRT/GRT.h"
+#include "IncrementalClassifier.h"
+
+namespace GRT {
+
+// IncrementalKNN is GRT's KNN with updateModel(): KNN's model is its
+// (scaled) training data, so a new sample is appended to it.
+//
+// New samples are scaled with the ranges of the last training data. With
+// null rejection enabled, only samples of labels the model already knows can
+// be added, as the rejection thresholds are computed from all of the training
+// data; retrain to pick up new labels.
+class IncrementalKNN : public KNN, public IncrementalClassifier {
+  public:
+    IncrementalKNN(UINT K = 10, bool useScaling = false,
+                   bool useNullRejection = false,
+                   double nullRejectionCoeff = 10.0,
+                   bool searchForBestKValue = false, UINT minKSearchValue = 1,
+                   UINT maxKSearchValue = 10);
+
+    IncrementalKNN(const IncrementalKNN& rhs);
+    IncrementalKNN& operator=(const IncrementalKNN& rhs);
+    bool deepCopyFrom(const Classifier* classifier) override;
+    ~IncrementalKNN() override {}
+
+    bool updateModel(UINT classLabel, const VectorDouble& sample) override;
+
+    using MLBase::train;
+    using MLBase::predict;
+
+  protected:
+    static RegisterClassifierModule<IncrementalKNN> registerModule;
+};
+
+} // namespace GRT
+
+#endif // ESP_INCREMENTAL_KNN_H_
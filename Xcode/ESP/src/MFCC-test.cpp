@@ -0,0 +1,62 @@
+#include "MFCC.h"
+#include "gtest/gtest.h"
+
+#include <random>
+
+static GRT::MFCC::Options makeOptions() {
+    GRT::MFCC::Options options;
+    options.sample_rate = 16000;
+    options.fft_size = 256;
+    options.start_freq = 300;
+    options.end_freq = 8000;
+    options.num_tri_filter = 26;
+    options.num_cepstral_coeff = 12;
+    options.lifter_param = 22;
+    return options;
+}
+
+TEST(MFCCTest, CopiesShareTables) {
+    int64_t before = GRT::MFCC::getTableMemoryUsage();
+    {
+        GRT::MFCC mfcc(makeOptions());
+        int64_t one = GRT::MFCC::getTableMemoryUsage() - before;
+        ASSERT_EQ((26 * 256 + 12 * 26) * sizeof(double), one);
+
+        // Copies, assignments and instances built from equal options all use
+        // the same tables.
+        GRT::MFCC copy(mfcc);
+        GRT::MFCC assigned;
+        assigned = mfcc;
+        GRT::MFCC same(makeOptions());
+        ASSERT_EQ(one, GRT::MFCC::getTableMemoryUsage() - before);
+
+        // Different options need tables of their own.
+        GRT::MFCC::Options options = makeOptions();
+        options.num_tri_filter = 20;
+        GRT::MFCC other(options);
+        ASSERT_GT(GRT::MFCC::getTableMemoryUsage() - before, one);
+    }
+    // The tables go with the last instance that uses them.
+    ASSERT_EQ(before, GRT::MFCC::getTableMemoryUsage());
+}
+
+TEST(MFCCTest, CopiesComputeTheSameFeatures) {
+    GRT::MFCC mfcc(makeOptions());
+    GRT::MFCC copy(mfcc);
+
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<double> magnitude(0, 10);
+    for (int i = 0; i < 10; i++) {
+        GRT::VectorDouble fft(256);
+        for (double& x : fft) x = magnitude(rng);
+        ASSERT_TRUE(mfcc.computeFeatures(fft));
+        ASSERT_TRUE(copy.computeFeatures(fft));
+        ASSERT_EQ(mfcc.getFeatureVector(), copy.getFeatureVector());
+    }
+}
+
+TEST(MFCCTest, UninitializedFails) {
+    GRT::MFCC mfcc;
+    GRT::MFCC copy(mfcc);
+    ASSERT_FALSE(copy.computeFeatures(GRT::VectorDouble(256, 1.0)));
+}
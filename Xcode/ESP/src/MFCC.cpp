@@ -1,9 +1,13 @@
 #include "MFCC.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cmath>
+#include <map>
+#include <mutex>
 #include <new>
 #include <numeric>
+#include <tuple>
 #include <vector>
 
 #if __APPLE__
@@ -18,14 +22,40 @@ using std::vector;
 
 RegisterFeatureExtractionModule<MFCC> MFCC::registerModule("MFCC");
 
-TriFilterBanks::TriFilterBanks() : initialized_(false) {
+// Heap bytes allocated for filter banks and DCT matrices, see
+// TriFilterBanks::getTableMemoryUsage().
+static std::atomic<int64_t> table_bytes(0);
+
+int64_t TriFilterBanks::getTableMemoryUsage() {
+    return table_bytes;
+}
+
+TriFilterBanks::TriFilterBanks() : num_filter_(0), filter_size_(0) {
+}
+
+TriFilterBanks::TriFilterBanks(const TriFilterBanks& rhs)
+    : filter_(rhs.filter_), num_filter_(rhs.num_filter_),
+      filter_size_(rhs.filter_size_) {
+    table_bytes += filter_.size() * sizeof(double);
+}
+
+TriFilterBanks& TriFilterBanks::operator=(const TriFilterBanks& rhs) {
+    if (this != &rhs) {
+        table_bytes -= filter_.size() * sizeof(double);
+        filter_ = rhs.filter_;
+        num_filter_ = rhs.num_filter_;
+        filter_size_ = rhs.filter_size_;
+        table_bytes += filter_.size() * sizeof(double);
+    }
+    return *this;
 }
 
 void TriFilterBanks::initialize(uint32_t num_filter, uint32_t filter_size) {
+    table_bytes -= filter_.size() * sizeof(double);
     num_filter_ = num_filter;
     filter_size_ = filter_size;
-    filter_ = new double[num_filter_ * filter_size_];
-    initialized_ = true;
+    filter_.assign(num_filter_ * filter_size_, 0.0);
+    table_bytes += filter_.size() * sizeof(double);
 }
 
 void TriFilterBanks::setFilter(uint32_t idx, double left, double middle,
@@ -51,76 +81,113 @@ void TriFilterBanks::setFilter(uint32_t idx, double left, double middle,
 }
 
 TriFilterBanks::~TriFilterBanks() {
-    if (initialized_) {
-        delete filter_;
-    }
+    table_bytes -= filter_.size() * sizeof(double);
 }
 
 void TriFilterBanks::filter(const vector<double>& input,
-                            vector<double>& output) {
+                            vector<double>& output) const {
     assert(input.size() == filter_size_ &&
            "Dimension mismatch in TriFilterBanks filter");
 
     // Perform matrix multiplication
     cblas_dgemv(CblasRowMajor, CblasNoTrans, num_filter_, filter_size_, 1.0,
-                filter_, filter_size_, input.data(), 1, 1.0, output.data(), 1);
+                filter_.data(), filter_size_, input.data(), 1, 1.0,
+                output.data(), 1);
 }
 
-MFCC::MFCC(Options options) : initialized_(false), options_(options) {
-    classType = "MFCC";
-    featureExtractionType = classType;
-    debugLog.setProceedingText("[INFO MFCC]");
-    debugLog.setProceedingText("[DEBUG MFCC]");
-    errorLog.setProceedingText("[ERROR MFCC]");
-    warningLog.setProceedingText("[WARNING MFCC]");
-
-    if (options == Options()) { // Default values
-        return;
+std::shared_ptr<const MFCC::Tables> MFCC::Tables::get(const Options& options) {
+    // Keyed by the options the tables are built from. The cache holds weak
+    // references, so unused tables aren't kept alive by it.
+    typedef std::tuple<uint32_t, uint32_t, double, double, uint32_t, uint32_t>
+        Key;
+    static std::mutex mutex;
+    static std::map<Key, std::weak_ptr<const Tables>> cache;
+
+    Key key(options.sample_rate, options.fft_size, options.start_freq,
+            options.end_freq, options.num_tri_filter,
+            options.num_cepstral_coeff);
+    std::lock_guard<std::mutex> lock(mutex);
+    std::shared_ptr<const Tables> tables = cache[key].lock();
+    if (!tables) {
+        tables = std::make_shared<const Tables>(options);
+        cache[key] = tables;
     }
 
-    initialize();
+    // Forget tables that are gone, so the cache can't grow without bound.
+    for (auto it = cache.begin(); it != cache.end();) {
+        if (it->second.expired()) {
+            it = cache.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    return tables;
 }
 
-void MFCC::initialize() {
-    numInputDimensions = options_.fft_size;
-    numOutputDimensions = options_.num_cepstral_coeff;
-
+MFCC::Tables::Tables(const Options& options) {
     //---------------------------------------------
     //  Prepare the tribank filter
     //---------------------------------------------
-    filters_.initialize(options_.num_tri_filter, options_.fft_size);
+    filters.initialize(options.num_tri_filter, options.fft_size);
 
-    vector<double> freqs(options_.num_tri_filter + 2);
-    double mel_start = TriFilterBanks::toMelScale(options_.start_freq);
-    double mel_end = TriFilterBanks::toMelScale(options_.end_freq);
-    double mel_step = (mel_end - mel_start) / (options_.num_tri_filter + 1);
+    vector<double> freqs(options.num_tri_filter + 2);
+    double mel_start = TriFilterBanks::toMelScale(options.start_freq);
+    double mel_end = TriFilterBanks::toMelScale(options.end_freq);
+    double mel_step = (mel_end - mel_start) / (options.num_tri_filter + 1);
 
-    for (uint32_t i = 0; i < options_.num_tri_filter + 2; i++) {
+    for (uint32_t i = 0; i < options.num_tri_filter + 2; i++) {
         freqs[i] = TriFilterBanks::fromMelScale(mel_start + i * mel_step);
     }
 
-    for (uint32_t i = 0; i < options_.num_tri_filter; i++) {
-        filters_.setFilter(i, freqs[i], freqs[i + 1], freqs[i + 2],
-                           options_.sample_rate);
+    for (uint32_t i = 0; i < options.num_tri_filter; i++) {
+        filters.setFilter(i, freqs[i], freqs[i + 1], freqs[i + 2],
+                          options.sample_rate);
     }
 
     //--------------------------------------------------------------------------
     //  Prepare the dct matrix
     //
-    //   [ num_cepstral_coeff rows * options_.num_tri_filter columns ]
+    //   [ num_cepstral_coeff rows * options.num_tri_filter columns ]
     //
     //--------------------------------------------------------------------------
-    uint32_t row = options_.num_cepstral_coeff;
-    uint32_t col = options_.num_tri_filter;
-    dct_matrix_ = new double[row * col];
+    uint32_t row = options.num_cepstral_coeff;
+    uint32_t col = options.num_tri_filter;
+    dct_matrix.resize(row * col);
+    table_bytes += dct_matrix.size() * sizeof(double);
     for (uint32_t i = 0; i < row; i++) {
         for (uint32_t j = 0; j < col; j++) {
             // In the matlab reference implementation, it's using (j - 0.5),
             // that's because j is 1:M not 0:(M-1). In C++, we use (j + 0.5).
-            dct_matrix_[i * col + j] =
+            dct_matrix[i * col + j] =
                 sqrt(2.0 / col) * cos(PI * i / col * (j + 0.5));
         }
     }
+}
+
+MFCC::Tables::~Tables() {
+    table_bytes -= dct_matrix.size() * sizeof(double);
+}
+
+MFCC::MFCC(Options options) : initialized_(false), options_(options) {
+    classType = "MFCC";
+    featureExtractionType = classType;
+    debugLog.setProceedingText("[INFO MFCC]");
+    debugLog.setProceedingText("[DEBUG MFCC]");
+    errorLog.setProceedingText("[ERROR MFCC]");
+    warningLog.setProceedingText("[WARNING MFCC]");
+
+    if (options == Options()) { // Default values
+        return;
+    }
+
+    initialize();
+}
+
+void MFCC::initialize() {
+    numInputDimensions = options_.fft_size;
+    numOutputDimensions = options_.num_cepstral_coeff;
+
+    tables_ = Tables::get(options_);
 
     // Vector allocation
     tmp_lfbe_.resize(options_.num_tri_filter);
@@ -129,22 +196,26 @@ void MFCC::initialize() {
     initialized_ = true;
 }
 
-MFCC::MFCC(const MFCC& rhs) {
+MFCC::MFCC(const MFCC& rhs) : initialized_(false) {
     classType = rhs.getClassType();
     featureExtractionType = classType;
     debugLog.setProceedingText("[DEBUG MFCC]");
     errorLog.setProceedingText("[ERROR MFCC]");
     warningLog.setProceedingText("[WARNING MFCC]");
 
-    this->options_ = rhs.options_;
     *this = rhs;
 }
 
 MFCC& MFCC::operator=(const MFCC& rhs) {
     if (this != &rhs) {
+        // The tables are shared rather than rebuilt; only the scratch buffers
+        // are per instance.
         this->classType = rhs.getClassType();
-        this->options_ = rhs.getOptions();
-        this->initialize();
+        this->options_ = rhs.options_;
+        this->initialized_ = rhs.initialized_;
+        this->tables_ = rhs.tables_;
+        this->tmp_lfbe_.assign(rhs.tmp_lfbe_.size(), 0);
+        this->tmp_cc_.assign(rhs.tmp_cc_.size(), 0);
         copyBaseVariables((FeatureExtraction*)&rhs);
     }
     return *this;
@@ -173,7 +244,7 @@ void MFCC::computeLFBE(const vector<double>& fft, vector<double>& lfbe) {
            "Dimension mismatch for LFBE computation");
 
     uint32_t M = options_.num_tri_filter;
-    filters_.filter(fft, lfbe);
+    tables_->filters.filter(fft, lfbe);
 
     for (uint32_t i = 0; i < M; i++) {
         if (lfbe[i] != 0) {
@@ -184,7 +255,7 @@ void MFCC::computeLFBE(const vector<double>& fft, vector<double>& lfbe) {
 
 void MFCC::computeCC(const vector<double>& lfbe, vector<double>& cc) {
     cblas_dgemv(CblasRowMajor, CblasNoTrans, options_.num_cepstral_coeff,
-                options_.num_tri_filter, 1.0, dct_matrix_,
+                options_.num_tri_filter, 1.0, tables_->dct_matrix.data(),
                 options_.num_tri_filter, lfbe.data(), 1, 1.0, cc.data(), 1);
 }
 
@@ -211,6 +282,12 @@ vector<double> MFCC::lifterCC(const vector<double>& cc) {
 }
 
 bool MFCC::computeFeatures(const VectorDouble& inputVector) {
+    if (!initialized_) {
+        errorLog << "computeFeatures(const VectorDouble &inputVector)"
+                 << " - Not initialized!" << std::endl;
+        return false;
+    }
+
     featureVector.resize(options_.num_cepstral_coeff);
 
     // The assumed input data is FFT value. We check VAD, if too small (somewhat
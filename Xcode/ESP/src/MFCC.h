@@ -5,6 +5,7 @@
 
 #include <math.h>
 #include <stdint.h>
+#include <memory>
 #include <vector>
 
 namespace GRT {
@@ -22,6 +23,8 @@ using std::vector;
 class TriFilterBanks {
   public:
     TriFilterBanks();
+    TriFilterBanks(const TriFilterBanks& rhs);
+    TriFilterBanks& operator=(const TriFilterBanks& rhs);
     ~TriFilterBanks();
 
     void initialize(uint32_t num_filter, uint32_t filter_size);
@@ -40,11 +43,15 @@ class TriFilterBanks {
         return num_filter_;
     }
 
-    void filter(const vector<double>& input, vector<double>& output);
+    // Bytes currently allocated for filter banks and DCT matrices by all
+    // TriFilterBanks and MFCC tables. MFCC copies share their tables, so this
+    // doesn't grow with the number of copies.
+    static int64_t getTableMemoryUsage();
+
+    void filter(const vector<double>& input, vector<double>& output) const;
 
   private:
-    bool initialized_;
-    double* filter_;
+    vector<double> filter_;
     uint32_t num_filter_;
     uint32_t filter_size_;
 };
@@ -117,20 +124,40 @@ class MFCC : public FeatureExtraction {
         }
     };
 
+    // The filter bank and DCT matrix for a set of options. They never change
+    // once built, and are shared by all MFCC instances with options that
+    // only differ in the lifter and VAD settings, so copying an MFCC (as
+    // cloning a pipeline does) doesn't rebuild them. They're freed with the
+    // last instance that uses them.
+    class Tables {
+      public:
+        static std::shared_ptr<const Tables> get(const Options& options);
+
+        Tables(const Options& options);
+        ~Tables();
+
+        TriFilterBanks filters;
+        // [ num_cepstral_coeff rows * num_tri_filter columns ]
+        vector<double> dct_matrix;
+    };
+
     MFCC(struct Options options = Options());
 
     MFCC(const MFCC& rhs);
     MFCC& operator=(const MFCC& rhs);
     bool deepCopyFrom(const FeatureExtraction* featureExtraction) override;
-    ~MFCC() override {
-        delete[] dct_matrix_;
-    }
+    ~MFCC() override {}
 
     void initialize();
 
     bool computeFeatures(const VectorDouble& inputVector) override;
     bool reset() override;
 
+    // See TriFilterBanks::getTableMemoryUsage().
+    static int64_t getTableMemoryUsage() {
+        return TriFilterBanks::getTableMemoryUsage();
+    }
+
     // Configurable Parameters
     bool setNoiseLevel(double noise_level) {
         options_.noise_level = noise_level;
@@ -147,7 +174,7 @@ class MFCC : public FeatureExtraction {
         return options_;
     }
     TriFilterBanks getFilters() const {
-        return filters_;
+        return tables_ ? tables_->filters : TriFilterBanks();
     }
 
   public:
@@ -160,10 +187,9 @@ class MFCC : public FeatureExtraction {
     bool initialized_;
     Options options_;
 
-    // The information below can be generated with options_. We fill them during
-    // the initialize() function.
-    double* dct_matrix_;
-    TriFilterBanks filters_;
+    // Generated from options_ (or shared with an instance with the same
+    // options) in initialize().
+    std::shared_ptr<const Tables> tables_;
 
     vector<double> tmp_lfbe_;
     vector<double> tmp_cc_;
@@ -0,0 +1,91 @@
+#include "MajorityVoteFilter.h"
+#include "GRT/GRT.h"
+#include "gtest/gtest.h"
+
+#include <random>
+
+TEST(MajorityVoteFilterTest, MatchesClassLabelFilter) {
+    // With a minimum count above half the buffer size there can be no ties,
+    // so both filters must agree on every prediction.
+    const uint32_t kBufferSize = 9;
+    const uint32_t kMinimumCount = 5;
+    GRT::MajorityVoteFilter filter(kMinimumCount, kBufferSize);
+    GRT::ClassLabelFilter reference(kMinimumCount, kBufferSize);
+
+    // Long runs of the same label so that the filter output changes often.
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<uint32_t> label(0, 3);
+    std::uniform_int_distribution<uint32_t> run(1, 8);
+    for (uint32_t i = 0; i < 200; i++) {
+        uint32_t l = label(rng);
+        for (uint32_t j = run(rng); j > 0; j--) {
+            ASSERT_EQ(reference.filter(l), filter.filter(l));
+        }
+    }
+}
+
+TEST(MajorityVoteFilterTest, NullLabelsDoNotVote) {
+    GRT::MajorityVoteFilter filter(1, 3);
+    ASSERT_EQ(0, filter.filter(0));
+    ASSERT_EQ(2, filter.filter(2));
+    ASSERT_EQ(2, filter.filter(0));
+    ASSERT_EQ(2, filter.filter(0));
+    ASSERT_EQ(0, filter.filter(0));
+}
+
+TEST(MajorityVoteFilterTest, TiesGoToTheLowerLabel) {
+    // Ties as votes come in, whichever label got there first.
+    GRT::MajorityVoteFilter filter(1, 4);
+    ASSERT_EQ(3, filter.filter(3));
+    ASSERT_EQ(2, filter.filter(2));
+    ASSERT_EQ(3, filter.filter(3));
+    ASSERT_EQ(2, filter.filter(2));
+
+    // A tie as the leader's vote leaves the buffer.
+    filter.reset();
+    filter.filter(4);
+    filter.filter(4);
+    ASSERT_EQ(4, filter.filter(2));
+    ASSERT_EQ(4, filter.filter(0));
+    ASSERT_EQ(2, filter.filter(0));
+}
+
+TEST(MajorityVoteFilterTest, ProcessUsesFirstValue) {
+    GRT::MajorityVoteFilter filter(2, 3);
+    ASSERT_TRUE(filter.process(GRT::VectorDouble(1, 4)));
+    ASSERT_EQ(0, filter.getFilteredClassLabel());
+    ASSERT_TRUE(filter.process(GRT::VectorDouble(1, 4)));
+    ASSERT_EQ(4, filter.getFilteredClassLabel());
+    ASSERT_FALSE(filter.process(GRT::VectorDouble(2, 4)));
+}
+
+TEST(MajorityVoteFilterTest, ResizeKeepsHistory) {
+    GRT::MajorityVoteFilter filter(3, 4);
+    filter.filter(2);
+    filter.filter(1);
+    filter.filter(1);
+    ASSERT_EQ(1, filter.filter(1));
+
+    // Growing pads the buffer with null labels.
+    ASSERT_TRUE(filter.setBufferSize(8));
+    ASSERT_EQ(1, filter.getFilteredClassLabel());
+    ASSERT_EQ(1, filter.filter(2));
+
+    // Shrinking keeps the most recent labels (1, 2) and lowers the minimum
+    // count to the new buffer size.
+    ASSERT_TRUE(filter.setBufferSize(2));
+    ASSERT_EQ(2, filter.getMinimumCount());
+    ASSERT_EQ(0, filter.getFilteredClassLabel());
+    ASSERT_EQ(2, filter.filter(2));
+
+    ASSERT_FALSE(filter.setBufferSize(0));
+    ASSERT_FALSE(filter.setMinimumCount(3));
+}
+
+TEST(MajorityVoteFilterTest, Reset) {
+    GRT::MajorityVoteFilter filter(1, 3);
+    ASSERT_EQ(1, filter.filter(1));
+    ASSERT_TRUE(filter.reset());
+    ASSERT_EQ(0, filter.getFilteredClassLabel());
+    ASSERT_EQ(0, filter.filter(0));
+}
@@ -0,0 +1,310 @@
+#include "MajorityVoteFilter.h"
+
+#include <algorithm>
+
+namespace GRT {
+
+RegisterPostProcessingModule<MajorityVoteFilter>
+    MajorityVoteFilter::registerModule("MajorityVoteFilter");
+
+MajorityVoteFilter::MajorityVoteFilter(uint32_t minimum_count,
+                                       uint32_t buffer_size) {
+    classType = "MajorityVoteFilter";
+    postProcessingType = classType;
+    postProcessingInputMode = INPUT_MODE_PREDICTED_CLASS_LABEL;
+    postProcessingOutputMode = OUTPUT_MODE_PREDICTED_CLASS_LABEL;
+    debugLog.setProceedingText("[DEBUG MajorityVoteFilter]");
+    errorLog.setProceedingText("[ERROR MajorityVoteFilter]");
+    warningLog.setProceedingText("[WARNING MajorityVoteFilter]");
+
+    init(minimum_count, buffer_size);
+}
+
+MajorityVoteFilter::MajorityVoteFilter(const MajorityVoteFilter& rhs) {
+    classType = "MajorityVoteFilter";
+    postProcessingType = classType;
+    postProcessingInputMode = INPUT_MODE_PREDICTED_CLASS_LABEL;
+    postProcessingOutputMode = OUTPUT_MODE_PREDICTED_CLASS_LABEL;
+    debugLog.setProceedingText("[DEBUG MajorityVoteFilter]");
+    errorLog.setProceedingText("[ERROR MajorityVoteFilter]");
+    warningLog.setProceedingText("[WARNING MajorityVoteFilter]");
+
+    *this = rhs;
+}
+
+MajorityVoteFilter& MajorityVoteFilter::operator=(
+    const MajorityVoteFilter& rhs) {
+    if (this != &rhs) {
+        minimum_count_ = rhs.minimum_count_;
+        buffer_size_ = rhs.buffer_size_;
+        buffer_ = rhs.buffer_;
+        head_ = rhs.head_;
+        counts_ = rhs.counts_;
+        best_label_ = rhs.best_label_;
+        best_count_ = rhs.best_count_;
+        filtered_class_label_ = rhs.filtered_class_label_;
+        copyBaseVariables((PostProcessing*)&rhs);
+    }
+    return *this;
+}
+
+bool MajorityVoteFilter::deepCopyFrom(const PostProcessing* postProcessing) {
+    if (postProcessing == nullptr) {
+        return false;
+    }
+
+    if (this->getPostProcessingType() ==
+        postProcessing->getPostProcessingType()) {
+        *this = *(MajorityVoteFilter*)postProcessing;
+        return true;
+    }
+
+    errorLog << "deepCopyFrom(const PostProcessing *postProcessing)"
+             << " - PostProcessing Types Do Not Match!" << std::endl;
+    return false;
+}
+
+bool MajorityVoteFilter::init(uint32_t minimum_count, uint32_t buffer_size) {
+    initialized = false;
+
+    if (buffer_size == 0) {
+        errorLog << "init(uint32_t minimum_count, uint32_t buffer_size)"
+                 << " - The buffer size must be larger than zero!" << std::endl;
+        return false;
+    }
+
+    if (minimum_count > buffer_size) {
+        errorLog << "init(uint32_t minimum_count, uint32_t buffer_size)"
+                 << " - The minimum count must be less than or equal to the"
+                 << " buffer size!" << std::endl;
+        return false;
+    }
+
+    minimum_count_ = minimum_count;
+    buffer_size_ = buffer_size;
+    numInputDimensions = 1;
+    numOutputDimensions = 1;
+    initialized = reset();
+    return true;
+}
+
+bool MajorityVoteFilter::reset() {
+    buffer_.assign(buffer_size_, 0);
+    head_ = 0;
+    counts_.clear();
+    best_label_ = 0;
+    best_count_ = 0;
+    filtered_class_label_ = 0;
+    processedData.clear();
+    processedData.resize(1, 0);
+    return true;
+}
+
+bool MajorityVoteFilter::process(const VectorDouble& inputVector) {
+    if (!initialized) {
+        errorLog << "process(const VectorDouble &inputVector)"
+                 << " - Not initialized!" << std::endl;
+        return false;
+    }
+
+    if (inputVector.size() != numInputDimensions) {
+        errorLog << "process(const VectorDouble &inputVector)"
+                 << " - The size of the inputVector (" << inputVector.size()
+                 << ") does not match that of the filter ("
+                 << numInputDimensions << ")!" << std::endl;
+        return false;
+    }
+
+    // Use only the first value (as that is the predicted class label)
+    processedData[0] = filter(static_cast<uint32_t>(inputVector[0]));
+    return true;
+}
+
+uint32_t MajorityVoteFilter::filter(uint32_t predicted_class_label) {
+    if (!initialized) {
+        errorLog << "filter(uint32_t predicted_class_label)"
+                 << " - Not initialized!" << std::endl;
+        return 0;
+    }
+
+    removeVote(buffer_[head_]);
+    buffer_[head_] = predicted_class_label;
+    addVote(predicted_class_label);
+    if (++head_ == buffer_size_) head_ = 0;
+
+    updateFilteredClassLabel();
+    return filtered_class_label_;
+}
+
+void MajorityVoteFilter::addVote(uint32_t label) {
+    if (label == 0) return;
+    if (label >= counts_.size()) counts_.resize(label + 1, 0);
+
+    uint32_t count = ++counts_[label];
+    if (count > best_count_ || (count == best_count_ && label < best_label_)) {
+        best_label_ = label;
+        best_count_ = count;
+    }
+}
+
+void MajorityVoteFilter::removeVote(uint32_t label) {
+    if (label == 0) return;
+
+    --counts_[label];
+    if (label != best_label_) return;
+
+    // The leader lost a vote. Another label may have been tied with it, which
+    // takes a scan over the labels (not the buffer) to find out. Scanning up
+    // from the lowest label keeps the lowest of any tied labels.
+    best_label_ = 0;
+    best_count_ = 0;
+    for (uint32_t l = 1; l < counts_.size(); l++) {
+        if (counts_[l] > best_count_) {
+            best_label_ = l;
+            best_count_ = counts_[l];
+        }
+    }
+}
+
+void MajorityVoteFilter::updateFilteredClassLabel() {
+    if (best_count_ > 0 && best_count_ >= minimum_count_) {
+        filtered_class_label_ = best_label_;
+    } else {
+        filtered_class_label_ = 0;
+    }
+}
+
+bool MajorityVoteFilter::setMinimumCount(uint32_t minimum_count) {
+    if (minimum_count > buffer_size_) {
+        errorLog << "setMinimumCount(uint32_t minimum_count)"
+                 << " - The minimum count must be less than or equal to the"
+                 << " buffer size!" << std::endl;
+        return false;
+    }
+    minimum_count_ = minimum_count;
+    updateFilteredClassLabel();
+    return true;
+}
+
+bool MajorityVoteFilter::setBufferSize(uint32_t buffer_size) {
+    if (buffer_size == 0) {
+        errorLog << "setBufferSize(uint32_t buffer_size)"
+                 << " - The buffer size must be larger than zero!" << std::endl;
+        return false;
+    }
+    if (!initialized) {
+        return init(std::min(minimum_count_, buffer_size), buffer_size);
+    }
+
+    // Lay out the most recent predictions, oldest first, at the end of the
+    // new buffer; pad the front with null labels when growing.
+    uint32_t keep = std::min(buffer_size, buffer_size_);
+    vector<uint32_t> buffer(buffer_size, 0);
+    for (uint32_t i = 0; i < keep; i++) {
+        uint32_t from = (head_ + buffer_size_ - keep + i) % buffer_size_;
+        buffer[buffer_size - keep + i] = buffer_[from];
+    }
+
+    buffer_.swap(buffer);
+    buffer_size_ = buffer_size;
+    head_ = 0;
+
+    counts_.clear();
+    best_label_ = 0;
+    best_count_ = 0;
+    for (uint32_t label : buffer_) addVote(label);
+
+    if (minimum_count_ > buffer_size_) {
+        warningLog << "setBufferSize(uint32_t buffer_size)"
+                   << " - Lowering the minimum count to the buffer size ("
+                   << buffer_size_ << ")" << std::endl;
+        minimum_count_ = buffer_size_;
+    }
+    updateFilteredClassLabel();
+    return true;
+}
+
+bool MajorityVoteFilter::saveModelToFile(string filename) const {
+    std::fstream file;
+    file.open(filename.c_str(), std::ios::out);
+
+    return saveModelToFile(file);
+}
+
+bool MajorityVoteFilter::loadModelFromFile(string filename) {
+    std::fstream file;
+    file.open(filename.c_str(), std::ios::in);
+
+    return loadModelFromFile(file);
+}
+
+bool MajorityVoteFilter::saveModelToFile(fstream &file) const {
+    if (!file.is_open()) {
+        errorLog << "saveModelToFile(fstream &file) - The file is not open!"
+                 << std::endl;
+        return false;
+    }
+
+    file << "GRT_MAJORITY_VOTE_FILTER_FILE_V1.0" << std::endl;
+
+    if (!savePostProcessingSettingsToFile(file)) {
+        errorLog << "saveModelToFile(fstream &file)"
+                 << " - Failed to save base post processing settings to file!"
+                 << std::endl;
+        return false;
+    }
+
+    file << "MinimumCount: " << minimum_count_ << std::endl;
+    file << "BufferSize: " << buffer_size_ << std::endl;
+
+    return true;
+}
+
+bool MajorityVoteFilter::loadModelFromFile(fstream &file) {
+    if (!file.is_open()) {
+        errorLog << "loadModelFromFile(fstream &file) - The file is not open!"
+                 << std::endl;
+        return false;
+    }
+
+    string word;
+
+    // Load the header
+    file >> word;
+    if (word != "GRT_MAJORITY_VOTE_FILTER_FILE_V1.0") {
+        errorLog << "loadModelFromFile(fstream &file) - Invalid file format!"
+                 << std::endl;
+        return false;
+    }
+
+    if (!loadPostProcessingSettingsFromFile(file)) {
+        errorLog << "loadModelFromFile(fstream &file)"
+                 << " - Failed to load base post processing settings from file!"
+                 << std::endl;
+        return false;
+    }
+
+    uint32_t minimum_count, buffer_size;
+
+    // Load the Minimum Count
+    file >> word;
+    if (word != "MinimumCount:") {
+        errorLog << "loadModelFromFile(fstream &file) "
+                 << "- Failed to read MinimumCount header!" << std::endl;
+        return false;
+    }
+    file >> minimum_count;
+
+    // Load the Buffer Size
+    file >> word;
+    if (word != "BufferSize:") {
+        errorLog << "loadModelFromFile(fstream &file) "
+                 << "- Failed to read BufferSize header!" << std::endl;
+        return false;
+    }
+    file >> buffer_size;
+
+    return init(minimum_count, buffer_size);
+}
+
+} // namespace GRT
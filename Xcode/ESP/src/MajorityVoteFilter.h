@@ -0,0 +1,95 @@
+#ifndef ESP_MAJORITY_VOTE_FILTER_H_
+#define ESP_MAJORITY_VOTE_FILTER_H_
+
+#include "GRT/CoreModules/PostProcessing.h"
+
+#include <stdint.h>
+#include <vector>
+
+namespace GRT {
+
+using std::vector;
+
+/* @brief MajorityVoteFilter is a drop-in replacement for GRT's
+ * ClassLabelFilter. It outputs the most frequent class label among the last
+ * `buffer_size` predictions, as long as that label was predicted at least
+ * `minimum_count` times, and the null label (0) otherwise. Null predictions
+ * take up a place in the buffer but never win a vote.
+ *
+ * ClassLabelFilter recounts its whole buffer on every prediction, which is
+ * O(buffer_size). With audio, where the buffer covers a second or more of
+ * predictions, that is a noticeable cost. This filter keeps a count per class
+ * label and only updates the counts of the label that enters and the label
+ * that leaves the buffer, so a prediction costs O(1) in the buffer size.
+ *
+ * Unlike ClassLabelFilter, changing the buffer size keeps the most recent
+ * predictions, so it can be driven by a tuneable while the pipeline is
+ * running:
+ *
+ *    MajorityVoteFilter* filter = dynamic_cast<MajorityVoteFilter*>(
+ *        pipeline.getPostProcessingModule(0));
+ *    filter->setBufferSize(new_size);
+ *
+ * When two labels have the same count, the lower label wins, however the
+ * tie came about.
+ */
+class MajorityVoteFilter : public PostProcessing {
+  public:
+    MajorityVoteFilter(uint32_t minimum_count = 1, uint32_t buffer_size = 1);
+
+    MajorityVoteFilter(const MajorityVoteFilter& rhs);
+    MajorityVoteFilter& operator=(const MajorityVoteFilter& rhs);
+    bool deepCopyFrom(const PostProcessing* postProcessing) override;
+    ~MajorityVoteFilter() override {}
+
+    bool process(const VectorDouble& inputVector) override;
+    bool reset() override;
+
+    // Add a prediction to the buffer and return the filtered class label.
+    uint32_t filter(uint32_t predicted_class_label);
+
+    uint32_t getFilteredClassLabel() const { return filtered_class_label_; }
+    uint32_t getMinimumCount() const { return minimum_count_; }
+    uint32_t getBufferSize() const { return buffer_size_; }
+
+    // Fails if `minimum_count` is larger than the buffer size.
+    bool setMinimumCount(uint32_t minimum_count);
+
+    // Resize the buffer, keeping the most recent predictions. If the minimum
+    // count no longer fits in the buffer, it is lowered to the buffer size.
+    bool setBufferSize(uint32_t buffer_size);
+
+    // Save and Load from file
+    bool saveModelToFile(string filename) const override;
+    bool loadModelFromFile(string filename) override;
+    bool saveModelToFile(fstream &file) const override;
+    bool loadModelFromFile(fstream &file) override;
+
+  protected:
+    bool init(uint32_t minimum_count, uint32_t buffer_size);
+
+    void addVote(uint32_t label);
+    void removeVote(uint32_t label);
+    void updateFilteredClassLabel();
+
+    uint32_t minimum_count_;
+    uint32_t buffer_size_;
+
+    // Ring of the last `buffer_size_` predictions; head_ is the oldest.
+    vector<uint32_t> buffer_;
+    uint32_t head_;
+
+    // Number of times each (non-null) label appears in buffer_, indexed by
+    // label, and the label with the most votes.
+    vector<uint32_t> counts_;
+    uint32_t best_label_;
+    uint32_t best_count_;
+
+    uint32_t filtered_class_label_;
+
+    static RegisterPostProcessingModule<MajorityVoteFilter> registerModule;
+};
+
+} // namespace GRT
+
+#endif // ESP_MAJORITY_VOTE_FILTER_H_
@@ -0,0 +1,85 @@
+// Throughput of OrientationFusion for each algorithm and output, and of the
+// per-sample lambda it replaces: a tilt computation taking and returning a
+// VectorDouble, called through a std::function as FeatureApply calls it.
+#include "OrientationFusion.h"
+#include "gtest/gtest.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <functional>
+#include <random>
+
+using GRT::OrientationFusion;
+
+namespace {
+
+const double kSampleRate = 100;
+const uint32_t kNumSamples = 1000000;
+
+// Readings of a sensor being waved about, in g and degrees per second.
+std::vector<GRT::VectorDouble> makeReadings() {
+    std::mt19937 rng(1);
+    std::normal_distribution<double> accel(0, 0.3), gyro(0, 90);
+    std::vector<GRT::VectorDouble> readings(1000);
+    for (GRT::VectorDouble& r : readings) {
+        r = { accel(rng), accel(rng), 1 + accel(rng),
+              gyro(rng), gyro(rng), gyro(rng) };
+    }
+    return readings;
+}
+
+template<typename F>
+double samplesPerSecond(const std::vector<GRT::VectorDouble>& readings,
+                        F process) {
+    double checksum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < kNumSamples; i++) {
+        checksum += process(readings[i % readings.size()]);
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    // Keep the work from being optimized away.
+    EXPECT_FALSE(std::isnan(checksum));
+    return kNumSamples / std::chrono::duration<double>(elapsed).count();
+}
+
+}  // namespace
+
+TEST(OrientationFusionBenchmark, Throughput) {
+    std::vector<GRT::VectorDouble> readings = makeReadings();
+
+    std::function<GRT::VectorDouble(GRT::VectorDouble)> tilt =
+        [](GRT::VectorDouble in) {
+            GRT::VectorDouble out(2);
+            out[0] = atan2(in[1], in[2]);
+            out[1] = atan2(-in[0], sqrt(in[1] * in[1] + in[2] * in[2]));
+            return out;
+        };
+    std::printf("Tilt lambda (accelerometer only): %.2f M samples/s\n",
+                samplesPerSecond(readings, [&](const GRT::VectorDouble& r) {
+                    return tilt(r)[0];
+                }) / 1e6);
+
+    const char* algorithms[] = { "Madgwick", "complementary" };
+    struct { uint32_t outputs; const char* name; } outputs[] = {
+        { OrientationFusion::QUATERNION, "quaternion" },
+        { OrientationFusion::LINEAR_ACCELERATION, "linear acceleration" },
+        { OrientationFusion::TILT, "tilt" },
+        { OrientationFusion::QUATERNION |
+          OrientationFusion::LINEAR_ACCELERATION | OrientationFusion::TILT,
+          "all" },
+    };
+    for (uint32_t algorithm : { OrientationFusion::MADGWICK,
+                                OrientationFusion::COMPLEMENTARY }) {
+        for (const auto& output : outputs) {
+            OrientationFusion fusion(kSampleRate, output.outputs, algorithm);
+            double rate = samplesPerSecond(
+                readings, [&](const GRT::VectorDouble& r) {
+                    fusion.process(r);
+                    return fusion.getProcessedData()[0];
+                });
+            std::printf("OrientationFusion, %s, %s: %.2f M samples/s\n",
+                        algorithms[algorithm], output.name, rate / 1e6);
+        }
+    }
+}
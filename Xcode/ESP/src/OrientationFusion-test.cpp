@@ -0,0 +1,116 @@
+#include "OrientationFusion.h"
+#include "gtest/gtest.h"
+
+#include <cmath>
+
+using GRT::OrientationFusion;
+
+// The direction of gravity, in the sensor frame, that `q` predicts.
+static void gravity(const double q[4], double v[3]) {
+    v[0] = 2 * (q[1] * q[3] - q[0] * q[2]);
+    v[1] = 2 * (q[0] * q[1] + q[2] * q[3]);
+    v[2] = q[0] * q[0] - q[1] * q[1] - q[2] * q[2] + q[3] * q[3];
+}
+
+TEST(OrientationFusionTest, OutputSizes) {
+    ASSERT_EQ(4, OrientationFusion::getOutputSize(
+                     OrientationFusion::QUATERNION));
+    ASSERT_EQ(9, OrientationFusion::getOutputSize(
+                     OrientationFusion::QUATERNION |
+                     OrientationFusion::LINEAR_ACCELERATION |
+                     OrientationFusion::TILT));
+
+    OrientationFusion fusion(100, OrientationFusion::LINEAR_ACCELERATION |
+                                  OrientationFusion::TILT);
+    ASSERT_EQ(6, fusion.getNumInputDimensions());
+    ASSERT_EQ(5, fusion.getNumOutputDimensions());
+    ASSERT_TRUE(fusion.process({ 0, 0, 1, 0, 0, 0 }));
+    ASSERT_EQ(5, fusion.getProcessedData().size());
+}
+
+TEST(OrientationFusionTest, StartsFromTheAccelerometer) {
+    OrientationFusion fusion(100, OrientationFusion::QUATERNION |
+                                  OrientationFusion::LINEAR_ACCELERATION |
+                                  OrientationFusion::TILT);
+    double roll = 0.3, pitch = -0.5;
+    double a[3] = { -sin(pitch), cos(pitch) * sin(roll),
+                    cos(pitch) * cos(roll) };
+    ASSERT_TRUE(fusion.process({ a[0], a[1], a[2], 0, 0, 0 }));
+
+    double q[4], v[3];
+    fusion.getQuaternion(q);
+    gravity(q, v);
+    const GRT::VectorDouble& out = fusion.getProcessedData();
+    for (int i = 0; i < 3; i++) {
+        ASSERT_NEAR(a[i], v[i], 1e-12);
+        // At rest, there's no linear acceleration.
+        ASSERT_NEAR(0, out[4 + i], 1e-12);
+    }
+    ASSERT_NEAR(roll, out[7], 1e-12);
+    ASSERT_NEAR(pitch, out[8], 1e-12);
+}
+
+TEST(OrientationFusionTest, IntegratesTheGyroscope) {
+    for (uint32_t algorithm : { OrientationFusion::MADGWICK,
+                                OrientationFusion::COMPLEMENTARY }) {
+        OrientationFusion fusion(200, OrientationFusion::QUATERNION,
+                                 algorithm);
+        // Lying flat and turning at 90 degrees per second for a second.
+        fusion.process({ 0, 0, 1, 0, 0, 0 });
+        for (int i = 0; i < 200; i++) fusion.process({ 0, 0, 1, 0, 0, 90 });
+
+        double q[4];
+        fusion.getQuaternion(q);
+        ASSERT_NEAR(cos(PI / 4), q[0], 1e-3);
+        ASSERT_NEAR(0, q[1], 1e-3);
+        ASSERT_NEAR(0, q[2], 1e-3);
+        ASSERT_NEAR(sin(PI / 4), q[3], 1e-3);
+    }
+}
+
+TEST(OrientationFusionTest, ConvergesToTheAccelerometer) {
+    for (uint32_t algorithm : { OrientationFusion::MADGWICK,
+                                OrientationFusion::COMPLEMENTARY }) {
+        OrientationFusion fusion(100, OrientationFusion::TILT, algorithm);
+        fusion.process({ 0, 0, 1, 0, 0, 0 });
+        // Tilted by 30 degrees (with no gyroscope reading): the estimate
+        // follows gravity, to within Madgwick's step of gain / sample rate.
+        double roll = PI / 6;
+        for (int i = 0; i < 1000; i++) {
+            fusion.process({ 0, sin(roll), cos(roll), 0, 0, 0 });
+        }
+        ASSERT_NEAR(roll, fusion.getProcessedData()[0], 2e-3);
+        ASSERT_NEAR(0, fusion.getProcessedData()[1], 2e-3);
+    }
+}
+
+TEST(OrientationFusionTest, CopiesAndResets) {
+    OrientationFusion fusion(100, OrientationFusion::QUATERNION,
+                             OrientationFusion::COMPLEMENTARY, 0.5);
+    fusion.process({ 0.1, 0.2, 0.9, 0, 0, 0 });
+    fusion.process({ 0.1, 0.2, 0.9, 10, 20, 30 });
+
+    OrientationFusion copy(fusion);
+    ASSERT_EQ(0.5, copy.getGain());
+    fusion.process({ 0, 0, 1, 5, 5, 5 });
+    copy.process({ 0, 0, 1, 5, 5, 5 });
+    ASSERT_EQ(fusion.getProcessedData(), copy.getProcessedData());
+
+    ASSERT_TRUE(copy.reset());
+    copy.process({ 0, 0, 1, 5, 5, 5 });
+    double q[4];
+    copy.getQuaternion(q);
+    ASSERT_EQ(1, q[0]);
+}
+
+TEST(OrientationFusionTest, RejectsBadSettings) {
+    OrientationFusion no_outputs(100, 0);
+    ASSERT_FALSE(no_outputs.process({ 0, 0, 1, 0, 0, 0 }));
+
+    OrientationFusion no_rate(0);
+    ASSERT_FALSE(no_rate.process({ 0, 0, 1, 0, 0, 0 }));
+
+    OrientationFusion fusion;
+    ASSERT_EQ(OrientationFusion::kDefaultMadgwickGain, fusion.getGain());
+    ASSERT_FALSE(fusion.process({ 0, 0, 1 }));
+}
@@ -0,0 +1,348 @@
+#include "OrientationFusion.h"
+
+#include <cmath>
+
+namespace GRT {
+
+RegisterPreProcessingModule<OrientationFusion>
+    OrientationFusion::registerModule("OrientationFusion");
+
+constexpr double OrientationFusion::kDefaultMadgwickGain;
+constexpr double OrientationFusion::kDefaultComplementaryGain;
+
+OrientationFusion::OrientationFusion(double sample_rate, uint32_t outputs,
+                                     uint32_t algorithm, double gain)
+    : sample_rate_(0), outputs_(0), algorithm_(MADGWICK), gain_(0),
+      q_{ 1, 0, 0, 0 }, has_orientation_(false) {
+    classType = "OrientationFusion";
+    preProcessingType = classType;
+    debugLog.setProceedingText("[DEBUG OrientationFusion]");
+    errorLog.setProceedingText("[ERROR OrientationFusion]");
+    warningLog.setProceedingText("[WARNING OrientationFusion]");
+
+    init(sample_rate, outputs, algorithm, gain);
+}
+
+OrientationFusion::OrientationFusion(const OrientationFusion& rhs) {
+    classType = "OrientationFusion";
+    preProcessingType = classType;
+    debugLog.setProceedingText("[DEBUG OrientationFusion]");
+    errorLog.setProceedingText("[ERROR OrientationFusion]");
+    warningLog.setProceedingText("[WARNING OrientationFusion]");
+
+    *this = rhs;
+}
+
+OrientationFusion& OrientationFusion::operator=(const OrientationFusion& rhs) {
+    if (this != &rhs) {
+        sample_rate_ = rhs.sample_rate_;
+        outputs_ = rhs.outputs_;
+        algorithm_ = rhs.algorithm_;
+        gain_ = rhs.gain_;
+        for (int i = 0; i < 4; i++) q_[i] = rhs.q_[i];
+        has_orientation_ = rhs.has_orientation_;
+        copyBaseVariables((PreProcessing*)&rhs);
+    }
+    return *this;
+}
+
+bool OrientationFusion::deepCopyFrom(const PreProcessing* preProcessing) {
+    if (preProcessing == nullptr) {
+        return false;
+    }
+
+    if (this->getPreProcessingType() ==
+        preProcessing->getPreProcessingType()) {
+        *this = *(OrientationFusion*)preProcessing;
+        return true;
+    }
+
+    errorLog << "deepCopyFrom(const PreProcessing *preProcessing)"
+             << " - PreProcessing Types Do Not Match!" << std::endl;
+    return false;
+}
+
+uint32_t OrientationFusion::getOutputSize(uint32_t outputs) {
+    return (outputs & QUATERNION ? 4 : 0) +
+           (outputs & LINEAR_ACCELERATION ? 3 : 0) +
+           (outputs & TILT ? 2 : 0);
+}
+
+bool OrientationFusion::init(double sample_rate, uint32_t outputs,
+                             uint32_t algorithm, double gain) {
+    initialized = false;
+
+    if (!(sample_rate > 0)) {
+        errorLog << "init(...) - The sample rate must be positive!"
+                 << std::endl;
+        return false;
+    }
+    if (getOutputSize(outputs) == 0 ||
+        (outputs & ~(QUATERNION | LINEAR_ACCELERATION | TILT)) != 0) {
+        errorLog << "init(...) - Outputs must be a combination of QUATERNION, "
+                 << "LINEAR_ACCELERATION and TILT!" << std::endl;
+        return false;
+    }
+    if (algorithm > COMPLEMENTARY || gain < 0) {
+        errorLog << "init(...) - Unknown algorithm or negative gain!"
+                 << std::endl;
+        return false;
+    }
+
+    sample_rate_ = sample_rate;
+    outputs_ = outputs;
+    algorithm_ = algorithm;
+    gain_ = gain > 0 ? gain :
+            algorithm == MADGWICK ? kDefaultMadgwickGain :
+                                    kDefaultComplementaryGain;
+
+    numInputDimensions = 6;
+    numOutputDimensions = getOutputSize(outputs);
+    initialized = reset();
+    return true;
+}
+
+bool OrientationFusion::reset() {
+    q_[0] = 1;
+    q_[1] = q_[2] = q_[3] = 0;
+    has_orientation_ = false;
+    processedData.clear();
+    processedData.resize(numOutputDimensions, 0);
+    return true;
+}
+
+void OrientationFusion::initializeFromAccelerometer(double ax, double ay,
+                                                    double az) {
+    double half_roll = atan2(ay, az) / 2;
+    double half_pitch = atan2(-ax, sqrt(ay * ay + az * az)) / 2;
+    double cr = cos(half_roll), sr = sin(half_roll);
+    double cp = cos(half_pitch), sp = sin(half_pitch);
+    q_[0] = cr * cp;
+    q_[1] = sr * cp;
+    q_[2] = cr * sp;
+    q_[3] = -sr * sp;
+}
+
+void OrientationFusion::updateMadgwick(double ax, double ay, double az,
+                                       double gx, double gy, double gz) {
+    double q0 = q_[0], q1 = q_[1], q2 = q_[2], q3 = q_[3];
+
+    // The rate of change of the quaternion from the gyroscope.
+    double dq0 = 0.5 * (-q1 * gx - q2 * gy - q3 * gz);
+    double dq1 = 0.5 * (q0 * gx + q2 * gz - q3 * gy);
+    double dq2 = 0.5 * (q0 * gy - q1 * gz + q3 * gx);
+    double dq3 = 0.5 * (q0 * gz + q1 * gy - q2 * gx);
+
+    double norm = sqrt(ax * ax + ay * ay + az * az);
+    if (norm > 0) {
+        ax /= norm;
+        ay /= norm;
+        az /= norm;
+
+        // Gradient of the error between the measured direction of gravity and
+        // the one the quaternion predicts.
+        double q0q0 = q0 * q0, q1q1 = q1 * q1, q2q2 = q2 * q2, q3q3 = q3 * q3;
+        double s0 = 4 * q0 * q2q2 + 2 * q2 * ax + 4 * q0 * q1q1 - 2 * q1 * ay;
+        double s1 = 4 * q1 * q3q3 - 2 * q3 * ax + 4 * q0q0 * q1 - 2 * q0 * ay -
+                    4 * q1 + 8 * q1 * q1q1 + 8 * q1 * q2q2 + 4 * q1 * az;
+        double s2 = 4 * q0q0 * q2 + 2 * q0 * ax + 4 * q2 * q3q3 - 2 * q3 * ay -
+                    4 * q2 + 8 * q2 * q1q1 + 8 * q2 * q2q2 + 4 * q2 * az;
+        double s3 = 4 * q1q1 * q3 - 2 * q1 * ax + 4 * q2q2 * q3 - 2 * q2 * ay;
+        double s_norm = sqrt(s0 * s0 + s1 * s1 + s2 * s2 + s3 * s3);
+        if (s_norm > 0) {
+            dq0 -= gain_ * s0 / s_norm;
+            dq1 -= gain_ * s1 / s_norm;
+            dq2 -= gain_ * s2 / s_norm;
+            dq3 -= gain_ * s3 / s_norm;
+        }
+    }
+
+    double dt = 1 / sample_rate_;
+    q0 += dq0 * dt;
+    q1 += dq1 * dt;
+    q2 += dq2 * dt;
+    q3 += dq3 * dt;
+    double q_norm = sqrt(q0 * q0 + q1 * q1 + q2 * q2 + q3 * q3);
+    q_[0] = q0 / q_norm;
+    q_[1] = q1 / q_norm;
+    q_[2] = q2 / q_norm;
+    q_[3] = q3 / q_norm;
+}
+
+void OrientationFusion::updateComplementary(double ax, double ay, double az,
+                                            double gx, double gy, double gz) {
+    double q0 = q_[0], q1 = q_[1], q2 = q_[2], q3 = q_[3];
+
+    double norm = sqrt(ax * ax + ay * ay + az * az);
+    if (norm > 0) {
+        ax /= norm;
+        ay /= norm;
+        az /= norm;
+
+        // The direction of gravity the quaternion predicts.
+        double vx = 2 * (q1 * q3 - q0 * q2);
+        double vy = 2 * (q0 * q1 + q2 * q3);
+        double vz = q0 * q0 - q1 * q1 - q2 * q2 + q3 * q3;
+
+        // Rotate towards the measured direction: add the axis (and sine of
+        // the angle) between them to the rates.
+        gx += gain_ * (ay * vz - az * vy);
+        gy += gain_ * (az * vx - ax * vz);
+        gz += gain_ * (ax * vy - ay * vx);
+    }
+
+    double dt = 1 / sample_rate_;
+    double dq0 = 0.5 * (-q1 * gx - q2 * gy - q3 * gz);
+    double dq1 = 0.5 * (q0 * gx + q2 * gz - q3 * gy);
+    double dq2 = 0.5 * (q0 * gy - q1 * gz + q3 * gx);
+    double dq3 = 0.5 * (q0 * gz + q1 * gy - q2 * gx);
+    q0 += dq0 * dt;
+    q1 += dq1 * dt;
+    q2 += dq2 * dt;
+    q3 += dq3 * dt;
+    double q_norm = sqrt(q0 * q0 + q1 * q1 + q2 * q2 + q3 * q3);
+    q_[0] = q0 / q_norm;
+    q_[1] = q1 / q_norm;
+    q_[2] = q2 / q_norm;
+    q_[3] = q3 / q_norm;
+}
+
+bool OrientationFusion::process(const VectorDouble& inputVector) {
+    if (!initialized) {
+        errorLog << "process(const VectorDouble &inputVector)"
+                 << " - Not initialized!" << std::endl;
+        return false;
+    }
+
+    if (inputVector.size() != numInputDimensions) {
+        errorLog << "process(const VectorDouble &inputVector)"
+                 << " - The size of the inputVector (" << inputVector.size()
+                 << ") does not match that of the OrientationFusion ("
+                 << numInputDimensions << ")!" << std::endl;
+        return false;
+    }
+
+    const double ax = inputVector[0], ay = inputVector[1], az = inputVector[2];
+    const double kRadiansPerDegree = PI / 180;
+    const double gx = inputVector[3] * kRadiansPerDegree;
+    const double gy = inputVector[4] * kRadiansPerDegree;
+    const double gz = inputVector[5] * kRadiansPerDegree;
+
+    if (!has_orientation_) {
+        initializeFromAccelerometer(ax, ay, az);
+        has_orientation_ = true;
+    } else if (algorithm_ == MADGWICK) {
+        updateMadgwick(ax, ay, az, gx, gy, gz);
+    } else {
+        updateComplementary(ax, ay, az, gx, gy, gz);
+    }
+
+    const double q0 = q_[0], q1 = q_[1], q2 = q_[2], q3 = q_[3];
+    uint32_t i = 0;
+    if (outputs_ & QUATERNION) {
+        processedData[i++] = q0;
+        processedData[i++] = q1;
+        processedData[i++] = q2;
+        processedData[i++] = q3;
+    }
+    if (outputs_ & LINEAR_ACCELERATION) {
+        // Gravity, in g, in the sensor frame.
+        processedData[i++] = ax - 2 * (q1 * q3 - q0 * q2);
+        processedData[i++] = ay - 2 * (q0 * q1 + q2 * q3);
+        processedData[i++] = az - (q0 * q0 - q1 * q1 - q2 * q2 + q3 * q3);
+    }
+    if (outputs_ & TILT) {
+        double sin_pitch = 2 * (q0 * q2 - q1 * q3);
+        if (sin_pitch > 1) sin_pitch = 1;
+        if (sin_pitch < -1) sin_pitch = -1;
+        processedData[i++] = atan2(q0 * q1 + q2 * q3, 0.5 - q1 * q1 - q2 * q2);
+        processedData[i++] = asin(sin_pitch);
+    }
+    return true;
+}
+
+bool OrientationFusion::saveModelToFile(string filename) const {
+    std::fstream file;
+    file.open(filename.c_str(), std::ios::out);
+
+    return saveModelToFile(file);
+}
+
+bool OrientationFusion::loadModelFromFile(string filename) {
+    std::fstream file;
+    file.open(filename.c_str(), std::ios::in);
+
+    return loadModelFromFile(file);
+}
+
+bool OrientationFusion::saveModelToFile(fstream &file) const {
+    if (!file.is_open()) {
+        errorLog << "saveModelToFile(fstream &file) - The file is not open!"
+                 << std::endl;
+        return false;
+    }
+
+    file << "GRT_ORIENTATION_FUSION_FILE_V1.0" << std::endl;
+
+    if (!savePreProcessingSettingsToFile(file)) {
+        errorLog << "saveModelToFile(fstream &file)"
+                 << " - Failed to save base pre processing settings to file!"
+                 << std::endl;
+        return false;
+    }
+
+    file.precision(17);
+    file << "SampleRate: " << sample_rate_ << std::endl;
+    file << "Outputs: " << outputs_ << std::endl;
+    file << "Algorithm: " << algorithm_ << std::endl;
+    file << "Gain: " << gain_ << std::endl;
+
+    return true;
+}
+
+bool OrientationFusion::loadModelFromFile(fstream &file) {
+    if (!file.is_open()) {
+        errorLog << "loadModelFromFile(fstream &file) - The file is not open!"
+                 << std::endl;
+        return false;
+    }
+
+    string word;
+
+    // Load the header
+    file >> word;
+    if (word != "GRT_ORIENTATION_FUSION_FILE_V1.0") {
+        errorLog << "loadModelFromFile(fstream &file) - Invalid file format!"
+                 << std::endl;
+        return false;
+    }
+
+    if (!loadPreProcessingSettingsFromFile(file)) {
+        errorLog << "loadModelFromFile(fstream &file)"
+                 << " - Failed to load base pre processing settings from file!"
+                 << std::endl;
+        return false;
+    }
+
+    double sample_rate, gain;
+    uint32_t outputs, algorithm;
+    const char* headers[] = { "SampleRate:", "Outputs:", "Algorithm:",
+                              "Gain:" };
+    for (const char* header : headers) {
+        file >> word;
+        if (word != header) {
+            errorLog << "loadModelFromFile(fstream &file) "
+                     << "- Failed to read " << header << " header!"
+                     << std::endl;
+            return false;
+        }
+        if (word == "SampleRate:") file >> sample_rate;
+        else if (word == "Outputs:") file >> outputs;
+        else if (word == "Algorithm:") file >> algorithm;
+        else if (word == "Gain:") file >> gain;
+    }
+
+    return init(sample_rate, outputs, algorithm, gain);
+}
+
+} // namespace GRT
@@ -0,0 +1,115 @@
+#ifndef ESP_ORIENTATION_FUSION_H_
+#define ESP_ORIENTATION_FUSION_H_
+
+#include "GRT/CoreModules/PreProcessing.h"
+
+#include <stdint.h>
+
+namespace GRT {
+
+/* @brief OrientationFusion estimates the orientation of a 6-axis IMU from its
+ * accelerometer and gyroscope, e.g. as streamed by Arduino101_IMU.ino, and
+ * passes on features derived from it instead of the raw axes.
+ *
+ * The input is (ax, ay, az, gx, gy, gz): acceleration in g and rotation in
+ * degrees per second. ImuCalibration converts raw sensor readings to these
+ * units in a Calibrator. The outputs are chosen with a combination of
+ * flags, and are concatenated in this order:
+ *
+ *  - QUATERNION: the orientation (w, x, y, z), from the sensor to the earth
+ *    frame. Without a magnetometer, the heading drifts.
+ *  - LINEAR_ACCELERATION: the acceleration (x, y, z) with gravity removed, in
+ *    g, in the sensor frame.
+ *  - TILT: roll and pitch, in radians.
+ *
+ *    pipeline.addPreProcessingModule(OrientationFusion(
+ *        100, OrientationFusion::LINEAR_ACCELERATION | OrientationFusion::TILT));
+ *
+ * Gyroscope rates are integrated and corrected towards the direction of
+ * gravity measured by the accelerometer, either with Madgwick's gradient
+ * descent filter [1] (`gain` is its beta) or with a complementary filter that
+ * feeds the tilt error back into the rates (`gain` is the proportional gain,
+ * as in Mahony's filter). The first sample after a reset sets the tilt from
+ * the accelerometer alone, so there's no settling time.
+ *
+ * All the math is on fixed-size values on the stack; processing a sample
+ * allocates nothing.
+ *
+ * [1] Madgwick, S., Harrison, A., Vaidyanathan, R., 2011. Estimation of IMU
+ *     and MARG orientation using a gradient descent algorithm. IEEE
+ *     International Conference on Rehabilitation Robotics, 1-7.
+ */
+class OrientationFusion : public PreProcessing {
+  public:
+    enum AlgorithmOptions {
+        MADGWICK = 0,
+        COMPLEMENTARY
+    };
+
+    enum OutputOptions {
+        QUATERNION = 1,
+        LINEAR_ACCELERATION = 2,
+        TILT = 4
+    };
+
+    static constexpr double kDefaultMadgwickGain = 0.1;
+    static constexpr double kDefaultComplementaryGain = 1.0;
+
+    // A `gain` of 0 uses the algorithm's default.
+    OrientationFusion(double sample_rate = 100, uint32_t outputs = QUATERNION,
+                      uint32_t algorithm = MADGWICK, double gain = 0);
+
+    OrientationFusion(const OrientationFusion& rhs);
+    OrientationFusion& operator=(const OrientationFusion& rhs);
+    bool deepCopyFrom(const PreProcessing* preProcessing) override;
+    ~OrientationFusion() override {}
+
+    bool process(const VectorDouble& inputVector) override;
+    bool reset() override;
+
+    double getSampleRate() const { return sample_rate_; }
+    uint32_t getOutputs() const { return outputs_; }
+    uint32_t getAlgorithm() const { return algorithm_; }
+    double getGain() const { return gain_; }
+
+    // The current orientation, as (w, x, y, z).
+    void getQuaternion(double q[4]) const {
+        q[0] = q_[0]; q[1] = q_[1]; q[2] = q_[2]; q[3] = q_[3];
+    }
+
+    // The number of values passed on for a combination of outputs, e.g. to
+    // size the modules after this one.
+    static uint32_t getOutputSize(uint32_t outputs);
+
+    // Save and Load from file
+    bool saveModelToFile(string filename) const override;
+    bool loadModelFromFile(string filename) override;
+    bool saveModelToFile(fstream &file) const override;
+    bool loadModelFromFile(fstream &file) override;
+
+  protected:
+    bool init(double sample_rate, uint32_t outputs, uint32_t algorithm,
+              double gain);
+
+    // Set q_ from the direction of gravity alone, with no heading.
+    void initializeFromAccelerometer(double ax, double ay, double az);
+    // Advance q_ by one sample. Rates in radians per second.
+    void updateMadgwick(double ax, double ay, double az,
+                        double gx, double gy, double gz);
+    void updateComplementary(double ax, double ay, double az,
+                             double gx, double gy, double gz);
+
+    double sample_rate_;
+    uint32_t outputs_;
+    uint32_t algorithm_;
+    double gain_;
+
+    double q_[4];
+    bool has_orientation_;
+
+    static RegisterPreProcessingModule<OrientationFusion> registerModule;
+};
+
+} // namespace GRT
+
+#endif // ESP_ORIENTATION_FUSION_H_
@@ -0,0 +1,189 @@
+#include "QuantizedKNN.h"
+#include "gtest/gtest.h"
+
+#include <cmath>
+#include <cstdio>
+#include <random>
+
+static const uint32_t kDim = 12;
+static const uint32_t kNumClasses = 3;
+
+// Samples from three Gaussian clusters, one per class, that overlap a little.
+static GRT::ClassificationData makeData(uint32_t samples_per_class,
+                                        uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::normal_distribution<double> noise(0, 0.6);
+    GRT::ClassificationData data;
+    data.setNumDimensions(kDim);
+    for (uint32_t i = 0; i < samples_per_class; i++) {
+        for (uint32_t label = 1; label <= kNumClasses; label++) {
+            GRT::VectorDouble x(kDim);
+            for (uint32_t d = 0; d < kDim; d++) {
+                x[d] = 100.0 * label * (d % kNumClasses == label - 1) +
+                       10.0 * label + 30.0 * noise(rng);
+            }
+            data.addSample(label, x);
+        }
+    }
+    return data;
+}
+
+TEST(QuantizedKNNTest, QuantizerCalibration) {
+    GRT::FeatureQuantizer quantizer;
+    quantizer.calibrate({0, -1}, {255, 1}, 256, -128);
+
+    int8_t q[2];
+    quantizer.quantize(GRT::VectorDouble({0, -1}), q);
+    ASSERT_EQ(-128, q[0]);
+    ASSERT_EQ(-128, q[1]);
+    quantizer.quantize(GRT::VectorDouble({255, 1}), q);
+    ASSERT_EQ(127, q[0]);
+    ASSERT_EQ(127, q[1]);
+
+    // Out of range values saturate.
+    quantizer.quantize(GRT::VectorDouble({1000, -5}), q);
+    ASSERT_EQ(127, q[0]);
+    ASSERT_EQ(-128, q[1]);
+
+    quantizer.quantize(GRT::VectorDouble({100, 0.5}), q);
+    ASSERT_NEAR(100, quantizer.dequantize(q[0], 0), 0.5);
+    ASSERT_NEAR(0.5, quantizer.dequantize(q[1], 1), 2.0 / 255);
+}
+
+TEST(QuantizedKNNTest, QuantizedMatchesDouble) {
+    GRT::ClassificationData training = makeData(40, 1);
+    GRT::ClassificationData test = makeData(20, 2);
+
+    GRT::QuantizedKNN reference(3, GRT::QuantizedKNN::kNone);
+    GRT::QuantizedKNN int8(3, GRT::QuantizedKNN::kInt8);
+    GRT::QuantizedKNN int16(3, GRT::QuantizedKNN::kInt16);
+    ASSERT_TRUE(reference.train(training));
+    ASSERT_TRUE(int8.train(training));
+    ASSERT_TRUE(int16.train(training));
+
+    ASSERT_EQ(8 * int8.getTemplateMemoryUsage(),
+              reference.getTemplateMemoryUsage());
+    ASSERT_EQ(4 * int16.getTemplateMemoryUsage(),
+              reference.getTemplateMemoryUsage());
+
+    uint32_t int8_agree = 0, int16_agree = 0;
+    for (uint32_t i = 0; i < test.getNumSamples(); i++) {
+        GRT::VectorDouble x = test[i].getSample();
+        ASSERT_TRUE(reference.predict(x));
+        ASSERT_TRUE(int8.predict(x));
+        ASSERT_TRUE(int16.predict(x));
+        uint32_t label = reference.getPredictedClassLabel();
+        if (int8.getPredictedClassLabel() == label) int8_agree++;
+        if (int16.getPredictedClassLabel() == label) int16_agree++;
+    }
+    ASSERT_GE(int8_agree, test.getNumSamples() * 0.95);
+    ASSERT_EQ(int16_agree, test.getNumSamples());
+
+    // Every fifth sample of each class was held out to compare the models.
+    const GRT::QuantizedKNN::QuantizationReport& report =
+        int8.getQuantizationReport();
+    ASSERT_EQ(8 * kNumClasses, report.num_test_samples);
+    ASSERT_GT(report.double_accuracy, 0.9);
+    ASSERT_LE(std::abs(report.getAccuracyDelta()), 0.1);
+    ASSERT_EQ(0, reference.getQuantizationReport().num_test_samples);
+}
+
+TEST(QuantizedKNNTest, SaveLoad) {
+    GRT::ClassificationData training = makeData(10, 3);
+    GRT::QuantizedKNN knn(1, GRT::QuantizedKNN::kInt8);
+    ASSERT_TRUE(knn.train(training));
+
+    const char* filename = "QuantizedKNNTest.grt";
+    ASSERT_TRUE(knn.saveModelToFile(filename));
+
+    GRT::QuantizedKNN loaded(5, GRT::QuantizedKNN::kNone);
+    ASSERT_TRUE(loaded.loadModelFromFile(filename));
+    std::remove(filename);
+
+    ASSERT_EQ(1, loaded.getK());
+    ASSERT_EQ(GRT::QuantizedKNN::kInt8, loaded.getQuantization());
+    ASSERT_EQ(knn.getTemplateMemoryUsage(), loaded.getTemplateMemoryUsage());
+
+    GRT::ClassificationData test = makeData(5, 4);
+    for (uint32_t i = 0; i < test.getNumSamples(); i++) {
+        GRT::VectorDouble x = test[i].getSample();
+        ASSERT_TRUE(knn.predict(x));
+        ASSERT_TRUE(loaded.predict(x));
+        ASSERT_EQ(knn.getPredictedClassLabel(),
+                  loaded.getPredictedClassLabel());
+    }
+}
+
+TEST(QuantizedKNNTest, UpdateModel) {
+    GRT::ClassificationData first = makeData(20, 5);
+    GRT::ClassificationData second = makeData(20, 6);
+    GRT::ClassificationData test = makeData(20, 7);
+
+    // The first training data lacks the last class, which only arrives
+    // through updates.
+    GRT::ClassificationData initial, all;
+    initial.setNumDimensions(kDim);
+    all.setNumDimensions(kDim);
+    for (uint32_t i = 0; i < first.getNumSamples(); i++) {
+        if (first[i].getClassLabel() < kNumClasses) {
+            initial.addSample(first[i].getClassLabel(), first[i].getSample());
+            all.addSample(first[i].getClassLabel(), first[i].getSample());
+        }
+    }
+
+    GRT::QuantizedKNN updated(3, GRT::QuantizedKNN::kNone);
+    ASSERT_FALSE(updated.updateModel(1, second[0].getSample()));
+    ASSERT_TRUE(updated.train(initial));
+    for (uint32_t i = 0; i < second.getNumSamples(); i++) {
+        ASSERT_TRUE(updated.updateModel(second[i].getClassLabel(),
+                                        second[i].getSample()));
+        all.addSample(second[i].getClassLabel(), second[i].getSample());
+    }
+    ASSERT_FALSE(updated.updateModel(1, GRT::VectorDouble(kDim + 1)));
+
+    GRT::QuantizedKNN retrained(3, GRT::QuantizedKNN::kNone);
+    ASSERT_TRUE(retrained.train(all));
+    ASSERT_EQ(retrained.getTemplateMemoryUsage(),
+              updated.getTemplateMemoryUsage());
+
+    // Only the scaling differs from the retrained model.
+    uint32_t agree = 0, correct = 0;
+    for (uint32_t i = 0; i < test.getNumSamples(); i++) {
+        GRT::VectorDouble x = test[i].getSample();
+        ASSERT_TRUE(updated.predict(x));
+        ASSERT_TRUE(retrained.predict(x));
+        if (updated.getPredictedClassLabel() ==
+            retrained.getPredictedClassLabel()) agree++;
+        if (updated.getPredictedClassLabel() == test[i].getClassLabel()) {
+            correct++;
+        }
+    }
+    ASSERT_EQ(kNumClasses, updated.getNumClasses());
+    ASSERT_GE(agree, test.getNumSamples() * 0.95);
+    ASSERT_GE(correct, test.getNumSamples() * 0.9);
+}
+
+TEST(QuantizedKNNTest, SetQuantizationWaitsForTraining) {
+    GRT::ClassificationData training = makeData(20, 8);
+    GRT::ClassificationData test = makeData(10, 9);
+
+    GRT::QuantizedKNN knn(3, GRT::QuantizedKNN::kInt8);
+    ASSERT_TRUE(knn.train(training));
+    size_t int8_bytes = knn.getTemplateMemoryUsage();
+
+    // The trained model keeps its int8 templates, and still predicts and
+    // takes updates.
+    ASSERT_TRUE(knn.setQuantization(GRT::QuantizedKNN::kNone));
+    ASSERT_EQ(GRT::QuantizedKNN::kInt8, knn.getQuantization());
+    for (uint32_t i = 0; i < test.getNumSamples(); i++) {
+        GRT::VectorDouble x = test[i].getSample();
+        ASSERT_TRUE(knn.predict(x));
+    }
+    ASSERT_TRUE(knn.updateModel(1, test[0].getSample()));
+    ASSERT_EQ(int8_bytes + kDim, knn.getTemplateMemoryUsage());
+
+    // Retraining switches to double templates.
+    ASSERT_TRUE(knn.train(training));
+    ASSERT_EQ(GRT::QuantizedKNN::kNone, knn.getQuantization());
+    ASSERT_EQ(int8_bytes * sizeof(double), knn.getTemplateMemoryUsage());
+}
@@ -0,0 +1,632 @@
+#include "QuantizedKNN.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <map>
+#include <numeric>
+
+namespace GRT {
+
+RegisterClassifierModule<QuantizedKNN> QuantizedKNN::registerModule(
+    "QuantizedKNN");
+
+// One in every kHoldOutPeriod samples of each class is held out when
+// comparing the quantized model against the double one.
+static const uint32_t kHoldOutPeriod = 5;
+
+void FeatureQuantizer::calibrate(const vector<double>& min,
+                                 const vector<double>& max,
+                                 int32_t num_levels, int32_t min_level) {
+    min_level_ = min_level;
+    max_level_ = min_level + num_levels - 1;
+    scale_.resize(min.size());
+    zero_point_.resize(min.size());
+    for (uint32_t d = 0; d < min.size(); d++) {
+        double range = max[d] - min[d];
+        scale_[d] = range > 0 ? range / (num_levels - 1) : 1.0;
+        zero_point_[d] = std::lround(min_level - min[d] / scale_[d]);
+    }
+}
+
+template <typename T>
+void FeatureQuantizer::quantize(const VectorDouble& x, T* out) const {
+    for (uint32_t d = 0; d < scale_.size(); d++) {
+        double q = std::round(x[d] / scale_[d]) + zero_point_[d];
+        q = std::min<double>(std::max<double>(q, min_level_), max_level_);
+        out[d] = static_cast<T>(q);
+    }
+}
+
+template void FeatureQuantizer::quantize<int8_t>(const VectorDouble&,
+                                                 int8_t*) const;
+template void FeatureQuantizer::quantize<int16_t>(const VectorDouble&,
+                                                  int16_t*) const;
+
+QuantizedKNN::QuantizedKNN(uint32_t k, Quantization quantization)
+        : k_(k > 0 ? k : 1), quantization_(quantization),
+          next_quantization_(quantization) {
+    classType = "QuantizedKNN";
+    classifierType = classType;
+    classifierMode = STANDARD_CLASSIFIER_MODE;
+    useScaling = false;
+    debugLog.setProceedingText("[DEBUG QuantizedKNN]");
+    errorLog.setProceedingText("[ERROR QuantizedKNN]");
+    trainingLog.setProceedingText("[TRAINING QuantizedKNN]");
+    warningLog.setProceedingText("[WARNING QuantizedKNN]");
+}
+
+QuantizedKNN::QuantizedKNN(const QuantizedKNN& rhs) {
+    classType = "QuantizedKNN";
+    classifierType = classType;
+    classifierMode = STANDARD_CLASSIFIER_MODE;
+    debugLog.setProceedingText("[DEBUG QuantizedKNN]");
+    errorLog.setProceedingText("[ERROR QuantizedKNN]");
+    trainingLog.setProceedingText("[TRAINING QuantizedKNN]");
+    warningLog.setProceedingText("[WARNING QuantizedKNN]");
+
+    *this = rhs;
+}
+
+QuantizedKNN& QuantizedKNN::operator=(const QuantizedKNN& rhs) {
+    if (this != &rhs) {
+        k_ = rhs.k_;
+        quantization_ = rhs.quantization_;
+        next_quantization_ = rhs.next_quantization_;
+        quantization_report_ = rhs.quantization_report_;
+        min_ = rhs.min_;
+        max_ = rhs.max_;
+        quantizer_ = rhs.quantizer_;
+        template_labels_ = rhs.template_labels_;
+        templates_ = rhs.templates_;
+        templates8_ = rhs.templates8_;
+        templates16_ = rhs.templates16_;
+        copyBaseVariables((Classifier*)&rhs);
+    }
+    return *this;
+}
+
+bool QuantizedKNN::deepCopyFrom(const Classifier* classifier) {
+    if (classifier == nullptr) {
+        return false;
+    }
+
+    if (this->getClassifierType() == classifier->getClassifierType()) {
+        *this = *(QuantizedKNN*)classifier;
+        return true;
+    }
+
+    errorLog << "deepCopyFrom(const Classifier *classifier)"
+             << " - Classifier Types Do Not Match!" << std::endl;
+    return false;
+}
+
+bool QuantizedKNN::setK(uint32_t k) {
+    if (k == 0) {
+        errorLog << "setK(uint32_t k) - K must be larger than zero!"
+                 << std::endl;
+        return false;
+    }
+    k_ = k;
+    return true;
+}
+
+bool QuantizedKNN::setQuantization(Quantization quantization) {
+    // The templates are stored for quantization_ only; switching it under a
+    // trained model would leave classify() reading empty templates.
+    next_quantization_ = quantization;
+    if (!trained) quantization_ = quantization;
+    return true;
+}
+
+bool QuantizedKNN::clear() {
+    Classifier::clear();
+    quantization_report_ = QuantizationReport();
+    min_.clear();
+    max_.clear();
+    template_labels_.clear();
+    templates_.clear();
+    templates8_.clear();
+    templates16_.clear();
+    return true;
+}
+
+size_t QuantizedKNN::getTemplateMemoryUsage() const {
+    return templates_.size() * sizeof(double) +
+           templates8_.size() * sizeof(int8_t) +
+           templates16_.size() * sizeof(int16_t);
+}
+
+static void computeRanges(const vector<VectorDouble>& samples,
+                          vector<double>& min, vector<double>& max) {
+    uint32_t dims = samples.empty() ? 0 : samples[0].size();
+    min.assign(dims, std::numeric_limits<double>::max());
+    max.assign(dims, std::numeric_limits<double>::lowest());
+    for (const VectorDouble& x : samples) {
+        for (uint32_t d = 0; d < dims; d++) {
+            min[d] = std::min(min[d], x[d]);
+            max[d] = std::max(max[d], x[d]);
+        }
+    }
+}
+
+bool QuantizedKNN::train_(ClassificationData& trainingData) {
+    clear();
+    quantization_ = next_quantization_;
+
+    const uint32_t num_samples = trainingData.getNumSamples();
+    if (num_samples == 0) {
+        errorLog << "train_(ClassificationData &trainingData)"
+                 << " - Training data has zero samples!" << std::endl;
+        return false;
+    }
+
+    numInputDimensions = trainingData.getNumDimensions();
+    numClasses = trainingData.getNumClasses();
+
+    vector<VectorDouble> samples(num_samples);
+    vector<UINT> labels(num_samples);
+    for (uint32_t i = 0; i < num_samples; i++) {
+        samples[i] = trainingData[i].getSample();
+        labels[i] = trainingData[i].getClassLabel();
+    }
+
+    classLabels = labels;
+    std::sort(classLabels.begin(), classLabels.end());
+    classLabels.erase(std::unique(classLabels.begin(), classLabels.end()),
+                      classLabels.end());
+    numClasses = classLabels.size();
+
+    if (quantization_ != kNone) {
+        evaluateQuantization(samples, labels);
+    }
+
+    vector<double> min, max;
+    computeRanges(samples, min, max);
+    fit(samples, labels, min, max);
+
+    classLikelihoods.assign(numClasses, 0);
+    classDistances.assign(numClasses, 0);
+    trained = true;
+    return true;
+}
+
+void QuantizedKNN::fit(const vector<VectorDouble>& samples,
+                       const vector<UINT>& labels,
+                       const vector<double>& min, const vector<double>& max) {
+    const uint32_t dims = numInputDimensions;
+    min_ = min;
+    max_ = max;
+    template_labels_ = labels;
+    templates_.clear();
+    templates8_.clear();
+    templates16_.clear();
+
+    switch (quantization_) {
+        case kNone:
+            templates_.reserve(samples.size() * dims);
+            break;
+        case kInt8:
+            quantizer_.calibrate(min_, max_, 256, -128);
+            templates8_.reserve(samples.size() * dims);
+            break;
+        case kInt16:
+            quantizer_.calibrate(min_, max_, 65536, -32768);
+            templates16_.reserve(samples.size() * dims);
+            break;
+    }
+    for (const VectorDouble& x : samples) {
+        appendTemplate(x);
+    }
+}
+
+void QuantizedKNN::appendTemplate(const VectorDouble& x) {
+    const uint32_t dims = numInputDimensions;
+    switch (quantization_) {
+        case kNone:
+            for (uint32_t d = 0; d < dims; d++) {
+                double range = max_[d] - min_[d];
+                templates_.push_back(range > 0 ? (x[d] - min_[d]) / range : 0);
+            }
+            break;
+        case kInt8:
+            templates8_.resize(templates8_.size() + dims);
+            quantizer_.quantize(x, &templates8_[templates8_.size() - dims]);
+            break;
+        case kInt16:
+            templates16_.resize(templates16_.size() + dims);
+            quantizer_.quantize(x, &templates16_[templates16_.size() - dims]);
+            break;
+    }
+}
+
+bool QuantizedKNN::updateModel(UINT classLabel, const VectorDouble& sample) {
+    if (!trained) {
+        errorLog << "updateModel(UINT classLabel, const VectorDouble &sample)"
+                 << " - Model Not Trained!" << std::endl;
+        return false;
+    }
+
+    if (sample.size() != numInputDimensions) {
+        errorLog << "updateModel(UINT classLabel, const VectorDouble &sample)"
+                 << " - The size of the sample (" << sample.size()
+                 << ") does not match the num features in the model ("
+                 << numInputDimensions << ")" << std::endl;
+        return false;
+    }
+
+    auto it = std::lower_bound(classLabels.begin(), classLabels.end(),
+                               classLabel);
+    if (it == classLabels.end() || *it != classLabel) {
+        classLabels.insert(it, classLabel);
+        numClasses = classLabels.size();
+        classLikelihoods.assign(numClasses, 0);
+        classDistances.assign(numClasses, 0);
+    }
+
+    template_labels_.push_back(classLabel);
+    appendTemplate(sample);
+    return true;
+}
+
+template <typename T, typename Acc>
+void QuantizedKNN::computeDistances(const vector<T>& templates,
+                                    const VectorDouble& x,
+                                    vector<double>& distances) const {
+    const uint32_t dims = numInputDimensions;
+    const uint32_t num_levels = 1u << (8 * sizeof(T));
+    vector<T> q(dims);
+    quantizer_.quantize(x, q.data());
+
+    // Squared differences of T fit in Acc (int32_t for int8_t, int64_t for
+    // int16_t), so the inner loop has no conversions to double.
+    for (uint32_t i = 0; i < template_labels_.size(); i++) {
+        const T* t = &templates[i * dims];
+        Acc sum = 0;
+        for (uint32_t d = 0; d < dims; d++) {
+            Acc diff = Acc(t[d]) - Acc(q[d]);
+            sum += diff * diff;
+        }
+        distances[i] = std::sqrt(double(sum)) / (num_levels - 1);
+    }
+}
+
+UINT QuantizedKNN::classify(const VectorDouble& x,
+                            VectorDouble& class_distances,
+                            VectorDouble& class_likelihoods) const {
+    const uint32_t dims = numInputDimensions;
+    const uint32_t num_templates = template_labels_.size();
+    vector<double> distances(num_templates);
+
+    switch (quantization_) {
+        case kNone: {
+            VectorDouble scaled(dims);
+            for (uint32_t d = 0; d < dims; d++) {
+                double range = max_[d] - min_[d];
+                scaled[d] = range > 0 ? (x[d] - min_[d]) / range : 0;
+            }
+            for (uint32_t i = 0; i < num_templates; i++) {
+                const double* t = &templates_[i * dims];
+                double sum = 0;
+                for (uint32_t d = 0; d < dims; d++) {
+                    double diff = t[d] - scaled[d];
+                    sum += diff * diff;
+                }
+                distances[i] = std::sqrt(sum);
+            }
+            break;
+        }
+        case kInt8:
+            computeDistances<int8_t, int32_t>(templates8_, x, distances);
+            break;
+        case kInt16:
+            computeDistances<int16_t, int64_t>(templates16_, x, distances);
+            break;
+    }
+
+    auto classIndex = [this](UINT label) {
+        return std::lower_bound(classLabels.begin(), classLabels.end(), label) -
+               classLabels.begin();
+    };
+
+    class_distances.assign(numClasses, std::numeric_limits<double>::max());
+    for (uint32_t i = 0; i < num_templates; i++) {
+        double& best = class_distances[classIndex(template_labels_[i])];
+        best = std::min(best, distances[i]);
+    }
+
+    // Vote among the k nearest templates; ties go to the class whose voters
+    // are closer in total.
+    uint32_t k = std::min<uint32_t>(k_, num_templates);
+    vector<uint32_t> order(num_templates);
+    std::iota(order.begin(), order.end(), 0);
+    std::partial_sort(order.begin(), order.begin() + k, order.end(),
+                      [&distances](uint32_t a, uint32_t b) {
+                          return distances[a] < distances[b];
+                      });
+
+    vector<uint32_t> votes(numClasses, 0);
+    vector<double> vote_distances(numClasses, 0);
+    for (uint32_t i = 0; i < k; i++) {
+        auto c = classIndex(template_labels_[order[i]]);
+        votes[c]++;
+        vote_distances[c] += distances[order[i]];
+    }
+
+    uint32_t best = 0;
+    for (uint32_t c = 1; c < numClasses; c++) {
+        if (votes[c] > votes[best] ||
+            (votes[c] == votes[best] &&
+             vote_distances[c] < vote_distances[best])) {
+            best = c;
+        }
+    }
+
+    class_likelihoods.resize(numClasses);
+    for (uint32_t c = 0; c < numClasses; c++) {
+        class_likelihoods[c] = double(votes[c]) / k;
+    }
+    return classLabels[best];
+}
+
+bool QuantizedKNN::predict_(VectorDouble& inputVector) {
+    if (!trained) {
+        errorLog << "predict_(VectorDouble &inputVector)"
+                 << " - Model Not Trained!" << std::endl;
+        return false;
+    }
+
+    if (inputVector.size() != numInputDimensions) {
+        errorLog << "predict_(VectorDouble &inputVector)"
+                 << " - The size of the input vector (" << inputVector.size()
+                 << ") does not match the num features in the model ("
+                 << numInputDimensions << ")" << std::endl;
+        return false;
+    }
+
+    predictedClassLabel = classify(inputVector, classDistances,
+                                   classLikelihoods);
+    auto c = std::lower_bound(classLabels.begin(), classLabels.end(),
+                              predictedClassLabel) - classLabels.begin();
+    maxLikelihood = classLikelihoods[c];
+    bestDistance = classDistances[c];
+    return true;
+}
+
+void QuantizedKNN::evaluateQuantization(const vector<VectorDouble>& samples,
+                                        const vector<UINT>& labels) {
+    vector<VectorDouble> train_samples, test_samples;
+    vector<UINT> train_labels, test_labels;
+    std::map<UINT, uint32_t> seen;
+    for (uint32_t i = 0; i < samples.size(); i++) {
+        if (++seen[labels[i]] % kHoldOutPeriod == 0) {
+            test_samples.push_back(samples[i]);
+            test_labels.push_back(labels[i]);
+        } else {
+            train_samples.push_back(samples[i]);
+            train_labels.push_back(labels[i]);
+        }
+    }
+
+    if (test_samples.empty()) {
+        warningLog << "Not enough training samples to evaluate quantization"
+                   << std::endl;
+        return;
+    }
+
+    // Both models are calibrated on the training part only, as they would be
+    // on unseen data.
+    vector<double> min, max;
+    computeRanges(train_samples, min, max);
+
+    QuantizedKNN reference(k_, kNone), quantized(k_, quantization_);
+    for (QuantizedKNN* model : { &reference, &quantized }) {
+        model->numInputDimensions = numInputDimensions;
+        model->classLabels = classLabels;
+        model->numClasses = numClasses;
+        model->fit(train_samples, train_labels, min, max);
+    }
+
+    auto evaluate = [&](const QuantizedKNN& model, double& accuracy,
+                        double& prediction_us) {
+        using Clock = std::chrono::steady_clock;
+        VectorDouble class_distances, class_likelihoods;
+        uint32_t correct = 0;
+        Clock::time_point start = Clock::now();
+        for (uint32_t i = 0; i < test_samples.size(); i++) {
+            UINT label = model.classify(test_samples[i], class_distances,
+                                        class_likelihoods);
+            if (label == test_labels[i]) correct++;
+        }
+        std::chrono::duration<double, std::micro> elapsed =
+            Clock::now() - start;
+        accuracy = double(correct) / test_samples.size();
+        prediction_us = elapsed.count() / test_samples.size();
+    };
+
+    QuantizationReport& r = quantization_report_;
+    r.num_test_samples = test_samples.size();
+    evaluate(reference, r.double_accuracy, r.double_prediction_us);
+    evaluate(quantized, r.quantized_accuracy, r.quantized_prediction_us);
+
+    trainingLog << "Quantized accuracy " << r.quantized_accuracy
+                << " vs. double " << r.double_accuracy
+                << " (delta " << r.getAccuracyDelta() << ") on "
+                << r.num_test_samples << " held out samples; "
+                << r.quantized_prediction_us << " us vs. "
+                << r.double_prediction_us << " us per prediction" << std::endl;
+}
+
+bool QuantizedKNN::saveModelToFile(string filename) const {
+    std::fstream file;
+    file.open(filename.c_str(), std::ios::out);
+
+    return saveModelToFile(file);
+}
+
+bool QuantizedKNN::loadModelFromFile(string filename) {
+    std::fstream file;
+    file.open(filename.c_str(), std::ios::in);
+
+    return loadModelFromFile(file);
+}
+
+bool QuantizedKNN::saveModelToFile(fstream& file) const {
+    if (!file.is_open()) {
+        errorLog << "saveModelToFile(fstream &file) - The file is not open!"
+                 << std::endl;
+        return false;
+    }
+
+    file << "GRT_QUANTIZED_KNN_MODEL_FILE_V1.0" << std::endl;
+
+    if (!saveBaseSettingsToFile(file)) {
+        errorLog << "saveModelToFile(fstream &file)"
+                 << " - Failed to save classifier base settings to file!"
+                 << std::endl;
+        return false;
+    }
+
+    file << "K: " << k_ << std::endl;
+    file << "Quantization: " << quantization_ << std::endl;
+
+    if (!trained) return true;
+
+    const uint32_t dims = numInputDimensions;
+    file.precision(std::numeric_limits<double>::max_digits10);
+    file << "Ranges:" << std::endl;
+    for (uint32_t d = 0; d < dims; d++) {
+        file << min_[d] << " " << max_[d] << std::endl;
+    }
+
+    file << "NumTemplates: " << template_labels_.size() << std::endl;
+    file << "Templates:" << std::endl;
+    for (uint32_t i = 0; i < template_labels_.size(); i++) {
+        file << template_labels_[i];
+        for (uint32_t d = 0; d < dims; d++) {
+            switch (quantization_) {
+                case kNone: file << " " << templates_[i * dims + d]; break;
+                case kInt8: file << " " << int(templates8_[i * dims + d]); break;
+                case kInt16: file << " " << templates16_[i * dims + d]; break;
+            }
+        }
+        file << std::endl;
+    }
+
+    return true;
+}
+
+bool QuantizedKNN::loadModelFromFile(fstream& file) {
+    clear();
+
+    if (!file.is_open()) {
+        errorLog << "loadModelFromFile(fstream &file) - The file is not open!"
+                 << std::endl;
+        return false;
+    }
+
+    string word;
+
+    // Load the header
+    file >> word;
+    if (word != "GRT_QUANTIZED_KNN_MODEL_FILE_V1.0") {
+        errorLog << "loadModelFromFile(fstream &file) - Invalid file format!"
+                 << std::endl;
+        return false;
+    }
+
+    if (!loadBaseSettingsFromFile(file)) {
+        errorLog << "loadModelFromFile(fstream &file)"
+                 << " - Failed to load base settings from file!" << std::endl;
+        return false;
+    }
+
+    file >> word;
+    if (word != "K:") {
+        errorLog << "loadModelFromFile(fstream &file) "
+                 << "- Failed to read K header!" << std::endl;
+        return false;
+    }
+    file >> k_;
+
+    int quantization;
+    file >> word;
+    if (word != "Quantization:") {
+        errorLog << "loadModelFromFile(fstream &file) "
+                 << "- Failed to read Quantization header!" << std::endl;
+        return false;
+    }
+    file >> quantization;
+    quantization_ = static_cast<Quantization>(quantization);
+    next_quantization_ = quantization_;
+
+    if (!trained) return true;
+
+    const uint32_t dims = numInputDimensions;
+    file >> word;
+    if (word != "Ranges:") {
+        errorLog << "loadModelFromFile(fstream &file) "
+                 << "- Failed to read Ranges header!" << std::endl;
+        return false;
+    }
+    min_.resize(dims);
+    max_.resize(dims);
+    for (uint32_t d = 0; d < dims; d++) {
+        file >> min_[d] >> max_[d];
+    }
+
+    uint32_t num_templates;
+    file >> word;
+    if (word != "NumTemplates:") {
+        errorLog << "loadModelFromFile(fstream &file) "
+                 << "- Failed to read NumTemplates header!" << std::endl;
+        return false;
+    }
+    file >> num_templates;
+
+    file >> word;
+    if (word != "Templates:") {
+        errorLog << "loadModelFromFile(fstream &file) "
+                 << "- Failed to read Templates header!" << std::endl;
+        return false;
+    }
+
+    switch (quantization_) {
+        case kNone: templates_.resize(num_templates * dims); break;
+        case kInt8:
+            quantizer_.calibrate(min_, max_, 256, -128);
+            templates8_.resize(num_templates * dims);
+            break;
+        case kInt16:
+            quantizer_.calibrate(min_, max_, 65536, -32768);
+            templates16_.resize(num_templates * dims);
+            break;
+    }
+
+    template_labels_.resize(num_templates);
+    for (uint32_t i = 0; i < num_templates; i++) {
+        file >> template_labels_[i];
+        for (uint32_t d = 0; d < dims; d++) {
+            int32_t q;
+            switch (quantization_) {
+                case kNone: file >> templates_[i * dims + d]; break;
+                case kInt8: file >> q; templates8_[i * dims + d] = q; break;
+                case kInt16: file >> q; templates16_[i * dims + d] = q; break;
+            }
+        }
+    }
+
+    if (!file.good()) {
+        errorLog << "loadModelFromFile(fstream &file) "
+                 << "- Failed to read templates!" << std::endl;
+        clear();
+        return false;
+    }
+
+    classLikelihoods.assign(numClasses, 0);
+    classDistances.assign(numClasses, 0);
+    return true;
+}
+
+} // namespace GRT
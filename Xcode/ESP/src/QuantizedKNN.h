@@ -0,0 +1,176 @@
+#ifndef ESP_QUANTIZED_KNN_H_
+#define ESP_QUANTIZED_KNN_H_
+
+#include "GRT/CoreModules/Classifier.h"
+#include "IncrementalClassifier.h"
+
+#include <stdint.h>
+#include <vector>
+
+namespace GRT {
+
+using std::vector;
+
+// FeatureQuantizer maps each dimension of a feature vector linearly onto the
+// full range of an integer type, using a per-dimension scale and zero-point
+// calibrated from the minimum and maximum of the training data:
+//
+//   q = clamp(round(x / scale) + zero_point)
+//
+// Values outside the calibrated range saturate at the ends of the range.
+class FeatureQuantizer {
+  public:
+    // Calibrate for `num_levels` integer levels starting at `min_level`, e.g.
+    // (256, -128) for int8_t.
+    void calibrate(const vector<double>& min, const vector<double>& max,
+                   int32_t num_levels, int32_t min_level);
+
+    template <typename T>
+    void quantize(const VectorDouble& x, T* out) const;
+
+    double dequantize(int32_t q, uint32_t dim) const {
+        return (q - zero_point_[dim]) * scale_[dim];
+    }
+
+    uint32_t getNumDimensions() const { return scale_.size(); }
+    const vector<double>& getScale() const { return scale_; }
+    const vector<int32_t>& getZeroPoint() const { return zero_point_; }
+
+  private:
+    vector<double> scale_;
+    vector<int32_t> zero_point_;
+    int32_t min_level_;
+    int32_t max_level_;
+};
+
+// QuantizedKNN is a k-nearest-neighbour classifier for per-frame feature
+// vectors (capacitive sensing, Touche, MFCC, ...) with an optional quantized
+// inference mode.
+//
+// Nearest-neighbour inference is bound by memory bandwidth: every prediction
+// reads every stored template. With quantization enabled, templates are stored
+// as int8_t or int16_t instead of double (8x or 4x less memory) and distances
+// are accumulated in integer arithmetic, in plain loops that the compiler
+// vectorizes.
+//
+// Each dimension is scaled to the range of the training data (as GRT's KNN
+// does with scaling enabled) in both modes, so the quantized distances only
+// differ from the double ones by rounding. When quantization is enabled,
+// training holds out part of the training data, trains both modes on the rest
+// and reports the accuracy of each on the held out samples (see
+// getQuantizationReport()), before training on all of the data.
+//
+// New samples can be added to a trained model with updateModel(), without
+// retraining. They are scaled with the ranges of the last training data, so
+// values outside those ranges saturate when quantization is enabled.
+//
+// Null rejection is not supported.
+class QuantizedKNN : public Classifier, public IncrementalClassifier {
+  public:
+    enum Quantization {
+        kNone = 0,  // Store and compare templates as double
+        kInt8,
+        kInt16,
+    };
+
+    // Accuracy and speed of the quantized model relative to the double one,
+    // measured on training samples held out during train().
+    struct QuantizationReport {
+        uint32_t num_test_samples = 0;
+        double double_accuracy = 0;
+        double quantized_accuracy = 0;
+        double double_prediction_us = 0;     // average per prediction
+        double quantized_prediction_us = 0;  // average per prediction
+
+        double getAccuracyDelta() const {
+            return quantized_accuracy - double_accuracy;
+        }
+    };
+
+    QuantizedKNN(uint32_t k = 1, Quantization quantization = kInt8);
+
+    QuantizedKNN(const QuantizedKNN& rhs);
+    QuantizedKNN& operator=(const QuantizedKNN& rhs);
+    bool deepCopyFrom(const Classifier* classifier) override;
+    ~QuantizedKNN() override {}
+
+    bool train_(ClassificationData& trainingData) override;
+    bool predict_(VectorDouble& inputVector) override;
+    bool clear() override;
+
+    // Add one template to the trained model, in O(numInputDimensions).
+    bool updateModel(UINT classLabel, const VectorDouble& sample) override;
+
+    uint32_t getK() const { return k_; }
+    bool setK(uint32_t k);
+
+    // The quantization of the trained model, or of the next training if
+    // there is no trained model.
+    Quantization getQuantization() const { return quantization_; }
+    // Takes effect the next time the model is trained; a trained model keeps
+    // its templates, and its quantization, until then.
+    bool setQuantization(Quantization quantization);
+
+    // Empty unless the model was trained with quantization enabled.
+    const QuantizationReport& getQuantizationReport() const {
+        return quantization_report_;
+    }
+
+    // Memory used by the stored templates, in bytes.
+    size_t getTemplateMemoryUsage() const;
+
+    // Save and Load from file
+    bool saveModelToFile(string filename) const override;
+    bool loadModelFromFile(string filename) override;
+    bool saveModelToFile(fstream& file) const override;
+    bool loadModelFromFile(fstream& file) override;
+
+    using MLBase::train;
+    using MLBase::predict;
+
+  protected:
+    // Store `samples` as templates, calibrating the scaling and quantization
+    // on `min` and `max`.
+    void fit(const vector<VectorDouble>& samples, const vector<UINT>& labels,
+             const vector<double>& min, const vector<double>& max);
+
+    // Return the label of the nearest neighbours of `x` and fill in
+    // `class_distances` (one entry per class in classLabels).
+    UINT classify(const VectorDouble& x, VectorDouble& class_distances,
+                  VectorDouble& class_likelihoods) const;
+
+    // Scale (and quantize) `x` and store it after the existing templates.
+    void appendTemplate(const VectorDouble& x);
+
+    template <typename T, typename Acc>
+    void computeDistances(const vector<T>& templates, const VectorDouble& x,
+                          vector<double>& distances) const;
+
+    void evaluateQuantization(const vector<VectorDouble>& samples,
+                              const vector<UINT>& labels);
+
+    uint32_t k_;
+    // The quantization of the stored templates, and the one set for the next
+    // training.
+    Quantization quantization_;
+    Quantization next_quantization_;
+    QuantizationReport quantization_report_;
+
+    // Per-dimension range of the training data.
+    vector<double> min_;
+    vector<double> max_;
+    FeatureQuantizer quantizer_;
+
+    // Templates, one row of numInputDimensions values per training sample.
+    // Only the vector matching quantization_ is filled in.
+    vector<UINT> template_labels_;
+    vector<double> templates_;
+    vector<int8_t> templates8_;
+    vector<int16_t> templates16_;
+
+    static RegisterClassifierModule<QuantizedKNN> registerModule;
+};
+
+} // namespace GRT
+
+#endif // ESP_QUANTIZED_KNN_H_
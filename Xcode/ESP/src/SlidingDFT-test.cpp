@@ -0,0 +1,134 @@
+#include "SlidingDFT.h"
+#include "gtest/gtest.h"
+
+#include <cmath>
+#include <random>
+
+// Magnitude of bin k of the DFT of `window`, multiplied by `taper`.
+static double dftMagnitude(const std::vector<double>& window, uint32_t k,
+                           const std::vector<double>& taper) {
+    double re = 0, im = 0;
+    uint32_t n = window.size();
+    for (uint32_t m = 0; m < n; m++) {
+        re += window[m] * taper[m] * cos(2 * PI * k * m / n);
+        im -= window[m] * taper[m] * sin(2 * PI * k * m / n);
+    }
+    return sqrt(re * re + im * im);
+}
+
+static std::vector<double> randomSignal(uint32_t length) {
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<double> sample(-1, 1);
+    std::vector<double> signal(length);
+    for (double& x : signal) x = sample(rng);
+    return signal;
+}
+
+TEST(SlidingDFTTest, MatchesTheDFTOfTheWindow) {
+    const uint32_t N = 64;
+    GRT::SlidingDFT sdft(N, 1, 1, GRT::SlidingDFT::RECTANGULAR_WINDOW,
+                         {}, 1.0);
+    ASSERT_EQ(N / 2, sdft.getNumOutputDimensions());
+
+    std::vector<double> signal = randomSignal(10 * N);
+    std::vector<double> rectangular(N, 1.0);
+    for (uint32_t n = 0; n < signal.size(); n++) {
+        ASSERT_TRUE(sdft.computeFeatures({ signal[n] }));
+        // Nothing until the window has filled.
+        ASSERT_EQ(n + 1 >= N, sdft.getFeatureDataReady());
+        if (n + 1 < N || n % 7 != 0) continue;
+
+        std::vector<double> window(signal.begin() + n + 1 - N,
+                                   signal.begin() + n + 1);
+        for (uint32_t k = 0; k < N / 2; k++) {
+            ASSERT_NEAR(dftMagnitude(window, k, rectangular),
+                        sdft.getFeatureVector()[k], 1e-9);
+        }
+    }
+}
+
+TEST(SlidingDFTTest, HannWindowAndChosenBins) {
+    const uint32_t N = 32;
+    std::vector<uint32_t> bins = { 0, 3, 4, 15 };
+    GRT::SlidingDFT sdft(N, 4, 2, GRT::SlidingDFT::HANNING_WINDOW, bins, 1.0);
+    ASSERT_EQ(2 * bins.size(), sdft.getNumOutputDimensions());
+
+    std::vector<double> hann(N);
+    for (uint32_t m = 0; m < N; m++) hann[m] = 0.5 - 0.5 * cos(2 * PI * m / N);
+
+    std::vector<double> signal = randomSignal(4 * N);
+    int num_spectra = 0;
+    for (uint32_t n = 0; n < signal.size(); n++) {
+        // The second dimension is the first one doubled.
+        ASSERT_TRUE(sdft.computeFeatures({ signal[n], 2 * signal[n] }));
+        // Every hop once the window has filled.
+        ASSERT_EQ(n + 1 >= N && (n + 1 - N) % 4 == 0,
+                  sdft.getFeatureDataReady());
+        if (!sdft.getFeatureDataReady()) continue;
+        num_spectra++;
+
+        std::vector<double> window(signal.begin() + n + 1 - N,
+                                   signal.begin() + n + 1);
+        for (uint32_t i = 0; i < bins.size(); i++) {
+            double expected = dftMagnitude(window, bins[i], hann);
+            ASSERT_NEAR(expected, sdft.getFeatureVector()[i], 1e-9);
+            ASSERT_NEAR(2 * expected, sdft.getFeatureVector()[4 + i], 1e-9);
+        }
+    }
+    ASSERT_EQ(3 * N / 4 + 1, num_spectra);
+}
+
+TEST(SlidingDFTTest, DampingWeightsOlderSamplesLess) {
+    const uint32_t N = 16;
+    const double r = 0.9;
+    // Resynchronizing after an odd number of samples must agree with the
+    // recurrence.
+    GRT::SlidingDFT sdft(N, 1, 1, GRT::SlidingDFT::RECTANGULAR_WINDOW,
+                         { 1, 5 }, r, 5);
+
+    std::vector<double> signal = randomSignal(5 * N);
+    for (uint32_t n = 0; n < signal.size(); n++) {
+        ASSERT_TRUE(sdft.computeFeatures({ signal[n] }));
+        if (n + 1 < N) continue;
+
+        std::vector<double> window(signal.begin() + n + 1 - N,
+                                   signal.begin() + n + 1);
+        std::vector<double> taper(N);
+        for (uint32_t m = 0; m < N; m++) taper[m] = pow(r, N - 1 - m);
+        ASSERT_NEAR(dftMagnitude(window, 1, taper),
+                    sdft.getFeatureVector()[0], 1e-9);
+        ASSERT_NEAR(dftMagnitude(window, 5, taper),
+                    sdft.getFeatureVector()[1], 1e-9);
+    }
+}
+
+TEST(SlidingDFTTest, CopiesAndResets) {
+    GRT::SlidingDFT sdft(16, 2, 1, GRT::SlidingDFT::HAMMING_WINDOW);
+    std::vector<double> signal = randomSignal(40);
+    for (uint32_t n = 0; n < 20; n++) sdft.computeFeatures({ signal[n] });
+
+    GRT::SlidingDFT copy(sdft);
+    for (uint32_t n = 20; n < 40; n++) {
+        ASSERT_TRUE(sdft.computeFeatures({ signal[n] }));
+        ASSERT_TRUE(copy.computeFeatures({ signal[n] }));
+        ASSERT_EQ(sdft.getFeatureDataReady(), copy.getFeatureDataReady());
+        ASSERT_EQ(sdft.getFeatureVector(), copy.getFeatureVector());
+    }
+
+    ASSERT_TRUE(copy.reset());
+    ASSERT_TRUE(copy.computeFeatures({ 1.0 }));
+    ASSERT_FALSE(copy.getFeatureDataReady());
+}
+
+TEST(SlidingDFTTest, RejectsBadSettings) {
+    GRT::SlidingDFT out_of_range(16, 1, 1,
+                                 GRT::SlidingDFT::RECTANGULAR_WINDOW, { 16 });
+    ASSERT_FALSE(out_of_range.computeFeatures({ 1.0 }));
+
+    GRT::SlidingDFT unstable(16, 1, 1, GRT::SlidingDFT::RECTANGULAR_WINDOW,
+                             {}, 1.5);
+    ASSERT_FALSE(unstable.computeFeatures({ 1.0 }));
+
+    GRT::SlidingDFT sdft(16, 1, 2);
+    ASSERT_FALSE(sdft.computeFeatures({ 1.0 }));
+}
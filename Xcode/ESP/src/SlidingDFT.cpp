@@ -0,0 +1,374 @@
+#include "SlidingDFT.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace GRT {
+
+RegisterFeatureExtractionModule<SlidingDFT>
+    SlidingDFT::registerModule("SlidingDFT");
+
+constexpr double SlidingDFT::kDefaultDamping;
+
+SlidingDFT::SlidingDFT(uint32_t window_size, uint32_t hop_size,
+                       uint32_t num_dimensions, uint32_t window_function,
+                       const vector<uint32_t>& bins, double damping,
+                       uint32_t resync_interval)
+    : window_size_(0), hop_size_(0), window_function_(RECTANGULAR_WINDOW),
+      damping_(kDefaultDamping), resync_interval_(0), damping_n_(1),
+      position_(0), num_samples_(0), samples_since_resync_(0) {
+    classType = "SlidingDFT";
+    featureExtractionType = classType;
+    debugLog.setProceedingText("[DEBUG SlidingDFT]");
+    errorLog.setProceedingText("[ERROR SlidingDFT]");
+    warningLog.setProceedingText("[WARNING SlidingDFT]");
+
+    init(window_size, hop_size, num_dimensions, window_function, bins, damping,
+         resync_interval);
+}
+
+SlidingDFT::SlidingDFT(const SlidingDFT& rhs) {
+    classType = "SlidingDFT";
+    featureExtractionType = classType;
+    debugLog.setProceedingText("[DEBUG SlidingDFT]");
+    errorLog.setProceedingText("[ERROR SlidingDFT]");
+    warningLog.setProceedingText("[WARNING SlidingDFT]");
+
+    *this = rhs;
+}
+
+SlidingDFT& SlidingDFT::operator=(const SlidingDFT& rhs) {
+    if (this != &rhs) {
+        window_size_ = rhs.window_size_;
+        hop_size_ = rhs.hop_size_;
+        window_function_ = rhs.window_function_;
+        bins_ = rhs.bins_;
+        damping_ = rhs.damping_;
+        resync_interval_ = rhs.resync_interval_;
+        tracked_bins_ = rhs.tracked_bins_;
+        center_index_ = rhs.center_index_;
+        lower_index_ = rhs.lower_index_;
+        upper_index_ = rhs.upper_index_;
+        rotation_real_ = rhs.rotation_real_;
+        rotation_imag_ = rhs.rotation_imag_;
+        cos_table_ = rhs.cos_table_;
+        sin_table_ = rhs.sin_table_;
+        damping_powers_ = rhs.damping_powers_;
+        damping_n_ = rhs.damping_n_;
+        samples_ = rhs.samples_;
+        position_ = rhs.position_;
+        real_ = rhs.real_;
+        imag_ = rhs.imag_;
+        num_samples_ = rhs.num_samples_;
+        samples_since_resync_ = rhs.samples_since_resync_;
+        copyBaseVariables((FeatureExtraction*)&rhs);
+    }
+    return *this;
+}
+
+bool SlidingDFT::deepCopyFrom(const FeatureExtraction* featureExtraction) {
+    if (featureExtraction == nullptr) {
+        return false;
+    }
+
+    if (this->getFeatureExtractionType() ==
+        featureExtraction->getFeatureExtractionType()) {
+        *this = *(SlidingDFT*)featureExtraction;
+        return true;
+    }
+
+    errorLog << "deepCopyFrom(const FeatureExtraction *featureExtraction)"
+             << " - FeatureExtraction Types Do Not Match!" << std::endl;
+    return false;
+}
+
+bool SlidingDFT::init(uint32_t window_size, uint32_t hop_size,
+                      uint32_t num_dimensions, uint32_t window_function,
+                      const vector<uint32_t>& bins, double damping,
+                      uint32_t resync_interval) {
+    initialized = false;
+
+    if (window_size < 2 || hop_size == 0 || num_dimensions == 0) {
+        errorLog << "init(...) - The window size must be at least 2, and the "
+                 << "hop size and number of dimensions at least 1!"
+                 << std::endl;
+        return false;
+    }
+    if (window_function > HANNING_WINDOW) {
+        errorLog << "init(...) - Unknown window function " << window_function
+                 << "!" << std::endl;
+        return false;
+    }
+    if (!(damping > 0 && damping <= 1)) {
+        errorLog << "init(...) - The damping must be in (0, 1]!" << std::endl;
+        return false;
+    }
+
+    vector<uint32_t> chosen = bins;
+    if (chosen.empty()) {
+        for (uint32_t k = 0; k < window_size / 2; k++) chosen.push_back(k);
+    }
+    for (uint32_t k : chosen) {
+        if (k >= window_size) {
+            errorLog << "init(...) - Bin " << k << " is out of range for a "
+                     << "window of " << window_size << " samples!"
+                     << std::endl;
+            return false;
+        }
+    }
+
+    window_size_ = window_size;
+    hop_size_ = hop_size;
+    window_function_ = window_function;
+    bins_ = bins;
+    damping_ = damping;
+    resync_interval_ = resync_interval;
+
+    // Track each bin once, even if several chosen bins need it.
+    tracked_bins_.clear();
+    auto track = [this](uint32_t k) -> uint32_t {
+        auto it = std::find(tracked_bins_.begin(), tracked_bins_.end(), k);
+        if (it != tracked_bins_.end()) return it - tracked_bins_.begin();
+        tracked_bins_.push_back(k);
+        return tracked_bins_.size() - 1;
+    };
+    center_index_.clear();
+    lower_index_.clear();
+    upper_index_.clear();
+    for (uint32_t k : chosen) {
+        center_index_.push_back(track(k));
+    }
+    if (window_function_ != RECTANGULAR_WINDOW) {
+        for (uint32_t k : chosen) {
+            lower_index_.push_back(track((k + window_size - 1) % window_size));
+            upper_index_.push_back(track((k + 1) % window_size));
+        }
+    }
+
+    rotation_real_.resize(tracked_bins_.size());
+    rotation_imag_.resize(tracked_bins_.size());
+    for (uint32_t i = 0; i < tracked_bins_.size(); i++) {
+        double angle = 2 * PI * tracked_bins_[i] / window_size_;
+        rotation_real_[i] = cos(angle);
+        rotation_imag_[i] = sin(angle);
+    }
+
+    cos_table_.resize(window_size_);
+    sin_table_.resize(window_size_);
+    damping_powers_.resize(window_size_);
+    for (uint32_t i = 0; i < window_size_; i++) {
+        cos_table_[i] = cos(2 * PI * i / window_size_);
+        sin_table_[i] = sin(2 * PI * i / window_size_);
+        damping_powers_[i] = pow(damping_, i);
+    }
+    damping_n_ = pow(damping_, window_size_);
+
+    numInputDimensions = num_dimensions;
+    numOutputDimensions = num_dimensions * chosen.size();
+    initialized = reset();
+    return true;
+}
+
+bool SlidingDFT::reset() {
+    samples_.assign(numInputDimensions * window_size_, 0);
+    position_ = 0;
+    real_.assign(numInputDimensions * tracked_bins_.size(), 0);
+    imag_.assign(numInputDimensions * tracked_bins_.size(), 0);
+    num_samples_ = 0;
+    samples_since_resync_ = 0;
+    featureVector.assign(numOutputDimensions, 0);
+    featureDataReady = false;
+    return true;
+}
+
+void SlidingDFT::resync() {
+    // X_k = sum over the window, oldest sample m = 0, of
+    // r^(N-1-m) x_m e^(-j 2 pi k m / N).
+    uint32_t num_tracked = tracked_bins_.size();
+    for (uint32_t d = 0; d < numInputDimensions; d++) {
+        const double* window = &samples_[d * window_size_];
+        for (uint32_t i = 0; i < num_tracked; i++) {
+            uint32_t k = tracked_bins_[i];
+            double re = 0, im = 0;
+            uint32_t j = 0;  // k * m mod N
+            for (uint32_t m = 0; m < window_size_; m++) {
+                double x = window[(position_ + m) % window_size_] *
+                           damping_powers_[window_size_ - 1 - m];
+                re += x * cos_table_[j];
+                im -= x * sin_table_[j];
+                j += k;
+                if (j >= window_size_) j -= window_size_;
+            }
+            real_[d * num_tracked + i] = re;
+            imag_[d * num_tracked + i] = im;
+        }
+    }
+}
+
+bool SlidingDFT::computeFeatures(const VectorDouble& inputVector) {
+    if (!initialized) {
+        errorLog << "computeFeatures(const VectorDouble &inputVector)"
+                 << " - Not initialized!" << std::endl;
+        return false;
+    }
+
+    if (inputVector.size() != numInputDimensions) {
+        errorLog << "computeFeatures(const VectorDouble &inputVector)"
+                 << " - The size of the inputVector (" << inputVector.size()
+                 << ") does not match that of the SlidingDFT ("
+                 << numInputDimensions << ")!" << std::endl;
+        return false;
+    }
+
+    // X_k(n) = e^(j 2 pi k / N) (r X_k(n - 1) + x(n) - r^N x(n - N))
+    uint32_t num_tracked = tracked_bins_.size();
+    for (uint32_t d = 0; d < numInputDimensions; d++) {
+        double& slot = samples_[d * window_size_ + position_];
+        double delta = inputVector[d] - damping_n_ * slot;
+        slot = inputVector[d];
+
+        double* re = &real_[d * num_tracked];
+        double* im = &imag_[d * num_tracked];
+        for (uint32_t i = 0; i < num_tracked; i++) {
+            double a = damping_ * re[i] + delta;
+            double b = damping_ * im[i];
+            re[i] = a * rotation_real_[i] - b * rotation_imag_[i];
+            im[i] = a * rotation_imag_[i] + b * rotation_real_[i];
+        }
+    }
+    position_ = (position_ + 1) % window_size_;
+    num_samples_++;
+
+    uint32_t interval = resync_interval_ > 0 ? resync_interval_ : window_size_;
+    if (++samples_since_resync_ >= interval) {
+        resync();
+        samples_since_resync_ = 0;
+    }
+
+    featureDataReady = num_samples_ >= window_size_ &&
+                       (num_samples_ - window_size_) % hop_size_ == 0;
+    if (!featureDataReady) return true;
+
+    // Hamming and Hann: a X_k - b (X_k-1 + X_k+1).
+    double a = 1, b = 0;
+    if (window_function_ == HAMMING_WINDOW) {
+        a = 0.54;
+        b = 0.23;
+    } else if (window_function_ == HANNING_WINDOW) {
+        a = 0.5;
+        b = 0.25;
+    }
+
+    uint32_t num_bins = center_index_.size();
+    featureVector.resize(numOutputDimensions);
+    for (uint32_t d = 0; d < numInputDimensions; d++) {
+        const double* re = &real_[d * num_tracked];
+        const double* im = &imag_[d * num_tracked];
+        for (uint32_t i = 0; i < num_bins; i++) {
+            double x = a * re[center_index_[i]];
+            double y = a * im[center_index_[i]];
+            if (b != 0) {
+                x -= b * (re[lower_index_[i]] + re[upper_index_[i]]);
+                y -= b * (im[lower_index_[i]] + im[upper_index_[i]]);
+            }
+            featureVector[d * num_bins + i] = sqrt(x * x + y * y);
+        }
+    }
+    return true;
+}
+
+bool SlidingDFT::saveModelToFile(string filename) const {
+    std::fstream file;
+    file.open(filename.c_str(), std::ios::out);
+
+    return saveModelToFile(file);
+}
+
+bool SlidingDFT::loadModelFromFile(string filename) {
+    std::fstream file;
+    file.open(filename.c_str(), std::ios::in);
+
+    return loadModelFromFile(file);
+}
+
+bool SlidingDFT::saveModelToFile(fstream &file) const {
+    if (!file.is_open()) {
+        errorLog << "saveModelToFile(fstream &file) - The file is not open!"
+                 << std::endl;
+        return false;
+    }
+
+    file << "GRT_SLIDING_DFT_FILE_V1.0" << std::endl;
+
+    if (!saveFeatureExtractionSettingsToFile(file)) {
+        errorLog << "saveModelToFile(fstream &file)"
+                 << " - Failed to save base feature extraction settings to file!"
+                 << std::endl;
+        return false;
+    }
+
+    file << "WindowSize: " << window_size_ << std::endl;
+    file << "HopSize: " << hop_size_ << std::endl;
+    file << "WindowFunction: " << window_function_ << std::endl;
+    file.precision(17);
+    file << "Damping: " << damping_ << std::endl;
+    file << "ResyncInterval: " << resync_interval_ << std::endl;
+    file << "Bins: " << bins_.size();
+    for (uint32_t k : bins_) file << " " << k;
+    file << std::endl;
+
+    return true;
+}
+
+bool SlidingDFT::loadModelFromFile(fstream &file) {
+    if (!file.is_open()) {
+        errorLog << "loadModelFromFile(fstream &file) - The file is not open!"
+                 << std::endl;
+        return false;
+    }
+
+    string word;
+
+    // Load the header
+    file >> word;
+    if (word != "GRT_SLIDING_DFT_FILE_V1.0") {
+        errorLog << "loadModelFromFile(fstream &file) - Invalid file format!"
+                 << std::endl;
+        return false;
+    }
+
+    if (!loadFeatureExtractionSettingsFromFile(file)) {
+        errorLog << "loadModelFromFile(fstream &file)"
+                 << " - Failed to load base feature extraction settings from file!"
+                 << std::endl;
+        return false;
+    }
+
+    uint32_t window_size, hop_size, window_function, resync_interval;
+    double damping;
+    const char* headers[] = { "WindowSize:", "HopSize:", "WindowFunction:",
+                              "Damping:", "ResyncInterval:", "Bins:" };
+    for (const char* header : headers) {
+        file >> word;
+        if (word != header) {
+            errorLog << "loadModelFromFile(fstream &file) "
+                     << "- Failed to read " << header << " header!"
+                     << std::endl;
+            return false;
+        }
+        if (word == "WindowSize:") file >> window_size;
+        else if (word == "HopSize:") file >> hop_size;
+        else if (word == "WindowFunction:") file >> window_function;
+        else if (word == "Damping:") file >> damping;
+        else if (word == "ResyncInterval:") file >> resync_interval;
+    }
+    uint32_t num_bins = 0;
+    file >> num_bins;
+    vector<uint32_t> bins(num_bins);
+    for (uint32_t& k : bins) file >> k;
+
+    return init(window_size, hop_size, numInputDimensions, window_function,
+                bins, damping, resync_interval);
+}
+
+} // namespace GRT
@@ -0,0 +1,130 @@
+#ifndef ESP_SLIDING_DFT_H_
+#define ESP_SLIDING_DFT_H_
+
+#include "GRT/CoreModules/FeatureExtraction.h"
+
+#include <stdint.h>
+#include <vector>
+
+namespace GRT {
+
+using std::vector;
+
+/* @brief SlidingDFT tracks the spectrum of the last `window_size` samples of
+ * each input dimension, updating a chosen set of DFT bins with every sample
+ * instead of recomputing a whole FFT every hop. Each update costs O(bins), so
+ * it's much cheaper than GRT::FFT with a hop size of 1, and cheaper than an
+ * FFT at any hop size when only a few bins are needed.
+ *
+ * The output is the magnitude of each chosen bin, per input dimension (all
+ * bins of the first dimension, then of the second, ...). With the default
+ * bins, 0 to window_size / 2 - 1, it has the size and (unnormalized) scale of
+ * the magnitude spectrum from GRT::FFT, so it can feed an MFCC module with
+ * `fft_size` set to window_size / 2:
+ *
+ *    GRT::SlidingDFT sdft(512, 128, 1, GRT::SlidingDFT::HAMMING_WINDOW);
+ *
+ * Spectra are produced once the window has filled and then every `hop_size`
+ * samples (featureDataReady is false in between), as with GRT::FFT.
+ *
+ * The recurrence is damped by `damping` (r, just below 1) to keep rounding
+ * errors from accumulating, which weights the sample m steps back by r^m.
+ * Every `resync_interval` samples (by default, once per window) the bins are
+ * recomputed exactly from the window, so a long run doesn't drift either.
+ * Hamming and Hann windows are applied in the frequency domain from the
+ * neighbouring bins, which are then tracked too; they're the periodic forms
+ * of the windows (GRT::FFT uses the symmetric ones).
+ *
+ * [1] Jacobsen, E., Lyons, R., 2003. The sliding DFT. IEEE Signal Processing
+ *     Magazine 20 (2), 74-80.
+ */
+class SlidingDFT : public FeatureExtraction {
+  public:
+    enum WindowFunctionOptions {
+        RECTANGULAR_WINDOW = 0,
+        HAMMING_WINDOW,
+        HANNING_WINDOW
+    };
+
+    static constexpr double kDefaultDamping = 0.999999;
+
+    // Empty `bins` tracks bins 0 to window_size / 2 - 1. A `resync_interval`
+    // of 0 resynchronizes once per window.
+    SlidingDFT(uint32_t window_size = 256, uint32_t hop_size = 1,
+               uint32_t num_dimensions = 1,
+               uint32_t window_function = RECTANGULAR_WINDOW,
+               const vector<uint32_t>& bins = vector<uint32_t>(),
+               double damping = kDefaultDamping,
+               uint32_t resync_interval = 0);
+
+    SlidingDFT(const SlidingDFT& rhs);
+    SlidingDFT& operator=(const SlidingDFT& rhs);
+    bool deepCopyFrom(const FeatureExtraction* featureExtraction) override;
+    ~SlidingDFT() override {}
+
+    bool computeFeatures(const VectorDouble& inputVector) override;
+    bool reset() override;
+
+    uint32_t getWindowSize() const { return window_size_; }
+    uint32_t getHopSize() const { return hop_size_; }
+    uint32_t getWindowFunction() const { return window_function_; }
+    const vector<uint32_t>& getBins() const { return bins_; }
+    double getDamping() const { return damping_; }
+    uint32_t getResyncInterval() const { return resync_interval_; }
+
+    // Save and Load from file
+    bool saveModelToFile(string filename) const override;
+    bool loadModelFromFile(string filename) override;
+    bool saveModelToFile(fstream &file) const override;
+    bool loadModelFromFile(fstream &file) override;
+
+  protected:
+    bool init(uint32_t window_size, uint32_t hop_size,
+              uint32_t num_dimensions, uint32_t window_function,
+              const vector<uint32_t>& bins, double damping,
+              uint32_t resync_interval);
+
+    // Recompute the tracked bins of every dimension from the window.
+    void resync();
+
+    uint32_t window_size_;
+    uint32_t hop_size_;
+    uint32_t window_function_;
+    vector<uint32_t> bins_;
+    double damping_;
+    uint32_t resync_interval_;
+
+    // The bins that are updated: the chosen ones and, with a window other
+    // than the rectangular one, their neighbours.
+    vector<uint32_t> tracked_bins_;
+    // For each chosen bin, the index into tracked_bins_ of it and of the bins
+    // below and above it.
+    vector<uint32_t> center_index_;
+    vector<uint32_t> lower_index_;
+    vector<uint32_t> upper_index_;
+
+    // e^(j 2 pi k / N) for each tracked bin k.
+    vector<double> rotation_real_;
+    vector<double> rotation_imag_;
+    // cos and sin(2 pi i / N), and damping^i, for i in [0, N), for resync().
+    vector<double> cos_table_;
+    vector<double> sin_table_;
+    vector<double> damping_powers_;
+    double damping_n_;
+
+    // The last window_size samples of each dimension; `position_` is the
+    // oldest (next to be replaced).
+    vector<double> samples_;
+    uint32_t position_;
+    // The tracked bins of each dimension.
+    vector<double> real_;
+    vector<double> imag_;
+    uint64_t num_samples_;
+    uint32_t samples_since_resync_;
+
+    static RegisterFeatureExtractionModule<SlidingDFT> registerModule;
+};
+
+} // namespace GRT
+
+#endif // ESP_SLIDING_DFT_H_
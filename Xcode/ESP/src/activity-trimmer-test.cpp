@@ -0,0 +1,62 @@
+#include "activity-trimmer.h"
+#include "gtest/gtest.h"
+
+// A 1-D sample that is flat except for a ramp over rows [20, 30).
+static GRT::MatrixDouble makeSample() {
+    GRT::MatrixDouble sample(50, 1);
+    for (uint32_t i = 0; i < 50; i++) {
+        if (i < 20) sample[i][0] = 1;
+        else if (i < 30) sample[i][0] = 1 + (i - 19);
+        else sample[i][0] = 11;
+    }
+    return sample;
+}
+
+TEST(ActivityTrimmerTest, FindsActivity) {
+    ActivityTrimmer trimmer(0.5, 0);
+    auto range = trimmer.findActiveRange(makeSample());
+    // Smoothing spreads the ramp by a couple of rows on each side.
+    ASSERT_GE(range.first, 17);
+    ASSERT_LE(range.first, 20);
+    ASSERT_GE(range.second, 29);
+    ASSERT_LE(range.second, 32);
+}
+
+TEST(ActivityTrimmerTest, AddsPaddingWithinBounds) {
+    ActivityTrimmer unpadded(0.5, 0);
+    ActivityTrimmer padded(0.5, 5);
+    auto a = unpadded.findActiveRange(makeSample());
+    auto b = padded.findActiveRange(makeSample());
+    ASSERT_EQ(a.first - 5, b.first);
+    ASSERT_EQ(a.second + 5, b.second);
+
+    ActivityTrimmer huge(0.5, 1000);
+    auto c = huge.findActiveRange(makeSample());
+    ASSERT_EQ(0, c.first);
+    ASSERT_EQ(49, c.second);
+}
+
+TEST(ActivityTrimmerTest, KeepsIdleSample) {
+    GRT::MatrixDouble sample(10, 2);
+    for (uint32_t i = 0; i < 10; i++) {
+        sample[i][0] = 3;
+        sample[i][1] = -1;
+    }
+    ActivityTrimmer trimmer;
+    auto range = trimmer.findActiveRange(sample);
+    ASSERT_EQ(0, range.first);
+    ASSERT_EQ(9, range.second);
+}
+
+TEST(ActivityTrimmerTest, EnergyMode) {
+    GRT::MatrixDouble sample(30, 1);
+    for (uint32_t i = 0; i < 30; i++) {
+        sample[i][0] = (i >= 10 && i < 20) ? ((i % 2) ? 1 : -1) : 0;
+    }
+    ActivityTrimmer trimmer(0.5, 0, ActivityTrimmer::Mode::kEnergy);
+    auto range = trimmer.findActiveRange(sample);
+    ASSERT_GE(range.first, 8);
+    ASSERT_LE(range.first, 11);
+    ASSERT_GE(range.second, 18);
+    ASSERT_LE(range.second, 21);
+}
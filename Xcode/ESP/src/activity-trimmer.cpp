@@ -0,0 +1,63 @@
+#include "activity-trimmer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+// Width (in rows) of the moving average applied to the activity measure, so
+// that a single noisy row doesn't count as activity.
+static const uint32_t kSmoothingWindow = 5;
+
+ActivityTrimmer::ActivityTrimmer(double threshold, uint32_t padding, Mode mode)
+        : threshold_(threshold), padding_(padding), mode_(mode) {
+}
+
+std::pair<uint32_t, uint32_t> ActivityTrimmer::findActiveRange(
+    const GRT::MatrixDouble& sample) const {
+    const uint32_t rows = sample.getNumRows();
+    const uint32_t cols = sample.getNumCols();
+    const auto whole = std::make_pair(0u, rows == 0 ? 0u : rows - 1);
+    if (rows < 2) return whole;
+
+    std::vector<double> activity(rows, 0.0);
+    for (uint32_t i = 0; i < rows; i++) {
+        double a = 0.0;
+        for (uint32_t j = 0; j < cols; j++) {
+            if (mode_ == Mode::kDerivative) {
+                a += i == 0 ? 0.0 : std::fabs(sample[i][j] - sample[i - 1][j]);
+            } else {
+                a += sample[i][j] * sample[i][j];
+            }
+        }
+        activity[i] = a;
+    }
+    // The first row has no predecessor; give it its neighbour's value so the
+    // derivative doesn't see an artificial quiet row.
+    if (mode_ == Mode::kDerivative) activity[0] = activity[1];
+
+    // Centered moving average using a running sum.
+    std::vector<double> smoothed(rows, 0.0);
+    const uint32_t half = kSmoothingWindow / 2;
+    double sum = 0.0;
+    uint32_t lo = 0, hi = 0;  // window is [lo, hi)
+    for (uint32_t i = 0; i < rows; i++) {
+        uint32_t want_lo = i > half ? i - half : 0;
+        uint32_t want_hi = std::min(rows, i + half + 1);
+        while (hi < want_hi) sum += activity[hi++];
+        while (lo < want_lo) sum -= activity[lo++];
+        smoothed[i] = sum / (hi - lo);
+    }
+
+    double peak = *std::max_element(smoothed.begin(), smoothed.end());
+    if (peak <= 0.0) return whole;
+
+    const double threshold = threshold_ * peak;
+    uint32_t first = 0;
+    while (smoothed[first] < threshold) first++;
+    uint32_t last = rows - 1;
+    while (smoothed[last] < threshold) last--;
+
+    first = first > padding_ ? first - padding_ : 0;
+    last = std::min(rows - 1, last + padding_);
+    return std::make_pair(first, last);
+}
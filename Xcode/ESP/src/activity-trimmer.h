@@ -0,0 +1,56 @@
+/** @file activity-trimmer.h
+ *  @brief ActivityTrimmer finds the part of a recorded sample that contains
+ *  activity, so that idle lead-in and lead-out can be trimmed automatically.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <utility>
+
+#include <GRT/GRT.h>
+
+/**
+ *  @brief ActivityTrimmer computes a per-row activity measure in a single pass
+ *  over the sample, smooths it with a short moving average, and keeps the
+ *  rows between the first and the last one whose activity reaches
+ *  `threshold` times the peak activity of the sample, extended by `padding`
+ *  rows on each side.
+ *
+ *  Two activity measures are available:
+ *    1. kDerivative: sum over dimensions of |x[i] - x[i - 1]|. Insensitive to
+ *       constant offsets (e.g. gravity on an accelerometer at rest), so this
+ *       is the default and suits gestures.
+ *    2. kEnergy: sum over dimensions of x[i]^2. Suits zero-centered signals
+ *       like audio.
+ */
+class ActivityTrimmer {
+  public:
+    enum class Mode {
+        kDerivative,
+        kEnergy,
+    };
+
+    ActivityTrimmer(double threshold = 0.1, uint32_t padding = 5,
+                    Mode mode = Mode::kDerivative);
+
+    void setThreshold(double threshold) { threshold_ = threshold; }
+    double getThreshold() const { return threshold_; }
+
+    void setPadding(uint32_t padding) { padding_ = padding; }
+    uint32_t getPadding() const { return padding_; }
+
+    void setMode(Mode mode) { mode_ = mode; }
+    Mode getMode() const { return mode_; }
+
+    /// @brief Return the rows [first, second] (closed interval) of `sample`
+    /// that contain activity. The whole sample is returned if it has no
+    /// activity at all. `sample` must have at least one row.
+    std::pair<uint32_t, uint32_t> findActiveRange(
+        const GRT::MatrixDouble& sample) const;
+
+  private:
+    double threshold_;
+    uint32_t padding_;
+    Mode mode_;
+};
@@ -0,0 +1,109 @@
+#include "audio-deinterleaver.h"
+#include "gtest/gtest.h"
+
+// Interleaved frames where sample i of channel c is 100 * i + c.
+static vector<float> makeInput(uint32_t num_frames, uint32_t num_channels) {
+    vector<float> input(num_frames * num_channels);
+    for (uint32_t i = 0; i < num_frames; i++) {
+        for (uint32_t c = 0; c < num_channels; c++) {
+            input[i * num_channels + c] = 100 * i + c;
+        }
+    }
+    return input;
+}
+
+TEST(AudioDeinterleaverTest, Deinterleave) {
+    for (uint32_t num_channels = 1; num_channels <= 6; num_channels++) {
+        for (uint32_t num_frames : { 0, 1, 3, 4, 5, 8, 13, 256 }) {
+            vector<float> input = makeInput(num_frames, num_channels);
+            vector<vector<float>> planes(num_channels,
+                                         vector<float>(num_frames));
+            vector<float*> pointers;
+            for (auto& plane : planes) pointers.push_back(plane.data());
+
+            AudioDeinterleaver::deinterleave(input.data(), num_frames,
+                                             num_channels, pointers.data());
+            for (uint32_t c = 0; c < num_channels; c++) {
+                for (uint32_t i = 0; i < num_frames; i++) {
+                    ASSERT_EQ(100 * i + c, planes[c][i])
+                        << num_channels << " channels, " << num_frames
+                        << " frames";
+                }
+            }
+        }
+    }
+}
+
+TEST(AudioDeinterleaverTest, SelectAndDecimate) {
+    // The left channel of a stereo device, every fifth frame, as AudioStream
+    // used to deliver.
+    AudioDeinterleaver left(2, {0}, 5);
+    ASSERT_EQ(1, left.getNumOutputDimensions());
+
+    vector<float> input = makeInput(256, 2);
+    GRT::MatrixDouble out;
+    left.process(input.data(), 256, out);
+    ASSERT_EQ(51, out.getNumRows());
+    ASSERT_EQ(1, out.getNumCols());
+    for (uint32_t i = 0; i < 51; i++) ASSERT_EQ(100 * 5 * i, out[i][0]);
+
+    // The leftover frame starts the first group of the next buffer.
+    left.process(input.data(), 256, out);
+    ASSERT_EQ(51, out.getNumRows());
+    ASSERT_EQ(100 * 255, out[0][0]);
+    ASSERT_EQ(100 * 4, out[1][0]);
+
+    // Channels can be picked in any order; missing ones are dropped.
+    AudioDeinterleaver picked(4, {3, 1, 7}, 1);
+    ASSERT_EQ(2, picked.getNumOutputDimensions());
+    input = makeInput(10, 4);
+    picked.process(input.data(), 10, out);
+    ASSERT_EQ(10, out.getNumRows());
+    ASSERT_EQ(903, out[9][0]);
+    ASSERT_EQ(901, out[9][1]);
+}
+
+TEST(AudioDeinterleaverTest, AverageAndMixDown) {
+    AudioDeinterleaver split(3, {}, 3);
+    split.setAveraging(true);
+    AudioDeinterleaver whole(3, {}, 3);
+    whole.setAveraging(true);
+    ASSERT_EQ(3, whole.getNumOutputDimensions());
+
+    // Buffers that don't line up with the groups give the same output as one
+    // big buffer.
+    vector<float> input = makeInput(14, 3);
+    GRT::MatrixDouble first, second, all;
+    split.process(input.data(), 7, first);
+    split.process(input.data() + 7 * 3, 7, second);
+    whole.process(input.data(), 14, all);
+    ASSERT_EQ(2, first.getNumRows());
+    ASSERT_EQ(2, second.getNumRows());
+    ASSERT_EQ(4, all.getNumRows());
+    for (uint32_t c = 0; c < 3; c++) {
+        ASSERT_EQ(100 + c, all[0][c]);
+        ASSERT_EQ(all[1][c], first[1][c]);
+        ASSERT_EQ(all[2][c], second[0][c]);
+        ASSERT_EQ(1000 + c, all[3][c]);
+    }
+
+    AudioDeinterleaver mixed(3, {0, 2}, 1);
+    mixed.setMixDown(true);
+    ASSERT_EQ(1, mixed.getNumOutputDimensions());
+    mixed.process(input.data(), 14, all);
+    ASSERT_EQ(14, all.getNumRows());
+    ASSERT_EQ(1, all.getNumCols());
+    ASSERT_EQ(1301, all[13][0]);
+}
+
+TEST(AudioDeinterleaverTest, NoChannelsLeft) {
+    // The device has neither channel; there's nothing to mix down.
+    AudioDeinterleaver mixed(2, {2, 3}, 1);
+    mixed.setMixDown(true);
+    ASSERT_EQ(0, mixed.getNumOutputDimensions());
+
+    vector<float> input = makeInput(8, 2);
+    GRT::MatrixDouble out;
+    mixed.process(input.data(), 8, out);
+    ASSERT_EQ(0, out.getNumRows());
+}
@@ -0,0 +1,162 @@
+#include "audio-deinterleaver.h"
+
+#include <algorithm>
+
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define ESP_DEINTERLEAVE_SSE2 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define ESP_DEINTERLEAVE_NEON 1
+#endif
+
+AudioDeinterleaver::AudioDeinterleaver(uint32_t num_device_channels,
+                                       vector<uint32_t> channels,
+                                       uint32_t downsample_rate)
+        : num_device_channels_(std::max(1u, num_device_channels)),
+          channels_(channels),
+          downsample_rate_(std::max(1u, downsample_rate)) {
+    if (channels_.empty()) {
+        for (uint32_t c = 0; c < num_device_channels_; c++) {
+            channels_.push_back(c);
+        }
+    }
+    // Ignore channels the device doesn't have.
+    uint32_t n = num_device_channels_;
+    channels_.erase(std::remove_if(channels_.begin(), channels_.end(),
+                                   [n](uint32_t c) { return c >= n; }),
+                    channels_.end());
+
+    planes_.resize(num_device_channels_);
+    plane_pointers_.resize(num_device_channels_, nullptr);
+    reset();
+}
+
+void AudioDeinterleaver::reset() {
+    group_size_ = 0;
+    group_sums_.assign(getNumOutputDimensions(), 0);
+}
+
+void AudioDeinterleaver::deinterleave(const float* input, uint32_t num_frames,
+                                      uint32_t num_channels,
+                                      float* const* planes) {
+    if (num_channels == 1) {
+        std::copy(input, input + num_frames, planes[0]);
+        return;
+    }
+
+    uint32_t i = 0;
+#if ESP_DEINTERLEAVE_SSE2
+    if (num_channels == 2) {
+        for (; i + 4 <= num_frames; i += 4) {
+            __m128 a = _mm_loadu_ps(input + 2 * i);      // L0 R0 L1 R1
+            __m128 b = _mm_loadu_ps(input + 2 * i + 4);  // L2 R2 L3 R3
+            _mm_storeu_ps(planes[0] + i,
+                          _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)));
+            _mm_storeu_ps(planes[1] + i,
+                          _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)));
+        }
+    } else if (num_channels == 4) {
+        for (; i + 4 <= num_frames; i += 4) {
+            __m128 f0 = _mm_loadu_ps(input + 4 * i);
+            __m128 f1 = _mm_loadu_ps(input + 4 * i + 4);
+            __m128 f2 = _mm_loadu_ps(input + 4 * i + 8);
+            __m128 f3 = _mm_loadu_ps(input + 4 * i + 12);
+            _MM_TRANSPOSE4_PS(f0, f1, f2, f3);
+            _mm_storeu_ps(planes[0] + i, f0);
+            _mm_storeu_ps(planes[1] + i, f1);
+            _mm_storeu_ps(planes[2] + i, f2);
+            _mm_storeu_ps(planes[3] + i, f3);
+        }
+    }
+#elif ESP_DEINTERLEAVE_NEON
+    if (num_channels == 2) {
+        for (; i + 4 <= num_frames; i += 4) {
+            float32x4x2_t v = vld2q_f32(input + 2 * i);
+            vst1q_f32(planes[0] + i, v.val[0]);
+            vst1q_f32(planes[1] + i, v.val[1]);
+        }
+    } else if (num_channels == 4) {
+        for (; i + 4 <= num_frames; i += 4) {
+            float32x4x4_t v = vld4q_f32(input + 4 * i);
+            vst1q_f32(planes[0] + i, v.val[0]);
+            vst1q_f32(planes[1] + i, v.val[1]);
+            vst1q_f32(planes[2] + i, v.val[2]);
+            vst1q_f32(planes[3] + i, v.val[3]);
+        }
+    }
+#endif
+
+    // Other channel counts, and the frames left over by the loops above.
+    for (; i < num_frames; i++) {
+        const float* frame = input + i * num_channels;
+        for (uint32_t c = 0; c < num_channels; c++) {
+            planes[c][i] = frame[c];
+        }
+    }
+}
+
+void AudioDeinterleaver::process(const float* input, uint32_t num_frames,
+                                 GRT::MatrixDouble& out) {
+    const uint32_t dims = getNumOutputDimensions();
+    if (dims == 0) {
+        out.clear();
+        return;
+    }
+
+    if (planes_[0].size() < num_frames) {
+        for (uint32_t c = 0; c < num_device_channels_; c++) {
+            planes_[c].resize(num_frames);
+            plane_pointers_[c] = planes_[c].data();
+        }
+        mix_.resize(num_frames);
+    }
+    deinterleave(input, num_frames, num_device_channels_,
+                 plane_pointers_.data());
+
+    if (mix_down_) {
+        std::fill(mix_.begin(), mix_.begin() + num_frames, 0.0f);
+        for (uint32_t c : channels_) {
+            const float* plane = planes_[c].data();
+            for (uint32_t i = 0; i < num_frames; i++) mix_[i] += plane[i];
+        }
+        const float scale = 1.0f / channels_.size();
+        for (uint32_t i = 0; i < num_frames; i++) mix_[i] *= scale;
+    }
+    auto source = [this](uint32_t k) -> const float* {
+        return mix_down_ ? mix_.data() : planes_[channels_[k]].data();
+    };
+
+    const uint32_t n = downsample_rate_;
+    const uint32_t num_out = (group_size_ + num_frames) / n;
+    if (out.getNumRows() != num_out || out.getNumCols() != dims) {
+        out.resize(num_out, dims);
+    }
+
+    for (uint32_t k = 0; k < dims; k++) {
+        const float* src = source(k);
+        if (n == 1) {
+            for (uint32_t i = 0; i < num_frames; i++) out[i][k] = src[i];
+            continue;
+        }
+
+        double sum = group_sums_[k];
+        uint32_t size = group_size_;
+        uint32_t row = 0;
+        for (uint32_t i = 0; i < num_frames; i++) {
+            if (averaging_) {
+                sum += src[i];
+            } else if (size == 0) {
+                sum = src[i];
+            }
+            if (++size == n) {
+                out[row++][k] = averaging_ ? sum / n : sum;
+                sum = 0;
+                size = 0;
+            }
+        }
+        group_sums_[k] = sum;
+    }
+    group_size_ = (group_size_ + num_frames) % n;
+}
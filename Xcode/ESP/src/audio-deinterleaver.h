@@ -0,0 +1,93 @@
+/** @file audio-deinterleaver.h
+ *  @brief AudioDeinterleaver turns interleaved multichannel audio buffers into
+ *  blocks of multi-dimensional frames.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <GRT/GRT.h>
+
+using std::vector;
+
+/**
+ *  @brief AudioDeinterleaver converts the interleaved buffers delivered by a
+ *  sound card (L R L R ...) into a GRT::MatrixDouble with one row per output
+ *  frame and one column per selected channel.
+ *
+ *  Each buffer is first split into one planar buffer per device channel, with
+ *  SSE2 or NEON for 2 and 4 channels and a plain loop otherwise. The selected
+ *  channels are then optionally mixed down to one, and decimated by the
+ *  downsample rate, either by keeping the first of every `downsample_rate`
+ *  frames or by averaging them. Decimation carries over from one buffer to
+ *  the next, so the output rate is exact even when the buffer size isn't a
+ *  multiple of the downsample rate.
+ *
+ *  The planar buffers are allocated on the first call to process() (and again
+ *  only if the buffer size grows), so the audio thread doesn't allocate
+ *  memory for them in steady state.
+ */
+class AudioDeinterleaver {
+  public:
+    /// @param num_device_channels channels in each interleaved input frame
+    /// @param channels the device channels to output, in order; empty for all
+    /// @param downsample_rate keep one output frame per this many input frames
+    AudioDeinterleaver(uint32_t num_device_channels = 1,
+                       vector<uint32_t> channels = {},
+                       uint32_t downsample_rate = 1);
+
+    /// @brief Output the average of the selected channels as a single
+    /// dimension.
+    void setMixDown(bool mix_down) { mix_down_ = mix_down; reset(); }
+    bool getMixDown() const { return mix_down_; }
+
+    /// @brief Average each group of `downsample_rate` frames instead of
+    /// keeping the first one. Averaging attenuates content above the new
+    /// Nyquist frequency a little instead of aliasing all of it.
+    void setAveraging(bool averaging) { averaging_ = averaging; reset(); }
+    bool getAveraging() const { return averaging_; }
+
+    uint32_t getNumDeviceChannels() const { return num_device_channels_; }
+    const vector<uint32_t>& getChannels() const { return channels_; }
+    uint32_t getDownsampleRate() const { return downsample_rate_; }
+
+    /// @brief Number of columns of the output: none if the device has none
+    /// of the selected channels, even when mixing down.
+    uint32_t getNumOutputDimensions() const {
+        if (channels_.empty()) return 0;
+        return mix_down_ ? 1 : channels_.size();
+    }
+
+    /// @brief Forget the partially decimated frame carried over from the
+    /// last buffer.
+    void reset();
+
+    /// @brief Convert `num_frames` interleaved frames into `out`, which is
+    /// resized to the number of output frames (possibly zero).
+    void process(const float* input, uint32_t num_frames,
+                 GRT::MatrixDouble& out);
+
+    /// @brief Split interleaved frames into planar buffers, one per channel,
+    /// each with room for `num_frames` samples.
+    static void deinterleave(const float* input, uint32_t num_frames,
+                             uint32_t num_channels, float* const* planes);
+
+  private:
+    uint32_t num_device_channels_;
+    vector<uint32_t> channels_;
+    uint32_t downsample_rate_;
+    bool mix_down_ = false;
+    bool averaging_ = false;
+
+    // One planar buffer per device channel, plus one for the mix.
+    vector<vector<float>> planes_;
+    vector<float*> plane_pointers_;
+    vector<float> mix_;
+
+    // Decimation state carried over between buffers: the number of input
+    // frames in the current group and their sums (or first values).
+    uint32_t group_size_ = 0;
+    vector<double> group_sums_;
+};
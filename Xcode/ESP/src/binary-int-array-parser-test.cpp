@@ -0,0 +1,105 @@
+#include "binary-int-array-parser.h"
+#include "gtest/gtest.h"
+
+typedef BinaryIntArrayParser::Result Result;
+
+// Captured from the Touche sketch with REDUCTION set to REDUCE_POOL (40 bands
+// of 4 frequencies each).
+static const unsigned char kPooledPacket[] = {
+    0x00, 0xA8, 0x80, 0xB5, 0x81, 0xB6, 0x81, 0xB5, 0x81, 0xB6, 0x81, 0xB6,
+    0x81, 0xB5, 0x81, 0xB6, 0x81, 0xB5, 0x81, 0xB6, 0x81, 0xB8, 0x81, 0xBC,
+    0x81, 0xCA, 0x81, 0xE7, 0x81, 0x9F, 0x82, 0xF4, 0x82, 0xD7, 0x83, 0xAE,
+    0x84, 0xD5, 0x84, 0xBE, 0x84, 0xF0, 0x83, 0x8B, 0x83, 0xB2, 0x82, 0xF2,
+    0x81, 0xCF, 0x81, 0xBF, 0x81, 0xB8, 0x81, 0xB6, 0x81, 0xB5, 0x81, 0xB6,
+    0x81, 0xB6, 0x81, 0xB5, 0x81, 0xB6, 0x81, 0xB5, 0x81, 0xB6, 0x81, 0xB6,
+    0x81, 0xB5, 0x81, 0xB6, 0x81, 0xB5, 0x81, 0xB6, 0x81, 0xB6, 0x81, 0xE8,
+};
+static const vector<double> kPooledValues = {
+    181, 182, 181, 182, 182, 181, 182, 181, 182, 184, 188, 202, 231, 287,
+    372, 471, 558, 597, 574, 496, 395, 306, 242, 207, 191, 184, 182, 181,
+    182, 182, 181, 182, 181, 182, 182, 181, 182, 181, 182, 182,
+};
+
+// Captured from the Touche sketch with REDUCTION set to REDUCE_PEAK and a
+// NEIGHBOURHOOD of 4: the peak's index, then the 9 bins around it.
+static const unsigned char kPeakPacket[] = {
+    0x00, 0x8A, 0x80, 0xC5, 0x80, 0xA5, 0x84, 0xB9, 0x84, 0xC9, 0x84, 0xD0,
+    0x84, 0xD8, 0x84, 0xD8, 0x84, 0xD7, 0x84, 0xD3, 0x84, 0xC6, 0x84, 0x8A,
+};
+static const vector<double> kPeakValues = {
+    69, 549, 569, 585, 592, 600, 600, 599, 595, 582,
+};
+
+static vector<unsigned char> bytes(const unsigned char* begin, size_t size) {
+    return vector<unsigned char>(begin, begin + size);
+}
+
+TEST(BinaryIntArrayParserTest, ParseCapturedPackets) {
+    vector<unsigned char> buffer = bytes(kPooledPacket, sizeof(kPooledPacket));
+    vector<unsigned char> peak = bytes(kPeakPacket, sizeof(kPeakPacket));
+    buffer.insert(buffer.end(), peak.begin(), peak.end());
+
+    vector<double> values;
+    ASSERT_EQ(Result::kPacket, BinaryIntArrayParser::parse(buffer, &values));
+    ASSERT_EQ(kPooledValues, values);
+    ASSERT_EQ(Result::kPacket, BinaryIntArrayParser::parse(buffer, &values));
+    ASSERT_EQ(kPeakValues, values);
+    ASSERT_EQ(Result::kIncomplete, BinaryIntArrayParser::parse(buffer, &values));
+    ASSERT_TRUE(buffer.empty());
+}
+
+TEST(BinaryIntArrayParserTest, EncodeMatchesSketch) {
+    vector<int> values(kPeakValues.begin(), kPeakValues.end());
+    ASSERT_EQ(bytes(kPeakPacket, sizeof(kPeakPacket)),
+              BinaryIntArrayParser::encode(values));
+
+    vector<int> full(160);
+    for (int i = 0; i < 160; i++) full[i] = 1023 - i;
+    vector<unsigned char> buffer = BinaryIntArrayParser::encode(full);
+    ASSERT_EQ(4 + 2 * 160, buffer.size());
+    vector<double> parsed;
+    ASSERT_EQ(Result::kPacket, BinaryIntArrayParser::parse(buffer, &parsed));
+    ASSERT_EQ(vector<double>(full.begin(), full.end()), parsed);
+}
+
+TEST(BinaryIntArrayParserTest, PartialPacket) {
+    vector<unsigned char> packet = bytes(kPeakPacket, sizeof(kPeakPacket));
+    vector<unsigned char> buffer;
+    vector<double> values;
+    for (size_t i = 0; i + 1 < packet.size(); i++) {
+        buffer.push_back(packet[i]);
+        ASSERT_EQ(Result::kIncomplete,
+                  BinaryIntArrayParser::parse(buffer, &values));
+        ASSERT_EQ(i + 1, buffer.size());
+    }
+    buffer.push_back(packet.back());
+    ASSERT_EQ(Result::kPacket, BinaryIntArrayParser::parse(buffer, &values));
+    ASSERT_EQ(kPeakValues, values);
+}
+
+TEST(BinaryIntArrayParserTest, SkipsToPacketStart) {
+    // The tail of a packet, as when the port is opened mid-stream.
+    vector<unsigned char> buffer = { 0xB6, 0x81, 0xB5, 0x81, 0xE8 };
+    vector<double> values;
+    ASSERT_EQ(Result::kIncomplete, BinaryIntArrayParser::parse(buffer, &values));
+    ASSERT_TRUE(buffer.empty());
+
+    buffer.push_back(0x81);
+    buffer.insert(buffer.end(), kPeakPacket, kPeakPacket + sizeof(kPeakPacket));
+    ASSERT_EQ(Result::kPacket, BinaryIntArrayParser::parse(buffer, &values));
+    ASSERT_EQ(kPeakValues, values);
+}
+
+TEST(BinaryIntArrayParserTest, InvalidChecksum) {
+    vector<unsigned char> buffer = bytes(kPeakPacket, sizeof(kPeakPacket));
+    buffer[5] ^= 0x01;  // corrupt one value
+    buffer.insert(buffer.end(), kPeakPacket, kPeakPacket + sizeof(kPeakPacket));
+
+    vector<double> values;
+    ASSERT_EQ(Result::kInvalidChecksum,
+              BinaryIntArrayParser::parse(buffer, &values));
+    ASSERT_TRUE(values.empty());
+    // The next packet is unaffected.
+    ASSERT_EQ(Result::kPacket, BinaryIntArrayParser::parse(buffer, &values));
+    ASSERT_EQ(kPeakValues, values);
+}
@@ -0,0 +1,48 @@
+#include "binary-int-array-parser.h"
+
+#include <algorithm>
+
+BinaryIntArrayParser::Result BinaryIntArrayParser::parse(
+        vector<unsigned char>& buffer, vector<double>* values) {
+    // Look for the start of a packet; anything before it is noise.
+    auto start = std::find(buffer.begin(), buffer.end(), 0);
+    buffer.erase(buffer.begin(), start);
+    if (buffer.size() < 3) return Result::kIncomplete; // 0, LSB(n), MSB(n)
+
+    unsigned char checksum = buffer[1] + buffer[2];
+    uint32_t n = ((buffer[2] & 0x7F) << 7) | (buffer[1] & 0x7F);
+    if (buffer.size() < 4 + 2 * n) return Result::kIncomplete;
+
+    values->clear();
+    values->reserve(n);
+    for (uint32_t j = 3; j < 3 + 2 * n; j += 2) {
+        int LSB = buffer[j], MSB = buffer[j + 1];
+        checksum += LSB + MSB;
+        values->push_back(((MSB & 0x7F) << 7) | (LSB & 0x7F));
+    }
+    bool valid = (checksum | 0x80) == buffer[3 + 2 * n];
+    buffer.erase(buffer.begin(), buffer.begin() + (4 + 2 * n));
+    if (!valid) {
+        values->clear();
+        return Result::kInvalidChecksum;
+    }
+    return Result::kPacket;
+}
+
+vector<unsigned char> BinaryIntArrayParser::encode(const vector<int>& values) {
+    vector<unsigned char> packet;
+    packet.reserve(4 + 2 * values.size());
+    unsigned char checksum = 0;
+    auto write14 = [&](int v) {
+        unsigned char LSB = (v & 0x7F) | 0x80;
+        unsigned char MSB = ((v >> 7) & 0x7F) | 0x80;
+        packet.push_back(LSB);
+        packet.push_back(MSB);
+        checksum += LSB + MSB;
+    };
+    packet.push_back(0);
+    write14(values.size());
+    for (int v : values) write14(v);
+    packet.push_back(checksum | 0x80);
+    return packet;
+}
@@ -0,0 +1,41 @@
+/** @file binary-int-array-parser.h
+ *  @brief BinaryIntArrayParser reads the binary packets sent by the Touche
+ *  and CapacitiveSensing-MPR121-Fast Arduino sketches.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+using std::vector;
+
+/**
+ *  @brief BinaryIntArrayParser splits a stream of bytes into packets of
+ *  integers, each framed as follows:
+ *
+ *  - a zero byte, which starts the packet;
+ *  - the number of values n, as two bytes of seven bits (low bits first);
+ *  - n values between 0 and 16383, each as two bytes of seven bits;
+ *  - the sum of the previous 2n + 2 bytes, as one byte of seven bits.
+ *
+ *  Every byte but the first has its high bit set, so a zero byte is always
+ *  the start of a packet. The packet header announces n, so the number of
+ *  values may change from one packet to the next (e.g. when the sketch
+ *  reduces its frequency sweep).
+ */
+class BinaryIntArrayParser {
+  public:
+    enum class Result {
+        kIncomplete,       ///< No complete packet in the buffer yet
+        kPacket,           ///< A packet was read into `values`
+        kInvalidChecksum,  ///< A packet was dropped for its checksum
+    };
+
+    /// @brief Read (and remove) the first complete packet, if any, from the
+    /// front of `buffer`. Bytes before the start of a packet are dropped.
+    static Result parse(vector<unsigned char>& buffer, vector<double>* values);
+
+    /// @brief Frame `values` as a packet; as the sketches' SendData() does.
+    static vector<unsigned char> encode(const vector<int>& values);
+};
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <GRT/GRT.h>
+#include <functional>
 #include <set>
 #include <string>
 
@@ -49,7 +50,8 @@ class CalibrateResult {
  */
 class CalibrateProcess {
   public:
-    typedef CalibrateResult (*CalibratorCallback)(const GRT::MatrixDouble&);
+    typedef std::function<CalibrateResult(const GRT::MatrixDouble&)>
+        CalibratorCallback;
 
     /**
     Create a CalibrateProcess.
@@ -59,7 +61,8 @@ class CalibrateProcess {
     collected by the user
     @param cb: the callback to call with the data collected by the user (as a
     MatrixDouble &). Called each time the user collects or re-collects the
-    associated calibration sample.
+    associated calibration sample. A function, or e.g. a lambda that passes
+    the data on to an object (see ImuCalibration::addTo()).
     */
     CalibrateProcess(std::string name, std::string description,
                      CalibratorCallback cb)
@@ -1,5 +1,8 @@
 #include "MFCC.h"
+#include "log-importer.h"
 #include "matplotlibcpp.h"
+#include "memory-stats.h"
+#include "template-condenser.h"
 #include "training-data-manager.h"
 #include <GRT/GRT.h>
 #include <assert.h>
@@ -23,12 +26,16 @@ constexpr uint32_t DIM = 1;
 int main(int argc, char* argv[]) {
     bool draw_sample = false;
     bool load_pipeline = false;
+    uint32_t max_templates = 0;
+    const char* import_log = nullptr;
     char c;
     opterr = 0;
-    while ((c = getopt(argc, argv, "dl")) != -1) {
+    while ((c = getopt(argc, argv, "dlc:i:")) != -1) {
         switch (c) {
             case 'd': draw_sample = true; break;
             case 'l': load_pipeline = true; break;
+            case 'c': max_templates = atoi(optarg); break;
+            case 'i': import_log = optarg; break;
             default: abort();
         }
     }
@@ -58,11 +65,53 @@ int main(int argc, char* argv[]) {
 
     TrainingDataManager training_data_manager(kNumMaxLabels);
 
+    bool has_training_data = false;
+    if (!load_pipeline && import_log != nullptr) {
+        // Import the training samples from a log with the label in the first
+        // column instead.
+        LogImporter::Options import_options;
+        import_options.label_column = 0;
+        LogImporter importer(import_options);
+        importer.setProgressCallback([](double progress) {
+            std::cerr << "\rImporting " << (int) (progress * 100) << "%";
+        });
+        if (importer.load(import_log) && importer.getNumDimensions() == DIM) {
+            training_data_manager.setNumDimensions(DIM);
+            std::cerr << std::endl << "Imported "
+                      << importer.addSamplesTo(training_data_manager)
+                      << " samples, skipped "
+                      << importer.getNumSkippedLines() << " lines" << std::endl;
+            has_training_data = true;
+        } else {
+            std::cout << "Failed to import " << import_log << ": "
+                      << (importer.getErrorMessage().empty() ?
+                          "wrong number of columns" :
+                          importer.getErrorMessage()) << std::endl;
+            return -1;
+        }
+    } else if (!load_pipeline) {
+        has_training_data = training_data_manager.load(kTrainingDataFilename);
+    }
+
     if (!load_pipeline) {
         // We load the training data and train the model
-        if (training_data_manager.load(kTrainingDataFilename)) {
+        if (has_training_data) {
             auto d = training_data_manager.getSample(1, 2);
 
+            if (max_templates > 0) {
+                // Report accuracy versus cost for a range of template caps.
+                std::vector<uint32_t> caps = { 0 };
+                for (uint32_t n = 1; n < max_templates; n *= 2) {
+                    caps.push_back(n);
+                }
+                caps.push_back(max_templates);
+
+                TemplateCondenser condenser;
+                std::cout << TemplateCondenser::formatResults(
+                    condenser.crossValidate(
+                        pipeline, training_data_manager.getAllData(), caps));
+            }
+
             if (draw_sample) {
                 plt::plot(training_data_manager.getSample(1, 2).getColVector(0));
                 plt::save("./sample.png");
@@ -116,6 +165,18 @@ int main(int argc, char* argv[]) {
 
     plt::plot(x, distances1, "r.", x, distances2, "g.");
     plt::save("./prediction.png");
+
+    MemoryStats memory_stats;
+    memory_stats.update("Training samples",
+                        training_data_manager.getSampleMemoryUsage());
+    memory_stats.update("Test data", (uint64_t) test_data.getNumRows() *
+                        test_data.getNumCols() * sizeof(double));
+    memory_stats.update("Prediction results",
+                        5 * vec_size * sizeof(double));
+    memory_stats.update("MFCC tables",
+                        std::max<int64_t>(0, GRT::MFCC::getTableMemoryUsage()));
+    memory_stats.updateResidentSetSize();
+    std::cout << memory_stats.getReport();
     std::cout << "Done" << std::endl;
 
     return 0;
@@ -0,0 +1,62 @@
+#include "cross-validation.h"
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <map>
+
+// `num_per_label[l - 1]` one-row samples of label l, whose value is the
+// index of the sample in the data.
+static GRT::TimeSeriesClassificationData makeData(
+    const vector<uint32_t>& num_per_label) {
+    GRT::TimeSeriesClassificationData data;
+    data.setNumDimensions(1);
+    uint32_t index = 0;
+    for (uint32_t label = 1; label <= num_per_label.size(); label++) {
+        for (uint32_t i = 0; i < num_per_label[label - 1]; i++) {
+            GRT::MatrixDouble sample(1, 1);
+            sample[0][0] = index++;
+            data.addSample(label, sample);
+        }
+    }
+    return data;
+}
+
+TEST(CrossValidationTest, FoldsAreStratifiedAndComplete) {
+    GRT::TimeSeriesClassificationData data = makeData({ 10, 7 });
+    CrossValidation folds(data, 3);
+    ASSERT_EQ(3, folds.getNumFolds());
+    ASSERT_EQ(17, folds.getNumSamples());
+
+    std::map<uint32_t, uint32_t> times_tested;
+    for (uint32_t fold = 0; fold < folds.getNumFolds(); fold++) {
+        auto test = folds.getTestSamples(fold);
+        GRT::TimeSeriesClassificationData train = folds.getTrainingData(fold);
+        ASSERT_EQ(data.getNumSamples(), test.size() + train.getNumSamples());
+        ASSERT_EQ(1, train.getNumDimensions());
+
+        std::map<uint32_t, uint32_t> per_label;
+        for (const auto& sample : test) {
+            per_label[sample.getClassLabel()]++;
+            times_tested[(uint32_t) sample.getData()[0][0]]++;
+        }
+        // The n-th sample of each class goes to fold n % 3.
+        EXPECT_EQ(fold == 0 ? 4 : 3, per_label[1]);
+        EXPECT_EQ(fold == 0 ? 3 : 2, per_label[2]);
+    }
+
+    // Every sample is tested exactly once.
+    ASSERT_EQ(17, times_tested.size());
+    for (const auto& entry : times_tested) EXPECT_EQ(1, entry.second);
+}
+
+TEST(CrossValidationTest, UsesAtLeastTwoFolds) {
+    CrossValidation folds(makeData({ 4 }), 1);
+    ASSERT_EQ(2, folds.getNumFolds());
+}
+
+TEST(CrossValidationTest, RunsEveryJob) {
+    vector<std::atomic<uint32_t>> runs(20);
+    for (auto& r : runs) r = 0;
+    CrossValidation::runJobs(runs.size(), [&](uint32_t job) { runs[job]++; });
+    for (const auto& r : runs) EXPECT_EQ(1, r);
+}
@@ -0,0 +1,73 @@
+#include "cross-validation.h"
+
+#include <algorithm>
+#include <map>
+
+#include "task-scheduler.h"
+
+CrossValidation::CrossValidation(const GRT::TimeSeriesClassificationData& data,
+                                 uint32_t num_folds)
+        : num_folds_(std::max(num_folds, 2u)),
+          num_dimensions_(data.getNumDimensions()),
+          samples_(data.getData()),
+          fold_of_(samples_.size()) {
+    std::map<uint32_t, uint32_t> seen_per_label;
+    for (uint32_t i = 0; i < samples_.size(); i++) {
+        fold_of_[i] = seen_per_label[samples_[i].getClassLabel()]++ % num_folds_;
+    }
+}
+
+GRT::TimeSeriesClassificationData CrossValidation::getTrainingData(
+    uint32_t fold) const {
+    GRT::TimeSeriesClassificationData train;
+    train.setNumDimensions(num_dimensions_);
+    for (uint32_t i = 0; i < samples_.size(); i++) {
+        if (fold_of_[i] != fold) {
+            train.addSample(samples_[i].getClassLabel(), samples_[i].getData());
+        }
+    }
+    return train;
+}
+
+vector<GRT::TimeSeriesClassificationSample> CrossValidation::getTestSamples(
+    uint32_t fold) const {
+    vector<GRT::TimeSeriesClassificationSample> test;
+    for (uint32_t i = 0; i < samples_.size(); i++) {
+        if (fold_of_[i] == fold) test.push_back(samples_[i]);
+    }
+    return test;
+}
+
+uint32_t CrossValidation::classify(GRT::GestureRecognitionPipeline& pipeline,
+                                   const GRT::MatrixDouble& sample) {
+    std::map<uint32_t, double> likelihoods;
+    pipeline.reset();
+    for (uint32_t r = 0; r < sample.getNumRows(); r++) {
+        pipeline.predict(sample.getRowVector(r));
+        auto l = pipeline.getClassLikelihoods();
+        auto labels = pipeline.getClassLabels();
+        for (uint32_t k = 0; k < l.size() && k < labels.size(); k++) {
+            likelihoods[labels[k]] += l[k];
+        }
+    }
+
+    uint32_t predicted = 0;
+    double best = 0.0;
+    for (const auto& entry : likelihoods) {
+        if (entry.second > best) {
+            best = entry.second;
+            predicted = entry.first;
+        }
+    }
+    return predicted;
+}
+
+void CrossValidation::runJobs(uint32_t num_jobs,
+                              const std::function<void(uint32_t)>& job) {
+    vector<TaskScheduler::TaskHandle> handles;
+    for (uint32_t j = 0; j < num_jobs; j++) {
+        handles.push_back(TaskScheduler::instance().submit(
+            TaskScheduler::kBulk, [&job, j] { job(j); }));
+    }
+    for (const TaskScheduler::TaskHandle& handle : handles) handle.wait();
+}
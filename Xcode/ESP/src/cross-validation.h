@@ -0,0 +1,57 @@
+/** @file cross-validation.h
+ *  @brief CrossValidation splits training data into folds and tests copies of
+ *  a pipeline on them.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include <GRT/GRT.h>
+
+using std::vector;
+
+/**
+ *  @brief CrossValidation holds the folds that TemplateCondenser and
+ *  FeatureAblation train and test their pipelines on.
+ *
+ *  Folds are stratified and deterministic: the n-th sample of each class goes
+ *  to fold n % num_folds, so every fold has about the same share of every
+ *  class, and two runs on the same data use the same folds.
+ */
+class CrossValidation {
+  public:
+    /// @brief At least two folds are used.
+    CrossValidation(const GRT::TimeSeriesClassificationData& data,
+                    uint32_t num_folds = 5);
+
+    uint32_t getNumFolds() const { return num_folds_; }
+    uint32_t getNumSamples() const { return samples_.size(); }
+
+    /// @brief The samples of the other folds, to train on.
+    GRT::TimeSeriesClassificationData getTrainingData(uint32_t fold) const;
+
+    /// @brief The samples of `fold`, to test on.
+    vector<GRT::TimeSeriesClassificationSample> getTestSamples(
+        uint32_t fold) const;
+
+    /// @brief The label `pipeline` predicts for `sample`, with the same rule
+    /// as ofApp::scoreTrainingData(): the class with the largest likelihood
+    /// summed over the frames of the sample wins. Resets the pipeline first.
+    static uint32_t classify(GRT::GestureRecognitionPipeline& pipeline,
+                             const GRT::MatrixDouble& sample);
+
+    /// @brief Run `job(0)` to `job(num_jobs - 1)` in parallel and wait for
+    /// them. Jobs are bulk tasks, so they yield to interactive and training
+    /// work.
+    static void runJobs(uint32_t num_jobs,
+                        const std::function<void(uint32_t)>& job);
+
+  private:
+    uint32_t num_folds_;
+    uint32_t num_dimensions_;
+    vector<GRT::TimeSeriesClassificationSample> samples_;
+    vector<uint32_t> fold_of_;
+};
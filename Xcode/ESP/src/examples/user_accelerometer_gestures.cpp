@@ -98,6 +98,7 @@ TrainingSampleCheckerResult checkTrainingSample(const MatrixDouble &in)
 
 int timeout = 500; // milliseconds
 double null_rej = 0.4;
+int max_templates = 0;
 
 void updateVariability(double new_null_rej) {
     pipeline.getClassifier()->setNullRejectionCoeff(new_null_rej);
@@ -112,6 +113,10 @@ void updateTimeout(int new_timeout) {
     filter->setTimeoutDuration(new_timeout);
 }
 
+void updateMaxTemplates(int new_max_templates) {
+    useTemplateCondensation(new_max_templates);
+}
+
 void setup()
 {
     stream.setLabelsForAllDimensions({"x", "y", "z"});
@@ -131,6 +136,8 @@ void setup()
     pipeline.setClassifier(dtw);
     pipeline.addPostProcessingModule(ClassLabelTimeoutFilter(timeout));
     usePipeline(pipeline);
+    useTemplateCondensation(max_templates);
+    useAutomaticTrimming();
 
     registerTuneable(null_rej, 0.1, 5.0, "Variability",
          "How different from the training data a new gesture can be and "
@@ -140,6 +147,12 @@ void setup()
         "Timeout",
         "How long (in milliseconds) to wait after recognizing a "
         "gesture before recognizing another one.", updateTimeout);
+    registerTuneable(max_templates, 0, 30,
+        "Templates per class",
+        "How many of the recorded examples of each gesture to train on. "
+        "Similar examples are grouped together and one from each group is "
+        "kept. Fewer is faster to train; 0 uses all examples. Retrain the "
+        "model after changing this.", updateMaxTemplates);
 
     useTrainingSampleChecker(checkTrainingSample);
   
@@ -3,6 +3,8 @@
 #include <ESP.h>
 
 OscInputStream stream(8001, "/gyrosc/accel", 3);
+// Send the recognized gestures, and how likely each one is, back over OSC.
+OscOStream oStream("localhost", 8002, "/esp/label", "/esp/likelihoods");
 GestureRecognitionPipeline pipeline;
 
 int timeout = 500; // milliseconds
@@ -11,6 +13,7 @@ double null_rej = 0.4;
 void setup() {
     stream.setLabelsForAllDimensions({"x", "y", "z"});
     useInputStream(stream);
+    useOutputStream(oStream);
 
     DTW dtw(false, true, null_rej);
     dtw.enableTrimTrainingData(true, 0.1, 75);
@@ -2,6 +2,7 @@
  * Pose detection using accelerometers.
  */
 #include <ESP.h>
+#include <IncrementalANBC.h>
 
 ASCIISerialStream stream(115200, 3);
 GestureRecognitionPipeline pipeline;
@@ -106,7 +107,7 @@ void setup()
     useCalibrator(calibrator);
 
     pipeline.addFeatureExtractionModule(TimeDomainFeatures(10, 1, 3, false, true, true, false, false));
-    pipeline.setClassifier(ANBC(false, !always_pick_something, null_rej)); // use scaling, use null rejection, null rejection parameter
+    pipeline.setClassifier(IncrementalANBC(false, !always_pick_something, null_rej)); // use scaling, use null rejection, null rejection parameter
     // null rejection parameter is multiplied by the standard deviation to determine
     // the rejection threshold. the higher the number, the looser the filter; the
     // lower the number, the tighter the filter.
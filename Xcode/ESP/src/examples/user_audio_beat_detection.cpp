@@ -1,56 +1,35 @@
 /** @example user_audio_beat.cpp
  * Audio beat detection example. Based on: http://archive.gamedev.net/archive/reference/programming/features/beatdetection/
+ *
+ * The spectrum comes from a SlidingDFT, which updates a few log-spaced bins
+ * with every audio sample, so a beat is reported within a hop (~3 ms) rather
+ * than a whole 1024-sample FFT frame (~23 ms) later.
  */
 #include <ESP.h>
+#include <SlidingDFT.h>
 
-//AudioStream stream(1);
-AudioFileStream stream("train1.wav", true);
+// Audio defaults to 44.1k sampling rate; keep every fourth sample.
+constexpr uint32_t kDownsampleRate = 4;
+constexpr uint32_t kSampleRate = 44100 / kDownsampleRate;
+
+AudioStream stream(kDownsampleRate);
 GestureRecognitionPipeline pipeline;
 TcpOStream oStream("localhost", 5204);
 ASCIISerialStream oStream2(0, 9600, 3);
 
-// Audio defaults to 44.1k sampling rate.
-uint32_t kFFT_WindowSize = 1024;
-uint32_t kFFT_HopSize = 1024;
+// 256 samples => 23 ms window, bins 43 Hz apart; a spectrum every 32 samples.
+uint32_t kSDFT_WindowSize = 256;
+uint32_t kSDFT_HopSize = 32;
 uint32_t DIM = 1;
-uint32_t BINS;
-uint32_t BIN_WIDTH_START = 2;
-uint32_t BIN_WIDTH_DELTA = 4;
-uint32_t HISTORY = 43;
+// One bin per band, from 43 Hz to 3.9 kHz, each band about 1.5 times as high
+// as the one before.
+vector<uint32_t> kSDFT_Bins = { 1, 2, 3, 5, 8, 12, 18, 27, 40, 60, 90 };
+uint32_t BINS = kSDFT_Bins.size();
+// One second of spectra.
+uint32_t HISTORY = kSampleRate / kSDFT_HopSize;
 
 double C = 2.0;
 
-VectorDouble increasingBinWidths(VectorDouble in) {
-    VectorDouble out;
-    int bin_width = BIN_WIDTH_START;
-    int i = 0;
-    while (i < in.size()) {
-        double val = 0;
-        if (i + bin_width >= in.size()) bin_width = in.size() - i;
-        for (int j = 0; j < bin_width; j++) {
-            val += in[i + j];
-        }
-        out.push_back(val / bin_width);
-        i += bin_width;
-        bin_width *= BIN_WIDTH_DELTA;
-    }
-    return out;
-}
-
-int getNumIncreasingBins(int in_size) {
-    int bin_width = BIN_WIDTH_START;
-    int i = 0, out_size = 0;
-    while (i < in_size) {
-        out_size++;
-        if (i + bin_width >= in_size) bin_width = in_size - i;
-        std::cout << "Bin " << out_size << ": band " << i << " (" << 44100.0 / 1024 * i << " Hz)" << " to ";
-        i += bin_width;
-        std::cout << "band " << (i - 1) << " (" << 44100.0 / 1024 * (i - 1) << " Hz)" << std::endl;
-        bin_width *= BIN_WIDTH_DELTA;
-    }
-    return out_size;
-}
-
 VectorDouble meanAndLast(VectorDouble in) {
     VectorDouble out(BINS * 2);
     
@@ -83,12 +62,13 @@ void setup() {
     useOutputStream(oStream);
     useOutputStream(oStream2);
     
-//    pipeline.addFeatureExtractionModule(
-//        FFT(kFFT_WindowSize, kFFT_HopSize,
-//            DIM, FFT::RECTANGULAR_WINDOW, true, false));
-    
-    BINS = getNumIncreasingBins(kFFT_WindowSize / 2);
-    pipeline.addFeatureExtractionModule(FeatureApply(kFFT_WindowSize / 2, BINS, increasingBinWidths));
+    for (uint32_t bin : kSDFT_Bins) {
+        std::cout << "Band at " << 1.0 * kSampleRate / kSDFT_WindowSize * bin
+                  << " Hz" << std::endl;
+    }
+    pipeline.addFeatureExtractionModule(
+        SlidingDFT(kSDFT_WindowSize, kSDFT_HopSize, DIM,
+                   SlidingDFT::HANNING_WINDOW, kSDFT_Bins));
     pipeline.addFeatureExtractionModule(TimeseriesBuffer(HISTORY, BINS));
     pipeline.addFeatureExtractionModule(FeatureApply(BINS * HISTORY,BINS * 2,meanAndLast));
     pipeline.addFeatureExtractionModule(FeatureApply(BINS * 2, BINS, detectBeat));
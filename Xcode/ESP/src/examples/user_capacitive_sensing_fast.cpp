@@ -0,0 +1,20 @@
+/** @example user_capacitive_sensing_fast.cpp
+ * Capacitve sensing at a high rate, for use with the
+ * CapacitiveSensing-MPR121-Fast Arduino sketch.
+ */
+#include <ESP.h>
+#include <IncrementalANBC.h>
+
+BinaryIntArraySerialStream stream(115200, 12);
+GestureRecognitionPipeline pipeline;
+
+void setup() {
+    useStream(stream);
+
+    // The sketch sends a reading about every millisecond, so smooth over a
+    // few of them.
+    pipeline.addPreProcessingModule(MovingAverageFilter(10, 12));
+    pipeline.setClassifier(IncrementalANBC(false, true, 10.0)); // use scaling, use null rejection, null rejection parameter
+
+    usePipeline(pipeline);
+}
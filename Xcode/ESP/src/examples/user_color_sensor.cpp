@@ -2,6 +2,7 @@
  * Color sensing. See <a href="https://github.com/damellis/ESP/wiki/%5BExample%5D-Color-Detection">documentation on the wiki</a>.
  */
 #include <ESP.h>
+#include <IncrementalANBC.h>
 
 // Normalize by dividing each dimension by the total magnitude.
 // Also add the magnitude as an additional feature.
@@ -40,7 +41,7 @@ void setup() {
 
     pipeline.addPreProcessingModule(MovingAverageFilter(5, 3));
     // use scaling, use null rejection, null rejection parameter
-    pipeline.setClassifier(ANBC(false, !always_pick_something, null_rej));
+    pipeline.setClassifier(IncrementalANBC(false, !always_pick_something, null_rej));
 
     // null rejection parameter is multiplied by the standard deviation to determine
     // the rejection threshold. the higher the number, the looser the filter; the
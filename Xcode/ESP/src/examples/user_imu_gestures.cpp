@@ -0,0 +1,52 @@
+/** @example user_imu_gestures.cpp
+ * Gesture recognition from an accelerometer and gyroscope. Upload
+ * Arduino101_IMU to an Arduino 101, which streams both at 100 Hz.
+ *
+ * Rather than the raw axes, the classifier gets the motion with gravity
+ * removed and the tilt of the board, from OrientationFusion, so gestures are
+ * recognized regardless of how the board is held when they start.
+ */
+#include <ESP.h>
+#include <OrientationFusion.h>
+#include <imu-calibration.h>
+
+constexpr double kSampleRate = 100;
+
+ASCIISerialStream stream(115200, 6);
+GestureRecognitionPipeline pipeline;
+Calibrator calibrator;
+TcpOStream oStream("localhost", 5204);
+
+// The CurieImu's default ranges: 2 g and 2000 degrees per second.
+ImuCalibration imu_calibration(16384, 16.4);
+
+double null_rej = 0.4;
+
+void updateVariability(double new_null_rej) {
+    pipeline.getClassifier()->setNullRejectionCoeff(new_null_rej);
+    pipeline.getClassifier()->recomputeNullRejectionThresholds();
+}
+
+void setup() {
+    stream.setLabelsForAllDimensions({"ax", "ay", "az", "gx", "gy", "gz"});
+    useInputStream(stream);
+    useOutputStream(oStream);
+
+    // Measures the gyroscope's bias and converts readings to g and degrees
+    // per second, as OrientationFusion expects.
+    imu_calibration.addTo(calibrator, "Rest",
+        "Put the board down and keep it still.");
+    useCalibrator(calibrator);
+
+    pipeline.addPreProcessingModule(OrientationFusion(
+        kSampleRate,
+        OrientationFusion::LINEAR_ACCELERATION | OrientationFusion::TILT));
+    pipeline.setClassifier(DTW(false, true, null_rej));
+    pipeline.addPostProcessingModule(ClassLabelTimeoutFilter(500));
+    usePipeline(pipeline);
+
+    registerTuneable(null_rej, 0.1, 5.0, "Variability",
+         "How different from the training data a new gesture can be and "
+         "still be considered the same gesture. The higher the number, the "
+         "more different it can be.", updateVariability);
+}
@@ -3,6 +3,7 @@
  */
 #include <ESP.h>
 #include <MFCC.h>
+#include <MajorityVoteFilter.h>
 
 constexpr uint32_t kDownsample = 5;
 constexpr uint32_t kSampleRate = 44100 / 5;  // 8820
@@ -50,24 +51,26 @@ void setup() {
     //         sample_rate = kSampleRate
     //         frame_size  = kFftHopSize
     // m = n * post_ratio
-    int num_predictions = post_duration / 1000 * kSampleRate / kFftHopSize;
-    pipeline.addPostProcessingModule(
-            ClassLabelFilter(num_predictions * post_ratio, num_predictions));
-
-    auto ratio_updater = [](double new_ratio) {
-        ClassLabelFilter* filter =
-            dynamic_cast<ClassLabelFilter*>(pipeline.getPostProcessingModule(0));
-        // Recalculate num_predictions as post_duration might have been changed
-        int num_predictions = post_duration / 1000 * kSampleRate / kFftHopSize;
-        filter->setMinimumCount(new_ratio * num_predictions);
+    //
+    // MajorityVoteFilter keeps its recent predictions when resized, so the
+    // tuneables below can change n without dropping the current vote.
+    auto num_predictions = []() {
+        return std::max(1u, post_duration * kSampleRate / 1000 / kFftHopSize);
+    };
+    pipeline.addPostProcessingModule(MajorityVoteFilter(
+        num_predictions() * post_ratio, num_predictions()));
+
+    auto ratio_updater = [num_predictions](double new_ratio) {
+        MajorityVoteFilter* filter = dynamic_cast<MajorityVoteFilter*>(
+            pipeline.getPostProcessingModule(0));
+        filter->setMinimumCount(new_ratio * num_predictions());
     };
 
-    auto duration_updater = [](int new_duration) {
-        ClassLabelFilter* filter =
-            dynamic_cast<ClassLabelFilter*>(pipeline.getPostProcessingModule(0));
-        // Recalculate num_predictions as post_duration might have been changed
-        int num_predictions = post_duration / 1000 * kSampleRate / kFftHopSize;
-        filter->setBufferSize(num_predictions);
+    auto duration_updater = [num_predictions](int new_duration) {
+        MajorityVoteFilter* filter = dynamic_cast<MajorityVoteFilter*>(
+            pipeline.getPostProcessingModule(0));
+        filter->setBufferSize(num_predictions());
+        filter->setMinimumCount(post_ratio * num_predictions());
     };
 
     auto noise_updater = [](int new_noise_level) {
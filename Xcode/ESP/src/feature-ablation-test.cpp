@@ -0,0 +1,93 @@
+#include "feature-ablation.h"
+#include "DimensionSelector.h"
+#include "gtest/gtest.h"
+
+#include <cmath>
+#include <random>
+
+static const uint32_t kDim = 3;
+
+// Only dimension 0 tells the classes apart; 1 and 2 are the same noise for
+// every class.
+static GRT::TimeSeriesClassificationData makeData(uint32_t samples_per_class) {
+    std::mt19937 rng(1);
+    std::normal_distribution<double> noise(0, 0.05);
+    GRT::TimeSeriesClassificationData data(kDim);
+    for (uint32_t i = 0; i < samples_per_class; i++) {
+        for (uint32_t label = 1; label <= 3; label++) {
+            GRT::MatrixDouble sample;
+            for (uint32_t t = 0; t < 20; t++) {
+                GRT::VectorDouble x(kDim);
+                x[0] = std::sin(0.2 * label * t) + noise(rng);
+                x[1] = 2 * noise(rng);
+                x[2] = 2 * noise(rng);
+                sample.push_back(x);
+            }
+            data.addSample(label, sample);
+        }
+    }
+    return data;
+}
+
+TEST(FeatureAblationTest, EachDimension) {
+    auto groups = FeatureAblation::eachDimension(2, {"x", "y"});
+    ASSERT_EQ(2, groups.size());
+    ASSERT_EQ("y", groups[1].name);
+    ASSERT_EQ(vector<uint32_t>({1}), groups[1].dimensions);
+
+    // Labels that don't cover every dimension aren't used.
+    groups = FeatureAblation::eachDimension(2, {"x"});
+    ASSERT_EQ("dim 0", groups[0].name);
+}
+
+TEST(FeatureAblationTest, FindsTheInformativeDimension) {
+    GRT::TimeSeriesClassificationData data = makeData(5);
+    GRT::GestureRecognitionPipeline pipeline;
+    pipeline.setClassifier(GRT::DTW());
+
+    for (auto method : { FeatureAblation::Method::kDrop,
+                         FeatureAblation::Method::kPermute }) {
+        FeatureAblation ablation(method);
+        FeatureAblation::Report report = ablation.analyze(
+            pipeline, data, FeatureAblation::eachDimension(kDim));
+        ASSERT_GT(report.baseline_accuracy, 0.9);
+        ASSERT_EQ(kDim, report.results.size());
+        ASSERT_GT(report.results[0].contribution, 0.3);
+        ASSERT_LT(report.results[1].contribution,
+                  report.results[0].contribution);
+        ASSERT_LT(report.results[2].contribution,
+                  report.results[0].contribution);
+        ASSERT_EQ(vector<uint32_t>({0}),
+                  FeatureAblation::selectDimensions(report, kDim, 0.2));
+    }
+}
+
+TEST(FeatureAblationTest, SelectDimensionsKeepsUngroupedDimensions) {
+    FeatureAblation::Report report;
+    report.results.push_back({ { "a", { 0, 1 } }, 0.5, 0.4 });
+    report.results.push_back({ { "b", { 2 } }, 0.9, 0.0 });
+    ASSERT_EQ(vector<uint32_t>({0, 1, 3}),
+              FeatureAblation::selectDimensions(report, 4));
+    ASSERT_EQ(vector<uint32_t>({3}),
+              FeatureAblation::selectDimensions(report, 4, 0.5));
+}
+
+TEST(DimensionSelectorTest, SelectsInOrder) {
+    GRT::DimensionSelector selector({2, 0}, 4);
+    ASSERT_EQ(4, selector.getNumInputDimensions());
+    ASSERT_EQ(2, selector.getNumOutputDimensions());
+    ASSERT_TRUE(selector.process({1, 2, 3, 4}));
+    ASSERT_EQ(GRT::VectorDouble({3, 1}), selector.getProcessedData());
+
+    // Input of the wrong size, and dimensions out of range, are refused.
+    ASSERT_FALSE(selector.process({1, 2}));
+    ASSERT_FALSE(selector.setDimensions({4}, 4));
+}
+
+TEST(DimensionSelectorTest, WorksInAPipeline) {
+    GRT::GestureRecognitionPipeline pipeline;
+    pipeline.addPreProcessingModule(GRT::DimensionSelector({0}, kDim));
+    pipeline.setClassifier(GRT::DTW());
+    ASSERT_TRUE(pipeline.train(makeData(3)));
+    ASSERT_EQ(kDim, pipeline.getInputVectorDimensionsSize());
+}
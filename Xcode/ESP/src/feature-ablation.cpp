@@ -0,0 +1,198 @@
+#include "feature-ablation.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <sstream>
+
+#include "cross-validation.h"
+
+namespace {
+
+// Set `dimensions` of every row of `m` to zero.
+void zero(GRT::MatrixDouble& m, const vector<uint32_t>& dimensions) {
+    for (uint32_t r = 0; r < m.getNumRows(); r++) {
+        for (uint32_t d : dimensions) m[r][d] = 0.0;
+    }
+}
+
+// Shuffle the values of `dimensions` among all rows of `samples`; the values
+// of one row move together.
+void permute(vector<GRT::MatrixDouble>& samples,
+             const vector<uint32_t>& dimensions, uint32_t seed) {
+    vector<vector<double>> values;
+    for (const GRT::MatrixDouble& m : samples) {
+        for (uint32_t r = 0; r < m.getNumRows(); r++) {
+            vector<double> v;
+            for (uint32_t d : dimensions) v.push_back(m[r][d]);
+            values.push_back(v);
+        }
+    }
+    std::mt19937 rng(seed);
+    std::shuffle(values.begin(), values.end(), rng);
+
+    uint32_t i = 0;
+    for (GRT::MatrixDouble& m : samples) {
+        for (uint32_t r = 0; r < m.getNumRows(); r++, i++) {
+            for (uint32_t k = 0; k < dimensions.size(); k++) {
+                m[r][dimensions[k]] = values[i][k];
+            }
+        }
+    }
+}
+
+}  // namespace
+
+vector<FeatureAblation::Group> FeatureAblation::eachDimension(
+    uint32_t num_dimensions, const vector<string>& labels) {
+    vector<Group> groups;
+    for (uint32_t d = 0; d < num_dimensions; d++) {
+        string name = labels.size() == num_dimensions ?
+            labels[d] : "dim " + std::to_string(d);
+        groups.push_back({ name, { d } });
+    }
+    return groups;
+}
+
+FeatureAblation::FeatureAblation(Method method, uint32_t num_folds)
+        : method_(method), num_folds_(std::max(num_folds, 2u)) {
+}
+
+FeatureAblation::Report FeatureAblation::analyze(
+    const GRT::GestureRecognitionPipeline& pipeline,
+    const GRT::TimeSeriesClassificationData& data,
+    const vector<Group>& groups) const {
+    CrossValidation folds(data, num_folds_);
+    const uint32_t num_folds = folds.getNumFolds();
+
+    // Dimensions that don't exist are ignored. Variant 0 is the baseline,
+    // with nothing taken away, and variant g + 1 is without groups[g].
+    vector<vector<uint32_t>> variants(1);
+    for (const Group& group : groups) {
+        vector<uint32_t> dimensions;
+        for (uint32_t d : group.dimensions) {
+            if (d < data.getNumDimensions()) dimensions.push_back(d);
+        }
+        variants.push_back(dimensions);
+    }
+
+    // With kPermute, every variant of a fold is tested on the same trained
+    // pipeline. Copies of it are made one at a time (see
+    // ofApp::scoreTrainingData()).
+    struct Trained {
+        std::unique_ptr<GRT::GestureRecognitionPipeline> pipeline;
+        std::mutex mutex;
+    };
+    vector<Trained> trained(num_folds);
+    if (method_ == Method::kPermute) {
+        CrossValidation::runJobs(num_folds, [&](uint32_t fold) {
+            std::unique_ptr<GRT::GestureRecognitionPipeline> p(
+                new GRT::GestureRecognitionPipeline(pipeline));
+            if (p->train(folds.getTrainingData(fold))) {
+                trained[fold].pipeline = std::move(p);
+            }
+        });
+    }
+
+    const uint32_t num_jobs = variants.size() * num_folds;
+    vector<uint32_t> num_correct(num_jobs, 0);
+
+    CrossValidation::runJobs(num_jobs, [&](uint32_t job) {
+        uint32_t fold = job % num_folds;
+        const vector<uint32_t>& dimensions = variants[job / num_folds];
+
+        vector<GRT::MatrixDouble> test;
+        vector<uint32_t> test_labels;
+        for (const auto& sample : folds.getTestSamples(fold)) {
+            test.push_back(sample.getData());
+            test_labels.push_back(sample.getClassLabel());
+        }
+
+        // A pipeline that fails to train gets nothing right, so the group is
+        // credited with the whole baseline accuracy and kept.
+        std::unique_ptr<GRT::GestureRecognitionPipeline> p;
+        if (method_ == Method::kDrop) {
+            GRT::TimeSeriesClassificationData train =
+                folds.getTrainingData(fold);
+            for (uint32_t i = 0; i < train.getNumSamples(); i++) {
+                zero(train[i].getData(), dimensions);
+            }
+            p.reset(new GRT::GestureRecognitionPipeline(pipeline));
+            if (!p->train(train)) return;
+            for (GRT::MatrixDouble& m : test) zero(m, dimensions);
+        } else {
+            std::lock_guard<std::mutex> lock(trained[fold].mutex);
+            if (!trained[fold].pipeline) return;
+            p.reset(new GRT::GestureRecognitionPipeline(
+                *trained[fold].pipeline));
+            if (!dimensions.empty()) permute(test, dimensions, job);
+        }
+
+        for (uint32_t i = 0; i < test.size(); i++) {
+            if (CrossValidation::classify(*p, test[i]) == test_labels[i]) {
+                num_correct[job]++;
+            }
+        }
+    });
+
+    // Samples that failed to be tested count as wrong.
+    uint32_t num_test_samples = folds.getNumSamples();
+    auto accuracy = [&](uint32_t variant) {
+        uint32_t correct = 0;
+        for (uint32_t f = 0; f < num_folds; f++) {
+            correct += num_correct[variant * num_folds + f];
+        }
+        return num_test_samples == 0 ? 0.0 : double(correct) / num_test_samples;
+    };
+
+    Report report;
+    report.baseline_accuracy = accuracy(0);
+    for (uint32_t g = 0; g < groups.size(); g++) {
+        double a = accuracy(g + 1);
+        report.results.push_back({ groups[g], a, report.baseline_accuracy - a });
+    }
+    return report;
+}
+
+vector<uint32_t> FeatureAblation::selectDimensions(const Report& report,
+                                                   uint32_t num_dimensions,
+                                                   double min_contribution) {
+    vector<bool> in_group(num_dimensions, false), keep(num_dimensions, false);
+    for (const Result& r : report.results) {
+        for (uint32_t d : r.group.dimensions) {
+            if (d >= num_dimensions) continue;
+            in_group[d] = true;
+            if (r.contribution > min_contribution) keep[d] = true;
+        }
+    }
+
+    vector<uint32_t> selected;
+    for (uint32_t d = 0; d < num_dimensions; d++) {
+        if (keep[d] || !in_group[d]) selected.push_back(d);
+    }
+    return selected;
+}
+
+string FeatureAblation::formatReport(const Report& report) {
+    vector<Result> results = report.results;
+    std::stable_sort(results.begin(), results.end(),
+                     [](const Result& a, const Result& b) {
+                         return a.contribution > b.contribution;
+                     });
+
+    std::ostringstream ss;
+    ss << std::fixed << std::setprecision(3);
+    ss << "baseline accuracy " << report.baseline_accuracy << std::endl;
+    ss << std::setw(20) << "group" << std::setw(8) << "dims"
+       << std::setw(10) << "accuracy" << std::setw(14) << "contribution"
+       << std::endl;
+    for (const Result& r : results) {
+        ss << std::setw(20) << r.group.name
+           << std::setw(8) << r.group.dimensions.size()
+           << std::setw(10) << r.accuracy
+           << std::setw(14) << r.contribution << std::endl;
+    }
+    return ss.str();
+}
@@ -0,0 +1,98 @@
+/** @file feature-ablation.h
+ *  @brief FeatureAblation measures how much each input dimension (or group of
+ *  dimensions) contributes to a pipeline's accuracy.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <GRT/GRT.h>
+
+using std::string;
+using std::vector;
+
+/**
+ *  @brief FeatureAblation cross-validates a pipeline on the training data
+ *  with each group of dimensions taken away in turn, and reports how much
+ *  accuracy each group is worth.
+ *
+ *  Many setups stream more dimensions than the model needs: all 12 MPR121
+ *  electrodes, 160 Touche bins, 6 IMU axes. Every extra dimension costs
+ *  parsing, filtering and classifier time. Dimensions whose removal doesn't
+ *  lower the accuracy can be pruned with selectDimensions(), either in the
+ *  pipeline (with a GRT::DimensionSelector in front) or in the stream (with
+ *  InputStream::useDimensions()).
+ *
+ *  A group is taken away in one of two ways:
+ *    1. kDrop: the group's values are set to zero, in the training and the
+ *       test samples, and the pipeline is retrained for every group. This is
+ *       what pruning the group would do. The dimensions are zeroed rather
+ *       than removed, as the pipeline's modules expect a fixed number of them.
+ *    2. kPermute: the pipeline is trained once per fold on the intact data,
+ *       and the group's values are shuffled among the frames of the test
+ *       samples. This is much cheaper, but credits correlated dimensions less
+ *       than dropping them would.
+ *
+ *  The contribution of a group is the baseline accuracy minus the accuracy
+ *  without the group. The folds are those of CrossValidation, as in
+ *  TemplateCondenser::crossValidate(); (group, fold) pairs run in parallel on
+ *  copies of the pipeline.
+ */
+class FeatureAblation {
+  public:
+    enum class Method {
+        kDrop,
+        kPermute,
+    };
+
+    /// @brief A set of dimensions that are taken away together, e.g. the
+    /// three axes of an accelerometer.
+    struct Group {
+        string name;
+        vector<uint32_t> dimensions;
+    };
+
+    /// @brief One group per dimension, named after `labels` if there is a
+    /// label for every dimension (see InputStream::getLabels()).
+    static vector<Group> eachDimension(uint32_t num_dimensions,
+                                       const vector<string>& labels = {});
+
+    struct Result {
+        Group group;
+        double accuracy;      // fraction of test samples correct without it
+        double contribution;  // baseline accuracy minus accuracy
+    };
+
+    struct Report {
+        double baseline_accuracy = 0.0;
+        vector<Result> results;  // in the order of the groups
+    };
+
+    FeatureAblation(Method method = Method::kDrop, uint32_t num_folds = 5);
+
+    void setMethod(Method method) { method_ = method; }
+    Method getMethod() const { return method_; }
+
+    /// @brief Cross-validate `pipeline` on `data` without each of `groups`.
+    Report analyze(const GRT::GestureRecognitionPipeline& pipeline,
+                   const GRT::TimeSeriesClassificationData& data,
+                   const vector<Group>& groups) const;
+
+    /// @brief The dimensions (of `num_dimensions`) worth keeping: those of
+    /// every group that contributes more than `min_contribution`, and those
+    /// that are in no group at all. In increasing order.
+    static vector<uint32_t> selectDimensions(const Report& report,
+                                             uint32_t num_dimensions,
+                                             double min_contribution = 0.0);
+
+    /// @brief Format the output of analyze() as a table, with the groups that
+    /// contribute most first.
+    static string formatReport(const Report& report);
+
+  private:
+    Method method_;
+    uint32_t num_folds_;
+};
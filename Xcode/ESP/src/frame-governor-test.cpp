@@ -0,0 +1,56 @@
+#include "frame-governor.h"
+#include "gtest/gtest.h"
+
+static const double kBudget = 10;
+
+TEST(FrameGovernorTest, DisabledWithoutBudget) {
+    FrameGovernor governor;
+    for (uint32_t i = 0; i < 1000; i++) governor.endFrame(50, 50);
+    ASSERT_EQ(FrameGovernor::kFull, governor.getLevel());
+    ASSERT_EQ(0, governor.getDeadlineMisses());
+    ASSERT_EQ("", governor.getSummary());
+}
+
+TEST(FrameGovernorTest, ShedsWorkInOrder) {
+    FrameGovernor governor(kBudget);
+    for (uint32_t i = 0; i < 100; i++) governor.endFrame(4, 4);
+    ASSERT_EQ(FrameGovernor::kFull, governor.getLevel());
+    ASSERT_EQ(0, governor.getDeadlineMisses());
+
+    // Each kEscalateFrames frames over budget sheds one more level.
+    for (uint32_t i = 0; i < 2 * FrameGovernor::kEscalateFrames; i++) {
+        governor.endFrame(10, 10);
+    }
+    ASSERT_EQ(FrameGovernor::kNoFeaturePlots, governor.getLevel());
+    ASSERT_FALSE(governor.shouldUpdateFeaturePlots());
+    ASSERT_TRUE(governor.shouldUpdatePipelinePlots());
+
+    for (uint32_t i = 0; i < 10 * FrameGovernor::kEscalateFrames; i++) {
+        governor.endFrame(10, 10);
+    }
+    ASSERT_EQ(FrameGovernor::kReducedDrawRate, governor.getLevel());
+    ASSERT_FALSE(governor.shouldUpdatePredictionPlots());
+    ASSERT_TRUE(governor.shouldReduceDrawRate());
+    ASSERT_EQ(12 * FrameGovernor::kEscalateFrames,
+              governor.getDeadlineMisses());
+}
+
+TEST(FrameGovernorTest, RecoversWhenWellUnderBudget) {
+    FrameGovernor governor(kBudget);
+    for (uint32_t i = 0; i < 4 * FrameGovernor::kEscalateFrames; i++) {
+        governor.endFrame(20, 0);
+    }
+    FrameGovernor::Level level = governor.getLevel();
+    ASSERT_GT(level, FrameGovernor::kFull);
+
+    // Just under budget is not enough to resume shed work.
+    for (uint32_t i = 0; i < 4 * FrameGovernor::kRecoverFrames; i++) {
+        governor.endFrame(8, 0);
+    }
+    ASSERT_EQ(level, governor.getLevel());
+
+    for (uint32_t i = 0; i < 10 * FrameGovernor::kRecoverFrames; i++) {
+        governor.endFrame(2, 0);
+    }
+    ASSERT_EQ(FrameGovernor::kFull, governor.getLevel());
+}
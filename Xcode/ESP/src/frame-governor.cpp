@@ -0,0 +1,76 @@
+#include "frame-governor.h"
+
+#include <cstdio>
+
+// Weight of the newest frame in the moving average of frame times.
+static const double kSmoothing = 0.1;
+
+// The average must drop below this fraction of the budget before work that
+// was shed is resumed.
+static const double kRecoverRatio = 0.6;
+
+const uint32_t FrameGovernor::kEscalateFrames;
+const uint32_t FrameGovernor::kRecoverFrames;
+
+FrameGovernor::FrameGovernor(double budget_ms) : budget_ms_(budget_ms) {
+    reset();
+}
+
+void FrameGovernor::setBudget(double budget_ms) {
+    budget_ms_ = budget_ms;
+    reset();
+}
+
+void FrameGovernor::reset() {
+    average_ms_ = 0;
+    level_ = kFull;
+    frames_over_ = 0;
+    frames_under_ = 0;
+    deadline_misses_ = 0;
+    num_frames_ = 0;
+}
+
+void FrameGovernor::endFrame(double update_ms, double draw_ms) {
+    if (budget_ms_ <= 0) return;
+
+    double frame_ms = update_ms + draw_ms;
+    average_ms_ = num_frames_ == 0 ?
+        frame_ms : (1 - kSmoothing) * average_ms_ + kSmoothing * frame_ms;
+    num_frames_++;
+    if (frame_ms > budget_ms_) deadline_misses_++;
+
+    if (average_ms_ > budget_ms_) {
+        frames_under_ = 0;
+        if (++frames_over_ >= kEscalateFrames && level_ < kReducedDrawRate) {
+            level_ = static_cast<Level>(level_ + 1);
+            frames_over_ = 0;
+        }
+    } else if (average_ms_ < kRecoverRatio * budget_ms_) {
+        frames_over_ = 0;
+        if (++frames_under_ >= kRecoverFrames && level_ > kFull) {
+            level_ = static_cast<Level>(level_ - 1);
+            frames_under_ = 0;
+        }
+    } else {
+        frames_over_ = 0;
+        frames_under_ = 0;
+    }
+}
+
+std::string FrameGovernor::getSummary() const {
+    if (budget_ms_ <= 0) return "";
+
+    static const char* kShedding[] = {
+        "",
+        ", skipping feature plots",
+        ", skipping feature and pipeline plots",
+        ", skipping feature, pipeline and prediction plots",
+        ", skipping plots, reduced draw rate",
+    };
+
+    char buf[160];
+    snprintf(buf, sizeof(buf), "Frame %.1f/%.1f ms, %llu missed%s",
+             average_ms_, budget_ms_, (unsigned long long) deadline_misses_,
+             kShedding[level_]);
+    return buf;
+}
@@ -0,0 +1,79 @@
+/** @file frame-governor.h
+ *  @brief FrameGovernor keeps the GUI within a per-frame time budget by
+ *  shedding optional work.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+/**
+ *  @brief FrameGovernor compares the time spent on each frame (processing
+ *  the input in update() plus draw()) against a budget and decides which
+ *  optional work to skip when the app falls behind.
+ *
+ *  Work is shed in levels, each one including the previous ones:
+ *    1. kNoFeaturePlots: stop updating the live feature plots.
+ *    2. kNoPipelinePlots: stop updating the per-stage plots of the PIPELINE
+ *       tab.
+ *    3. kNoPredictionPlots: stop updating the class likelihood and distance
+ *       plots.
+ *    4. kReducedDrawRate: redraw the window only every few frames.
+ *
+ *  Prediction and output streams are never shed. The level goes up when the
+ *  average frame time stays over budget for kEscalateFrames frames, and back
+ *  down once it stays well under budget for kRecoverFrames frames; the gap
+ *  between the two keeps the governor from oscillating.
+ */
+class FrameGovernor {
+  public:
+    enum Level {
+        kFull = 0,
+        kNoFeaturePlots,
+        kNoPipelinePlots,
+        kNoPredictionPlots,
+        kReducedDrawRate,
+    };
+
+    /// @brief A budget of zero disables the governor.
+    explicit FrameGovernor(double budget_ms = 0);
+
+    void setBudget(double budget_ms);
+    double getBudget() const { return budget_ms_; }
+
+    /// @brief Record the time spent on the last frame.
+    void endFrame(double update_ms, double draw_ms);
+
+    /// @brief Forget the timing history and go back to kFull.
+    void reset();
+
+    Level getLevel() const { return level_; }
+    bool shouldUpdateFeaturePlots() const { return level_ < kNoFeaturePlots; }
+    bool shouldUpdatePipelinePlots() const { return level_ < kNoPipelinePlots; }
+    bool shouldUpdatePredictionPlots() const {
+        return level_ < kNoPredictionPlots;
+    }
+    bool shouldReduceDrawRate() const { return level_ >= kReducedDrawRate; }
+
+    /// @brief Number of frames that took longer than the budget.
+    uint64_t getDeadlineMisses() const { return deadline_misses_; }
+    uint64_t getNumFrames() const { return num_frames_; }
+    double getAverageFrameTime() const { return average_ms_; }
+
+    /// @brief One line for the status area, e.g.
+    /// "Frame 41.2/33.3 ms, 17 missed, skipping feature plots".
+    std::string getSummary() const;
+
+    static const uint32_t kEscalateFrames = 10;
+    static const uint32_t kRecoverFrames = 120;
+
+  private:
+    double budget_ms_;
+    double average_ms_;
+    Level level_;
+    uint32_t frames_over_;
+    uint32_t frames_under_;
+    uint64_t deadline_misses_;
+    uint64_t num_frames_;
+};
@@ -0,0 +1,69 @@
+#include "imu-calibration.h"
+#include "gtest/gtest.h"
+
+#include <random>
+
+// `rows` readings of a sensor at rest, tilted so that gravity is spread over
+// all three axes, in CurieImu units.
+static GRT::MatrixDouble restData(uint32_t rows, double gyro_noise) {
+    std::mt19937 rng(1);
+    std::normal_distribution<double> noise(0, gyro_noise);
+    GRT::MatrixDouble data;
+    for (uint32_t i = 0; i < rows; i++) {
+        data.push_back({ 8000, -9000, 11000,
+                         50 + noise(rng), -20 + noise(rng), 5 + noise(rng) });
+    }
+    return data;
+}
+
+TEST(ImuCalibrationTest, MeasuresBiasAndScale) {
+    ImuCalibration calibration(16384, 16.4);
+    ASSERT_EQ(CalibrateResult::SUCCESS,
+              calibration.calibrateAtRest(restData(100, 1)).getResult());
+
+    double scale = sqrt(8000.0 * 8000 + 9000.0 * 9000 + 11000.0 * 11000);
+    ASSERT_DOUBLE_EQ(scale, calibration.getAccelerometerUnitsPerG());
+    ASSERT_NEAR(50, calibration.getGyroscopeBias(0), 0.5);
+    ASSERT_NEAR(-20, calibration.getGyroscopeBias(1), 0.5);
+    ASSERT_NEAR(5, calibration.getGyroscopeBias(2), 0.5);
+
+    std::vector<double> out =
+        calibration.calibrate({ 0, 0, scale, 50 + 164, -20, 5 });
+    ASSERT_DOUBLE_EQ(1, out[2]);
+    ASSERT_NEAR(10, out[3], 0.05);
+    ASSERT_NEAR(0, out[4], 0.05);
+
+    // Other data passes through.
+    ASSERT_EQ(std::vector<double>({ 1, 2 }), calibration.calibrate({ 1, 2 }));
+}
+
+TEST(ImuCalibrationTest, ChecksTheSample) {
+    ImuCalibration calibration(16384, 16.4);
+    // Moving: 100 units is about 6 degrees per second on each axis.
+    ASSERT_EQ(CalibrateResult::WARNING,
+              calibration.calibrateAtRest(restData(100, 100)).getResult());
+    ASSERT_EQ(CalibrateResult::FAILURE,
+              calibration.calibrateAtRest(restData(5, 1)).getResult());
+
+    // A 4 g range reads half as much.
+    ImuCalibration wrong_range(2 * 16384, 16.4);
+    ASSERT_EQ(CalibrateResult::WARNING,
+              wrong_range.calibrateAtRest(restData(100, 1)).getResult());
+}
+
+TEST(ImuCalibrationTest, SetsUpACalibrator) {
+    ImuCalibration imu_calibration(16384, 16.4);
+    Calibrator calibrator;
+    imu_calibration.addTo(calibrator);
+
+    ASSERT_EQ(1, calibrator.getCalibrateProcesses().size());
+    ASSERT_FALSE(calibrator.isCalibrated());
+    calibrator.getCalibrateProcesses()[0].calibrate(restData(100, 1));
+    ASSERT_TRUE(calibrator.isCalibrated());
+
+    std::vector<double> out = calibrator.calibrate({ 8000, -9000, 11000,
+                                                     50, -20, 5 });
+    ASSERT_NEAR(1, sqrt(out[0] * out[0] + out[1] * out[1] + out[2] * out[2]),
+                1e-12);
+    ASSERT_NEAR(0, out[3], 0.05);
+}
@@ -0,0 +1,92 @@
+#include "imu-calibration.h"
+
+#include <cmath>
+
+// Fewer readings than this don't tell noise from bias.
+static const uint32_t kMinRestSamples = 10;
+// Gyroscope noise (standard deviation, degrees per second) above which the
+// sensor is taken to have moved.
+static const double kMaxRestRotation = 5;
+// How far (as a fraction) the measured accelerometer scale may be from the
+// nominal one before it's reported.
+static const double kMaxScaleError = 0.2;
+
+ImuCalibration::ImuCalibration(double accel_units_per_g,
+                               double gyro_units_per_degree)
+        : nominal_accel_units_per_g_(accel_units_per_g),
+          accel_units_per_g_(accel_units_per_g),
+          gyro_units_per_degree_(gyro_units_per_degree),
+          gyro_bias_{ 0, 0, 0 } {
+}
+
+Calibrator& ImuCalibration::addTo(Calibrator& calibrator,
+                                  const std::string& name,
+                                  const std::string& description) {
+    calibrator.setCalibrateFunction(Calibrator::CalibrateFunc(
+        [this](std::vector<double> raw) { return calibrate(raw); }));
+    return calibrator.addCalibrateProcess(
+        name, description, [this](const GRT::MatrixDouble& data) {
+            return calibrateAtRest(data);
+        });
+}
+
+CalibrateResult ImuCalibration::calibrateAtRest(const GRT::MatrixDouble& data) {
+    if (data.getNumCols() != 6) {
+        return CalibrateResult(CalibrateResult::FAILURE,
+            "Expected 6 dimensions (accelerometer and gyroscope) but got " +
+            std::to_string(data.getNumCols()) + ".");
+    }
+    if (data.getNumRows() < kMinRestSamples) {
+        return CalibrateResult(CalibrateResult::FAILURE,
+            "Sample is too short. Hold the key down for longer.");
+    }
+
+    double mean[6] = { 0 }, variance[6] = { 0 };
+    uint32_t rows = data.getNumRows();
+    for (uint32_t i = 0; i < rows; i++) {
+        for (int j = 0; j < 6; j++) mean[j] += data[i][j];
+    }
+    for (int j = 0; j < 6; j++) mean[j] /= rows;
+    for (uint32_t i = 0; i < rows; i++) {
+        for (int j = 0; j < 6; j++) {
+            variance[j] += (data[i][j] - mean[j]) * (data[i][j] - mean[j]);
+        }
+    }
+    for (int j = 0; j < 6; j++) variance[j] /= rows;
+
+    double scale = sqrt(mean[0] * mean[0] + mean[1] * mean[1] +
+                        mean[2] * mean[2]);
+    if (scale == 0) {
+        return CalibrateResult(CalibrateResult::FAILURE,
+            "The accelerometer reads 0. Check the circuit.");
+    }
+
+    accel_units_per_g_ = scale;
+    for (int i = 0; i < 3; i++) gyro_bias_[i] = mean[3 + i];
+
+    double rotation = sqrt(variance[3] + variance[4] + variance[5]) /
+                      gyro_units_per_degree_;
+    if (rotation > kMaxRestRotation) {
+        return CalibrateResult(CalibrateResult::WARNING,
+            "The sensor moved by " + std::to_string((int) rotation) +
+            " degrees per second. Hold it still and collect again.");
+    }
+    double error = scale / nominal_accel_units_per_g_ - 1;
+    if (std::abs(error) > kMaxScaleError) {
+        return CalibrateResult(CalibrateResult::WARNING,
+            "The accelerometer reads " +
+            std::to_string(scale / nominal_accel_units_per_g_) +
+            " g at rest. Check its range setting.");
+    }
+    return CalibrateResult::SUCCESS;
+}
+
+std::vector<double> ImuCalibration::calibrate(std::vector<double> raw) const {
+    if (raw.size() != 6) return raw;
+
+    for (int i = 0; i < 3; i++) {
+        raw[i] /= accel_units_per_g_;
+        raw[3 + i] = (raw[3 + i] - gyro_bias_[i]) / gyro_units_per_degree_;
+    }
+    return raw;
+}
@@ -0,0 +1,78 @@
+/**
+ @file imu-calibration.h
+ @brief Calibration of 6-axis IMU readings for OrientationFusion.
+ */
+#pragma once
+
+#include "calibrator.h"
+
+#include <string>
+#include <vector>
+
+/**
+ @brief Converts raw 6-axis IMU readings (ax, ay, az, gx, gy, gz) to g and
+ degrees per second, as OrientationFusion expects, with the gyroscope's bias
+ and the accelerometer's scale measured from a sample of the sensor held
+ still.
+
+ It provides the calibration function and calibration process of a
+ Calibrator, e.g. for Arduino101_IMU.ino with the CurieImu's default ranges
+ (2 g and 2000 degrees per second):
+
+     ImuCalibration imu_calibration(16384, 16.4);
+     imu_calibration.addTo(calibrator);
+     useCalibrator(calibrator);
+
+ Both keep a pointer to the ImuCalibration, so it must outlive the Calibrator.
+ */
+class ImuCalibration {
+  public:
+    /**
+     @param accel_units_per_g: the raw accelerometer reading for 1 g, until
+     the sample at rest has been collected
+     @param gyro_units_per_degree: the raw gyroscope reading for 1 degree per
+     second
+     */
+    ImuCalibration(double accel_units_per_g = 1,
+                   double gyro_units_per_degree = 1);
+
+    /**
+     Make calibrate() the calibration function of `calibrator`, and add a
+     calibration process that collects the sample at rest and passes it to
+     calibrateAtRest().
+
+     @return `calibrator`, to allow for chaining of Calibrator methods
+     */
+    Calibrator& addTo(Calibrator& calibrator,
+                      const std::string& name = "Rest",
+                      const std::string& description =
+                          "Hold the sensor still, in any orientation.");
+
+    /**
+     Measure the gyroscope's bias (its mean reading) and the accelerometer's
+     scale (the magnitude of its mean reading, which is 1 g) from a sample of
+     raw readings of the sensor held still. Warns if the sensor moved or the
+     scale is far from the one given to the constructor (e.g. the sensor's
+     range is set differently), and fails if the sample is too short to tell.
+     */
+    CalibrateResult calibrateAtRest(const GRT::MatrixDouble& data);
+
+    /**
+     Convert one raw reading to g and degrees per second. Readings that
+     don't have 6 dimensions are passed on unchanged.
+     */
+    std::vector<double> calibrate(std::vector<double> raw) const;
+
+    double getAccelerometerUnitsPerG() const { return accel_units_per_g_; }
+    double getGyroscopeUnitsPerDegree() const {
+        return gyro_units_per_degree_;
+    }
+    // The gyroscope's bias on axis `i`, in raw units.
+    double getGyroscopeBias(int i) const { return gyro_bias_[i]; }
+
+  private:
+    const double nominal_accel_units_per_g_;
+    double accel_units_per_g_;
+    const double gyro_units_per_degree_;
+    double gyro_bias_[3];
+};
@@ -0,0 +1,90 @@
+#include "io-reactor.h"
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <chrono>
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+// Wait up to a second for `done` to become true.
+template <typename Predicate>
+static bool waitFor(Predicate done) {
+    for (int i = 0; i < 1000 && !done(); i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return done();
+}
+
+TEST(IoReactorTest, Timers) {
+    IoReactor reactor;
+    std::atomic<int> ticks(0), once(0), posted(0);
+    IoReactor::Handle repeating =
+        reactor.addTimer(2, [&ticks] { ticks++; });
+    reactor.addTimer(5, [&once] { once++; }, false);
+    reactor.post([&posted, &reactor] {
+        posted += reactor.isReactorThread() ? 1 : 100;
+    });
+
+    ASSERT_TRUE(waitFor([&] { return ticks >= 5 && once == 1; }));
+    ASSERT_EQ(1, posted);
+
+    // After remove() returns, the handler never runs again.
+    reactor.remove(repeating);
+    int last = ticks;
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    ASSERT_EQ(last, ticks);
+    ASSERT_EQ(1, once);
+
+    // Removing unknown handles is harmless.
+    reactor.remove(repeating);
+    reactor.remove(IoReactor::kInvalidHandle);
+}
+
+TEST(IoReactorTest, RemoveFromHandler) {
+    IoReactor reactor;
+    std::atomic<int> ticks(0);
+    std::atomic<IoReactor::Handle> self(IoReactor::kInvalidHandle);
+    self = reactor.addTimer(1, [&] {
+        if (++ticks == 3) reactor.remove(self);
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(30));
+    ASSERT_EQ(3, ticks);
+}
+
+#ifndef _WIN32
+TEST(IoReactorTest, Fds) {
+    ASSERT_TRUE(IoReactor::supportsFds());
+
+    IoReactor reactor;
+    int fds[2];
+    ASSERT_EQ(0, pipe(fds));
+
+    std::atomic<int> received(0);
+    IoReactor::Handle handle = reactor.addFd(fds[0], [&received](int fd) {
+        char buffer[16];
+        ssize_t n = read(fd, buffer, sizeof(buffer));
+        if (n > 0) received += n;
+    });
+    ASSERT_NE(IoReactor::kInvalidHandle, handle);
+
+    ASSERT_EQ(3, write(fds[1], "abc", 3));
+    ASSERT_TRUE(waitFor([&] { return received == 3; }));
+
+    // Level-triggered: more data than one read takes is all delivered.
+    char data[100] = {};
+    ASSERT_EQ(100, write(fds[1], data, 100));
+    ASSERT_TRUE(waitFor([&] { return received == 103; }));
+
+    reactor.remove(handle);
+    ASSERT_EQ(1, write(fds[1], "d", 1));
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    ASSERT_EQ(103, received);
+
+    ASSERT_EQ(IoReactor::kInvalidHandle,
+              reactor.addFd(-1, [](int) {}));
+    close(fds[0]);
+    close(fds[1]);
+}
+#endif
@@ -0,0 +1,289 @@
+#include "io-reactor.h"
+
+#include <algorithm>
+#include <chrono>
+
+#if defined(_WIN32)
+#define ESP_REACTOR_NO_FDS 1
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#if defined(__linux__)
+#include <sys/epoll.h>
+#define ESP_REACTOR_EPOLL 1
+#else
+#include <poll.h>
+#define ESP_REACTOR_POLL 1
+#endif
+#endif
+
+// The longest the thread sleeps without a timer to wake it; only bounds how
+// long a missed wakeup could go unnoticed.
+static const int kMaxWaitMs = 1000;
+
+const IoReactor::Handle IoReactor::kInvalidHandle;
+
+IoReactor::IoReactor() {
+#if !ESP_REACTOR_NO_FDS
+    if (pipe(wake_fds_) == 0) {
+        for (int fd : wake_fds_) {
+            fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+            fcntl(fd, F_SETFD, FD_CLOEXEC);
+        }
+    }
+#endif
+#if ESP_REACTOR_EPOLL
+    epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+    if (epoll_fd_ >= 0 && wake_fds_[0] >= 0) {
+        epoll_event event = {};
+        event.events = EPOLLIN;
+        event.data.u64 = kInvalidHandle;
+        epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, wake_fds_[0], &event);
+    }
+#endif
+    // run() takes the lock before calling any handler, so handlers see
+    // thread_ set (isReactorThread() depends on it).
+    std::lock_guard<std::mutex> lock(mutex_);
+    thread_ = std::thread(&IoReactor::run, this);
+}
+
+IoReactor::~IoReactor() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wake();
+    if (thread_.joinable()) thread_.join();
+#if !ESP_REACTOR_NO_FDS
+    if (epoll_fd_ >= 0) close(epoll_fd_);
+    for (int fd : wake_fds_) {
+        if (fd >= 0) close(fd);
+    }
+#endif
+}
+
+IoReactor& IoReactor::instance() {
+    static IoReactor reactor;
+    return reactor;
+}
+
+bool IoReactor::supportsFds() {
+#if ESP_REACTOR_NO_FDS
+    return false;
+#else
+    return true;
+#endif
+}
+
+uint64_t IoReactor::now() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+IoReactor::Handle IoReactor::addEntry(std::shared_ptr<Entry> entry) {
+    Handle handle;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        handle = next_handle_++;
+#if ESP_REACTOR_EPOLL
+        if (entry->fd >= 0) {
+            epoll_event event = {};
+            event.events = EPOLLIN;
+            event.data.u64 = handle;
+            if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, entry->fd, &event) != 0) {
+                return kInvalidHandle;
+            }
+        }
+#endif
+        entries_[handle] = entry;
+    }
+    wake();
+    return handle;
+}
+
+IoReactor::Handle IoReactor::addFd(int fd, FdHandler handler) {
+#if ESP_REACTOR_NO_FDS
+    return kInvalidHandle;
+#else
+    if (fd < 0 || handler == nullptr) return kInvalidHandle;
+    std::shared_ptr<Entry> entry = std::make_shared<Entry>();
+    entry->fd = fd;
+    entry->fd_handler = handler;
+    return addEntry(entry);
+#endif
+}
+
+IoReactor::Handle IoReactor::addTimer(uint64_t interval_ms,
+                                      TimerHandler handler, bool repeat) {
+    if (handler == nullptr) return kInvalidHandle;
+    std::shared_ptr<Entry> entry = std::make_shared<Entry>();
+    entry->timer_handler = handler;
+    entry->interval_ms = interval_ms;
+    entry->deadline_ms = now() + interval_ms;
+    // A repeating timer with no interval would starve everything else.
+    entry->repeat = repeat && interval_ms > 0;
+    return addEntry(entry);
+}
+
+IoReactor::Handle IoReactor::watch(int fd, uint64_t poll_interval_ms,
+                                   TimerHandler handler) {
+    if (handler == nullptr) return kInvalidHandle;
+    Handle handle = addFd(fd, [handler](int) { handler(); });
+    if (handle == kInvalidHandle) {
+        handle = addTimer(std::max<uint64_t>(1, poll_interval_ms), handler);
+    }
+    return handle;
+}
+
+void IoReactor::remove(Handle handle) {
+    if (handle == kInvalidHandle) return;
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        auto it = entries_.find(handle);
+        if (it != entries_.end()) {
+#if ESP_REACTOR_EPOLL
+            if (it->second->fd >= 0) {
+                epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, it->second->fd, nullptr);
+            }
+#endif
+            entries_.erase(it);
+        }
+
+        // Wait for a running handler to return, unless we are that handler.
+        // (A one-shot timer is already gone from entries_ while it runs.)
+        if (!isReactorThread()) {
+            idle_.wait(lock, [this, handle] {
+                return dispatching_ != handle;
+            });
+        }
+    }
+    wake();
+}
+
+void IoReactor::wake() {
+#if ESP_REACTOR_NO_FDS
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        woken_ = true;
+    }
+    wake_.notify_one();
+#else
+    if (wake_fds_[1] >= 0) {
+        char c = 0;
+        // If the pipe is full, the thread is already going to wake up.
+        ssize_t ignored = write(wake_fds_[1], &c, 1);
+        (void) ignored;
+    }
+#endif
+}
+
+vector<IoReactor::Handle> IoReactor::wait(int timeout_ms) {
+    vector<Handle> ready;
+#if ESP_REACTOR_EPOLL
+    const int kMaxEvents = 32;
+    epoll_event events[kMaxEvents];
+    int n = epoll_wait(epoll_fd_, events, kMaxEvents, timeout_ms);
+    for (int i = 0; i < n; i++) {
+        if (events[i].data.u64 != kInvalidHandle) {
+            ready.push_back(events[i].data.u64);
+        }
+    }
+#elif ESP_REACTOR_POLL
+    vector<pollfd> fds;
+    vector<Handle> handles;
+    fds.push_back({ wake_fds_[0], POLLIN, 0 });
+    handles.push_back(kInvalidHandle);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto& entry : entries_) {
+            if (entry.second->fd < 0) continue;
+            fds.push_back({ entry.second->fd, POLLIN, 0 });
+            handles.push_back(entry.first);
+        }
+    }
+    if (poll(fds.data(), fds.size(), timeout_ms) > 0) {
+        for (size_t i = 1; i < fds.size(); i++) {
+            if (fds[i].revents != 0) ready.push_back(handles[i]);
+        }
+    }
+#else
+    std::unique_lock<std::mutex> lock(mutex_);
+    wake_.wait_for(lock, std::chrono::milliseconds(timeout_ms),
+                   [this] { return woken_; });
+    woken_ = false;
+#endif
+
+#if !ESP_REACTOR_NO_FDS
+    // Drain the wakeup pipe; the wakeup has done its job by now.
+    char buffer[64];
+    while (read(wake_fds_[0], buffer, sizeof(buffer)) > 0) {}
+#endif
+    return ready;
+}
+
+void IoReactor::dispatch(Handle handle) {
+    std::shared_ptr<Entry> entry;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = entries_.find(handle);
+        if (it == entries_.end()) return;  // removed since it became ready
+        entry = it->second;
+        if (entry->fd < 0) {
+            if (entry->repeat) {
+                // Skip the ticks we're too late for instead of bursting.
+                uint64_t t = now();
+                entry->deadline_ms += entry->interval_ms;
+                if (entry->deadline_ms <= t) {
+                    entry->deadline_ms = t + entry->interval_ms;
+                }
+            } else {
+                entries_.erase(it);
+            }
+        }
+        dispatching_ = handle;
+    }
+
+    if (entry->fd >= 0) {
+        entry->fd_handler(entry->fd);
+    } else {
+        entry->timer_handler();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        dispatching_ = kInvalidHandle;
+    }
+    idle_.notify_all();
+}
+
+void IoReactor::run() {
+    while (true) {
+        int timeout_ms = kMaxWaitMs;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (stopping_) return;
+            uint64_t t = now();
+            for (const auto& entry : entries_) {
+                if (entry.second->fd >= 0) continue;
+                uint64_t deadline = entry.second->deadline_ms;
+                int wait_ms = deadline > t ? (int) std::min<uint64_t>(
+                    deadline - t, kMaxWaitMs) : 0;
+                timeout_ms = std::min(timeout_ms, wait_ms);
+            }
+        }
+
+        for (Handle handle : wait(timeout_ms)) dispatch(handle);
+
+        vector<Handle> due;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            uint64_t t = now();
+            for (const auto& entry : entries_) {
+                if (entry.second->fd < 0 && entry.second->deadline_ms <= t) {
+                    due.push_back(entry.first);
+                }
+            }
+        }
+        for (Handle handle : due) dispatch(handle);
+    }
+}
@@ -0,0 +1,116 @@
+/** @file io-reactor.h
+ *  @brief IoReactor runs the I/O of all input and output streams on a single
+ *  thread.
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using std::vector;
+
+/**
+ *  @brief IoReactor waits on file descriptors (serial ports, sockets) and
+ *  timers, and calls the handlers that streams register for them, all on
+ *  one thread. Streams register handlers instead of owning a thread each
+ *  that sleeps and polls.
+ *
+ *  The thread blocks in epoll_wait() on Linux and poll() on other POSIX
+ *  systems until a descriptor is ready or the next timer is due, so idle
+ *  streams cost nothing and data is handled as soon as it arrives. On
+ *  Windows, where serial ports can't be waited on together with sockets,
+ *  only timers are available: addFd() fails, and streams fall back to a
+ *  timer that checks for data.
+ *
+ *  Handlers run on the reactor thread and must not block. Descriptors are
+ *  level-triggered: a handler that leaves data unread is called again.
+ *  Handles returned by addFd() and addTimer() are removed with remove(),
+ *  which may be called from any thread, including from a handler; when it
+ *  returns (on another thread) the handler is not running and won't run
+ *  again.
+ */
+class IoReactor {
+  public:
+    typedef uint64_t Handle;
+    typedef std::function<void(int fd)> FdHandler;
+    typedef std::function<void()> TimerHandler;
+
+    static const Handle kInvalidHandle = 0;
+
+    IoReactor();
+    ~IoReactor();
+
+    /// @brief The reactor shared by all streams.
+    static IoReactor& instance();
+
+    /// @brief Call `handler` whenever `fd` has data to read (or is closed).
+    /// Returns kInvalidHandle if the descriptor can't be waited on.
+    Handle addFd(int fd, FdHandler handler);
+
+    /// @brief Call `handler` every `interval_ms` milliseconds, or only once,
+    /// `interval_ms` from now, if `repeat` is false.
+    Handle addTimer(uint64_t interval_ms, TimerHandler handler,
+                    bool repeat = true);
+
+    /// @brief Call `handler` when `fd` has data to read if the descriptor
+    /// can be waited on, and otherwise every `poll_interval_ms` to check for
+    /// data itself.
+    Handle watch(int fd, uint64_t poll_interval_ms, TimerHandler handler);
+
+    /// @brief Unregister a descriptor or a timer. Unknown handles are
+    /// ignored.
+    void remove(Handle handle);
+
+    /// @brief Run `fn` once on the reactor thread, as soon as possible.
+    void post(TimerHandler fn) { addTimer(0, fn, false); }
+
+    /// @brief Whether fds can be waited on (false on Windows).
+    static bool supportsFds();
+
+    bool isReactorThread() const {
+        return std::this_thread::get_id() == thread_.get_id();
+    }
+
+  private:
+    struct Entry {
+        int fd = -1;                 // -1 for timers
+        FdHandler fd_handler;
+        TimerHandler timer_handler;
+        uint64_t interval_ms = 0;
+        uint64_t deadline_ms = 0;
+        bool repeat = false;
+    };
+
+    void run();
+    void wake();
+    // Wait for up to `timeout_ms` (-1: forever) and return the handles of the
+    // ready descriptors.
+    vector<Handle> wait(int timeout_ms);
+    void dispatch(Handle handle);
+    Handle addEntry(std::shared_ptr<Entry> entry);
+    static uint64_t now();
+
+    std::mutex mutex_;
+    std::condition_variable idle_;
+    std::map<Handle, std::shared_ptr<Entry>> entries_;
+    Handle next_handle_ = 1;
+    Handle dispatching_ = kInvalidHandle;
+    bool stopping_ = false;
+
+    // Backend state: the epoll descriptor (Linux) and a pipe used to wake
+    // the thread when entries change. On Windows, wake() signals the
+    // condition variable instead.
+    int epoll_fd_ = -1;
+    int wake_fds_[2] = { -1, -1 };
+    std::condition_variable wake_;
+    bool woken_ = false;
+
+    std::thread thread_;
+};
@@ -29,12 +29,10 @@ void ASCIISerialStream::parseSerial(vector<unsigned char> &buffer) {
             while (iss >> d) data.push_back(d);
 
             if (data.size() > 0) {
-                data = normalize(data);
-
                 GRT::MatrixDouble matrix;
-                matrix.push_back(data);
+                matrix.push_back(applyNormalizer(data));
 
-                data_ready_callback_(matrix);
+                emitData(matrix);
             }
         }
     }
@@ -55,44 +53,30 @@ void BinaryIntArraySerialStream::onReceive(vector<double> data) {
 }
 
 void BinaryIntArraySerialStream::parseSerial(vector<unsigned char> &buffer) {
-    auto start = std::find(buffer.begin(), buffer.end(), 0); // look for packet start
-    if (start != buffer.end()) {
-        buffer.erase(buffer.begin(), start); // advance to start of packet
-        if (buffer.size() >= 3) { // 0, LSB(n), MSB(n)
-            unsigned char checksum = 0;
-            int LSB = buffer[1]; checksum += LSB;
-            int MSB = buffer[2]; checksum += MSB;
-            int n = ((MSB & 0x7F) << 7) | (LSB & 0x7F);
-            if (buffer.size() >= 4 + 2 * n) {
-                vector<double> vals;
-                //std::cout << "Got array of " << n << " bytes: " << buffer.size();
-                for (int j = 3; j < (3 + 2 * n);) {
-                    LSB = buffer[j++]; checksum += LSB;
-                    MSB = buffer[j++]; checksum += MSB;
-                    int val = ((MSB & 0x7F) << 7) | (LSB & 0x7F);
-                    //std::cout << val << " ";
-                    vals.push_back(val);
-                }
-                //std::cout << "(" << (checksum | 0x80) << " <> " << buffer[3 + 2 * n] << ")" << std::endl;
-                if ((checksum | 0x80) != buffer[3 + 2 * n]) {
-                    ofLog(OF_LOG_WARNING) << "Invalid checksum, discarding serial packet.";
-                } else if (n != getNumInputDimensions()) {
-                    ofLog(OF_LOG_WARNING) << "Serial packet contains " << n <<
-                        " dimensions. Expected " << getNumInputDimensions();
-                } else {
-                    GRT::MatrixDouble data(1, n);
-                    for (int i = 0; i < getNumInputDimensions(); i++) {
-                        int b = vals[i];
-                        data[0][i] = (normalizer_ != nullptr) ? normalizer_(b) : b;
-                    }
-                    if (data_ready_callback_ != nullptr) {
-                        data_ready_callback_(data);
-                    }
-
-                }
+    vector<double> vals;
+    switch (BinaryIntArrayParser::parse(buffer, &vals)) {
+        case BinaryIntArrayParser::Result::kIncomplete:
+            return;
+        case BinaryIntArrayParser::Result::kInvalidChecksum:
+            ofLog(OF_LOG_WARNING) << "Invalid checksum, discarding serial packet.";
+            return;
+        case BinaryIntArrayParser::Result::kPacket:
+            break;
+    }
 
-                buffer.erase(buffer.begin(), buffer.begin() + (4 + 2 * n));
-            }
+    if (vals.size() != getNumInputDimensions()) {
+        if (fixed_dimensions_) {
+            ofLog(OF_LOG_WARNING) << "Serial packet contains " << vals.size() <<
+                " dimensions. Expected " << getNumInputDimensions();
+            return;
         }
+        setNumInputDimensions(vals.size());
+    }
+
+    GRT::MatrixDouble data(1, vals.size());
+    for (int i = 0; i < vals.size(); i++) {
+        double b = vals[i];
+        data[0][i] = (normalizer_ != nullptr) ? normalizer_(b) : b;
     }
+    emitData(data);
 }
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "binary-int-array-parser.h"
 #include "istream.h"
 #include "ostream.h"
 
@@ -28,6 +29,16 @@ class ASCIISerialStream : public BaseSerialInputStream, public IOStreamVector {
     virtual void parseSerial(vector<unsigned char> &buffer);
 };
 
+/**
+ @brief Input stream for reading binary packets of integers from a (USB)
+ serial port, as sent by the Touche and CapacitiveSensing-MPR121-Fast Arduino
+ sketches. See BinaryIntArrayParser for the packet format.
+
+ Each packet announces how many values it holds, and the stream adopts that
+ number of dimensions (e.g. the reduced number of bins when the Touche sketch
+ pools its sweep), telling the dimensions changed callback. The number given
+ to the constructor is what's expected until the first packet arrives.
+ */
 class BinaryIntArraySerialStream : public BaseSerialInputStream, public IOStreamVector {
   public:
     using BaseSerialInputStream::BaseSerialInputStream; // inherit constructors
@@ -35,6 +46,12 @@ class BinaryIntArraySerialStream : public BaseSerialInputStream, public IOStream
     virtual void onReceive(uint32_t label);
     virtual void onReceive(vector<double> data);
 
+    // Drop packets with a different number of values than the current one
+    // instead of adopting it.
+    void useFixedDimensions(bool fixed = true) { fixed_dimensions_ = fixed; }
+
   private:
     virtual void parseSerial(vector<unsigned char> &buffer);
+
+    bool fixed_dimensions_ = false;
 };
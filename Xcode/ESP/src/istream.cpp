@@ -12,16 +12,28 @@
 #include "istream.h"
 
 #include <GRT/GRT.h>
-#include <chrono>         // std::chrono::milliseconds
-#include <thread>         // std::this_thread::sleep_for
-
-
-#include "ofxNetwork.h"  
+#include <algorithm>
+
+#include "ofxNetwork.h"
+#include "osc/OscReceivedElements.h"
+
+#ifndef TARGET_WIN32
+#include <arpa/inet.h>
+#include <cerrno>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
 
 
 InputStream::InputStream() : data_ready_callback_(nullptr) {}
 
 vector<double> InputStream::normalize(vector<double> input) {
+    return selectDimensions(applyNormalizer(input));
+}
+
+vector<double> InputStream::applyNormalizer(vector<double> input) const {
     if (vectorNormalizer_ != nullptr) {
         return vectorNormalizer_(input);
     } else if (normalizer_ != nullptr) {
@@ -33,6 +45,49 @@ vector<double> InputStream::normalize(vector<double> input) {
     }
 }
 
+void InputStream::useDimensions(const vector<uint32_t>& dimensions) {
+    if (!selected_dimensions_.empty() || dimensions.empty()) {
+        selected_dimensions_ = dimensions;
+        return;
+    }
+    // The labels are of all dimensions so far.
+    if (!InputStream_labels_.empty()) {
+        vector<string> labels;
+        for (uint32_t d : dimensions) {
+            labels.push_back(d < InputStream_labels_.size() ?
+                             InputStream_labels_[d] : "");
+        }
+        InputStream_labels_ = labels;
+    }
+    selected_dimensions_ = dimensions;
+}
+
+vector<double> InputStream::selectDimensions(vector<double> data) const {
+    if (selected_dimensions_.empty()) return data;
+    vector<double> selected(selected_dimensions_.size(), 0.0);
+    for (uint32_t i = 0; i < selected_dimensions_.size(); i++) {
+        uint32_t d = selected_dimensions_[i];
+        if (d < data.size()) selected[i] = data[d];
+    }
+    return selected;
+}
+
+void InputStream::emitData(const GRT::MatrixDouble& data) {
+    if (data_ready_callback_ == nullptr) return;
+    if (selected_dimensions_.empty()) {
+        data_ready_callback_(data);
+        return;
+    }
+    GRT::MatrixDouble selected(data.getNumRows(), selected_dimensions_.size());
+    for (uint32_t r = 0; r < data.getNumRows(); r++) {
+        for (uint32_t i = 0; i < selected_dimensions_.size(); i++) {
+            uint32_t d = selected_dimensions_[i];
+            selected[r][i] = d < data.getNumCols() ? data[r][d] : 0.0;
+        }
+    }
+    data_ready_callback_(selected);
+}
+
 void InputStream::setLabelsForAllDimensions(const vector<string> labels) {
     InputStream_labels_ = labels;
 }
@@ -48,15 +103,34 @@ const vector<string>& InputStream::getLabels() const {
 }
 
 AudioStream::AudioStream(uint32_t downsample_rate)
-        : downsample_rate_(downsample_rate),
+        : AudioStream(downsample_rate, 2, {0}) {
+}
+
+AudioStream::AudioStream(uint32_t downsample_rate,
+                         uint32_t num_device_channels,
+                         vector<uint32_t> channels)
+        : deinterleaver_(num_device_channels, channels, downsample_rate),
           sound_stream_(new ofSoundStream()) {
-    setup_successful_ = sound_stream_->setup(this, 0, 2,
+    if (deinterleaver_.getChannels().empty()) {
+        ofLog(OF_LOG_ERROR) << "AudioStream: none of the selected channels "
+                            << "exist on a device with " << num_device_channels
+                            << " channels";
+    }
+    setup_successful_ = sound_stream_->setup(this, 0, num_device_channels,
                                              kOfSoundStream_SamplingRate,
                                              kOfSoundStream_BufferSize,
                                              kOfSoundStream_nBuffers);
     sound_stream_->stop();
 }
 
+void AudioStream::useMixDown(bool mix_down) {
+    deinterleaver_.setMixDown(mix_down);
+}
+
+void AudioStream::useAveragingDecimation(bool averaging) {
+    deinterleaver_.setAveraging(averaging);
+}
+
 bool AudioStream::start() {
     if (!setup_successful_) return false;
     if (!has_started_) {
@@ -74,21 +148,15 @@ void AudioStream::stop() {
 }
 
 int AudioStream::getNumInputDimensions() {
-    return 1; // set by the call to sound_stream->setup() above
+    return deinterleaver_.getNumOutputDimensions();
 }
 
 void AudioStream::audioIn(float* input, int buffer_size, int nChannel) {
-    // set nChannelOut as 1 to load only a single channel (left).
-    int nChannelOut = 1;
-    GRT::MatrixDouble data(buffer_size / nChannel / downsample_rate_, nChannelOut);
+    // `buffer_size` is the number of frames, each of `nChannel` samples.
+    if ((uint32_t) nChannel != deinterleaver_.getNumDeviceChannels()) return;
 
-    for (int i = 0; i < buffer_size / nChannel / downsample_rate_; i++)
-        for (int j = 0; j < nChannelOut; j++)
-            data[i][j] = input[i * nChannel * downsample_rate_ + j];
-
-    if (data_ready_callback_ != nullptr) {
-        data_ready_callback_(data);
-    }
+    deinterleaver_.process(input, buffer_size, block_);
+    if (block_.getNumRows() > 0) emitData(block_);
 }
 
 AudioFileStream::AudioFileStream(char *file, bool loop) {
@@ -99,7 +167,8 @@ AudioFileStream::AudioFileStream(char *file, bool loop) {
 bool AudioFileStream::start() {
     if (!has_started_) {
         player_.play();
-        update_thread_.reset(new std::thread(&AudioFileStream::readSpectrum, this));
+        timer_ = IoReactor::instance().addTimer(
+            1000 / (44100 / 1024), [this]() { readSpectrum(); });
         has_started_ = true;
     }
 
@@ -109,19 +178,15 @@ bool AudioFileStream::start() {
 void AudioFileStream::stop() {
     player_.stop();
     has_started_ = false;
-    if (update_thread_ != nullptr && update_thread_->joinable()) {
-        update_thread_->join();
-    }
+    IoReactor::instance().remove(timer_);
+    timer_ = IoReactor::kInvalidHandle;
 }
 
 void AudioFileStream::readSpectrum() {
-    while (has_started_) {
-        std::this_thread::sleep_for(std::chrono::milliseconds(1000 / (44100 / 1024)));
-        float *spectrum = ofSoundGetSpectrum(512);
-        GRT::VectorDouble data(spectrum, spectrum + 512);
-        GRT::MatrixDouble out; out.push_back(data);
-        if (data_ready_callback_ != nullptr) data_ready_callback_(out);
-    }
+    float *spectrum = ofSoundGetSpectrum(512);
+    GRT::VectorDouble data(spectrum, spectrum + 512);
+    GRT::MatrixDouble out; out.push_back(data);
+    emitData(out);
 }
 
 int AudioFileStream::getNumInputDimensions() {
@@ -129,13 +194,13 @@ int AudioFileStream::getNumInputDimensions() {
 }
 
 BaseSerialInputStream::BaseSerialInputStream(uint32_t baud, int dimensions)
-        : port_(-1), baud_(baud), dimensions_(dimensions), serial_(new ofSerial()) {
+        : port_(-1), baud_(baud), dimensions_(dimensions), serial_(new ReactorSerial()) {
     // Print all devices for convenience.
     // serial_->listDevices();
 }
 
 BaseSerialInputStream::BaseSerialInputStream(uint32_t port, uint32_t baud, int dimensions)
-        : port_(port), baud_(baud), dimensions_(dimensions), serial_(new ofSerial()) {
+        : port_(port), baud_(baud), dimensions_(dimensions), serial_(new ReactorSerial()) {
     // Print all devices for convenience.
     // serial_->listDevices();
 }
@@ -147,8 +212,9 @@ bool BaseSerialInputStream::start() {
     }
 
     if (!has_started_) {
-        if (!serial_->setup(port_, baud_)) return false;
-        reading_thread_.reset(new std::thread(&BaseSerialInputStream::readSerial, this));
+        string path = SerialDeviceRegistry::instance().getPath(port_);
+        if (path.empty() || !serial_->setup(path, baud_)) return false;
+        watchSerial();
         has_started_ = true;
     }
 
@@ -157,42 +223,62 @@ bool BaseSerialInputStream::start() {
 
 void BaseSerialInputStream::stop() {
     has_started_ = false;
-    if (reading_thread_ != nullptr && reading_thread_->joinable()) {
-        reading_thread_->join();
-    }
+    IoReactor::instance().remove(reading_handle_);
+    reading_handle_ = IoReactor::kInvalidHandle;
 }
 
 int BaseSerialInputStream::getNumInputDimensions() {
     return dimensions_;
 }
 
+void BaseSerialInputStream::setNumInputDimensions(int dimensions) {
+    if (dimensions_.exchange(dimensions) == dimensions) return;
+    ofLog(OF_LOG_NOTICE) << "Serial device now sends " << dimensions
+                         << " dimensions.";
+    if (dimensions_changed_callback_ != nullptr) {
+        dimensions_changed_callback_(dimensions);
+    }
+}
+
+void BaseSerialInputStream::watchSerial() {
+    // Where the port can't be waited on, check it about as often as a byte
+    // arrives.
+    int poll_interval = std::max(1u, 1000 / (baud_ / 10));
+    reading_handle_ = IoReactor::instance().watch(
+        serial_->getFileDescriptor(), poll_interval, [this]() { readSerial(); });
+}
+
 void BaseSerialInputStream::readSerial() {
-    // TODO(benzh) This readSerial is running in a different thread
-    // and performing a busy polling (100% CPU usage). Should be
-    // optimized.
-    int sleep_time = 1000 / (baud_ / 10); // sleep about long enough to receive a byte
-    ofLog() << "Serial port will be read every " << sleep_time << " ms";
-    while (has_started_) {
-        std::this_thread::sleep_for(std::chrono::milliseconds(sleep_time));
-        const int kBufSize = 32;
-        unsigned char buf[kBufSize];
-        while (serial_->available() > 0) {
-            int result = serial_->readBytes(buf, kBufSize);
-
-            if ( result == OF_SERIAL_ERROR ) {
-                ofLog( OF_LOG_ERROR, "unrecoverable error reading from serial" );
-                break;
-            } else if ( result != OF_SERIAL_NO_DATA ) {
-                buffer_.insert(buffer_.end(), buf, buf + result);
-            }
+    const int kBufSize = 256;
+    unsigned char buf[kBufSize];
+    int available;
+    while ((available = serial_->available()) > 0) {
+        int result = serial_->readBytes(buf, std::min(available, kBufSize));
+
+        if ( result == OF_SERIAL_ERROR ) {
+            break;
+        } else if ( result != OF_SERIAL_NO_DATA ) {
+            buffer_.insert(buffer_.end(), buf, buf + result);
         }
+    }
+    if (available == OF_SERIAL_ERROR) {
+        // The device is gone; stop watching it rather than being woken up
+        // for the hangup over and over.
+        ofLog( OF_LOG_ERROR, "unrecoverable error reading from serial" );
+        IoReactor::instance().remove(reading_handle_);
+        reading_handle_ = IoReactor::kInvalidHandle;
+    }
 
+    // Parse every complete packet that arrived, not just the first.
+    size_t size;
+    do {
+        size = buffer_.size();
         parseSerial(buffer_);
-    }
+    } while (!buffer_.empty() && buffer_.size() < size);
 }
 
 SerialStream::SerialStream(uint32_t port, uint32_t baud = 115200)
-        : port_(port), baud_(baud), serial_(new ofSerial()) {
+        : port_(port), baud_(baud), serial_(new ReactorSerial()) {
     // Print all devices for convenience.
     // serial_->listDevices();
 }
@@ -204,8 +290,13 @@ bool SerialStream::start() {
     }
 
     if (!has_started_) {
-        if (!serial_->setup(port_, baud_)) return false;
-        reading_thread_.reset(new std::thread(&SerialStream::readSerial, this));
+        string path = SerialDeviceRegistry::instance().getPath(port_);
+        if (path.empty() || !serial_->setup(path, baud_)) return false;
+        bytes_.clear();
+        int poll_interval = std::max(1u, kBufferSize_ * 1000 / (baud_ / 10));
+        reading_handle_ = IoReactor::instance().watch(
+            serial_->getFileDescriptor(), poll_interval,
+            [this]() { readSerial(); });
         has_started_ = true;
     }
 
@@ -214,9 +305,8 @@ bool SerialStream::start() {
 
 void SerialStream::stop() {
     has_started_ = false;
-    if (reading_thread_ != nullptr && reading_thread_->joinable()) {
-        reading_thread_->join();
-    }
+    IoReactor::instance().remove(reading_handle_);
+    reading_handle_ = IoReactor::kInvalidHandle;
 }
 
 int SerialStream::getNumInputDimensions() {
@@ -224,57 +314,35 @@ int SerialStream::getNumInputDimensions() {
 }
 
 void SerialStream::readSerial() {
-    // TODO(benzh) This readSerial is running in a different thread
-    // and performing a busy polling (100% CPU usage). Should be
-    // optimized.
-    int sleep_time = kBufferSize_ * 1000 / (baud_ / 10);
-    ofLog() << "Serial port will be read every " << sleep_time << " ms";
-    while (has_started_) {
-        std::this_thread::sleep_for(std::chrono::milliseconds(sleep_time));
-
-        int local_buffer_size = kBufferSize_;
-        int bytesRequired = kBufferSize_;
-        uint8_t *bytes = new uint8_t[bytesRequired];
-        int bytesRemaining = bytesRequired;
-        while (bytesRemaining > 0) {
-            // check for data
-            if (serial_->available() > 0) {
-                // try to read - note offset into the bytes[] array, this is so
-                // that we don't overwrite the bytes we already have
-                int bytesArrayOffset = bytesRequired - bytesRemaining;
-                int result = serial_->readBytes(&bytes[bytesArrayOffset],
-                    bytesRemaining);
-
-                // check for error code
-                if (result == OF_SERIAL_ERROR) {
-                    // something bad happened
-                    ofLog(OF_LOG_ERROR) << "Error reading from serial";
-                    break;
-                }
-                else if (result == OF_SERIAL_NO_DATA) {
-                    // nothing was read, try again
-                }
-                else {
-                    // we read some data!
-                    bytesRemaining -= result;
-                }
-            }
-        }
-        delete[] bytes;
-        GRT::MatrixDouble data(local_buffer_size, 1);
-        for (int i = 0; i < local_buffer_size; i++) {
-            int b = bytes[i];
+    // Read whatever has arrived and pass it on in blocks of kBufferSize_
+    // bytes; a partial block waits for the next call.
+    int available = serial_->available();
+    if (available == OF_SERIAL_ERROR) {
+        ofLog(OF_LOG_ERROR) << "Error reading from serial";
+        IoReactor::instance().remove(reading_handle_);
+        reading_handle_ = IoReactor::kInvalidHandle;
+        return;
+    }
+    if (available > 0) {
+        size_t size = bytes_.size();
+        bytes_.resize(size + available);
+        int result = serial_->readBytes(&bytes_[size], available);
+        bytes_.resize(size + std::max(0, result));
+    }
+
+    uint32_t offset = 0;
+    for (; offset + kBufferSize_ <= bytes_.size(); offset += kBufferSize_) {
+        GRT::MatrixDouble data(kBufferSize_, 1);
+        for (uint32_t i = 0; i < kBufferSize_; i++) {
+            int b = bytes_[offset + i];
             data[i][0] = (normalizer_ != nullptr) ? normalizer_(b) : b;
         }
-        if (data_ready_callback_ != nullptr) {
-            data_ready_callback_(data);
-        }
+        emitData(data);
     }
+    bytes_.erase(bytes_.begin(), bytes_.begin() + offset);
 }
 
 FirmataStream::FirmataStream(uint32_t port) : port_(port) {
-    ofSerial serial;
-    serial.listDevices();
 }
 
 void FirmataStream::useAnalogPin(int i) {
@@ -294,11 +362,12 @@ bool FirmataStream::start() {
 
 
     if (!has_started_) {
-        ofSerial serial;
         configured_arduino_ = false;
-        if (!arduino_.connect(serial.getDeviceList()[port_].getDevicePath()))
+        string path = SerialDeviceRegistry::instance().getPath(port_);
+        if (path.empty() || !arduino_.connect(path))
             return false;
-        update_thread_.reset(new std::thread(&FirmataStream::update, this));
+        update_timer_ = IoReactor::instance().addTimer(
+            10, [this]() { update(); });
         has_started_ = true;
     }
 
@@ -307,9 +376,8 @@ bool FirmataStream::start() {
 
 void FirmataStream::stop() {
     has_started_ = false;
-    if (update_thread_ != nullptr && update_thread_->joinable()) {
-        update_thread_->join();
-    }
+    IoReactor::instance().remove(update_timer_);
+    update_timer_ = IoReactor::kInvalidHandle;
 }
 
 int FirmataStream::getNumInputDimensions() {
@@ -317,53 +385,151 @@ int FirmataStream::getNumInputDimensions() {
 }
 
 void FirmataStream::update() {
-    int sleep_time = 10;
-    ofLog() << "Serial port will be read every " << sleep_time << " ms";
-    while (has_started_) {
-        std::this_thread::sleep_for(std::chrono::milliseconds(sleep_time));
-        arduino_.update();
-
-        if (configured_arduino_) {
-            vector<double> data(pins_.size());
-            for (int i = 0; pins_.size(); i++)
-                data[i] = arduino_.getAnalog(pins_[i]);
-            data = normalize(data);
-            GRT::MatrixDouble matrix;
-            matrix.push_back(data);
-            if (data_ready_callback_ != nullptr) data_ready_callback_(matrix);
-        } else if (arduino_.isInitialized()) {
-            ofLog() << "Configuring Arduino.";
-            for (int i = 0; i < pins_.size(); i++)
-                arduino_.sendAnalogPinReporting(pins_[i], ARD_ON);
-            configured_arduino_ = true;
-        }
+    arduino_.update();
+
+    if (configured_arduino_) {
+        vector<double> data(pins_.size());
+        for (int i = 0; i < pins_.size(); i++)
+            data[i] = arduino_.getAnalog(pins_[i]);
+        GRT::MatrixDouble matrix;
+        matrix.push_back(applyNormalizer(data));
+        emitData(matrix);
+    } else if (arduino_.isInitialized()) {
+        ofLog() << "Configuring Arduino.";
+        for (int i = 0; i < pins_.size(); i++)
+            arduino_.sendAnalogPinReporting(pins_[i], ARD_ON);
+        configured_arduino_ = true;
+    }
+}
+
+#ifndef TARGET_WIN32
+// A non-blocking socket of `type` bound to `port` on all interfaces, or -1.
+static int bindSocket(int type, int port) {
+    int fd = socket(AF_INET, type, 0);
+    if (fd < 0) return -1;
+    int reuse = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port = htons(port);
+    if (bind(fd, (sockaddr*) &addr, sizeof(addr)) < 0) {
+        close(fd);
+        return -1;
     }
+    return fd;
 }
+#endif
 
+#ifdef TARGET_WIN32
 bool TcpInputStream::start() {
 	server_ = new ofxTCPServer();
     server_->setup(port_num_);
     server_->setMessageDelimiter("\n");
     has_started_ = true;
 
-    reading_thread_.reset(new std::thread([this]() {
-        int sleep_time = 10;
-        ofLog() << "TCP inputs are checked every " << sleep_time << " ms";
-        while (has_started_) {
-            std::this_thread::sleep_for(std::chrono::milliseconds(sleep_time));
-            for (int i = 0; i < server_->getLastID(); i++) {
-                if (server_->isClientConnected(i)) {
-                    string str = server_->receive(i);
-                    if (str != "") {
-                        parseInput(str);
-                    }
-                }
+    timer_ = IoReactor::instance().addTimer(10, [this]() { checkClients(); });
+    return true;
+}
+
+void TcpInputStream::checkClients() {
+    for (int i = 0; i < server_->getLastID(); i++) {
+        if (server_->isClientConnected(i)) {
+            string str = server_->receive(i);
+            if (str != "") {
+                parseInput(str);
             }
         }
-    }));
+    }
+}
+
+void TcpInputStream::stop() {
+    has_started_.store(false);
+    IoReactor::instance().remove(timer_);
+    timer_ = IoReactor::kInvalidHandle;
+    server_->close();
+}
+#else
+bool TcpInputStream::start() {
+    if (has_started_) return true;
+
+    listen_fd_ = bindSocket(SOCK_STREAM, port_num_);
+    if (listen_fd_ < 0 || listen(listen_fd_, SOMAXCONN) < 0) {
+        ofLog(OF_LOG_ERROR) << "Can't listen on TCP port " << port_num_
+                            << ": " << strerror(errno);
+        if (listen_fd_ >= 0) close(listen_fd_);
+        listen_fd_ = -1;
+        return false;
+    }
+    listen_handle_ = IoReactor::instance().watch(
+        listen_fd_, 10, [this]() { acceptClients(); });
+    has_started_ = true;
     return true;
 }
 
+void TcpInputStream::acceptClients() {
+    int fd;
+    while ((fd = accept(listen_fd_, nullptr, nullptr)) >= 0) {
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+        std::lock_guard<std::mutex> lock(clients_mutex_);
+        clients_[fd].handle = IoReactor::instance().watch(
+            fd, 10, [this, fd]() { readClient(fd); });
+    }
+}
+
+void TcpInputStream::readClient(int fd) {
+    std::lock_guard<std::mutex> lock(clients_mutex_);
+    auto it = clients_.find(fd);
+    if (it == clients_.end()) return;  // stop() got to it first.
+    string& buffer = it->second.buffer;
+
+    char buf[1024];
+    ssize_t result;
+    while ((result = recv(fd, buf, sizeof(buf), 0)) > 0) {
+        buffer.append(buf, result);
+    }
+    const bool closed = result == 0 ||
+                        (errno != EAGAIN && errno != EWOULDBLOCK);
+    // Pass on every complete line; a partial one waits for the rest.
+    size_t begin = 0, end;
+    while ((end = buffer.find('\n', begin)) != string::npos) {
+        parseInput(buffer.substr(begin, end - begin));
+        begin = end + 1;
+    }
+    buffer.erase(0, begin);
+
+    if (closed) closeClient(fd);
+}
+
+void TcpInputStream::closeClient(int fd) {
+    // Called with clients_mutex_ held, from the client's own handler.
+    IoReactor::instance().remove(clients_[fd].handle);
+    clients_.erase(fd);
+    close(fd);
+}
+
+void TcpInputStream::stop() {
+    has_started_.store(false);
+    // Once the listening socket's handler is gone, no client can be added.
+    IoReactor::instance().remove(listen_handle_);
+    listen_handle_ = IoReactor::kInvalidHandle;
+    if (listen_fd_ >= 0) close(listen_fd_);
+    listen_fd_ = -1;
+
+    std::map<int, Client> clients;
+    {
+        std::lock_guard<std::mutex> lock(clients_mutex_);
+        clients.swap(clients_);
+    }
+    for (auto& client : clients) {
+        IoReactor::instance().remove(client.second.handle);
+        close(client.first);
+    }
+}
+#endif
+
 void TcpInputStream::parseInput(const string& buffer) {
     if (data_ready_callback_ != nullptr) {
         istringstream iss(buffer);
@@ -374,48 +540,18 @@ void TcpInputStream::parseInput(const string& buffer) {
             data.push_back(d);
 
         if (data.size() > 0) {
-            data = normalize(data);
-
             GRT::MatrixDouble matrix;
-            matrix.push_back(data);
+            matrix.push_back(applyNormalizer(data));
 
-            data_ready_callback_(matrix);
+            emitData(matrix);
         }
     }
 }
 
-void TcpInputStream::stop() {
-    has_started_.store(false);
-    server_->close();
-    if (reading_thread_ != nullptr && reading_thread_->joinable()) {
-        reading_thread_->join();
-    }
-}
-
 int TcpInputStream::getNumInputDimensions() {
     return dim_;
 }
 
-bool OscInputStream::start() {
-    receiver_.setup(port_num_);
-    has_started_ = true;
-
-    reading_thread_.reset(new std::thread([this]() {
-        int sleep_time = 10;
-        ofLog() << "OSC inputs are checked every " << sleep_time << " ms";
-        while (has_started_) {
-            std::this_thread::sleep_for(std::chrono::milliseconds(sleep_time));
-
-            ofxOscMessage m;
-            while (receiver_.hasWaitingMessages()) {
-                receiver_.getNextMessage(m);
-                handleMessage(m);
-            }
-        }
-    }));
-    return true;
-}
-
 void OscInputStream::handleMessage(ofxOscMessage& m) {
     // check for mouse moved message
     if (data_ready_callback_ != nullptr && m.getAddress() == addr_) {
@@ -425,17 +561,113 @@ void OscInputStream::handleMessage(ofxOscMessage& m) {
             data.push_back(m.getArgAsFloat(i));
         }
         matrix.push_back(data);
-        data_ready_callback_(matrix);
+        emitData(matrix);
+    }
+}
+
+#ifdef TARGET_WIN32
+bool OscInputStream::start() {
+    receiver_.setup(port_num_);
+    has_started_ = true;
+
+    timer_ = IoReactor::instance().addTimer(10, [this]() { checkMessages(); });
+    return true;
+}
+
+void OscInputStream::checkMessages() {
+    ofxOscMessage m;
+    while (receiver_.hasWaitingMessages()) {
+        receiver_.getNextMessage(m);
+        handleMessage(m);
     }
 }
 
 void OscInputStream::stop() {
     has_started_.store(false);
-    if (reading_thread_ != nullptr && reading_thread_->joinable()) {
-        reading_thread_->join();
+    IoReactor::instance().remove(timer_);
+    timer_ = IoReactor::kInvalidHandle;
+}
+#else
+bool OscInputStream::start() {
+    if (has_started_) return true;
+
+    socket_fd_ = bindSocket(SOCK_DGRAM, port_num_);
+    if (socket_fd_ < 0) {
+        ofLog(OF_LOG_ERROR) << "Can't listen on UDP port " << port_num_
+                            << ": " << strerror(errno);
+        return false;
+    }
+    socket_handle_ = IoReactor::instance().watch(
+        socket_fd_, 10, [this]() { readPackets(); });
+    has_started_ = true;
+    return true;
+}
+
+// Pass on the messages of `element`, and of the bundles within it, as
+// ofxOscReceiver would.
+static void forEachMessage(const osc::ReceivedBundleElement& element,
+                           const std::function<void(ofxOscMessage&)>& fn);
+
+static void forEachMessage(const osc::ReceivedBundle& bundle,
+                           const std::function<void(ofxOscMessage&)>& fn) {
+    for (auto it = bundle.ElementsBegin(); it != bundle.ElementsEnd(); ++it) {
+        forEachMessage(*it, fn);
     }
 }
 
+static void forEachMessage(const osc::ReceivedMessage& message,
+                           const std::function<void(ofxOscMessage&)>& fn) {
+    ofxOscMessage m;
+    m.setAddress(message.AddressPattern());
+    for (auto arg = message.ArgumentsBegin(); arg != message.ArgumentsEnd();
+         ++arg) {
+        if (arg->IsFloat()) {
+            m.addFloatArg(arg->AsFloatUnchecked());
+        } else if (arg->IsInt32()) {
+            m.addIntArg(arg->AsInt32Unchecked());
+        } else if (arg->IsString()) {
+            m.addStringArg(arg->AsStringUnchecked());
+        }
+    }
+    fn(m);
+}
+
+static void forEachMessage(const osc::ReceivedBundleElement& element,
+                           const std::function<void(ofxOscMessage&)>& fn) {
+    if (element.IsBundle()) {
+        forEachMessage(osc::ReceivedBundle(element), fn);
+    } else {
+        forEachMessage(osc::ReceivedMessage(element), fn);
+    }
+}
+
+void OscInputStream::readPackets() {
+    char buf[65536];
+    ssize_t size;
+    while ((size = recv(socket_fd_, buf, sizeof(buf), 0)) > 0) {
+        try {
+            osc::ReceivedPacket packet(buf, size);
+            auto handle = [this](ofxOscMessage& m) { handleMessage(m); };
+            if (packet.IsBundle()) {
+                forEachMessage(osc::ReceivedBundle(packet), handle);
+            } else {
+                forEachMessage(osc::ReceivedMessage(packet), handle);
+            }
+        } catch (osc::Exception& e) {
+            ofLog(OF_LOG_WARNING) << "Malformed OSC packet: " << e.what();
+        }
+    }
+}
+
+void OscInputStream::stop() {
+    has_started_.store(false);
+    IoReactor::instance().remove(socket_handle_);
+    socket_handle_ = IoReactor::kInvalidHandle;
+    if (socket_fd_ >= 0) close(socket_fd_);
+    socket_fd_ = -1;
+}
+#endif
+
 int OscInputStream::getNumInputDimensions() {
     return dim_;
 }
@@ -11,9 +11,15 @@
 #include "GRT/GRT.h"
 #include "ofMain.h"
 #include "ofxOsc.h"
+#include "audio-deinterleaver.h"
+#include "io-reactor.h"
+#include "serial-device-registry.h"
 #include "stream.h"
 
+#include <atomic>
 #include <cstdint>
+#include <map>
+#include <mutex>
 
 // See more documentation:
 // http://openframeworks.cc/documentation/sound/ofSoundStream/#show_setup
@@ -26,6 +32,10 @@ const uint32_t kOfSoundStream_nBuffers = 4;
  system.
  To use an InputStream instance in your application, pass it to useInputStream()
  in your setup() function.
+
+ Streams don't run threads of their own: they register handlers for their
+ serial ports, sockets and timers with the shared IoReactor, whose thread
+ calls the data ready callback.
  */
 class InputStream : public virtual Stream {
   public:
@@ -72,6 +82,15 @@ class InputStream : public virtual Stream {
         data_ready_callback_ = std::bind(listenerMethod, owner, _1);
     }
 
+    // Called with the new number of input dimensions when a stream whose
+    // device announces it (e.g. BinaryIntArraySerialStream) starts sending
+    // a different number. Called on the stream's (IoReactor) thread.
+    typedef std::function<void(int)> onDimensionsChangedCallback;
+
+    void onDimensionsChangedEvent(onDimensionsChangedCallback callback) {
+        dimensions_changed_callback_ = callback;
+    }
+
     // Set labels on all input dimension. This function takes either a vector of
     // strings, or an initialization list (such as {"left", "right"}).
     void setLabelsForAllDimensions(const vector<string> labels);
@@ -79,27 +98,82 @@ class InputStream : public virtual Stream {
 
     const vector<string>& getLabels() const;
 
+    // Pass on only the given dimensions of the (normalized) data, in the
+    // given order, e.g. those kept by FeatureAblation::selectDimensions().
+    // Labels set before are selected too. An empty list passes on all.
+    void useDimensions(const vector<uint32_t>& dimensions);
+
+    // Apply the normalization function, if any, to one vector of data, and
+    // keep the dimensions chosen with useDimensions().
+    vector<double> normalize(vector<double>);
+
   protected:
+    // Apply the normalization function, if any, to one vector of data.
+    vector<double> applyNormalizer(vector<double> data) const;
+
+    // Keep the dimensions chosen with useDimensions() of `data`.
+    vector<double> selectDimensions(vector<double> data) const;
+
+    // Pass (normalized) data on to the data ready callback, keeping only the
+    // dimensions chosen with useDimensions() of each row. Every stream emits
+    // its data through here.
+    void emitData(const GRT::MatrixDouble& data);
+
     vector<string> InputStream_labels_;
+    vector<uint32_t> selected_dimensions_;
     onDataReadyCallback data_ready_callback_;
+    onDimensionsChangedCallback dimensions_changed_callback_;
     normalizeFunc normalizer_;
     vectorNormalizeFunc vectorNormalizer_;
-
-    vector<double> normalize(vector<double>);
 };
 
 /**
  @brief Input stream for reading audio from the computer's microphone.
+
+ By default, the left channel of the default stereo input device is read. For
+ multichannel devices (e.g. microphone arrays), all channels or a subset of
+ them can be read instead, one dimension per channel, or mixed down to one.
+ Each buffer from the sound card is passed on as a single block of frames.
  */
 class AudioStream : public ofBaseApp, public InputStream {
   public:
+    /**
+     Read the left channel of the default stereo input device.
+     @param downsample_rate: keep one of every this many audio frames
+     */
     AudioStream(uint32_t downsample_rate = 1);
+
+    /**
+     Read several channels of the default input device.
+     @param downsample_rate: keep one of every this many audio frames
+     @param num_device_channels: the number of channels to open the device
+     with
+     @param channels: the device channels to read, in the order in which they
+     appear in the data; empty (the default) for all of them
+     */
+    AudioStream(uint32_t downsample_rate, uint32_t num_device_channels,
+                vector<uint32_t> channels = {});
+
+    /**
+     Deliver the average of the selected channels as a single dimension. Must
+     be called before the stream is started.
+     */
+    void useMixDown(bool mix_down = true);
+
+    /**
+     Average each group of `downsample_rate` frames instead of keeping only
+     the first, which reduces aliasing. Must be called before the stream is
+     started.
+     */
+    void useAveragingDecimation(bool averaging = true);
+
     void audioIn(float *input, int buffer_size, int nChannel);
     virtual bool start() final;
     virtual void stop() final;
     virtual int getNumInputDimensions() final;
   private:
-    uint32_t downsample_rate_;
+    AudioDeinterleaver deinterleaver_;
+    GRT::MatrixDouble block_;
     unique_ptr<ofSoundStream> sound_stream_;
     bool setup_successful_;
 };
@@ -120,7 +194,22 @@ class AudioFileStream : public InputStream {
     void readSpectrum();
 
     ofSoundPlayer player_;
-    unique_ptr<std::thread> update_thread_;
+    IoReactor::Handle timer_ = IoReactor::kInvalidHandle;
+};
+
+/**
+ @brief An ofSerial whose file descriptor can be waited on by the IoReactor
+ (-1 on Windows, where serial ports are polled instead).
+ */
+class ReactorSerial : public ofSerial {
+  public:
+    int getFileDescriptor() const {
+#ifdef TARGET_WIN32
+        return -1;
+#else
+        return fd;
+#endif
+    }
 };
 
 class BaseSerialInputStream : public virtual InputStream {
@@ -148,44 +237,55 @@ class BaseSerialInputStream : public virtual InputStream {
     virtual void stop() final;
     virtual int getNumInputDimensions() final;
 
+    // Descriptions of the serial ports, from SerialDeviceRegistry.
     vector<string> getSerialDeviceList() {
-        serial_->listDevices();
         vector<string> retval;
-        vector<ofSerialDeviceInfo> device_list = serial_->getDeviceList();
-        retval.reserve(device_list.size());
-        for (auto& d : device_list) {
-            retval.push_back(d.getDevicePath());
+        for (auto& d : SerialDeviceRegistry::instance().getDevices()) {
+            retval.push_back(d.getDescription());
         }
         return retval;
     }
 
+    // Start reading from the `port`-th port of getSerialDeviceList(), and
+    // remember it as the one to select next time.
     bool selectSerialDevice(uint32_t port) {
         assert(has_started_ == false
                && "Should only reach here if ASCIISerialStream hasn't started");
 
+        SerialDeviceRegistry& registry = SerialDeviceRegistry::instance();
+        vector<SerialDeviceRegistry::Device> devices = registry.getDevices();
+        if (port >= devices.size()) return false;
+
         port_ = port;
-        if (!serial_->setup(port_, baud_)) {
+        if (!serial_->setup(devices[port].path, baud_)) {
             return false;
         }
+        registry.remember(devices[port]);
 
-        reading_thread_.reset(new std::thread(&BaseSerialInputStream::readSerial, this));
+        watchSerial();
         has_started_ = true;
         return true;
     }
 
   protected:
+    // Parse (and remove) the first complete packet, if any, in `buffer`.
     virtual void parseSerial(vector<unsigned char> &buffer) = 0;
-    unique_ptr<ofSerial> serial_;
+    unique_ptr<ReactorSerial> serial_;
+
+    // Adopt the number of dimensions the device sends, and tell the
+    // dimensions changed callback, if any.
+    void setNumInputDimensions(int dimensions);
 
   private:
     uint32_t port_ = -1;
     uint32_t baud_;
-    int dimensions_;
+    std::atomic<int> dimensions_;
 
     vector<unsigned char> buffer_;
 
-    // A separate reading thread to read data from Serial.
-    unique_ptr<std::thread> reading_thread_;
+    // Called by the IoReactor when the serial port has data.
+    IoReactor::Handle reading_handle_ = IoReactor::kInvalidHandle;
+    void watchSerial();
     void readSerial();
 };
 
@@ -201,10 +301,11 @@ class SerialStream : public InputStream {
     // Serial buffer size
     uint32_t kBufferSize_ = 64;
 
-    unique_ptr<ofSerial> serial_;
+    unique_ptr<ReactorSerial> serial_;
+    vector<uint8_t> bytes_;
 
-    // A separate reading thread to read data from Serial.
-    unique_ptr<std::thread> reading_thread_;
+    // Called by the IoReactor when the serial port has data.
+    IoReactor::Handle reading_handle_ = IoReactor::kInvalidHandle;
     void readSerial();
 };
 
@@ -242,7 +343,8 @@ class FirmataStream : public InputStream {
     bool configured_arduino_;
 
     ofArduino arduino_;
-    unique_ptr<std::thread> update_thread_;
+    // ofArduino reads its serial port itself, so update() runs on a timer.
+    IoReactor::Handle update_timer_ = IoReactor::kInvalidHandle;
     void update();
 };
 
@@ -250,7 +352,8 @@ class FirmataStream : public InputStream {
 class ofxTCPServer;
 
 /**
- @brief Listening for data inputs over a TCP socket.
+ @brief Listening for data inputs over a TCP socket: lines of numbers
+ separated by whitespace, one sample per line, from any number of clients.
  */
 class TcpInputStream : public InputStream {
   public:
@@ -264,8 +367,26 @@ class TcpInputStream : public InputStream {
 
   private:
     void parseInput(const string& buffer);
+#ifdef TARGET_WIN32
+    // Winsock sockets can't be waited on by the reactor, so ofxTCPServer's
+    // clients are checked on a timer.
+    void checkClients();
     ofxTCPServer* server_;
-    unique_ptr<std::thread> reading_thread_;
+    IoReactor::Handle timer_ = IoReactor::kInvalidHandle;
+#else
+    struct Client {
+        IoReactor::Handle handle;
+        string buffer;  // The start of a line that's yet to be completed.
+    };
+    void acceptClients();
+    void readClient(int fd);
+    void closeClient(int fd);
+    int listen_fd_ = -1;
+    IoReactor::Handle listen_handle_ = IoReactor::kInvalidHandle;
+    // By socket. Guarded by clients_mutex_, since stop() closes them.
+    std::map<int, Client> clients_;
+    std::mutex clients_mutex_;
+#endif
     int port_num_;
     int dim_;
 };
@@ -285,9 +406,17 @@ class OscInputStream : public InputStream {
     virtual int getNumInputDimensions() final;
 
   private:
-    void parseInput(const string& buffer);
+#ifdef TARGET_WIN32
+    // ofxOscReceiver listens on its own thread and queues the messages,
+    // which are checked on a timer.
+    void checkMessages();
     ofxOscReceiver receiver_;
-    unique_ptr<std::thread> reading_thread_;
+    IoReactor::Handle timer_ = IoReactor::kInvalidHandle;
+#else
+    void readPackets();
+    int socket_fd_ = -1;
+    IoReactor::Handle socket_handle_ = IoReactor::kInvalidHandle;
+#endif
     int port_num_;
     string addr_;
     int dim_;
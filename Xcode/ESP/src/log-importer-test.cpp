@@ -0,0 +1,162 @@
+#include "log-importer.h"
+#include "training-data-manager.h"
+#include "gtest/gtest.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+
+static bool parse(const char* s, double* value) {
+    const char* p = s;
+    const char* end = s + strlen(s);
+    return LogImporter::parseNumber(p, end, value) && p == end;
+}
+
+TEST(LogImporterTest, ParseNumber) {
+    const char* numbers[] = {
+        "0", "-0", "42", "+7", "3.25", "-0.001", ".5", "5.", "1e3", "2.5E-4",
+        "123456789012345", "0.1", "1.7976931348623157e308", "4.9e-324",
+        "12345678901234567890", "3.14159265358979323846",
+    };
+    for (const char* s : numbers) {
+        double value;
+        ASSERT_TRUE(parse(s, &value)) << s;
+        ASSERT_EQ(strtod(s, nullptr), value) << s;
+    }
+
+    double value;
+    ASSERT_FALSE(parse("", &value));
+    ASSERT_FALSE(parse("-", &value));
+    ASSERT_FALSE(parse("abc", &value));
+    ASSERT_FALSE(parse("1.5x", &value));
+
+    // Parsing stops at the first character that isn't part of the number.
+    const char* s = "12,34";
+    const char* p = s;
+    ASSERT_TRUE(LogImporter::parseNumber(p, s + strlen(s), &value));
+    ASSERT_EQ(12, value);
+    ASSERT_EQ(',', *p);
+}
+
+TEST(LogImporterTest, LabelColumn) {
+    const char* text =
+        "label\tx\ty\n"
+        "0\t1\t2\n"
+        "1\t3\t4\n"
+        "1\t5\t6\r\n"
+        "# comment\n"
+        "\n"
+        "0\t7\t8\n"
+        "2\t9\t10\n"
+        "2\tbad\t11\n"
+        "2\t12\n"
+        "1\t13\t14";
+
+    LogImporter::Options options;
+    options.label_column = 0;
+    LogImporter importer(options);
+    ASSERT_TRUE(importer.parse(text, strlen(text)));
+
+    ASSERT_EQ(6, importer.getNumRows());
+    ASSERT_EQ(2, importer.getNumDimensions());
+    ASSERT_EQ(2, importer.getNumSkippedLines());
+    ASSERT_EQ(vector<string>({"x", "y"}), importer.getColumnNames());
+
+    vector<LogImporter::Sample> samples = importer.getSamples();
+    ASSERT_EQ(3, samples.size());
+    ASSERT_EQ(1, samples[0].label);
+    ASSERT_EQ(2, samples[0].end - samples[0].begin);
+    ASSERT_EQ(2, samples[1].label);
+    ASSERT_EQ(1, samples[2].label);
+
+    GRT::MatrixDouble sample = importer.getSampleData(samples[0]);
+    ASSERT_EQ(2, sample.getNumRows());
+    ASSERT_EQ(3, sample[0][0]);
+    ASSERT_EQ(6, sample[1][1]);
+
+    TrainingDataManager manager(2);
+    manager.setNumDimensions(2);
+    ASSERT_EQ(3, importer.addSamplesTo(manager));
+    ASSERT_EQ(2, manager.getNumSampleForLabel(1));
+    ASSERT_EQ(1, manager.getNumSampleForLabel(2));
+    ASSERT_EQ(13, manager.getSample(1, 1)[0][0]);
+}
+
+TEST(LogImporterTest, TimeRanges) {
+    const char* text =
+        "0.0, 1, 10\n"
+        "0.5, 2, 20\n"
+        "1.0, 3, 30\n"
+        "1.5, 4, 40\n"
+        "2.0, 5, 50\n";
+
+    LogImporter::Options options;
+    options.time_column = 0;
+    LogImporter importer(options);
+    importer.addTimeRange(0.5, 1.5, 3);
+    importer.addTimeRange(1.5, 10, 1);
+    importer.addTimeRange(20, 30, 2);
+    ASSERT_TRUE(importer.parse(text, strlen(text)));
+    ASSERT_EQ(5, importer.getNumRows());
+    ASSERT_EQ(2, importer.getNumDimensions());
+
+    vector<LogImporter::Sample> samples = importer.getSamples();
+    ASSERT_EQ(2, samples.size());
+    ASSERT_EQ(3, samples[0].label);
+    ASSERT_EQ(1, samples[0].begin);
+    ASSERT_EQ(3, samples[0].end);
+    ASSERT_EQ(1, samples[1].label);
+    ASSERT_EQ(3, samples[1].begin);
+    ASSERT_EQ(5, samples[1].end);
+
+    // Transforms, e.g. normalization, may change the number of dimensions.
+    ASSERT_TRUE(importer.transformRows([](vector<double> row) {
+        return vector<double>{row[0] + row[1]};
+    }));
+    ASSERT_EQ(1, importer.getNumDimensions());
+    ASSERT_EQ(44, importer.getData()[3][0]);
+}
+
+TEST(LogImporterTest, ParallelMatchesSerial) {
+    const char* filename = "LogImporterTest.tsv";
+    {
+        std::ofstream file(filename);
+        srand(0);
+        for (int i = 0; i < 20000; i++) {
+            file << (i / 100) % 4 << "\t" << i << "\t"
+                 << (rand() % 20001 - 10000) / 1000.0 << "\t"
+                 << rand() * 1e-6 << "\n";
+        }
+    }
+
+    LogImporter::Options options;
+    options.label_column = 0;
+    options.num_threads = 1;
+    LogImporter serial(options);
+    ASSERT_TRUE(serial.load(filename));
+
+    options.num_threads = 8;
+    LogImporter parallel(options);
+    double last_progress = 0;
+    parallel.setProgressCallback([&last_progress](double progress) {
+        ASSERT_GE(progress, last_progress);
+        last_progress = progress;
+    });
+    ASSERT_TRUE(parallel.load(filename));
+    std::remove(filename);
+
+    ASSERT_EQ(1.0, last_progress);
+    ASSERT_EQ(20000, parallel.getNumRows());
+    ASSERT_EQ(serial.getNumRows(), parallel.getNumRows());
+    for (uint32_t r = 0; r < serial.getNumRows(); r++) {
+        ASSERT_EQ(r, parallel.getData()[r][0]);
+        for (uint32_t c = 0; c < 3; c++) {
+            ASSERT_EQ(serial.getData()[r][c], parallel.getData()[r][c]);
+        }
+    }
+    ASSERT_EQ(150, parallel.getSamples().size());
+
+    ASSERT_FALSE(parallel.load(filename));
+    ASSERT_FALSE(parallel.getErrorMessage().empty());
+}
@@ -0,0 +1,469 @@
+#include "log-importer.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX  // keep std::min and std::max usable
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "task-scheduler.h"
+#include "training-data-manager.h"
+
+// Chunks smaller than this aren't worth a thread of their own.
+static const size_t kMinChunkSize = 64 * 1024;
+
+// Number of chunks per thread, so that threads that finish early can help
+// with the rest.
+static const size_t kChunksPerThread = 4;
+
+// Powers of ten that are exactly representable as a double.
+static const double kExactPowersOfTen[] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+};
+
+static inline bool isSeparator(char c) {
+    return c == ' ' || c == '\t' || c == ',' || c == ';' || c == '\r';
+}
+
+static inline bool isDigit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+namespace {
+
+// Read-only view of a whole file, memory-mapped where possible.
+class MappedFile {
+  public:
+    ~MappedFile() { close(); }
+
+    bool open(const string& filename) {
+#ifdef _WIN32
+        file_ = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ,
+                            NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+        if (file_ == INVALID_HANDLE_VALUE) return false;
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(file_, &size)) return false;
+        size_ = (size_t) size.QuadPart;
+        if (size_ == 0) return true;
+        mapping_ = CreateFileMappingA(file_, NULL, PAGE_READONLY, 0, 0, NULL);
+        if (mapping_ == NULL) return false;
+        data_ = (const char*) MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0);
+        return data_ != nullptr;
+#else
+        fd_ = ::open(filename.c_str(), O_RDONLY);
+        if (fd_ < 0) return false;
+        struct stat st;
+        if (fstat(fd_, &st) != 0) return false;
+        size_ = (size_t) st.st_size;
+        if (size_ == 0) return true;
+        void* p = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd_, 0);
+        if (p == MAP_FAILED) return false;
+        data_ = (const char*) p;
+        return true;
+#endif
+    }
+
+    void close() {
+#ifdef _WIN32
+        if (data_ != nullptr) UnmapViewOfFile(data_);
+        if (mapping_ != NULL) CloseHandle(mapping_);
+        if (file_ != INVALID_HANDLE_VALUE) CloseHandle(file_);
+        mapping_ = NULL;
+        file_ = INVALID_HANDLE_VALUE;
+#else
+        if (data_ != nullptr) munmap((void*) data_, size_);
+        if (fd_ >= 0) ::close(fd_);
+        fd_ = -1;
+#endif
+        data_ = nullptr;
+        size_ = 0;
+    }
+
+    const char* data() const { return data_; }
+    size_t size() const { return size_; }
+
+  private:
+#ifdef _WIN32
+    HANDLE file_ = INVALID_HANDLE_VALUE;
+    HANDLE mapping_ = NULL;
+#else
+    int fd_ = -1;
+#endif
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+// The numbers of one chunk of the text, row after row.
+struct ParsedChunk {
+    vector<double> values;
+    vector<uint32_t> row_sizes;
+    vector<string> header;
+    uint32_t num_skipped_lines = 0;
+};
+
+void parseChunk(const char* p, const char* end, bool is_first_chunk,
+                ParsedChunk* chunk) {
+    bool seen_data = false;
+    while (p < end) {
+        const char* eol = (const char*) memchr(p, '\n', end - p);
+        if (eol == nullptr) eol = end;
+
+        while (p < eol && isSeparator(*p)) p++;
+        if (p == eol || *p == '#') {
+            p = eol + 1;
+            continue;
+        }
+
+        size_t row_start = chunk->values.size();
+        bool ok = true;
+        const char* line = p;
+        while (p < eol) {
+            double value;
+            if (!LogImporter::parseNumber(p, eol, &value) ||
+                (p < eol && !isSeparator(*p))) {
+                ok = false;
+                break;
+            }
+            chunk->values.push_back(value);
+            while (p < eol && isSeparator(*p)) p++;
+        }
+
+        if (ok) {
+            chunk->row_sizes.push_back(chunk->values.size() - row_start);
+        } else {
+            chunk->values.resize(row_start);
+            if (is_first_chunk && !seen_data && chunk->header.empty()) {
+                // Column names.
+                p = line;
+                while (p < eol) {
+                    const char* name = p;
+                    while (p < eol && !isSeparator(*p)) p++;
+                    chunk->header.push_back(string(name, p));
+                    while (p < eol && isSeparator(*p)) p++;
+                }
+            } else {
+                chunk->num_skipped_lines++;
+            }
+        }
+        seen_data = true;
+        p = eol + 1;
+    }
+}
+
+}  // namespace
+
+bool LogImporter::parseNumber(const char*& p, const char* end, double* value) {
+    const char* s = p;
+    bool negative = false;
+    if (s < end && (*s == '+' || *s == '-')) {
+        negative = *s == '-';
+        s++;
+    }
+
+    // Up to 19 significant digits fit in the mantissa; the exponent keeps
+    // track of the position of the decimal point.
+    uint64_t mantissa = 0;
+    int num_digits = 0;
+    int exponent = 0;
+    bool has_digits = false;
+    for (; s < end && isDigit(*s); s++) {
+        has_digits = true;
+        if (num_digits < 19) {
+            mantissa = mantissa * 10 + (*s - '0');
+            if (mantissa != 0) num_digits++;
+        } else {
+            exponent++;
+        }
+    }
+    if (s < end && *s == '.') {
+        for (s++; s < end && isDigit(*s); s++) {
+            has_digits = true;
+            if (num_digits < 19) {
+                mantissa = mantissa * 10 + (*s - '0');
+                if (mantissa != 0) num_digits++;
+                exponent--;
+            }
+        }
+    }
+
+    if (has_digits && s < end && (*s == 'e' || *s == 'E')) {
+        const char* e = s + 1;
+        bool negative_exponent = false;
+        if (e < end && (*e == '+' || *e == '-')) {
+            negative_exponent = *e == '-';
+            e++;
+        }
+        if (e < end && isDigit(*e)) {
+            int n = 0;
+            for (; e < end && isDigit(*e); e++) {
+                if (n < 100000) n = n * 10 + (*e - '0');
+            }
+            exponent += negative_exponent ? -n : n;
+            s = e;
+        }
+    }
+
+    if (has_digits && num_digits <= 15 && exponent >= -22 && exponent <= 22) {
+        // Both the mantissa and the power of ten are exact, so a single
+        // multiplication or division rounds correctly.
+        double d = (double) mantissa;
+        d = exponent < 0 ? d / kExactPowersOfTen[-exponent]
+                         : d * kExactPowersOfTen[exponent];
+        *value = negative ? -d : d;
+        p = s;
+        return true;
+    }
+
+    // Slow path: long mantissas, large exponents, "nan" and "inf". strtod()
+    // needs a terminated string, which the mapped file doesn't provide.
+    const char* token_end = p;
+    while (token_end < end && !isSeparator(*token_end) && *token_end != '\n') {
+        token_end++;
+    }
+    string token(p, token_end);
+    char* parsed_end = nullptr;
+    double d = strtod(token.c_str(), &parsed_end);
+    if (parsed_end == token.c_str()) return false;
+    *value = d;
+    p += parsed_end - token.c_str();
+    return true;
+}
+
+void LogImporter::addTimeRange(double start, double end, uint32_t label) {
+    time_ranges_.push_back(TimeRange{start, end, label});
+}
+
+bool LogImporter::load(const string& filename) {
+    MappedFile file;
+    if (!file.open(filename)) {
+        data_.clear();
+        labels_.clear();
+        times_.clear();
+        column_names_.clear();
+        num_skipped_lines_ = 0;
+        error_message_ = "Failed to open " + filename;
+        return false;
+    }
+    return parse(file.data(), file.size());
+}
+
+bool LogImporter::parse(const char* text, size_t size) {
+    data_.clear();
+    labels_.clear();
+    times_.clear();
+    column_names_.clear();
+    num_skipped_lines_ = 0;
+    error_message_.clear();
+
+    // Split the text into chunks that start at the beginning of a line.
+    uint32_t num_threads = options_.num_threads;
+    if (num_threads == 0) {
+        num_threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    size_t num_chunks = std::max<size_t>(1, std::min<size_t>(
+        size / kMinChunkSize, num_threads * kChunksPerThread));
+    vector<size_t> bounds(1, 0);
+    for (size_t i = 1; i < num_chunks; i++) {
+        size_t pos = std::max(bounds.back(), size * i / num_chunks);
+        const char* eol = (const char*) memchr(text + pos, '\n', size - pos);
+        if (eol == nullptr) break;
+        bounds.push_back(eol + 1 - text);
+    }
+    bounds.push_back(size);
+    num_chunks = bounds.size() - 1;
+    num_threads = std::min<size_t>(num_threads, num_chunks);
+
+    // Every task, plus this thread, takes the next unparsed chunk until none
+    // are left. Progress is reported from this thread only.
+    vector<ParsedChunk> chunks(num_chunks);
+    std::atomic<size_t> next_chunk(0);
+    std::atomic<size_t> bytes_parsed(0);
+    auto work = [&](bool report_progress) {
+        for (size_t i = next_chunk++; i < num_chunks; i = next_chunk++) {
+            parseChunk(text + bounds[i], text + bounds[i + 1], i == 0,
+                       &chunks[i]);
+            bytes_parsed += bounds[i + 1] - bounds[i];
+            if (report_progress && progress_callback_ != nullptr) {
+                progress_callback_(size > 0 ? (double) bytes_parsed / size : 1);
+            }
+        }
+    };
+    vector<TaskScheduler::TaskHandle> tasks;
+    for (uint32_t i = 1; i < num_threads; i++) {
+        tasks.push_back(TaskScheduler::instance().submit(
+            TaskScheduler::kBulk, [&work] { work(false); }));
+    }
+    work(true);
+    for (const TaskScheduler::TaskHandle& task : tasks) task.wait();
+
+    // The first data line decides the number of columns.
+    uint32_t num_columns = 0;
+    for (const ParsedChunk& chunk : chunks) {
+        if (!chunk.row_sizes.empty()) {
+            num_columns = chunk.row_sizes[0];
+            break;
+        }
+    }
+    if (num_columns == 0) {
+        error_message_ = "No data found";
+        return false;
+    }
+
+    const int label_column = options_.label_column;
+    const int time_column = options_.time_column;
+    if (label_column >= (int) num_columns || time_column >= (int) num_columns) {
+        error_message_ = "Label or time column out of range, the data has " +
+                         std::to_string(num_columns) + " columns";
+        return false;
+    }
+    uint32_t dim = num_columns - (label_column >= 0 ? 1 : 0) -
+                   (time_column >= 0 && time_column != label_column ? 1 : 0);
+    if (dim == 0) {
+        error_message_ = "No data columns besides the label and time";
+        return false;
+    }
+
+    auto is_valid = [&](const double* row, uint32_t row_size) {
+        if (row_size != num_columns) return false;
+        if (label_column < 0) return true;
+        double label = row[label_column];
+        return label >= 0 && label == std::floor(label) && label < 4294967296.0;
+    };
+
+    uint32_t num_rows = 0;
+    for (ParsedChunk& chunk : chunks) {
+        const double* row = chunk.values.data();
+        for (uint32_t row_size : chunk.row_sizes) {
+            if (is_valid(row, row_size)) {
+                num_rows++;
+            } else {
+                chunk.num_skipped_lines++;
+            }
+            row += row_size;
+        }
+        num_skipped_lines_ += chunk.num_skipped_lines;
+    }
+
+    data_.resize(num_rows, dim);
+    if (label_column >= 0) labels_.resize(num_rows);
+    times_.resize(num_rows);
+    uint32_t r = 0;
+    for (const ParsedChunk& chunk : chunks) {
+        const double* row = chunk.values.data();
+        for (uint32_t row_size : chunk.row_sizes) {
+            if (is_valid(row, row_size)) {
+                double* out = data_[r];
+                for (uint32_t c = 0; c < num_columns; c++) {
+                    if ((int) c == label_column || (int) c == time_column) {
+                        continue;
+                    }
+                    *out++ = row[c];
+                }
+                if (label_column >= 0) labels_[r] = (uint32_t) row[label_column];
+                times_[r] = time_column >= 0 ? row[time_column] : r;
+                r++;
+            }
+            row += row_size;
+        }
+    }
+
+    const vector<string>& header = chunks[0].header;
+    if (header.size() == num_columns) {
+        for (uint32_t c = 0; c < num_columns; c++) {
+            if ((int) c == label_column || (int) c == time_column) continue;
+            column_names_.push_back(header[c]);
+        }
+    }
+
+    if (progress_callback_ != nullptr) progress_callback_(1.0);
+
+    if (num_rows == 0) {
+        error_message_ = "No valid data lines found";
+        return false;
+    }
+    return true;
+}
+
+vector<LogImporter::Sample> LogImporter::getSamples() const {
+    vector<Sample> samples;
+    uint32_t num_rows = data_.getNumRows();
+
+    if (!time_ranges_.empty()) {
+        for (const TimeRange& range : time_ranges_) {
+            // Time stamps are usually increasing, but needn't be: take the
+            // rows from the first to the last one in the range.
+            uint32_t begin = num_rows, end = 0;
+            for (uint32_t r = 0; r < num_rows; r++) {
+                if (times_[r] >= range.start && times_[r] < range.end) {
+                    begin = std::min(begin, r);
+                    end = r + 1;
+                }
+            }
+            if (begin < end) samples.push_back(Sample{range.label, begin, end});
+        }
+    } else if (!labels_.empty()) {
+        uint32_t begin = 0;
+        for (uint32_t r = 1; r <= num_rows; r++) {
+            if (r == num_rows || labels_[r] != labels_[begin]) {
+                if (labels_[begin] != 0) {
+                    samples.push_back(Sample{labels_[begin], begin, r});
+                }
+                begin = r;
+            }
+        }
+    }
+    return samples;
+}
+
+GRT::MatrixDouble LogImporter::getSampleData(const Sample& sample) const {
+    uint32_t dim = data_.getNumCols();
+    GRT::MatrixDouble matrix(sample.end - sample.begin, dim);
+    for (uint32_t r = sample.begin; r < sample.end; r++) {
+        std::copy(data_[r], data_[r] + dim, matrix[r - sample.begin]);
+    }
+    return matrix;
+}
+
+bool LogImporter::transformRows(
+        std::function<vector<double>(vector<double>)> f) {
+    uint32_t num_rows = data_.getNumRows();
+    if (num_rows == 0) return true;
+
+    vector<double> first = f(data_.getRowVector(0));
+    if (first.empty()) return false;
+
+    GRT::MatrixDouble transformed(num_rows, first.size());
+    std::copy(first.begin(), first.end(), transformed[0]);
+    for (uint32_t r = 1; r < num_rows; r++) {
+        vector<double> row = f(data_.getRowVector(r));
+        if (row.size() != first.size()) return false;
+        std::copy(row.begin(), row.end(), transformed[r]);
+    }
+    data_ = transformed;
+    return true;
+}
+
+uint32_t LogImporter::addSamplesTo(TrainingDataManager& manager) const {
+    uint32_t num_added = 0;
+    for (const Sample& sample : getSamples()) {
+        if (sample.label >= 1 && sample.label <= manager.getNumLabels() &&
+            manager.addSample(sample.label, getSampleData(sample))) {
+            num_added++;
+        }
+    }
+    return num_added;
+}
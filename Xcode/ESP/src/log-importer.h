@@ -0,0 +1,130 @@
+/** @file log-importer.h
+ *  @brief LogImporter loads sensor logs saved as CSV or TSV text into training
+ *  or test data.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <GRT/GRT.h>
+
+using std::string;
+using std::vector;
+
+class TrainingDataManager;
+
+/**
+ *  @brief LogImporter parses text logs with one data point per line, in the
+ *  format that ASCIISerialStream reads: numbers separated by tabs, spaces,
+ *  commas or semicolons. An optional first line of column names is skipped,
+ *  as are lines starting with '#'.
+ *
+ *  The file is memory-mapped and split into chunks at line boundaries, which
+ *  are parsed in parallel. Lines that don't parse, or that have a different
+ *  number of columns than the first data line, are skipped and counted.
+ *
+ *  The rows can be used as test data as they are, or split into labelled
+ *  samples (see getSamples()), either by a label column or by time ranges.
+ */
+class LogImporter {
+  public:
+    struct Options {
+        /// Column holding the class label of each row, or -1 for none.
+        int label_column = -1;
+
+        /// Column holding the time stamp of each row, or -1 to use the row
+        /// index as time stamp. Only used to match time ranges.
+        int time_column = -1;
+
+        /// Number of chunks parsed at once on the shared TaskScheduler, or 0
+        /// for one per core.
+        uint32_t num_threads = 0;
+    };
+
+    /// @brief Rows [begin, end) of the data, all with the same label.
+    struct Sample {
+        uint32_t label;
+        uint32_t begin;
+        uint32_t end;
+    };
+
+    /// @brief Called with the fraction of the file parsed so far, always on
+    /// the thread that called load() or parse().
+    using ProgressCallback = std::function<void(double)>;
+
+    LogImporter() = default;
+    explicit LogImporter(const Options& options) : options_(options) {}
+
+    void setOptions(const Options& options) { options_ = options; }
+    const Options& getOptions() const { return options_; }
+
+    /// @brief Label the rows whose time stamp is in [start, end). When any
+    /// time range is set, the label column is ignored by getSamples().
+    void addTimeRange(double start, double end, uint32_t label);
+    void clearTimeRanges() { time_ranges_.clear(); }
+
+    void setProgressCallback(ProgressCallback callback) {
+        progress_callback_ = callback;
+    }
+
+    /// @brief Parse the file. Returns false, with getErrorMessage() set, if
+    /// the file can't be read or holds no data.
+    bool load(const string& filename);
+
+    /// @brief Parse `size` bytes of text.
+    bool parse(const char* text, size_t size);
+
+    /// @brief The parsed rows, without the label and time columns.
+    const GRT::MatrixDouble& getData() const { return data_; }
+    uint32_t getNumRows() const { return data_.getNumRows(); }
+    uint32_t getNumDimensions() const { return data_.getNumCols(); }
+
+    /// @brief Names of the data columns if the file has a header line.
+    const vector<string>& getColumnNames() const { return column_names_; }
+
+    uint32_t getNumSkippedLines() const { return num_skipped_lines_; }
+    const string& getErrorMessage() const { return error_message_; }
+
+    /// @brief Split the rows into samples. With time ranges, each range with
+    /// at least one row is a sample. Otherwise each run of consecutive rows
+    /// with the same label in the label column is a sample; rows labelled 0
+    /// separate samples. Without either, there are no samples.
+    vector<Sample> getSamples() const;
+    GRT::MatrixDouble getSampleData(const Sample& sample) const;
+
+    /// @brief Replace every row with f(row), e.g. to apply the normalizer and
+    /// calibration of the live input. Every output must have the same size.
+    bool transformRows(std::function<vector<double>(vector<double>)> f);
+
+    /// @brief Add all samples to `manager`. Returns the number added; samples
+    /// with labels the manager doesn't accept are left out.
+    uint32_t addSamplesTo(TrainingDataManager& manager) const;
+
+    /// @brief Parse a number at `p`, stopping at `end` or at the first
+    /// character that can't be part of it, and advance `p` past it. Decimal
+    /// numbers with up to 15 significant digits are converted exactly without
+    /// calling strtod().
+    static bool parseNumber(const char*& p, const char* end, double* value);
+
+  private:
+    struct TimeRange {
+        double start;
+        double end;
+        uint32_t label;
+    };
+
+    Options options_;
+    vector<TimeRange> time_ranges_;
+    ProgressCallback progress_callback_;
+
+    GRT::MatrixDouble data_;
+    vector<uint32_t> labels_;
+    vector<double> times_;
+    vector<string> column_names_;
+    uint32_t num_skipped_lines_ = 0;
+    string error_message_;
+};
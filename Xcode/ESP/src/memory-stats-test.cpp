@@ -0,0 +1,47 @@
+#include "memory-stats.h"
+#include "gtest/gtest.h"
+
+TEST(MemoryStatsTest, TracksCurrentAndHighWater) {
+    MemoryStats stats;
+    stats.update("Plots", 100);
+    stats.update("Samples", 300);
+    stats.update("Plots", 50);
+
+    ASSERT_EQ(50, stats.getCurrent("Plots"));
+    ASSERT_EQ(100, stats.getHighWater("Plots"));
+    ASSERT_EQ(350, stats.getTotal());
+    ASSERT_EQ(400, stats.getTotalHighWater());
+
+    stats.update("Samples", 10);
+    ASSERT_EQ(60, stats.getTotal());
+    ASSERT_EQ(400, stats.getTotalHighWater());
+    ASSERT_EQ(300, stats.getHighWater("Samples"));
+
+    ASSERT_EQ(0, stats.getCurrent("Unknown"));
+    ASSERT_EQ(vector<string>({ "Plots", "Samples" }), stats.getSubsystems());
+}
+
+TEST(MemoryStatsTest, Clear) {
+    MemoryStats stats;
+    stats.update("Plots", 100);
+    stats.clear();
+    ASSERT_EQ(0, stats.getTotal());
+    ASSERT_EQ(0, stats.getTotalHighWater());
+    ASSERT_TRUE(stats.getSubsystems().empty());
+}
+
+TEST(MemoryStatsTest, FormatBytes) {
+    ASSERT_EQ("512 B", MemoryStats::formatBytes(512));
+    ASSERT_EQ("1.5 KB", MemoryStats::formatBytes(1536));
+    ASSERT_EQ("12.0 MB", MemoryStats::formatBytes(12 * 1024 * 1024));
+}
+
+TEST(MemoryStatsTest, Report) {
+    MemoryStats stats;
+    stats.update("Rewind buffer", 2048);
+    string report = stats.getReport();
+    ASSERT_NE(string::npos, report.find("Rewind buffer"));
+    ASSERT_NE(string::npos, report.find("2.0 KB"));
+    ASSERT_NE(string::npos, report.find("Total"));
+    ASSERT_EQ("Memory: 2.0 KB (peak 2.0 KB)", stats.getSummary());
+}
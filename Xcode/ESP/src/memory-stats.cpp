@@ -0,0 +1,161 @@
+#include "memory-stats.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+
+#if __APPLE__
+#include <mach/mach.h>
+#elif __linux__
+#include <unistd.h>
+#elif _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX  // keep std::min and std::max usable
+#endif
+#include <windows.h>
+#include <psapi.h>
+#endif
+
+MemoryStats::MemoryStats()
+        : total_high_water_(0), rss_(0), rss_high_water_(0) {
+}
+
+void MemoryStats::update(const string& subsystem, uint64_t bytes) {
+    Entry* entry = nullptr;
+    for (Entry& e : entries_) {
+        if (e.name == subsystem) entry = &e;
+    }
+    if (entry == nullptr) {
+        entries_.push_back(Entry{subsystem, 0, 0});
+        entry = &entries_.back();
+    }
+    entry->current = bytes;
+    entry->high_water = std::max(entry->high_water, bytes);
+    total_high_water_ = std::max(total_high_water_, getTotal());
+}
+
+void MemoryStats::updateResidentSetSize() {
+    rss_ = queryResidentSetSize();
+    rss_high_water_ = std::max(rss_high_water_, rss_);
+}
+
+void MemoryStats::clear() {
+    entries_.clear();
+    total_high_water_ = 0;
+    rss_ = 0;
+    rss_high_water_ = 0;
+}
+
+const MemoryStats::Entry* MemoryStats::find(const string& subsystem) const {
+    for (const Entry& entry : entries_) {
+        if (entry.name == subsystem) return &entry;
+    }
+    return nullptr;
+}
+
+uint64_t MemoryStats::getCurrent(const string& subsystem) const {
+    const Entry* entry = find(subsystem);
+    return entry == nullptr ? 0 : entry->current;
+}
+
+uint64_t MemoryStats::getHighWater(const string& subsystem) const {
+    const Entry* entry = find(subsystem);
+    return entry == nullptr ? 0 : entry->high_water;
+}
+
+uint64_t MemoryStats::getTotal() const {
+    uint64_t total = 0;
+    for (const Entry& entry : entries_) total += entry.current;
+    return total;
+}
+
+vector<string> MemoryStats::getSubsystems() const {
+    vector<string> names;
+    for (const Entry& entry : entries_) names.push_back(entry.name);
+    return names;
+}
+
+string MemoryStats::getSummary() const {
+    std::ostringstream ss;
+    ss << "Memory: " << formatBytes(getTotal())
+       << " (peak " << formatBytes(total_high_water_) << ")";
+    if (rss_ > 0) {
+        ss << ", process " << formatBytes(rss_);
+    }
+    return ss.str();
+}
+
+string MemoryStats::getReport() const {
+    size_t width = strlen("Unaccounted");
+    for (const Entry& entry : entries_) {
+        width = std::max(width, entry.name.size());
+    }
+
+    std::ostringstream ss;
+    auto line = [&ss, width](const string& name, uint64_t current,
+                             uint64_t peak) {
+        ss << std::left << std::setw(width + 2) << name
+           << std::right << std::setw(10) << formatBytes(current)
+           << "  (peak " << formatBytes(peak) << ")" << std::endl;
+    };
+
+    for (const Entry& entry : entries_) {
+        line(entry.name, entry.current, entry.high_water);
+    }
+    line("Total", getTotal(), total_high_water_);
+    if (rss_ > 0) {
+        line("Process", rss_, rss_high_water_);
+        line("Unaccounted", rss_ > getTotal() ? rss_ - getTotal() : 0,
+             rss_high_water_ > total_high_water_ ?
+                 rss_high_water_ - total_high_water_ : 0);
+    }
+    return ss.str();
+}
+
+string MemoryStats::formatBytes(uint64_t bytes) {
+    static const char* kUnits[] = { "B", "KB", "MB", "GB", "TB" };
+    double value = bytes;
+    uint32_t unit = 0;
+    while (value >= 1024 && unit + 1 < sizeof(kUnits) / sizeof(kUnits[0])) {
+        value /= 1024;
+        unit++;
+    }
+
+    char buf[32];
+    if (unit == 0) {
+        snprintf(buf, sizeof(buf), "%llu B", (unsigned long long) bytes);
+    } else {
+        snprintf(buf, sizeof(buf), "%.1f %s", value, kUnits[unit]);
+    }
+    return buf;
+}
+
+uint64_t MemoryStats::queryResidentSetSize() {
+#if __APPLE__
+    mach_task_basic_info info;
+    mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+    if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO,
+                  (task_info_t) &info, &count) != KERN_SUCCESS) {
+        return 0;
+    }
+    return info.resident_size;
+#elif __linux__
+    FILE* f = fopen("/proc/self/statm", "r");
+    if (f == nullptr) return 0;
+    long pages = 0, resident = 0;
+    int n = fscanf(f, "%ld %ld", &pages, &resident);
+    fclose(f);
+    return n == 2 ? (uint64_t) resident * sysconf(_SC_PAGESIZE) : 0;
+#elif _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters,
+                              sizeof(counters))) {
+        return 0;
+    }
+    return counters.WorkingSetSize;
+#else
+    return 0;
+#endif
+}
@@ -0,0 +1,72 @@
+/** @file memory-stats.h
+ *  @brief MemoryStats keeps a per-subsystem breakdown of the memory held by
+ *  ESP, with high-water marks.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using std::string;
+using std::vector;
+
+/**
+ *  @brief MemoryStats records how many bytes each subsystem (training
+ *  samples, plots, rewind buffer, ...) holds. Owners report their usage with
+ *  update(), usually from a periodic poll; MemoryStats remembers the highest
+ *  value seen for each subsystem and for the total.
+ *
+ *  The process resident set size is tracked alongside, so that the memory
+ *  not attributed to any subsystem (allocator overhead, libraries, leaks)
+ *  shows up as the difference between the two.
+ */
+class MemoryStats {
+  public:
+    MemoryStats();
+
+    /// @brief Set the current usage of `subsystem`. Subsystems are listed in
+    /// the order they were first updated.
+    void update(const string& subsystem, uint64_t bytes);
+
+    /// @brief Sample the resident set size of the process.
+    void updateResidentSetSize();
+
+    /// @brief Forget all subsystems and high-water marks.
+    void clear();
+
+    uint64_t getCurrent(const string& subsystem) const;
+    uint64_t getHighWater(const string& subsystem) const;
+    uint64_t getTotal() const;
+    uint64_t getTotalHighWater() const { return total_high_water_; }
+    uint64_t getResidentSetSize() const { return rss_; }
+    uint64_t getResidentSetSizeHighWater() const { return rss_high_water_; }
+    vector<string> getSubsystems() const;
+
+    /// @brief One line, suitable for the status area, e.g.
+    /// "Memory: 12.1 MB (peak 40.0 MB), process 210.3 MB".
+    string getSummary() const;
+
+    /// @brief One line per subsystem with its current and peak usage.
+    string getReport() const;
+
+    /// @brief Human-readable size, e.g. "1.5 KB" or "12.0 MB".
+    static string formatBytes(uint64_t bytes);
+
+    /// @brief Resident set size of this process, or 0 if unknown.
+    static uint64_t queryResidentSetSize();
+
+  private:
+    struct Entry {
+        string name;
+        uint64_t current;
+        uint64_t high_water;
+    };
+    const Entry* find(const string& subsystem) const;
+
+    vector<Entry> entries_;
+    uint64_t total_high_water_;
+    uint64_t rss_;
+    uint64_t rss_high_water_;
+};
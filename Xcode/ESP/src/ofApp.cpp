@@ -2,12 +2,17 @@
 
 #include <algorithm>
 #include <cctype>
+#include <chrono>
 #include <cmath>
 #include <iomanip>
+#include <memory>
+#include <mutex>
 #include <sstream>
 #include <string>
 
 #include "user.h"
+#include "MFCC.h"
+#include "QuantizedKNN.h"
 #include "ofxParagraph.h"
 #include "ofYesNoDialog.h"
 
@@ -18,6 +23,24 @@ const uint32_t kTooManyFeaturesThreshold = 32;
 // This delay is needed so that UI can update to reflect the training status.
 const uint32_t kDelayBeforeTraining = 50;  // milliseconds
 
+// Memory budget for the rewind buffer when the user doesn't specify its size.
+const uint64_t kRewindBufferBytes = 64 * 1024 * 1024;
+
+// How often memory usage is polled, and how often the full report is logged.
+const uint64_t kMemoryStatsInterval = 1000;    // milliseconds
+const uint64_t kMemoryReportInterval = 60000;  // milliseconds
+
+// Time allowed for update() plus draw() before the plots start being shed.
+// The frame rate is capped at 120 fps, but 30 fps is enough for the plots.
+const double kDefaultFrameBudget = 1000.0 / 30;  // milliseconds
+
+// Serial devices listed in the serial port dropdown at most.
+const uint32_t kMaxSerialSelectionOptions = 16;
+
+// When the frame governor reduces the draw rate, the window is redrawn only
+// once every this many frames and a cached image is shown in between.
+const uint32_t kReducedDrawRateDivisor = 4;
+
 // Instructions for each tab.
 static const char* kCalibrateInstruction =
     "Collect the specified samples to calibrate ESP to your sensor. Must be completed before using the rest of the system.";
@@ -26,7 +49,7 @@ static const char* kPipelineInstruction =
     "Live data at each stage of the machine learning pipeline. Classifier uses the data (\"features\") from the last stage.";
 
 static const char* kTrainingInstruction =
-    "Press and hold keys `1` to `9` to collect examples of the classes of phenomena you want to classify.";
+    "Press and hold keys `1` to `9` to collect examples of the classes of phenomena you want to classify. Press `d` to find out which input dimensions the classifier needs.";
 
 static const char* kAnalysisInstruction =
     "Press and hold `r` to record test data, which will be re-classified every time you retrain the classifier.";
@@ -56,6 +79,12 @@ void ofApp::useCalibrator(Calibrator &calibrator) {
     calibrator_ = &calibrator;
 }
 
+void ofApp::useAutomaticTrimming(double threshold, uint32_t padding) {
+    use_automatic_trimming_ = threshold > 0;
+    activity_trimmer_.setThreshold(threshold);
+    activity_trimmer_.setPadding(padding);
+}
+
 void ofApp::useIStream(InputStream &stream) {
     if (!setup_finished_) istream_ = &stream;
 }
@@ -74,6 +103,10 @@ void ofApp::useOStream(OStreamVector &stream) {
     }
 }
 
+void ofApp::useOStream(PredictionOStream &stream) {
+    if (!setup_finished_) prediction_ostreams_.push_back(&stream);
+}
+
 void ofApp::useTrainingSampleChecker(TrainingSampleChecker checker) {
     training_sample_checker_ = checker;
 }
@@ -93,7 +126,8 @@ ofApp::ofApp() : fragment_(TRAINING),
                  is_training_scheduled_(false),
                  is_recording_(false),
                  true_positive_threshold_(0),
-                 false_negative_threshold_(0) {
+                 false_negative_threshold_(0),
+                 governor_(kDefaultFrameBudget) {
 }
 
 //--------------------------------------------------------------
@@ -140,6 +174,10 @@ void ofApp::setup() {
     ofSetLogLevel(OF_LOG_VERBOSE);
     ESP_EVENT("System Started");
 
+    // Imported logs have the class label in the first column, unless the
+    // user's setup() says otherwise.
+    setLogImportColumns(0, -1);
+
     // setup() is a user-defined function.
     ::setup(); setup_finished_ = true;
 
@@ -157,6 +195,12 @@ void ofApp::setup() {
         }
     }
 
+    for (PredictionOStream *ostream : prediction_ostreams_) {
+        if (!(ostream->start())) {
+            ofLog(OF_LOG_ERROR) << "failed to connect to ostream";
+        }
+    }
+
     // Determine the initial state of the application:
     //  o  w/ calibrator: direct to calibrator view
     //  o  no calibrator: jump directly to pipeline view
@@ -169,44 +213,22 @@ void ofApp::setup() {
     }
 
     istream_->onDataReadyEvent(this, &ofApp::onDataIn);
+    // The plots and the pipeline are laid out for the number of dimensions
+    // the stream has now. If the device starts sending another number, e.g.
+    // a Touche sketch with another reduction mode, its data is dropped until
+    // onInputDimensionsChanged() lays the plots out again.
+    input_dimensions_ = istream_->getNumOutputDimensions();
+    istream_->onDimensionsChangedEvent([this](int) {
+        TaskScheduler::instance().runOnMainThread(
+            [this] { onInputDimensionsChanged(); });
+    });
 
     predicted_label_buffer_.resize(buffer_size_);
     predicted_class_labels_buffer_.resize(buffer_size_);
     predicted_class_distances_buffer_.resize(buffer_size_);
     predicted_class_likelihoods_buffer_.resize(buffer_size_);
 
-    const vector<string>& istream_labels = istream_->getLabels();
-    plot_raw_.setup(buffer_size_, istream_->getNumOutputDimensions(), "Raw Data");
-    plot_raw_.setDrawGrid(true);
-    plot_raw_.setDrawInfoText(true);
-    plot_raw_.setChannelNames(istream_labels);
-    plot_raw_.setAxisTitle("Time", "");
-    plot_raw_.setChannelColors(color_palette_.generate(istream_->getNumOutputDimensions()));
-    plot_raw_.setLinkRanges(true);
-    plot_raw_.setIncludeAxisLabelsInPlotDimensions(false, true);
-    plot_inputs_.setup(buffer_size_, istream_->getNumOutputDimensions(), "Input");
-    plot_inputs_.setDrawGrid(true);
-    plot_inputs_.setDrawInfoText(true);
-    plot_inputs_.setChannelNames(istream_labels);
-    plot_inputs_.onRangeSelected(this, &ofApp::onInputPlotRangeSelection, NULL);
-    plot_inputs_.onValueHighlighted(this, &ofApp::onInputPlotValueSelection, NULL);
-    plot_inputs_.setAxisTitle("Time", "");
-    plot_inputs_.setChannelColors(color_palette_.generate(istream_->getNumOutputDimensions()));
-    plot_inputs_.setLinkRanges(true);
-    plot_inputs_.setIncludeAxisLabelsInPlotDimensions(false, true);
-    if (istream_->getNumOutputDimensions() >= kTooManyFeaturesThreshold) {
-        plot_inputs_snapshot_.setup(istream_->getNumOutputDimensions(), 1, "Snapshot");
-        plot_inputs_.setDrawInfoText(false); // this will be too long to show
-    }
-
-    plot_testdata_window_.setup(buffer_size_, istream_->getNumOutputDimensions(), "Test Data");
-    plot_testdata_window_.setDrawGrid(true);
-    plot_testdata_window_.setDrawInfoText(true);
-    plot_testdata_window_.setChannelColors(color_palette_.generate(istream_->getNumOutputDimensions()));
-    plot_testdata_window_.setIncludeAxisLabelsInPlotDimensions(false, true);
-
-    plot_testdata_overview_.setup(istream_->getNumOutputDimensions(), "Overview");
-    plot_testdata_overview_.onRangeSelected(this, &ofApp::onTestOverviewPlotSelection, NULL);
+    setupInputPlots();
 
     plot_class_likelihoods_.setup(buffer_size_, kNumMaxLabels_, "Class Likelihoods");
     plot_class_likelihoods_.setDrawInfoText(true);
@@ -317,6 +339,11 @@ void ofApp::setup() {
     for (uint32_t i = 0; i < num_final_features; i++) {
         sample_feature_ranges_.push_back(make_pair(0, 0));
     }
+    if (num_final_features >= kTooManyFeaturesThreshold) {
+        spectrogram_features_.setup(buffer_size_, num_final_features,
+                                    "Feature history");
+        spectrogram_features_.setBackgroundColor(background_color_);
+    }
 
     if (calibrator_ != nullptr) {
         vector<CalibrateProcess>& calibrators = calibrator_->getCalibrateProcesses();
@@ -424,20 +451,21 @@ void ofApp::setup() {
     // Start input streaming.
     // If failed, this could be due to serial stream's port configuration.
     // We prompt to ask for the port.
-    if (!istream_->start()) {
-        if (BaseSerialInputStream* ss = dynamic_cast<BaseSerialInputStream*>(istream_)) {
-            vector<string> serials = ss->getSerialDeviceList();
-            serial_selection_dropdown_ =
-                    gui_.addDropdown("Select A Serial Port", serials);
-            serial_selection_dropdown_->onDropdownEvent(
-                this, &ofApp::onSerialSelectionDropdownEvent);
-
-            // Fine tune the theme (the default has a red color; we use
-            // kSerialSelectionColor)
-            ofxDatGuiTheme myTheme(true);
-            myTheme.stripe.dropdown = kSerialSelectionColor;
-            serial_selection_dropdown_->setTheme(&myTheme);
+    SerialDeviceRegistry::instance().setMemoryFile(
+        kLogDirectory + "serial-device.txt");
+    if (!istream_->start() && !selectRememberedSerialDevice()) {
+        if (dynamic_cast<BaseSerialInputStream*>(istream_) != nullptr) {
+            // Pick the device up as soon as it's plugged in, or else list
+            // what's plugged in now.
+            SerialDeviceRegistry::instance().watchForHotplug([this] {
+                TaskScheduler::instance().runOnMainThread([this] {
+                    if (!selectRememberedSerialDevice()) {
+                        updateSerialSelectionDropdown();
+                    }
+                });
+            });
 
+            updateSerialSelectionDropdown();
             gui_.addBreak()->setHeight(5.0f);
 
             status_text_ = "Please select a serial port from the dropdown menu";
@@ -500,6 +528,8 @@ void ofApp::setup() {
     save_load_folder_->addButton("Load training data...")->onButtonEvent(this, &ofApp::loadTrainingData);
     save_load_folder_->addButton("Save test data...")->onButtonEvent(this, &ofApp::saveTestData);
     save_load_folder_->addButton("Load test data...")->onButtonEvent(this, &ofApp::loadTestData);
+    save_load_folder_->addButton("Import training log...")->onButtonEvent(this, &ofApp::importTrainingLog);
+    save_load_folder_->addButton("Import test log...")->onButtonEvent(this, &ofApp::importTestLog);
     save_load_folder_->addButton("Save tuneables...")->onButtonEvent(this, &ofApp::saveTuneables);
     save_load_folder_->addButton("Load tuneables...")->onButtonEvent(this, &ofApp::loadTuneables);
     save_load_folder_->setPosition(10, 0);
@@ -523,6 +553,19 @@ void ofApp::setup() {
     GRT::ErrorLog::registerObserver(*this);
 }
 
+std::shared_ptr<void> ofApp::enableGrtErrorLog() {
+    if (grt_error_log_users_++ == 0) GRT::ErrorLog::enableLogging(true);
+    // The deleter runs wherever the last copy goes, usually on a worker, so
+    // the log is switched off from the main thread.
+    return std::shared_ptr<void>(nullptr, [this](void*) {
+        TaskScheduler::instance().runOnMainThread([this] {
+            if (--grt_error_log_users_ == 0) {
+                GRT::ErrorLog::enableLogging(false);
+            }
+        });
+    });
+}
+
 void ofApp::onPlotRangeSelected(InteractivePlot::RangeSelectedCallbackArgs arg) {
     if (is_in_feature_view_) {
         uint32_t sample_index = reinterpret_cast<uint64_t>(arg.data) - 1;
@@ -550,13 +593,18 @@ void ofApp::updatePlotSamplesSnapshot(int num, int row) {
 }
 
 vector<double> ofApp::getLastStageProcessedData() const {
+    return getLastStageProcessedData(*pipeline_);
+}
+
+vector<double> ofApp::getLastStageProcessedData(
+        GRT::GestureRecognitionPipeline& pipeline) const {
     // This could be get last stage of feature extraction if there is feature
     // extraction or last stage of pre-processing if there is no feature
     // extraction data
     if (num_feature_modules_ > 0) {
-        return pipeline_->getFeatureExtractionData(num_feature_modules_ - 1);
+        return pipeline.getFeatureExtractionData(num_feature_modules_ - 1);
     } else if (num_preprocessing_modules_ > 0) {
-        return pipeline_->getPreProcessedData(num_preprocessing_modules_ - 1);
+        return pipeline.getPreProcessedData(num_preprocessing_modules_ - 1);
     } else {
         // we should have never been here for pipeline without any processing
         assert(false);
@@ -566,11 +614,11 @@ vector<double> ofApp::getLastStageProcessedData() const {
 void ofApp::populateSampleFeatures(uint32_t sample_index) {
     if (num_preprocessing_modules_ + num_feature_modules_ == 0) { return; }
 
-    // Clean up historical data/caches.
-    pipeline_->reset();
-
-    vector<Plotter>& feature_plots = plot_sample_features_[sample_index];
-    for (Plotter& plot : feature_plots) { plot.clearData(); }
+    // A newer request for the same sample supersedes this one.
+    sample_feature_tokens_.resize(plot_sample_features_.size());
+    sample_feature_tokens_[sample_index].cancel();
+    TaskScheduler::CancellationToken token;
+    sample_feature_tokens_[sample_index] = token;
 
     // 1. get samples
     MatrixDouble& sample = plot_samples_[sample_index].getData();
@@ -583,18 +631,44 @@ void ofApp::populateSampleFeatures(uint32_t sample_index) {
             end = sel.second;
         }
     }
-
-    // 2. get processed data by flowing samples through
+    vector<vector<double>> rows;
     for (uint32_t i = start; i < end; i++) {
-        vector<double> data_point = sample.getRowVector(i);
-        if (!pipeline_->preProcessData(data_point)) {
-            ofLog(OF_LOG_ERROR) << "ERROR: Failed to compute features!";
-            continue;
-        }
+        rows.push_back(sample.getRowVector(i));
+    }
+
+    // 2. get processed data by flowing samples through a copy of the
+    // pipeline, so the live one keeps its state.
+    auto pipeline = std::make_shared<GRT::GestureRecognitionPipeline>(*pipeline_);
+    pipeline->reset();
+    submitPipelineTask(TaskScheduler::kInteractive,
+        [this, sample_index, token, rows, pipeline] {
+            vector<vector<double>> features;
+            for (const vector<double>& row : rows) {
+                if (token.isCancelled()) return;
+                vector<double> data_point = row;
+                if (!pipeline->preProcessData(data_point)) {
+                    ofLog(OF_LOG_ERROR) << "ERROR: Failed to compute features!";
+                    continue;
+                }
+                // Last stage of processing
+                features.push_back(getLastStageProcessedData(*pipeline));
+            }
 
-        // Last stage of processing
-        vector<double> feature = getLastStageProcessedData();
+            TaskScheduler::instance().runOnMainThread(
+                [this, sample_index, token, features] {
+                    if (token.isCancelled()) return;
+                    showSampleFeatures(sample_index, features);
+                });
+        }, token);
+}
 
+void ofApp::showSampleFeatures(uint32_t sample_index,
+                               const vector<vector<double>>& features) {
+    if (sample_index >= plot_sample_features_.size()) return;
+    vector<Plotter>& feature_plots = plot_sample_features_[sample_index];
+    for (Plotter& plot : feature_plots) { plot.clearData(); }
+
+    for (const vector<double>& feature : features) {
         for (uint32_t k = 0; k < feature_plots.size(); k++) {
             vector<double> feature_point = { feature[k] };
             feature_plots[k].push_back(feature_point);
@@ -630,12 +704,49 @@ void ofApp::onInputPlotRangeSelection(InteractiveTimeSeriesPlot::RangeSelectedCa
     status_text_ = "Press 1-9 to extract from live data to training data.";
     state_ = AppState::kTrainingHistoryRecording;
 
+    // The plot's last point is rewind_frames_ago_ frames before the newest
+    // frame in the rewind buffer (0 unless scrolled back).
+    uint32_t end = std::min(arg.end, buffer_size_);
+    uint32_t start = std::min(arg.start, end);
     sample_data_.clear();
-    sample_data_ = plot_inputs_.getData(arg.start, arg.end);
+    sample_data_ = rewind_buffer_.getRecent(
+        rewind_frames_ago_ + buffer_size_ - end, end - start);
+}
+
+void ofApp::scrollInputHistory(int64_t frames) {
+    uint32_t size = rewind_buffer_.size();
+    int64_t max_frames_ago = size > buffer_size_ ? size - buffer_size_ : 0;
+    int64_t frames_ago = (int64_t) rewind_frames_ago_ + frames;
+    frames_ago = std::max<int64_t>(0, std::min(frames_ago, max_frames_ago));
+    if (frames_ago == rewind_frames_ago_) return;
+    rewind_frames_ago_ = frames_ago;
+
+    // Redraw the input plot from the full-precision history. Selections on
+    // it are then mapped back through rewind_frames_ago_.
+    MatrixDouble view = rewind_buffer_.getRecent(rewind_frames_ago_,
+                                                 buffer_size_);
+    plot_inputs_.clearSelection();
+    plot_inputs_.reset();
+    for (uint32_t i = 0; i < view.getNumRows(); i++) {
+        plot_inputs_.update(view.getRowVector(i), false, "");
+    }
+
+    if (rewind_frames_ago_ == 0) {
+        setStatus("Showing the most recent data.");
+    } else {
+        uint64_t newest = rewind_buffer_.getTimestamp(size - 1);
+        uint64_t shown = rewind_buffer_.getTimestamp(
+            size - 1 - rewind_frames_ago_);
+        setStatus("Showing data from " +
+                  ofToString((newest - shown) / 1000.0, 1) +
+                  " s before the most recent. Use the left and right arrow "
+                  "keys to scroll.");
+    }
 }
 
 void ofApp::onInputPlotValueSelection(InteractiveTimeSeriesPlot::ValueHighlightedCallbackArgs arg) {
-    if (enable_history_recording_) {
+    // The prediction buffers only cover what the live plot showed.
+    if (enable_history_recording_ && rewind_frames_ago_ == 0) {
         int i = arg.index;
         predicted_label_ = predicted_label_buffer_[i];
         predicted_class_distances_ = predicted_class_distances_buffer_[i];
@@ -687,18 +798,30 @@ void ofApp::updateTestWindowPlot() {
 }
 
 void ofApp::runPredictionOnTestData() {
-    test_data_predicted_class_labels_.resize(test_data_.getNumRows());
-    for (int i = 0; i < test_data_.getNumRows(); i++) {
-        if (pipeline_->getTrained()) {
-            pipeline_->predict(test_data_.getRowVector(i));
-
-            int predicted_label = pipeline_->getPredictedClassLabel();
+    test_prediction_token_.cancel();
+    test_data_predicted_class_labels_.assign(test_data_.getNumRows(), 0);
+    if (!pipeline_->getTrained()) return;
+
+    TaskScheduler::CancellationToken token;
+    test_prediction_token_ = token;
+    auto pipeline = std::make_shared<GRT::GestureRecognitionPipeline>(*pipeline_);
+    auto test_data = std::make_shared<MatrixDouble>(test_data_);
+    submitPipelineTask(TaskScheduler::kBulk,
+        [this, token, pipeline, test_data] {
+            vector<UINT> labels(test_data->getNumRows(), 0);
+            for (int i = 0; i < test_data->getNumRows(); i++) {
+                if (token.isCancelled()) return;
+                pipeline->predict(test_data->getRowVector(i));
+                labels[i] = pipeline->getPredictedClassLabel();
+            }
 
-            test_data_predicted_class_labels_[i] = predicted_label;
-        } else {
-            test_data_predicted_class_labels_[i] = 0;
-        }
-    }
+            TaskScheduler::instance().runOnMainThread([this, token, labels] {
+                if (token.isCancelled() ||
+                    labels.size() != test_data_.getNumRows()) return;
+                test_data_predicted_class_labels_ = labels;
+                updateTestWindowPlot();
+            });
+        }, token);
 }
 
 bool ofApp::savePipelineWithPrompt() {
@@ -733,6 +856,10 @@ bool ofApp::loadPipelineWithPrompt() {
 
 bool ofApp::loadPipeline(const string& filename) {
     if (pipeline_->load(filename)) {
+        training_token_.cancel();  // the loaded pipeline wins
+        is_training_running_ = false;
+        samples_added_during_training_.clear();
+        parallel_trainer_.clear();
         setStatus("Pipeline is loaded from " + filename);
         should_save_pipeline_ = false;
         if (pipeline_->getTrained()) afterTrainModel();
@@ -845,6 +972,9 @@ bool ofApp::loadCalibrationData(const string& filename) {
     }
 
     plot_inputs_.reset();
+
+    rewind_buffer_.clear();
+    rewind_frames_ago_ = 0;
     ESP_EVENT("Calibration data is loaded from " + filename);
     should_save_calibration_data_ = false;
     return true;
@@ -890,7 +1020,14 @@ bool ofApp::loadTrainingData(const string& filename) {
         return false;
     }
 
-    // Update the plotting
+    updatePlotSamples();
+
+    ESP_EVENT("Training data is loaded from " + filename);
+    return true;
+}
+
+void ofApp::updatePlotSamples() {
+    // Show the last sample of each label.
     for (uint32_t i = 1; i <= kNumMaxLabels_; i++) {
         uint32_t num = training_data_manager_.getNumSampleForLabel(i);
         plot_sample_indices_[i - 1] = num - 1;
@@ -906,9 +1043,6 @@ bool ofApp::loadTrainingData(const string& filename) {
 
         updatePlotSamplesSnapshot(i - 1);
     }
-
-    ESP_EVENT("Training data is loaded from " + filename);
-    return true;
 }
 
 bool ofApp::saveTestDataWithPrompt() {
@@ -968,6 +1102,86 @@ bool ofApp::loadTestData(const string& filename) {
     return true;
 }
 
+bool ofApp::importLogWithPrompt(bool as_test_data) {
+    ofFileDialogResult result = ofSystemLoadDialog(
+        as_test_data ? "Import test data from a log" :
+                       "Import training data from a log", false);
+    if (!result.bSuccess) { return false; }
+    return importLog(result.getPath(), as_test_data);
+}
+
+bool ofApp::importLog(const string& filename, bool as_test_data) {
+    if (calibrator_ != nullptr && !calibrator_->isCalibrated()) {
+        setStatus("Calibrate before importing " + filename);
+        return false;
+    }
+
+    // Copy the options and time ranges set with setLogImportColumns() and
+    // addLogImportTimeRange(); the copy holds the parsed data.
+    LogImporter importer = log_importer_;
+    uint32_t reported_percent = 0;
+    importer.setProgressCallback(
+        [&filename, &reported_percent](double progress) {
+            uint32_t percent = progress * 100;
+            if (percent >= reported_percent + 10) {
+                reported_percent = percent;
+                ofLog(OF_LOG_NOTICE) << "Importing " << filename << ": "
+                                     << percent << "%";
+            }
+        });
+    if (!importer.load(filename)) {
+        setStatus("Failed to import " + filename + ": " +
+                  importer.getErrorMessage());
+        return false;
+    }
+    if (importer.getNumDimensions() != istream_->getNumInputDimensions()) {
+        setStatus("Failed to import " + filename + ": expected " +
+                  std::to_string(istream_->getNumInputDimensions()) +
+                  " data columns but found " +
+                  std::to_string(importer.getNumDimensions()));
+        return false;
+    }
+
+    // The log holds the raw readings of the input stream, so they go
+    // through the same normalization and calibration as live data.
+    bool transformed = importer.transformRows([this](vector<double> row) {
+        row = istream_->normalize(row);
+        if (calibrator_ != nullptr) row = calibrator_->calibrate(row);
+        return row;
+    });
+    if (!transformed) {
+        setStatus("Failed to normalize the data imported from " + filename);
+        return false;
+    }
+
+    if (as_test_data) {
+        test_data_ = importer.getData();
+        plot_testdata_overview_.setData(test_data_);
+        runPredictionOnTestData();
+        updateTestWindowPlot();
+        should_save_test_data_ = true;
+        setStatus("Imported " + std::to_string(test_data_.getNumRows()) +
+                  " points of test data from " + filename);
+    } else {
+        uint32_t num_samples = importer.addSamplesTo(training_data_manager_);
+        if (num_samples == 0) {
+            setStatus("No labelled samples found in " + filename);
+            return false;
+        }
+        updatePlotSamples();
+        should_save_training_data_ = true;
+        setStatus("Imported " + std::to_string(num_samples) +
+                  " training samples from " + filename);
+    }
+
+    if (importer.getNumSkippedLines() > 0) {
+        ESP_EVENT("Skipped " +
+                  std::to_string(importer.getNumSkippedLines()) +
+                  " malformed lines in " + filename);
+    }
+    return true;
+}
+
 bool ofApp::saveTuneablesWithPrompt() {
     ofFileDialogResult result = ofSystemSaveDialog("TuneableParameters.grt",
                                                    "Save your tuneable parameters?");
@@ -981,9 +1195,13 @@ bool ofApp::saveTuneables(const string& filename) {
         file << t->toString() << std::endl;
     }
     file.close();
+    if (!file) {
+        setStatus("Failed to save tuneables to " + filename);
+        return false;
+    }
 
     ESP_EVENT("Tuneable is saved to " + filename);
-    return true; // TODO: check for failure
+    return true;
 }
 
 bool ofApp::loadTuneablesWithPrompt() {
@@ -993,17 +1211,42 @@ bool ofApp::loadTuneablesWithPrompt() {
 }
 
 bool ofApp::loadTuneables(const string& filename) {
-    std::string line;
     std::ifstream file(filename);
-    for (Tuneable* t : tuneable_parameters_) {
-        std::getline(file, line);
-        t->fromString(line);
+    if (!file) {
+        setStatus("Failed to open " + filename);
+        return false;
     }
-    file.close();
+
+    // Check the whole file before changing anything.
+    vector<std::string> lines(tuneable_parameters_.size());
+    for (uint32_t i = 0; i < tuneable_parameters_.size(); i++) {
+        double value;
+        if (!std::getline(file, lines[i]) ||
+            !tuneable_parameters_[i]->parse(lines[i], &value)) {
+            setStatus("Failed to load tuneables from " + filename +
+                      ": line " + std::to_string(i + 1) + " is malformed");
+            return false;
+        }
+    }
+    for (uint32_t i = 0; i < tuneable_parameters_.size(); i++) {
+        tuneable_parameters_[i]->fromString(lines[i]);
+    }
+
+    // The pipeline is rebuilt right away, e.g. so that loadAll() can load a
+    // trained one next, and ::setup() must see the loaded values. Stop the
+    // tasks running pipeline copies and wait for them to let go of the
+    // values, so that they can be applied now.
+    cancelPipelineTasks();
+    tuneable_values_.publish();
+    tuneable_values_.waitForLeases();
+    tuneable_values_.apply();
+    // The reload takes care of the changes; applyTuneables() mustn't reload
+    // again, after loadAll() has loaded a pipeline.
+    for (Tuneable* t : tuneable_parameters_) t->notifyUserChange();
     reloadPipelineModules();
 
     ESP_EVENT("Tuneable is loaded from " + filename);
-    return true; // TODO: check for failure
+    return true;
 }
 
 void ofApp::saveTuneables(ofxDatGuiButtonEvent e) { saveTuneablesWithPrompt(); }
@@ -1063,11 +1306,86 @@ void ofApp::saveAll(bool saveAs) {
 
 }
 
+bool ofApp::selectRememberedSerialDevice() {
+    if (istream_->hasStarted()) { return false; }
+
+    BaseSerialInputStream* ss = dynamic_cast<BaseSerialInputStream*>(istream_);
+    if (ss == nullptr) { return false; }
+
+    SerialDeviceRegistry& registry = SerialDeviceRegistry::instance();
+    int port = registry.findRemembered();
+    if (port < 0 || !ss->selectSerialDevice(port)) { return false; }
+
+    registry.stopWatching();
+    if (serial_selection_dropdown_ != nullptr) {
+        serial_selection_dropdown_->collapse();
+        serial_selection_dropdown_->setVisible(false);
+        gui_.collapse();
+    }
+    ESP_EVENT("Serial input selected");
+    status_text_ = "Using serial port " +
+                   registry.getDevices()[port].getDescription();
+    return true;
+}
+
+void ofApp::updateSerialSelectionDropdown() {
+    if (istream_->hasStarted()) { return; }
+
+    vector<SerialDeviceRegistry::Device> devices =
+        SerialDeviceRegistry::instance().getDevices();
+    if (devices.size() > kMaxSerialSelectionOptions) {
+        devices.resize(kMaxSerialSelectionOptions);
+    }
+    vector<string> serials, shown;
+    for (auto& device : devices) {
+        serials.push_back(device.getDescription());
+    }
+    for (auto& device : serial_selection_devices_) {
+        shown.push_back(device.getDescription());
+    }
+
+    if (serial_selection_dropdown_ == nullptr) {
+        // ofxDatGui can't add or remove the options of a dropdown, so it has
+        // a fixed number of them, relabelled below, and the unused ones are
+        // hidden.
+        serial_selection_dropdown_ = gui_.addDropdown(
+            "Select A Serial Port",
+            vector<string>(kMaxSerialSelectionOptions, ""));
+        serial_selection_dropdown_->onDropdownEvent(
+            this, &ofApp::onSerialSelectionDropdownEvent);
+
+        // Fine tune the theme (the default has a red color; we use
+        // kSerialSelectionColor)
+        ofxDatGuiTheme myTheme(true);
+        myTheme.stripe.dropdown = kSerialSelectionColor;
+        serial_selection_dropdown_->setTheme(&myTheme);
+    } else if (serials == shown) {
+        return;
+    } else {
+        status_text_ = "The serial ports changed; please select one from "
+                       "the dropdown menu";
+    }
+
+    serial_selection_devices_ = devices;
+    for (uint32_t i = 0; i < kMaxSerialSelectionOptions; i++) {
+        ofxDatGuiDropdownOption* option =
+            serial_selection_dropdown_->getChildAt(i);
+        option->setVisible(i < serials.size());
+        if (i < serials.size()) option->setLabel(serials[i]);
+    }
+    // Lay the options out again when the dropdown is next expanded.
+    serial_selection_dropdown_->collapse();
+}
+
 void ofApp::onSerialSelectionDropdownEvent(ofxDatGuiDropdownEvent e) {
     if (istream_->hasStarted()) { return; }
 
     if (BaseSerialInputStream* ss = dynamic_cast<BaseSerialInputStream*>(istream_)) {
-        if (ss->selectSerialDevice(e.child)) {
+        int port = e.child < serial_selection_devices_.size() ?
+            SerialDeviceRegistry::instance().find(
+                serial_selection_devices_[e.child].getFingerprint()) : -1;
+        if (port >= 0 && ss->selectSerialDevice(port)) {
+            SerialDeviceRegistry::instance().stopWatching();
             serial_selection_dropdown_->collapse();
             serial_selection_dropdown_->setVisible(false);
             gui_.collapse();
@@ -1266,6 +1584,11 @@ void ofApp::doRelabelTrainingSample(uint32_t source, uint32_t target) {
 
 //--------------------------------------------------------------
 void ofApp::update() {
+    // Results of background work (training, scoring, features).
+    TaskScheduler::instance().runMainThreadTasks();
+
+    applyTuneables();
+
     save_load_folder_->update();
     pause_button_->update();
     train_model_button_->update();
@@ -1309,7 +1632,8 @@ void ofApp::update() {
             input.push_back(input_data_.getRowVector(i));
         input_data_.clear();
     }
-    
+
+    uint64_t update_start = ofGetElapsedTimeMicros();
     for (int i = 0; i < input.getNumRows(); i++){
         vector<double> raw_data = input.getRowVector(i);
         vector<double> data_point;
@@ -1349,6 +1673,10 @@ void ofApp::update() {
 
             predicted_class_likelihoods_ = pipeline_->getClassLikelihoods();
             predicted_class_likelihoods_buffer_.push_back(predicted_class_likelihoods_);
+            for (OStream *ostream : ostreams_)
+                ostream->onReceiveLikelihoods(predicted_class_likelihoods_);
+            for (OStream *ostream : ostreamvectors_)
+                ostream->onReceiveLikelihoods(predicted_class_likelihoods_);
 
             vector<double> likelihoods(kNumMaxLabels_);
             for (int i = 0; i < predicted_class_likelihoods_.size() &&
@@ -1357,7 +1685,10 @@ void ofApp::update() {
                 likelihoods[predicted_class_labels_[i] - 1] =
                     predicted_class_likelihoods_[i];
             }
-            plot_class_likelihoods_.update(likelihoods, predicted_label_ != 0, title);
+            if (governor_.shouldUpdatePredictionPlots()) {
+                plot_class_likelihoods_.update(likelihoods,
+                                               predicted_label_ != 0, title);
+            }
 
             predicted_class_distances_ = pipeline_->getClassDistances();
             if (pipeline_->getClassifier()->
@@ -1372,26 +1703,30 @@ void ofApp::update() {
             }
             predicted_class_distances_buffer_.push_back(predicted_class_distances_);
 
-            for (int i = 0; i < predicted_class_distances_.size() &&
-                            i < predicted_class_labels_.size(); i++) {
-                if (pipeline_->getClassifier()->
-                    getSupportsClassDistanceToNullRejectionCoefficient()) {
-                    double nullRejectionCoeff =
-                        pipeline_->getClassifier()->getNullRejectionCoeff();
-                    plot_class_distances_[predicted_class_labels_[i] - 1]->update(
-                        vector<double>{
-                            nullRejectionCoeff,
-                            predicted_class_distances_[i]
-                        }, predicted_class_distances_[i] < nullRejectionCoeff,
-                        "");
-                } else {
-                    vector<double> thresholds = pipeline_->getClassifier()->getNullRejectionThresholds();
-                    plot_class_distances_[predicted_class_labels_[i] - 1]->update(
-                        vector<double>{
-                            (thresholds.size() > i ? thresholds[i] : 0.0),
-                            predicted_class_distances_[i]
-                        }, thresholds.size() > i && predicted_class_distances_[i] < thresholds[i],
-                        "");
+            if (!prediction_ostreams_.empty()) sendPredictionRecord();
+
+            if (governor_.shouldUpdatePredictionPlots()) {
+                for (int i = 0; i < predicted_class_distances_.size() &&
+                                i < predicted_class_labels_.size(); i++) {
+                    if (pipeline_->getClassifier()->
+                        getSupportsClassDistanceToNullRejectionCoefficient()) {
+                        double nullRejectionCoeff =
+                            pipeline_->getClassifier()->getNullRejectionCoeff();
+                        plot_class_distances_[predicted_class_labels_[i] - 1]->update(
+                            vector<double>{
+                                nullRejectionCoeff,
+                                predicted_class_distances_[i]
+                            }, predicted_class_distances_[i] < nullRejectionCoeff,
+                            "");
+                    } else {
+                        vector<double> thresholds = pipeline_->getClassifier()->getNullRejectionThresholds();
+                        plot_class_distances_[predicted_class_labels_[i] - 1]->update(
+                            vector<double>{
+                                (thresholds.size() > i ? thresholds[i] : 0.0),
+                                predicted_class_distances_[i]
+                            }, thresholds.size() > i && predicted_class_distances_[i] < thresholds[i],
+                            "");
+                    }
                 }
             }
 
@@ -1406,18 +1741,28 @@ void ofApp::update() {
 
         // live data
         plot_inputs_.update(data_point, predicted_label_ != 0, title);
+        if (!data_point.empty() &&
+            data_point.size() != rewind_buffer_.getCalibratedDimension()) {
+            setupRewindBuffer(data_point.size());
+        }
+        rewind_buffer_.push(raw_data, data_point, ofGetElapsedTimeMillis());
         if (istream_->getNumOutputDimensions() >= kTooManyFeaturesThreshold) {
             plot_inputs_snapshot_.setData(data_point);
+            spectrogram_inputs_.update(data_point);
         }
 
         // live feature data
-        if (num_preprocessing_modules_ + num_feature_modules_ > 0) {
+        if (num_preprocessing_modules_ + num_feature_modules_ > 0 &&
+            governor_.shouldUpdateFeaturePlots()) {
             vector<double> data = getLastStageProcessedData();
 
             if (pipeline_->getNumFeatureExtractionModules() == 0) {
                 // no feature extraction modules, so we're showing the last
                 // stage of pre-processing, which is a single, timeseries plot.
                 plot_live_features_[0]->update(data);
+                if (data.size() >= kTooManyFeaturesThreshold) {
+                    spectrogram_features_.update(data);
+                }
             } else if (data.size() < kTooManyFeaturesThreshold) {
                 // here, we're showing the last stage of feature extraction,
                 // one plot per feature.
@@ -1431,6 +1776,7 @@ void ofApp::update() {
                 // create a separate plot for each.
                 assert(plot_live_features_.size() == 1);
                 plot_live_features_[0]->setData(data);
+                spectrogram_features_.update(data);
             }
         }
 
@@ -1439,6 +1785,9 @@ void ofApp::update() {
         if (state_ == AppState::kPipeline) {
             int j = 0;
             vector<double> data = data_point;
+            // The plots may be shed when we are over the frame budget, but
+            // the data still has to be computed for the OStreamVectors below.
+            bool update_plots = governor_.shouldUpdatePipelinePlots();
             // Till this point, either `pipeline_->predict` or
             // `pipeline->preProcessData` has been called. It's safe to directly
             // get the data and update the plots in the PIPELINE tab.
@@ -1451,14 +1800,16 @@ void ofApp::update() {
                  j + (pipeline_->getNumFeatureExtractionModules() == 0 ? 1 : 0)
                    < pipeline_->getNumPreProcessingModules(); j++) {
                 data = pipeline_->getPreProcessedData(j);
-                plot_pre_processed_[j]->update(data);
+                if (update_plots) plot_pre_processed_[j]->update(data);
             }
 
             // feature data
             for (j = 0; j + 1 < pipeline_->getNumFeatureExtractionModules(); j++) {
                 // Working on j-th stage.
                 data = pipeline_->getFeatureExtractionData(j);
-                if (data.size() < kTooManyFeaturesThreshold) {
+                if (!update_plots) {
+                    continue;
+                } else if (data.size() < kTooManyFeaturesThreshold) {
                     for (int k = 0; k < data.size(); k++) {
                         vector<double> v = { data[k] };
                         plot_features_[j][k]->update(v);
@@ -1489,11 +1840,122 @@ void ofApp::update() {
             }
         }
     }
+    // Send what this frame produced, e.g. as one OSC bundle.
+    for (OStream *ostream : ostreams_) ostream->flush();
+    for (OStream *ostream : ostreamvectors_) ostream->flush();
+    for (PredictionOStream *ostream : prediction_ostreams_) ostream->flush();
+    governor_.endFrame((ofGetElapsedTimeMicros() - update_start) / 1000.0,
+                       last_draw_ms_);
 
     if (is_training_scheduled_ == true &&
         (ofGetElapsedTimeMillis() - schedule_time_ > kDelayBeforeTraining)) {
         trainModel();
     }
+
+    uint64_t now = ofGetElapsedTimeMillis();
+    if (now - memory_stats_time_ >= kMemoryStatsInterval) {
+        memory_stats_time_ = now;
+        updateMemoryStats();
+        if (now - memory_report_time_ >= kMemoryReportInterval) {
+            memory_report_time_ = now;
+            ESP_EVENT("Memory usage\n" + memory_stats_.getReport());
+        }
+    }
+}
+
+// Size of an ofxGrtTimeseriesPlot, which keeps `length` points of `dim`
+// floats.
+static uint64_t timeseriesPlotBytes(uint32_t length, uint32_t dim) {
+    return (uint64_t) length * dim * sizeof(float);
+}
+
+uint64_t ofApp::getPlotMemoryUsage() {
+    uint32_t input_dim = istream_->getNumOutputDimensions();
+    uint64_t bytes = plot_inputs_.getMemoryUsage() +
+                     plot_class_likelihoods_.getMemoryUsage();
+    for (InteractiveTimeSeriesPlot* p : plot_class_distances_) {
+        bytes += p->getMemoryUsage();
+    }
+
+    // plot_raw_, plot_testdata_window_ and plot_inputs_snapshot_.
+    bytes += 2 * timeseriesPlotBytes(buffer_size_, input_dim);
+    if (input_dim >= kTooManyFeaturesThreshold) {
+        bytes += timeseriesPlotBytes(input_dim, 1);
+    }
+    bytes += spectrogram_inputs_.getMemoryUsage() +
+             spectrogram_features_.getMemoryUsage();
+
+    for (uint32_t i = 0; i < plot_pre_processed_.size(); i++) {
+        bytes += timeseriesPlotBytes(buffer_size_,
+            pipeline_->getPreProcessingModule(i)->getNumOutputDimensions());
+    }
+    for (uint32_t i = 0; i < plot_features_.size(); i++) {
+        uint32_t dim =
+            pipeline_->getFeatureExtractionModule(i)->getNumOutputDimensions();
+        bytes += dim < kTooManyFeaturesThreshold ?
+            timeseriesPlotBytes(buffer_size_, dim) :
+            timeseriesPlotBytes(dim, 1);
+    }
+
+    bytes += plot_testdata_overview_.getMemoryUsage();
+    for (const Plotter& p : plot_calibrators_) bytes += p.getMemoryUsage();
+    for (const Plotter& p : plot_samples_) bytes += p.getMemoryUsage();
+    for (const Plotter& p : plot_samples_snapshots_) {
+        bytes += p.getMemoryUsage();
+    }
+    for (const vector<Plotter>& ps : plot_sample_features_) {
+        for (const Plotter& p : ps) bytes += p.getMemoryUsage();
+    }
+    return bytes;
+}
+
+uint64_t ofApp::getPredictionHistoryMemoryUsage() {
+    uint64_t per_prediction = sizeof(int) + 3 * sizeof(vector<double>) +
+        predicted_class_labels_.size() * sizeof(UINT) +
+        predicted_class_likelihoods_.size() * sizeof(double) +
+        predicted_class_distances_.size() * sizeof(double);
+    return per_prediction * buffer_size_;
+}
+
+uint64_t ofApp::getPipelineMemoryUsage() {
+    // GRT modules don't report the size of their internal state, so this
+    // counts the data passed between stages plus the templates of classifiers
+    // that do report them. MFCC tables are accounted separately.
+    uint64_t bytes = 0;
+    for (uint32_t i = 0; i < pipeline_->getNumPreProcessingModules(); i++) {
+        bytes += pipeline_->getPreProcessingModule(i)->getProcessedData().size()
+                 * sizeof(double);
+    }
+    for (uint32_t i = 0; i < pipeline_->getNumFeatureExtractionModules(); i++) {
+        bytes += pipeline_->getFeatureExtractionModule(i)->getFeatureVector()
+                 .size() * sizeof(double);
+    }
+    GRT::QuantizedKNN* knn =
+        dynamic_cast<GRT::QuantizedKNN*>(pipeline_->getClassifier());
+    if (knn != nullptr) {
+        bytes += knn->getTemplateMemoryUsage();
+    }
+    return bytes;
+}
+
+void ofApp::updateMemoryStats() {
+    memory_stats_.update("Training samples",
+                         training_data_manager_.getSampleMemoryUsage());
+    memory_stats_.update("Sample scores and likelihoods",
+                         training_data_manager_.getScoreMemoryUsage());
+    memory_stats_.update("Test data",
+        (uint64_t) test_data_.getNumRows() * test_data_.getNumCols() *
+        sizeof(double) +
+        test_data_predicted_class_labels_.capacity() * sizeof(UINT));
+    memory_stats_.update("Rewind buffer", rewind_buffer_.getMemoryUsage());
+    memory_stats_.update("Plots", getPlotMemoryUsage());
+    memory_stats_.update("Prediction history",
+                         getPredictionHistoryMemoryUsage());
+    memory_stats_.update("Pipeline", getPipelineMemoryUsage());
+    memory_stats_.update("Feature cache", parallel_trainer_.getMemoryUsage());
+    memory_stats_.update("MFCC tables",
+                         std::max<int64_t>(0, GRT::MFCC::getTableMemoryUsage()));
+    memory_stats_.updateResidentSetSize();
 }
 
 void ofDrawColoredBitmapString(ofColor color,
@@ -1539,6 +2001,56 @@ void ofApp::enableTrainingSampleGUI(bool should_enable) {
 
 //--------------------------------------------------------------
 void ofApp::draw() {
+    uint64_t draw_start = ofGetElapsedTimeMicros();
+
+    if (governor_.shouldReduceDrawRate()) {
+        // Redraw the tabs into draw_cache_ only every few frames and show the
+        // cached image in between. The status line and the GUI widgets below
+        // are still drawn every frame so that they stay responsive.
+        if (!draw_cache_.isAllocated() ||
+            draw_cache_.getWidth() != ofGetWidth() ||
+            draw_cache_.getHeight() != ofGetHeight()) {
+            draw_cache_.allocate(ofGetWidth(), ofGetHeight(), GL_RGBA);
+            draw_cache_valid_ = false;
+        }
+        if (!draw_cache_valid_ ||
+            ofGetFrameNum() % kReducedDrawRateDivisor == 0) {
+            draw_cache_.begin();
+            drawTabs();
+            draw_cache_.end();
+            draw_cache_valid_ = true;
+        }
+        ofSetColor(255);
+        draw_cache_.draw(0, 0);
+        ofSetColor(text_color_);
+    } else {
+        draw_cache_valid_ = false;
+        drawTabs();
+    }
+
+    // Status text at the bottom, with the memory summary on the right and the
+    // frame budget summary below it.
+    const uint32_t left_margin = 10;
+    ofDrawBitmapString(status_text_, left_margin, ofGetHeight() - 20);
+    string memory_summary = memory_stats_.getSummary();
+    ofDrawBitmapString(memory_summary,
+                       ofGetWidth() - left_margin - 8 * memory_summary.size(),
+                       ofGetHeight() - 20);
+    string frame_summary = governor_.getSummary();
+    ofDrawBitmapString(frame_summary,
+                       ofGetWidth() - left_margin - 8 * frame_summary.size(),
+                       ofGetHeight() - 5);
+
+    save_load_folder_->draw();
+    pause_button_->draw();
+    train_model_button_->draw();
+    toggle_features_button_->draw();
+    gui_.draw();
+
+    last_draw_ms_ = (ofGetElapsedTimeMicros() - draw_start) / 1000.0;
+}
+
+void ofApp::drawTabs() {
     ofBackground(background_color_);
     ofSetColor(text_color_);
 
@@ -1637,15 +2149,6 @@ void ofApp::draw() {
     ofDrawLine(tab_start, ceiling, tab_start + kTabWidth, ceiling);
     ofDrawLine(tab_start + kTabWidth, ceiling, tab_start + kTabWidth, bottom);
     ofDrawLine(tab_start + kTabWidth, bottom, ofGetWidth(), bottom);
-
-    // Status text at the bottom
-    ofDrawBitmapString(status_text_, left_margin, ofGetHeight() - 20);
-
-    save_load_folder_->draw();
-    pause_button_->draw();
-    train_model_button_->draw();
-    toggle_features_button_->draw();
-    gui_.draw();    
 }
 
 void ofApp::drawInputs(uint32_t stage_left, uint32_t stage_top,
@@ -1655,7 +2158,9 @@ void ofApp::drawInputs(uint32_t stage_left, uint32_t stage_top,
         float maxY = plot_inputs_.getRanges().second;
         plot_inputs_snapshot_.setRanges(minY, maxY, true);
         plot_inputs_snapshot_.draw(stage_left, stage_top, stage_width,
-                                   stage_height * 0.75);
+                                   stage_height * 0.25);
+        spectrogram_inputs_.draw(stage_left, stage_top + stage_height * 0.25,
+                                 stage_width, stage_height * 0.5);
         plot_inputs_.draw(stage_left, stage_top + stage_height * 0.75,
                           stage_width, stage_height * 0.25);
     } else {
@@ -1681,6 +2186,12 @@ void ofApp::drawLiveFeatures(uint32_t stage_left, uint32_t stage_top,
         uint32_t margin = 10;
         stage_top = stage_top + (height + margin);
         stage_height = stage_height - (height + margin);
+
+        // The feature history as a spectrogram, above the latest features.
+        height = stage_height / 2;
+        spectrogram_features_.draw(stage_left, stage_top, stage_width, height);
+        stage_top += height + margin;
+        stage_height -= height + margin;
     }
 
     uint32_t height = stage_height / plot_live_features_.size();
@@ -1990,11 +2501,13 @@ void ofApp::drawPrediction() {
 }
 
 void ofApp::exit() {
+    updateMemoryStats();
+    ESP_EVENT("Memory usage\n" + memory_stats_.getReport());
     ESP_EVENT("Quit the program");
 
-    if (training_thread_.joinable()) {
-        training_thread_.join();
-    }
+    // Results of background work that is still running are no longer wanted.
+    cancelPipelineTasks();
+    SerialDeviceRegistry::instance().stopWatching();
     istream_->stop();
 
     // Save data here!
@@ -2015,16 +2528,156 @@ void ofApp::exit() {
 
 void ofApp::onDataIn(GRT::MatrixDouble input) {
     std::lock_guard<std::mutex> guard(input_data_mutex_);
+    if (input.getNumCols() != input_dimensions_) return;
     for (int i = 0; i < input.getNumRows(); i++)
         input_data_.push_back(input.getRowVector(i));
 }
 
+void ofApp::sendPredictionRecord() {
+    PredictionRecord& record = prediction_record_;
+    record.timestamp_us =
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+    record.sequence = prediction_sequence_++;
+    record.label = predicted_label_;
+    record.classifier_label = pipeline_->getUnProcessedPredictedClassLabel();
+    record.null_rejection_enabled =
+        pipeline_->getClassifier()->getNullRejectionEnabled();
+    record.class_labels.assign(predicted_class_labels_.begin(),
+                               predicted_class_labels_.end());
+    record.likelihoods.assign(predicted_class_likelihoods_.begin(),
+                              predicted_class_likelihoods_.end());
+    // The classifier's own distances, not the ones scaled for plotting.
+    GRT::VectorDouble distances = pipeline_->getClassDistances();
+    record.distances.assign(distances.begin(), distances.end());
+    for (PredictionOStream *ostream : prediction_ostreams_) {
+        ostream->onReceive(record);
+    }
+}
+
+void ofApp::setupInputPlots() {
+    const vector<string>& istream_labels = istream_->getLabels();
+    plot_raw_.setup(buffer_size_, istream_->getNumOutputDimensions(), "Raw Data");
+    plot_raw_.setDrawGrid(true);
+    plot_raw_.setDrawInfoText(true);
+    plot_raw_.setChannelNames(istream_labels);
+    plot_raw_.setAxisTitle("Time", "");
+    plot_raw_.setChannelColors(color_palette_.generate(istream_->getNumOutputDimensions()));
+    plot_raw_.setLinkRanges(true);
+    plot_raw_.setIncludeAxisLabelsInPlotDimensions(false, true);
+    plot_inputs_.setup(buffer_size_, istream_->getNumOutputDimensions(), "Input");
+    plot_inputs_.setDrawGrid(true);
+    plot_inputs_.setDrawInfoText(true);
+    plot_inputs_.setChannelNames(istream_labels);
+    plot_inputs_.onRangeSelected(this, &ofApp::onInputPlotRangeSelection, NULL);
+    plot_inputs_.onValueHighlighted(this, &ofApp::onInputPlotValueSelection, NULL);
+    plot_inputs_.setAxisTitle("Time", "");
+    plot_inputs_.setChannelColors(color_palette_.generate(istream_->getNumOutputDimensions()));
+    plot_inputs_.setLinkRanges(true);
+    plot_inputs_.setIncludeAxisLabelsInPlotDimensions(false, true);
+    if (istream_->getNumOutputDimensions() >= kTooManyFeaturesThreshold) {
+        plot_inputs_snapshot_.setup(istream_->getNumOutputDimensions(), 1, "Snapshot");
+        spectrogram_inputs_.setup(buffer_size_,
+                                  istream_->getNumOutputDimensions(),
+                                  "Input history");
+        spectrogram_inputs_.setBackgroundColor(background_color_);
+        plot_inputs_.setDrawInfoText(false); // this will be too long to show
+    }
+
+    // The calibrator's output width is only known once it has calibrated a
+    // frame; onDataIn() sets the buffer up again if it differs.
+    setupRewindBuffer(istream_->getNumOutputDimensions());
+
+    plot_testdata_window_.setup(buffer_size_, istream_->getNumOutputDimensions(), "Test Data");
+    plot_testdata_window_.setDrawGrid(true);
+    plot_testdata_window_.setDrawInfoText(true);
+    plot_testdata_window_.setChannelColors(color_palette_.generate(istream_->getNumOutputDimensions()));
+    plot_testdata_window_.setIncludeAxisLabelsInPlotDimensions(false, true);
+
+    plot_testdata_overview_.setup(istream_->getNumOutputDimensions(), "Overview");
+    plot_testdata_overview_.onRangeSelected(this, &ofApp::onTestOverviewPlotSelection, NULL);
+}
+
+void ofApp::setupRewindBuffer(uint32_t calibrated_dim) {
+    // Each frame stores the raw and the calibrated data plus a timestamp.
+    uint32_t input_dim = istream_->getNumOutputDimensions();
+    uint32_t rewind_size = rewind_buffer_size_;
+    if (rewind_size == 0) {
+        rewind_size = kRewindBufferBytes /
+            ((input_dim + calibrated_dim) * sizeof(double) + sizeof(uint64_t));
+    }
+    rewind_buffer_.setup(input_dim, calibrated_dim,
+                         std::max(rewind_size, buffer_size_));
+    rewind_frames_ago_ = 0;
+}
+
+void ofApp::onInputDimensionsChanged() {
+    uint32_t dimensions = istream_->getNumOutputDimensions();
+    if (dimensions == input_dimensions_) {
+        setStatus("Input stream is back to " + std::to_string(dimensions) +
+                  " dimensions");
+        return;
+    }
+
+    // Only the plots can be laid out again. The pipeline's pre-processing
+    // and feature extraction modules, the calibrator and the recorded data
+    // were all made for the old number of dimensions.
+    string reason;
+    if (pipeline_->getNumPreProcessingModules() > 0 ||
+        pipeline_->getNumFeatureExtractionModules() > 0) {
+        reason = "the pipeline expects ";
+    } else if (calibrator_ != nullptr) {
+        reason = "the calibrator expects ";
+    } else if (training_data_manager_.getTotalNumSamples() > 0) {
+        reason = "the training samples have ";
+    } else if (test_data_.getNumRows() > 0) {
+        reason = "the test data has ";
+    }
+    if (!reason.empty()) {
+        setStatus("Input stream now sends " + std::to_string(dimensions) +
+                  " dimensions but " + reason +
+                  std::to_string(input_dimensions_) +
+                  "; update your code to match and restart");
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> guard(input_data_mutex_);
+        input_data_.clear();
+        input_dimensions_ = dimensions;
+    }
+    is_recording_ = false;
+    sample_data_.clear();
+
+    setupInputPlots();
+    for (uint32_t i = 0; i < plot_samples_.size(); i++) {
+        plot_samples_[i].setup(dimensions,
+                               training_data_manager_.getLabelName(i + 1));
+        plot_samples_[i].setColorPalette(color_palette_.generate(dimensions));
+    }
+    if (dimensions >= kTooManyFeaturesThreshold) {
+        while (plot_samples_snapshots_.size() < kNumMaxLabels_) {
+            Plotter plot;
+            plot.setup(1, "");
+            plot_samples_snapshots_.push_back(plot);
+        }
+    }
+    training_data_manager_.setNumDimensions(dimensions);
+    // A classifier loaded from a file was trained on the old dimensions.
+    pipeline_->clear();
+
+    setStatus("Input stream now sends " + std::to_string(dimensions) +
+              " dimensions");
+}
+
 void ofApp::pauseResume() {
     istream_->toggle();
     enable_history_recording_ = !enable_history_recording_;
     if (!enable_history_recording_) {
         class_likelihood_values_.resize(0);
         class_distance_values_.resize(0);
+        // Back to the live data if the plot was scrolled back.
+        scrollInputHistory(-(int64_t) rewind_frames_ago_);
     }
     
     std::lock_guard<std::mutex> guard(input_data_mutex_);
@@ -2067,42 +2720,77 @@ void ofApp::trainModel() {
 
     is_training_scheduled_ = false;
 
-   // If prior training has not finished, we wait.
-   if (training_thread_.joinable()) {
-       training_thread_.join();
-   }
-
-   auto training_func = [this]() -> bool {
-       ofLog() << "Training started";
-       bool training_status = false;
-
-       // Enable logging. GRT error logs will call ofApp::notify().
-       GRT::ErrorLog::enableLogging(true);
-
-       if (pipeline_->train(training_data_manager_.getAllData())) {
-           for (Plotter& plot : plot_samples_) {
-               assert(true == plot.clearContentModifiedFlag());
-           }
-
-           should_save_pipeline_ = true;
-           training_status = true;
-
-           ESP_EVENT("Training is successful");
-       } else {
-           ofLog(OF_LOG_ERROR) << "Failed to train the model";
-           ESP_EVENT("Training failed");
-       }
-
-       // Stop logging.
-       GRT::ErrorLog::enableLogging(false);
-       return training_status;
-   };
+    // A newer training run supersedes one that hasn't finished.
+    training_token_.cancel();
+    TaskScheduler::CancellationToken token;
+    training_token_ = token;
+    is_training_running_ = true;
+    samples_added_during_training_.clear();
+
+    // Train a copy so that the live pipeline keeps predicting meanwhile.
+    auto pipeline = std::make_shared<GRT::GestureRecognitionPipeline>(*pipeline_);
+    GRT::TimeSeriesClassificationData all_data = training_data_manager_.getAllData();
+    TemplateCondenser condenser = template_condenser_;
+
+    // GRT error logs will call ofApp::notify() until the training is over.
+    std::shared_ptr<void> error_log = enableGrtErrorLog();
+    submitPipelineTask(TaskScheduler::kNormal,
+        [this, token, pipeline, all_data, condenser, error_log] {
+            ofLog() << "Training started";
+
+            GRT::TimeSeriesClassificationData training_data =
+                condenser.condense(all_data);
+            // Features of samples that are gone won't be needed again.
+            parallel_trainer_.prune(all_data);
+            vector<uint32_t> skipped;
+            bool trained = parallel_trainer_.train(*pipeline, training_data,
+                                                   token, &skipped);
+
+            uint32_t num_trained = training_data.getNumSamples();
+            uint32_t num_total = all_data.getNumSamples();
+            uint32_t num_skipped = skipped.size();
+            TaskScheduler::instance().runOnMainThread(
+                [this, token, pipeline, trained, num_trained, num_total,
+                 num_skipped] {
+                    if (token.isCancelled()) return;
+                    is_training_running_ = false;
+                    vector<std::pair<uint32_t, MatrixDouble>> added;
+                    added.swap(samples_added_during_training_);
+                    if (template_condenser_.isEnabled()) {
+                        ESP_EVENT("Training on " + std::to_string(num_trained) +
+                                  " of " + std::to_string(num_total) +
+                                  " samples after template condensation");
+                    }
+                    if (!trained) {
+                        ofLog(OF_LOG_ERROR) << "Failed to train the model";
+                        ESP_EVENT("Training failed");
+                        return;
+                    }
 
-   // TODO(benzh) Fix data race issue later.
-   if (training_func()) {
-       afterTrainModel();
-       status_text_ = "Training was successful";
-   }
+                    *pipeline_ = *pipeline;
+                    for (const auto& sample : added) {
+                        updateModelWithSample(sample.first, sample.second);
+                    }
+                    for (Plotter& plot : plot_samples_) {
+                        assert(true == plot.clearContentModifiedFlag());
+                    }
+                    should_save_pipeline_ = true;
+                    ESP_EVENT("Training is successful");
+
+                    afterTrainModel();
+                    status_text_ = "Training was successful";
+                    if (num_skipped > 0) {
+                        // Usually samples shorter than a feature extraction
+                        // module's window.
+                        std::string skipped_text = "skipped " +
+                            std::to_string(num_skipped) +
+                            " samples that yield no features";
+                        ofLog(OF_LOG_WARNING) << "Training " << skipped_text;
+                        ESP_EVENT("Training " + skipped_text);
+                        status_text_ += ", " + skipped_text;
+                    }
+                });
+        }, token);
 }
 
 void ofApp::afterTrainModel() {
@@ -2120,50 +2808,139 @@ void ofApp::afterTrainModel() {
 }
 
 void ofApp::scoreTrainingData(bool leaveOneOut) {
-    for (int label = 1; label <= training_data_manager_.getNumLabels(); label++) {
+    // A newer round of scoring supersedes this one.
+    scoring_token_.cancel();
+    TaskScheduler::CancellationToken token;
+    scoring_token_ = token;
+
+    // Every task predicts with its own copy of the trained pipeline. GRT
+    // doesn't promise that copying is thread-safe, so copies are made one at
+    // a time.
+    auto trained = std::make_shared<GRT::GestureRecognitionPipeline>(*pipeline_);
+    auto trained_mutex = std::make_shared<std::mutex>();
+    auto all_data = std::make_shared<GRT::TimeSeriesClassificationData>(
+        training_data_manager_.getAllData());
+    TemplateCondenser condenser = template_condenser_;
+    const uint32_t num_labels = training_data_manager_.getNumLabels();
+    const uint64_t version = training_data_manager_.getVersion();
+
+    // Where each sample of each label is in all_data.
+    vector<vector<uint32_t>> positions(num_labels + 1);
+    for (uint32_t i = 0; i < all_data->getNumSamples(); i++) {
+        positions[(*all_data)[i].getClassLabel()].push_back(i);
+    }
+
+    for (uint32_t label = 1; label <= num_labels; label++) {
         // No point in doing leave-one-out scoring for labels w/ one sample.
-        if (leaveOneOut && training_data_manager_.getNumSampleForLabel(label) == 1)
-            continue;
+        uint32_t num_samples = training_data_manager_.getNumSampleForLabel(label);
+        if (leaveOneOut && num_samples == 1) continue;
 
-        for (int i = 0; i < training_data_manager_.getNumSampleForLabel(label); i++) {
-            GRT::MatrixDouble sample =
-                training_data_manager_.getSample(label, (leaveOneOut ? 0 : i));
+        for (uint32_t i = 0; i < num_samples; i++) {
+            GRT::MatrixDouble sample = training_data_manager_.getSample(label, i);
+            uint32_t position = positions[label][i];
 
-            if (leaveOneOut) {
-                training_data_manager_.deleteSample(label, 0);
-                pipeline_->train(training_data_manager_.getAllData());
-            }
-
-            //ofLog(OF_LOG_NOTICE) << "sample " << i << " (class " << label << "):";
-            vector<double> likelihoods(training_data_manager_.getNumLabels() + 1, 0.0);
-            for (int j = 0; j < sample.getNumRows(); j++) {
-                pipeline_->predict(sample.getRowVector(j));
-                auto l = pipeline_->getClassLikelihoods();
-                for (int k = 0; k < l.size(); k++) {
-                    likelihoods[pipeline_->getClassLabels()[k]] += l[k];
+            submitPipelineTask(TaskScheduler::kNormal, [=] {
+                std::unique_ptr<GRT::GestureRecognitionPipeline> pipeline;
+                {
+                    std::lock_guard<std::mutex> lock(*trained_mutex);
+                    pipeline.reset(new GRT::GestureRecognitionPipeline(*trained));
+                }
+                pipeline->reset();
+
+                if (leaveOneOut) {
+                    GRT::TimeSeriesClassificationData data = *all_data;
+                    data.removeSample(position);
+                    if (!parallel_trainer_.train(
+                            *pipeline, condenser.condense(data), token)) {
+                        return;
+                    }
                 }
-            }
-            double sum = 0.0;
-            for (int j = 0; j < likelihoods.size(); j++) {
-                //ofLog(OF_LOG_NOTICE) << "\t" << (j + 1) << ": " << likelihoods[j] << "%";
-                sum += likelihoods[j];
-            }
-            for (int j = 0; j < likelihoods.size(); j++) {
-                likelihoods[j] /= (sum == 0.0 ? 1e-9 : sum);
-                //ofLog(OF_LOG_NOTICE) << "\t" << (j + 1) << ": " << likelihoods[j] << "%";
-            }
-
-            if (leaveOneOut) training_data_manager_.addSample(label, sample);
 
-            training_data_manager_.setSampleClassLikelihoods(label,
-                (leaveOneOut ? training_data_manager_.getNumSampleForLabel(label) - 1 : i),
-                likelihoods);
+                vector<double> likelihoods(num_labels + 1, 0.0);
+                for (int j = 0; j < sample.getNumRows(); j++) {
+                    if (token.isCancelled()) return;
+                    pipeline->predict(sample.getRowVector(j));
+                    auto l = pipeline->getClassLikelihoods();
+                    for (int k = 0; k < l.size(); k++) {
+                        likelihoods[pipeline->getClassLabels()[k]] += l[k];
+                    }
+                }
+                double sum = 0.0;
+                for (int j = 0; j < likelihoods.size(); j++) {
+                    sum += likelihoods[j];
+                }
+                for (int j = 0; j < likelihoods.size(); j++) {
+                    likelihoods[j] /= (sum == 0.0 ? 1e-9 : sum);
+                }
 
-            pipeline_->reset();
+                TaskScheduler::instance().runOnMainThread(
+                    [this, token, version, label, i, likelihoods] {
+                        // Drop scores of samples that have since changed.
+                        if (token.isCancelled() ||
+                            training_data_manager_.getVersion() != version) {
+                            return;
+                        }
+                        training_data_manager_.setSampleClassLikelihoods(
+                            label, i, likelihoods);
+                    });
+            }, token);
         }
     }
+}
 
-    if (leaveOneOut) pipeline_->train(training_data_manager_.getAllData());
+void ofApp::analyzeDimensions() {
+    auto data = std::make_shared<GRT::TimeSeriesClassificationData>(
+        training_data_manager_.getAllData());
+    if (data->getNumSamples() == 0) {
+        setStatus("Collect training samples to analyze the input dimensions");
+        return;
+    }
+
+    // A newer analysis supersedes this one.
+    ablation_token_.cancel();
+    TaskScheduler::CancellationToken token;
+    ablation_token_ = token;
+
+    auto pipeline = std::make_shared<GRT::GestureRecognitionPipeline>(*pipeline_);
+    const uint32_t num_dimensions = data->getNumDimensions();
+    vector<FeatureAblation::Group> groups =
+        FeatureAblation::eachDimension(num_dimensions, istream_->getLabels());
+    setStatus("Analyzing the input dimensions...");
+
+    submitPipelineTask(TaskScheduler::kBulk, [=] {
+        // Permuting a dimension is much cheaper than retraining without it.
+        FeatureAblation ablation(FeatureAblation::Method::kPermute);
+        FeatureAblation::Report report =
+            ablation.analyze(*pipeline, *data, groups);
+        vector<uint32_t> keep =
+            FeatureAblation::selectDimensions(report, num_dimensions);
+
+        TaskScheduler::instance().runOnMainThread(
+            [this, token, report, keep, num_dimensions] {
+                if (token.isCancelled()) return;
+                ofLog(OF_LOG_NOTICE) << "Contribution of each input dimension"
+                                     << " to the accuracy:" << std::endl
+                                     << FeatureAblation::formatReport(report);
+                if (keep.size() == num_dimensions) {
+                    setStatus("Every input dimension contributes to the "
+                              "accuracy");
+                    return;
+                }
+
+                std::ostringstream selector;
+                selector << "DimensionSelector({";
+                for (uint32_t i = 0; i < keep.size(); i++) {
+                    selector << (i > 0 ? ", " : "") << keep[i];
+                }
+                selector << "}, " << num_dimensions << ")";
+                setStatus(std::to_string(keep.size()) + " of " +
+                          std::to_string(num_dimensions) +
+                          " input dimensions contribute to the accuracy; add " +
+                          selector.str() + " first in the pipeline to use "
+                          "only those");
+                ESP_EVENT("Suggested " + selector.str());
+            });
+    }, token);
 }
 
 void ofApp::scoreImpactOfTrainingSample(int label, const MatrixDouble &sample) {
@@ -2176,12 +2953,12 @@ void ofApp::scoreImpactOfTrainingSample(int label, const MatrixDouble &sample) {
     double score = 0.0;
     int num_non_zero = 0;
     for (int j = 0; j < sample.getNumRows(); j++) {
-        pipeline_->predict(sample.getRowVector(j));
-        auto l = pipeline_->getClassLikelihoods();
+        p.predict(sample.getRowVector(j));
+        auto l = p.getClassLikelihoods();
         bool non_zero = false;
         for (int k = 0; k < l.size(); k++) {
             if (l[k] > 1e-9) non_zero = true;
-            if (pipeline_->getClassLabels()[k] == label) {
+            if (p.getClassLabels()[k] == label) {
                 //std::cout << l[k] << " ";
                 score += l[k];
             }
@@ -2194,8 +2971,91 @@ void ofApp::scoreImpactOfTrainingSample(int label, const MatrixDouble &sample) {
         std::to_string((int) (100 * -log(score / num_non_zero))) + "%");
 }
 
+bool ofApp::updateModelWithSample(uint32_t label, const MatrixDouble &sample) {
+    // Template condensation and resampling change which samples and rows the
+    // model is trained on, so they need a full retrain.
+    GRT::IncrementalClassifier *classifier =
+        dynamic_cast<GRT::IncrementalClassifier *>(pipeline_->getClassifier());
+    if (classifier == nullptr || template_condenser_.isEnabled() ||
+        training_data_manager_.getTargetSampleLength() > 0) {
+        return false;
+    }
+
+    // The model being trained won't have this sample either.
+    if (is_training_running_) {
+        samples_added_during_training_.emplace_back(label, sample);
+    }
+    if (!pipeline_->getTrained()) return false;
+
+    // Flow the sample through a copy of the pipeline, as
+    // populateSampleFeatures() does, so the live pipeline keeps the state of
+    // its filters, and add each feature vector to the live model.
+    GestureRecognitionPipeline p(*pipeline_);
+    p.reset();
+    uint32_t num_updates = 0;
+    for (uint32_t i = 0; i < sample.getNumRows(); i++) {
+        vector<double> features = sample.getRowVector(i);
+        if (num_preprocessing_modules_ + num_feature_modules_ > 0) {
+            if (!p.preProcessData(features)) continue;
+            features = getLastStageProcessedData(p);
+        }
+        if (classifier->updateModel(label, features)) num_updates++;
+    }
+
+    if (num_updates == 0) return false;
+    should_save_pipeline_ = true;
+    ESP_EVENT("Updated the model with " + std::to_string(num_updates) +
+              " feature vectors of class " + std::to_string(label));
+    return true;
+}
+
+void ofApp::applyTuneables() {
+    // Publish this frame's tuneable changes as one batch and apply them
+    // before the pipeline sees the next frame.
+    tuneable_values_.publish();
+    if (tuneable_values_.apply()) {
+        // FeatureApply functions may read any tuneable, so cached features
+        // can't be trusted after a change.
+        parallel_trainer_.clear();
+    } else if (tuneable_values_.hasUnapplied()) {
+        // Background tasks are running pipeline copies. The change, and the
+        // callbacks, wait for a frame after they're done.
+        return;
+    }
+
+    bool reload = false;
+    for (Tuneable* t : tuneable_parameters_) {
+        if (t->notifyUserChange()) reload = true;
+    }
+    if (reload) reloadPipelineModules();
+}
+
+TaskScheduler::TaskHandle ofApp::submitPipelineTask(
+    TaskScheduler::Priority priority, std::function<void()> fn,
+    TaskScheduler::CancellationToken token) {
+    ParameterStore::Lease lease = tuneable_values_.lease();
+    return TaskScheduler::instance().submit(
+        priority, [lease, fn] { fn(); }, token);
+}
+
+void ofApp::cancelPipelineTasks() {
+    training_token_.cancel();
+    scoring_token_.cancel();
+    test_prediction_token_.cancel();
+    ablation_token_.cancel();
+    for (auto& token : sample_feature_tokens_) token.cancel();
+}
+
 void ofApp::reloadPipelineModules() {
+    // Whatever is being trained or scored is for the old modules.
+    training_token_.cancel();
+    is_training_running_ = false;
+    samples_added_during_training_.clear();
+    scoring_token_.cancel();
+    ablation_token_.cancel();
+    parallel_trainer_.clear();
     pipeline_->clearAll();
+    log_importer_.clearTimeRanges();
     ::setup();
 }
 
@@ -2232,6 +3092,17 @@ void ofApp::keyPressed(int key) {
         case 't':
             beginTrainModel();
             return;
+        case 'd':
+            analyzeDimensions();
+            return;
+        case OF_KEY_LEFT:
+        case OF_KEY_RIGHT:
+            // Scroll the paused input plot by half a screen.
+            if (enable_history_recording_) {
+                int64_t step = buffer_size_ / 2;
+                scrollInputHistory(key == OF_KEY_LEFT ? step : -step);
+            }
+            return;
         }
         break;
     }  // case AppState::kTraining
@@ -2243,6 +3114,7 @@ void ofApp::keyPressed(int key) {
                 label_ = 255;
                 sample_data_.clear();
                 test_data_.clear();
+                test_prediction_token_.cancel();
                 plot_testdata_window_.reset();
             }
             return;
@@ -2407,7 +3279,14 @@ void ofApp::keyReleased(int key) {
                 int num_samples =
                     training_data_manager_.getNumSampleForLabel(label_);
 
-                plot_samples_[label_ - 1].setData(sample_data_);
+                if (use_automatic_trimming_ && sample_data_.getNumRows() > 0) {
+                    auto range = activity_trimmer_.findActiveRange(sample_data_);
+                    training_data_manager_.trimSample(
+                        label_, num_samples - 1, range.first, range.second);
+                }
+
+                plot_samples_[label_ - 1].setData(
+                    training_data_manager_.getSample(label_, num_samples - 1));
                 plot_sample_indices_[label_ - 1] = num_samples - 1;
 
                 updatePlotSamplesSnapshot(label_ - 1);
@@ -2417,6 +3296,10 @@ void ofApp::keyReleased(int key) {
                 ESP_EVENT("Collected " + std::to_string(sample_data_.getNumRows()) +
                           " data points for training class " +
                           std::to_string(label_));
+
+                updateModelWithSample(
+                    label_,
+                    training_data_manager_.getSample(label_, num_samples - 1));
             }
             return;
         }
@@ -2439,6 +3322,8 @@ void ofApp::keyReleased(int key) {
                 if (result.getResult() != CalibrateResult::FAILURE) {
                     plot_calibrators_[label_ - 1].setData(sample_data_);
                     plot_inputs_.reset();
+                    rewind_buffer_.clear();
+                    rewind_frames_ago_ = 0;
                     should_save_calibration_data_ = true;
                 }
 
@@ -2676,6 +3561,10 @@ void useOutputStream(OStreamVector &stream) {
     ((ofApp *) ofGetAppPtr())->useOStream(stream);
 }
 
+void useOutputStream(PredictionOStream &stream) {
+    ((ofApp *) ofGetAppPtr())->useOStream(stream);
+}
+
 void usePipeline(GRT::GestureRecognitionPipeline &pipeline) {
     ((ofApp *) ofGetAppPtr())->usePipeline(pipeline);
 }
@@ -2688,6 +3577,22 @@ void setGUIBufferSize(uint32_t buffer_size) {
     ((ofApp *) ofGetAppPtr())->setBufferSize(buffer_size);
 }
 
+void setRewindBufferSize(uint32_t num_frames) {
+    ((ofApp *) ofGetAppPtr())->setRewindBufferSize(num_frames);
+}
+
+void setFrameBudget(double milliseconds) {
+    ((ofApp *) ofGetAppPtr())->setFrameBudget(milliseconds);
+}
+
+void setLogImportColumns(int label_column, int time_column) {
+    ((ofApp *) ofGetAppPtr())->setLogImportColumns(label_column, time_column);
+}
+
+void addLogImportTimeRange(double start, double end, uint32_t label) {
+    ((ofApp *) ofGetAppPtr())->addLogImportTimeRange(start, end, label);
+}
+
 void useStream(IOStream &stream) {
     ((ofApp *) ofGetAppPtr())->useIStream(stream);
     ((ofApp *) ofGetAppPtr())->useOStream(stream);
@@ -2706,6 +3611,18 @@ void useLeaveOneOutScoring(bool enable) {
     ((ofApp *) ofGetAppPtr())->useLeaveOneOutScoring(enable);
 }
 
+void useTemplateCondensation(uint32_t max_templates_per_class) {
+    ((ofApp *) ofGetAppPtr())->useTemplateCondensation(max_templates_per_class);
+}
+
+void useAutomaticTrimming(double threshold, uint32_t padding) {
+    ((ofApp *) ofGetAppPtr())->useAutomaticTrimming(threshold, padding);
+}
+
+void setTrainingSampleLength(uint32_t length) {
+    ((ofApp *) ofGetAppPtr())->setTrainingSampleLength(length);
+}
+
 void setTruePositiveWarningThreshold(double threshold) {
     ((ofApp *) ofGetAppPtr())->true_positive_threshold_ = threshold;
 }
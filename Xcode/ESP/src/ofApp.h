@@ -1,7 +1,6 @@
 #pragma once
 
 #include <cstdint>
-#include <thread>
 
 // of System
 #include "ofMain.h"
@@ -10,9 +9,22 @@
 #include "ofConsoleFileLoggerChannel.h"
 
 // custom
+#include "activity-trimmer.h"
 #include "calibrator.h"
+#include "feature-ablation.h"
+#include "frame-governor.h"
+#include "IncrementalClassifier.h"
 #include "iostream.h"
+#include "log-importer.h"
+#include "memory-stats.h"
+#include "parallel-trainer.h"
+#include "parameter-store.h"
 #include "plotter.h"
+#include "rewind-buffer.h"
+#include "serial-device-registry.h"
+#include "spectrogram-plot.h"
+#include "task-scheduler.h"
+#include "template-condenser.h"
 #include "training.h"
 #include "training-data-manager.h"
 #include "tuneable.h"
@@ -87,20 +99,51 @@ class ofApp : public ofBaseApp, public GRT::Observer<GRT::ErrorLogMessage> {
     void gotMessage(ofMessage msg) final;
 
     void registerTuneable(Tuneable* t) {
+        t->attach(&tuneable_values_);
         tuneable_parameters_.push_back(t);
     }
 
     void reloadPipelineModules();
 
     // GRT error log observer callback: we simply display it as status text.
+    // Training logs from a worker thread, so this goes through the next
+    // update().
     virtual void notify(const ErrorLogMessage& data) final {
-        status_text_ = data.getMessage();
+        std::string message = data.getMessage();
+        TaskScheduler::instance().runOnMainThread([this, message] {
+            status_text_ = message;
+        });
     }
 
+    // GRT's error log is process-wide, so it's only switched on and off on
+    // the main thread: it's on while any copy of the returned pointer is
+    // alive. Capture it in the background work whose errors should be shown.
+    std::shared_ptr<void> enableGrtErrorLog();
+    uint32_t grt_error_log_users_ = 0;
+
     void setBufferSize(uint32_t buffer_size) {
         buffer_size_ = buffer_size;
     }
 
+    void setRewindBufferSize(uint32_t num_frames) {
+        rewind_buffer_size_ = num_frames;
+    }
+
+    void setFrameBudget(double milliseconds) {
+        governor_.setBudget(milliseconds);
+    }
+
+    void setLogImportColumns(int label_column, int time_column) {
+        LogImporter::Options options = log_importer_.getOptions();
+        options.label_column = label_column;
+        options.time_column = time_column;
+        log_importer_.setOptions(options);
+    }
+
+    void addLogImportTimeRange(double start, double end, uint32_t label) {
+        log_importer_.addTimeRange(start, end, label);
+    }
+
   private:
     enum class AppState {
         kCalibration,
@@ -151,6 +194,7 @@ class ofApp : public ofBaseApp, public GRT::Observer<GRT::ErrorLogMessage> {
         }
     }
 
+    void drawTabs();
     void drawInputs(uint32_t, uint32_t, uint32_t, uint32_t);
     void drawLiveFeatures(uint32_t, uint32_t, uint32_t, uint32_t);
 
@@ -166,9 +210,15 @@ class ofApp : public ofBaseApp, public GRT::Observer<GRT::ErrorLogMessage> {
     void useIStream(InputStream& stream);
     void useOStream(OStream& stream);
     void useOStream(OStreamVector& stream);
+    void useOStream(PredictionOStream& stream);
     void useTrainingSampleChecker(TrainingSampleChecker checker);
     void useLeaveOneOutScoring(bool enable) {
         use_leave_one_out_scoring_ = enable;}
+    void useTemplateCondensation(uint32_t max_templates_per_class) {
+        template_condenser_.setMaxTemplatesPerClass(max_templates_per_class);}
+    void useAutomaticTrimming(double threshold, uint32_t padding);
+    void setTrainingSampleLength(uint32_t length) {
+        training_data_manager_.setTargetSampleLength(length);}
 
     friend void useCalibrator(Calibrator &calibrator);
     friend void usePipeline(GRT::GestureRecognitionPipeline &pipeline);
@@ -179,6 +229,9 @@ class ofApp : public ofBaseApp, public GRT::Observer<GRT::ErrorLogMessage> {
     friend void useStream(IOStreamVector &stream);
     friend void useTrainingSampleChecker(TrainingSampleChecker checker);
     friend void useLeaveOneOutScoring(bool enable);
+    friend void useTemplateCondensation(uint32_t max_templates_per_class);
+    friend void useAutomaticTrimming(double threshold, uint32_t padding);
+    friend void setTrainingSampleLength(uint32_t length);
     friend void setTruePositiveWarningThreshold(double threshold);
     friend void setFalseNegativeWarningThreshold(double threshold);
 
@@ -197,6 +250,18 @@ class ofApp : public ofBaseApp, public GRT::Observer<GRT::ErrorLogMessage> {
     // the buffer size used for training/prediction.
     uint32_t buffer_size_ = 256;
 
+    // Full-precision history of the live input that samples are extracted
+    // from when the input plot is paused. It is updated in lockstep with
+    // plot_inputs_ but holds many more frames. rewind_buffer_size_ is its
+    // capacity in frames; zero means it is derived from a memory budget.
+    uint32_t rewind_buffer_size_ = 0;
+    RewindBuffer rewind_buffer_;
+    // While paused, the left and right arrow keys scroll plot_inputs_ through
+    // rewind_buffer_. This is how many frames before the newest one the
+    // plot's last point is; 0 shows the live data.
+    uint32_t rewind_frames_ago_ = 0;
+    void scrollInputHistory(int64_t frames);
+
     //========================================================================
     // Pipeline, tuneables and all data
     //========================================================================
@@ -212,12 +277,33 @@ class ofApp : public ofBaseApp, public GRT::Observer<GRT::ErrorLogMessage> {
     uint32_t num_preprocessing_modules_;
     uint32_t num_feature_modules_;
     vector<double> getLastStageProcessedData() const;
+    vector<double> getLastStageProcessedData(
+        GRT::GestureRecognitionPipeline& pipeline) const;
 
     vector<Tuneable*> tuneable_parameters_;
+    // Holds the values of the tuneables' variables. Changes from the GUI are
+    // published once per frame and applied before the pipeline runs, unless
+    // a background task is running a copy of the pipeline.
+    ParameterStore tuneable_values_;
+    void applyTuneables();
+
+    // Submit background work that runs a copy of the pipeline. The copy's
+    // FeatureApply functions read the tuneables' variables, so the task
+    // holds a lease on them until it has run or been cancelled.
+    TaskScheduler::TaskHandle submitPipelineTask(
+        TaskScheduler::Priority priority, std::function<void()> fn,
+        TaskScheduler::CancellationToken token);
+    // Cancel all the work submitted with submitPipelineTask().
+    void cancelPipelineTasks();
     Calibrator* calibrator_;
     TrainingDataManager training_data_manager_;
     TrainingSampleChecker training_sample_checker_ = 0;
 
+    // If enabled, newly recorded training samples are trimmed to the part
+    // that contains activity (see useAutomaticTrimming()).
+    bool use_automatic_trimming_ = false;
+    ActivityTrimmer activity_trimmer_;
+
     GRT::MatrixDouble sample_data_;
     GRT::MatrixDouble input_data_;
     std::mutex input_data_mutex_;  // input_data_ is written by istream_ thread
@@ -248,8 +334,27 @@ class ofApp : public ofBaseApp, public GRT::Observer<GRT::ErrorLogMessage> {
     //========================================================================
     InputStream *istream_;
     void onDataIn(GRT::MatrixDouble in);
+    // Width of the data the plots are laid out for; data of another width is
+    // dropped. Guarded by input_data_mutex_.
+    uint32_t input_dimensions_ = 0;
+    // Lays the plots out again for the stream's new width, as long as nothing
+    // else depends on the old one: the pipeline has no pre-processing or
+    // feature extraction modules, there's no calibrator and no data has been
+    // recorded. Otherwise, asks the user to update their code and restart.
+    void onInputDimensionsChanged();
+    // Sets up the plots of the input data for the stream's current width.
+    void setupInputPlots();
+    // Sizes rewind_buffer_ for the stream's width and `calibrated_dim`, the
+    // width of the calibrator's output.
+    void setupRewindBuffer(uint32_t calibrated_dim);
+    // Pass the current prediction on to prediction_ostreams_.
+    void sendPredictionRecord();
     vector<OStream *> ostreams_;
     vector<OStreamVector *> ostreamvectors_;
+    vector<PredictionOStream *> prediction_ostreams_;
+    // Reused for every prediction, to keep its vectors' memory.
+    PredictionRecord prediction_record_;
+    uint32_t prediction_sequence_ = 0;
 
     //========================================================================
     // Application states
@@ -294,8 +399,18 @@ class ofApp : public ofBaseApp, public GRT::Observer<GRT::ErrorLogMessage> {
     //========================================================================
     // visual: input stream
     //========================================================================
-    ofxDatGuiDropdown *serial_selection_dropdown_;
+    ofxDatGuiDropdown *serial_selection_dropdown_ = nullptr;
+    // The devices listed in the dropdown; a hotplug rescan may renumber the
+    // registry's devices while it's shown.
+    vector<SerialDeviceRegistry::Device> serial_selection_devices_;
+    // List the registry's devices in serial_selection_dropdown_, adding it
+    // the first time and relabelling its options after that. Called at
+    // startup and whenever a serial device is plugged in or out.
+    void updateSerialSelectionDropdown();
     void onSerialSelectionDropdownEvent(ofxDatGuiDropdownEvent e);
+    // Select the serial port used last time, if it's plugged in. Called at
+    // startup and whenever a serial device is plugged in.
+    bool selectRememberedSerialDevice();
 
     //========================================================================
     // visual: live plots are across all tabs
@@ -323,6 +438,9 @@ class ofApp : public ofBaseApp, public GRT::Observer<GRT::ErrorLogMessage> {
                                                  // only if the number of input
                                                  // dimensions is greater than
                                                  // kTooManyFeaturesThreshold
+    SpectrogramPlot spectrogram_inputs_;    // input and final feature history
+    SpectrogramPlot spectrogram_features_;  // as heatmaps, set up only over
+                                            // kTooManyFeaturesThreshold
     void onInputPlotRangeSelection(InteractivePlot::RangeSelectedCallbackArgs);
     void onInputPlotValueSelection(
         InteractivePlot::ValueHighlightedCallbackArgs arg);
@@ -352,7 +470,10 @@ class ofApp : public ofBaseApp, public GRT::Observer<GRT::ErrorLogMessage> {
     Plotter plot_testdata_overview_;
     void onTestOverviewPlotSelection(InteractivePlot::RangeSelectedCallbackArgs);
     void updateTestWindowPlot();
+    // Predicts on a copy of the pipeline in the background and updates the
+    // test window plot when done; labels read as 0 until then.
     void runPredictionOnTestData();
+    TaskScheduler::CancellationToken test_prediction_token_;
 
     //========================================================================
     // visual: training
@@ -364,13 +485,19 @@ class ofApp : public ofBaseApp, public GRT::Observer<GRT::ErrorLogMessage> {
     vector<std::string> plot_samples_info_;
     void onPlotRangeSelected(InteractivePlot::RangeSelectedCallbackArgs arg);
     void updatePlotSamplesSnapshot(int num, int row = -1);
+    // Show the last sample of each label in the TRAINING tab.
+    void updatePlotSamples();
     void onPlotSamplesValueHighlight(InteractivePlot::ValueHighlightedCallbackArgs arg);
 
     bool is_final_features_too_many_ = false;
     vector<vector<Plotter>> plot_sample_features_;
     void toggleFeatureView(ofxDatGuiButtonEvent e) { toggleFeatureView(); }
     void toggleFeatureView();
+    // Computes the features in the background; the plots fill in when done.
     void populateSampleFeatures(uint32_t sample_index);
+    void showSampleFeatures(uint32_t sample_index,
+                            const vector<vector<double>>& features);
+    vector<TaskScheduler::CancellationToken> sample_feature_tokens_;
     vector<pair<double, double>> sample_feature_ranges_;
 
     vector<int> plot_sample_indices_; // the index of the currently plotted
@@ -401,6 +528,8 @@ class ofApp : public ofBaseApp, public GRT::Observer<GRT::ErrorLogMessage> {
             p->setBackgroundColor(background_color_);
         }
         plot_inputs_snapshot_.setBackgroundColor(background_color_);
+        spectrogram_inputs_.setBackgroundColor(background_color_);
+        spectrogram_features_.setBackgroundColor(background_color_);
         plot_raw_.setBackgroundColor(background_color_);
         for (auto& p : plot_calibrators_) {
             p.setBackgroundColor(background_color_);
@@ -582,6 +711,14 @@ class ofApp : public ofBaseApp, public GRT::Observer<GRT::ErrorLogMessage> {
     // Prompts to ask the user to save the test data if changed.
     bool should_save_test_data_;
 
+    // Import CSV/TSV logs of raw sensor readings as training or test data.
+    void importTrainingLog(ofxDatGuiButtonEvent e) { save_load_folder_->collapse(); importLogWithPrompt(false); }
+    void importTestLog(ofxDatGuiButtonEvent e) { save_load_folder_->collapse(); importLogWithPrompt(true); }
+    bool importLogWithPrompt(bool as_test_data);
+    bool importLog(const string& filename, bool as_test_data);
+    // Holds the import options only; importLog() parses into a copy.
+    LogImporter log_importer_;
+
     // Convenient functions that save and load everything from a directory. This
     // assumes the structure of the directory follows our naming convention (see
     // the following few const string definitions). If the naming convention is
@@ -603,8 +740,16 @@ class ofApp : public ofBaseApp, public GRT::Observer<GRT::ErrorLogMessage> {
     //========================================================================
     // Training
     //========================================================================
-    std::thread training_thread_;
+    // Training runs on a copy of the pipeline, which replaces pipeline_ once
+    // it's trained. Cancelling the token drops the result.
+    TaskScheduler::CancellationToken training_token_;
     bool is_training_scheduled_;
+    // Samples recorded while a training run is in progress, for an
+    // incremental classifier. The run trains on a snapshot of the training
+    // data without them, so they are added to its model once it replaces
+    // pipeline_.
+    bool is_training_running_ = false;
+    vector<std::pair<uint32_t, MatrixDouble>> samples_added_during_training_;
     std::uint64_t schedule_time_;
 
     void trainModel(ofxDatGuiButtonEvent e) { beginTrainModel(); }
@@ -613,16 +758,66 @@ class ofApp : public ofBaseApp, public GRT::Observer<GRT::ErrorLogMessage> {
     void trainModel();
     void afterTrainModel();
 
+    // Optionally keeps only a few representative samples per class for
+    // training (see useTemplateCondensation()). Training and scoring work on
+    // a copy, so its settings are taken when they start.
+    TemplateCondenser template_condenser_;
+
+    // Trains (in trainModel() and leave-one-out scoring) with the samples
+    // featurized in parallel, keeping their features for the next time.
+    // Cleared whenever the pipeline's front end may have changed.
+    ParallelTrainer parallel_trainer_;
+
     //========================================================================
     // Scoring
     //========================================================================
+    // Scores every sample in the background, one task per sample.
     void scoreTrainingData(bool leaveOneOut);
+    TaskScheduler::CancellationToken scoring_token_;
     void scoreImpactOfTrainingSample(int label, const MatrixDouble &sample);
+
+    // Add a newly recorded sample to the trained model without retraining,
+    // if the classifier is a GRT::IncrementalClassifier. Other classifiers
+    // only learn from the sample when the model is retrained.
+    bool updateModelWithSample(uint32_t label, const MatrixDouble &sample);
+
+    // Cross-validates the pipeline on the training data without each input
+    // dimension in turn (see FeatureAblation), in the background, and
+    // suggests a DimensionSelector for the dimensions the classifier needs.
+    void analyzeDimensions();
+    TaskScheduler::CancellationToken ablation_token_;
     bool use_leave_one_out_scoring_ = true;
 
     double true_positive_threshold_;
     double false_negative_threshold_;
 
+    //========================================================================
+    // Memory accounting
+    //
+    // Each owner of a large buffer reports its size to memory_stats_ once per
+    // kMemoryStatsInterval. The summary is shown next to the status text and
+    // the full report, with high-water marks, is written to the log.
+    //========================================================================
+    MemoryStats memory_stats_;
+    uint64_t memory_stats_time_ = 0;
+    uint64_t memory_report_time_ = 0;
+    void updateMemoryStats();
+    uint64_t getPlotMemoryUsage();
+    uint64_t getPredictionHistoryMemoryUsage();
+    uint64_t getPipelineMemoryUsage();
+
+    //========================================================================
+    // Frame budget
+    //
+    // governor_ measures update() and draw() and sheds plot updates, then
+    // redraws, when they don't fit in the budget. Prediction and the output
+    // streams are never shed.
+    //========================================================================
+    FrameGovernor governor_;
+    double last_draw_ms_ = 0;
+    ofFbo draw_cache_;
+    bool draw_cache_valid_ = false;
+
     //========================================================================
     // Utils
     //========================================================================
@@ -0,0 +1,130 @@
+#include "osc-bundle-sender.h"
+#include "gtest/gtest.h"
+
+#include "ip/UdpSocket.h"
+#include "osc/OscReceivedElements.h"
+
+static const int kPort = 9877;
+
+// A message, as ofxOscReceiver (and so OscInputStream) reads it out of a
+// bundle.
+struct Message {
+    string address;
+    vector<double> values;
+};
+
+struct Bundle {
+    uint64_t time_tag = 0;
+    vector<Message> messages;
+};
+
+class OscBundleSenderTest : public ::testing::Test {
+  protected:
+    OscBundleSenderTest()
+        : receiver_(IpEndpointName("127.0.0.1", kPort)) {}
+
+    // Wait for a datagram on the port, which must be a bundle of messages.
+    Bundle receive() {
+        char data[65536];
+        IpEndpointName remote;
+        size_t size = receiver_.ReceiveFrom(remote, data, sizeof(data));
+        osc::ReceivedPacket packet(data, size);
+        EXPECT_TRUE(packet.IsBundle());
+
+        Bundle bundle;
+        osc::ReceivedBundle received(packet);
+        bundle.time_tag = received.TimeTag();
+        for (auto e = received.ElementsBegin(); e != received.ElementsEnd();
+             ++e) {
+            osc::ReceivedMessage m(*e);
+            Message message;
+            message.address = m.AddressPattern();
+            for (auto a = m.ArgumentsBegin(); a != m.ArgumentsEnd(); ++a) {
+                message.values.push_back(
+                    a->IsInt32() ? a->AsInt32() : a->AsFloat());
+            }
+            bundle.messages.push_back(message);
+        }
+        return bundle;
+    }
+
+    UdpReceiveSocket receiver_;
+};
+
+TEST_F(OscBundleSenderTest, OneBundlePerFlush) {
+    OscBundleSender sender;
+    ASSERT_TRUE(sender.setup("localhost", kPort));
+
+    uint64_t before = OscBundleSender::getTimeTag();
+    sender.add("/esp/label", 2);
+    sender.add("/esp/likelihoods", vector<double>{ 0.25, 0.75 });
+    sender.add("/esp/vector", vector<double>{ 1.5, -2, 1000 });
+    ASSERT_TRUE(sender.flush());
+    uint64_t after = OscBundleSender::getTimeTag();
+    ASSERT_EQ(1, sender.getNumBundlesSent());
+
+    Bundle bundle = receive();
+    ASSERT_LE(before, bundle.time_tag);
+    ASSERT_GE(after, bundle.time_tag);
+    ASSERT_EQ(3, bundle.messages.size());
+    ASSERT_EQ("/esp/label", bundle.messages[0].address);
+    ASSERT_EQ(vector<double>{ 2 }, bundle.messages[0].values);
+    ASSERT_EQ("/esp/likelihoods", bundle.messages[1].address);
+    ASSERT_EQ((vector<double>{ 0.25, 0.75 }), bundle.messages[1].values);
+    ASSERT_EQ("/esp/vector", bundle.messages[2].address);
+    ASSERT_EQ((vector<double>{ 1.5, -2, 1000 }), bundle.messages[2].values);
+
+    // The next frame gets a bundle of its own.
+    sender.add("/esp/label", 3);
+    ASSERT_TRUE(sender.flush());
+    bundle = receive();
+    ASSERT_EQ(1, bundle.messages.size());
+    ASSERT_EQ(vector<double>{ 3 }, bundle.messages[0].values);
+}
+
+TEST_F(OscBundleSenderTest, NothingToFlush) {
+    OscBundleSender sender;
+    ASSERT_TRUE(sender.setup("127.0.0.1", kPort));
+    ASSERT_TRUE(sender.flush());
+    ASSERT_EQ(0, sender.getNumBundlesSent());
+}
+
+TEST_F(OscBundleSenderTest, SplitsWhenFull) {
+    // Room for the bundle header and three messages of 40 bytes: the element
+    // size, "/esp/vector", ",ffff" and four floats.
+    OscBundleSender sender(16 + 3 * 40);
+    ASSERT_TRUE(sender.setup("127.0.0.1", kPort));
+
+    vector<double> values(4);
+    for (int i = 0; i < 5; i++) {
+        values[0] = i;
+        sender.add("/esp/vector", values);
+    }
+    ASSERT_EQ(1, sender.getNumBundlesSent());
+    sender.flush();
+    ASSERT_EQ(2, sender.getNumBundlesSent());
+
+    Bundle first = receive(), second = receive();
+    ASSERT_EQ(3, first.messages.size());
+    ASSERT_EQ(2, second.messages.size());
+    ASSERT_EQ(4, second.messages[1].values[0]);
+    ASSERT_EQ(0, sender.getNumMessagesDropped());
+}
+
+TEST_F(OscBundleSenderTest, DropsOversizedMessages) {
+    OscBundleSender sender(64);
+    ASSERT_TRUE(sender.setup("127.0.0.1", kPort));
+    sender.add("/esp/vector", vector<double>(100));
+    ASSERT_EQ(1, sender.getNumMessagesDropped());
+    sender.add("/esp/label", 1);
+    sender.flush();
+    ASSERT_EQ(1, receive().messages.size());
+}
+
+TEST_F(OscBundleSenderTest, WithoutSetup) {
+    OscBundleSender sender;
+    sender.add("/esp/label", 1);
+    ASSERT_FALSE(sender.flush());
+    ASSERT_FALSE(sender.setup("no.such.host.invalid", kPort));
+    ASSERT_FALSE(sender.isSetup());
+}
@@ -0,0 +1,95 @@
+#include "osc-bundle-sender.h"
+
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+
+#include "ip/UdpSocket.h"
+#include "osc/OscOutboundPacketStream.h"
+
+// "#bundle" and the time tag.
+static const size_t kBundleHeaderSize = 16;
+
+static size_t roundUp4(size_t size) { return (size + 3) & ~((size_t) 3); }
+
+OscBundleSender::OscBundleSender(size_t capacity)
+        : buffer_(capacity),
+          packet_(new osc::OutboundPacketStream(buffer_.data(),
+                                                buffer_.size())) {
+}
+
+// Out of line, where the oscpack types are complete.
+OscBundleSender::~OscBundleSender() = default;
+
+bool OscBundleSender::setup(const string& host, int port) {
+    socket_.reset();
+    IpEndpointName endpoint(host.c_str(), port);
+    if (endpoint.address == 0) return false;  // the lookup failed
+    try {
+        socket_.reset(new UdpTransmitSocket(endpoint));
+    } catch (const std::exception&) {
+        return false;
+    }
+    return true;
+}
+
+uint64_t OscBundleSender::getTimeTag() {
+    // Seconds from 1900 (NTP's epoch) to 1970 (the Unix one).
+    const uint64_t kSecondsFrom1900To1970 = 2208988800ULL;
+    uint64_t us = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    uint64_t seconds = us / 1000000 + kSecondsFrom1900To1970;
+    uint64_t fraction = ((us % 1000000) << 32) / 1000000;
+    return (seconds << 32) | fraction;
+}
+
+bool OscBundleSender::beginMessage(const char* address,
+                                   size_t num_arguments) {
+    // The element size, the address, the type tags (",", one per argument,
+    // and the terminating 0) and the arguments.
+    size_t size = 4 + roundUp4(strlen(address) + 1) +
+                  roundUp4(num_arguments + 2) + 4 * num_arguments;
+    if (kBundleHeaderSize + size > packet_->Capacity()) {
+        num_messages_dropped_++;
+        return false;
+    }
+    if (bundle_open_ && packet_->Size() + size > packet_->Capacity()) {
+        flush();
+    }
+    if (!bundle_open_) {
+        *packet_ << osc::BeginBundle(getTimeTag());
+        bundle_open_ = true;
+    }
+    *packet_ << osc::BeginMessage(address);
+    return true;
+}
+
+void OscBundleSender::add(const char* address, int32_t value) {
+    if (!beginMessage(address, 1)) return;
+    *packet_ << (osc::int32) value << osc::EndMessage;
+}
+
+void OscBundleSender::add(const char* address, const vector<double>& values) {
+    if (!beginMessage(address, values.size())) return;
+    for (double v : values) *packet_ << (float) v;
+    *packet_ << osc::EndMessage;
+}
+
+bool OscBundleSender::flush() {
+    if (!bundle_open_) return true;
+    *packet_ << osc::EndBundle;
+    bundle_open_ = false;
+
+    bool sent = false;
+    if (socket_ != nullptr) {
+        try {
+            socket_->Send(packet_->Data(), packet_->Size());
+            num_bundles_sent_++;
+            sent = true;
+        } catch (const std::exception&) {
+            // The bundle is lost, but the next one may go through.
+        }
+    }
+    packet_->Clear();
+    return sent;
+}
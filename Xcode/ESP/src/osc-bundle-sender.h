@@ -0,0 +1,76 @@
+/** @file osc-bundle-sender.h
+ *  @brief OscBundleSender packs OSC messages into time-tagged bundles and
+ *  sends them over UDP.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+using std::string;
+using std::vector;
+
+// Forward declarations (oscpack).
+namespace osc { class OutboundPacketStream; }
+class UdpTransmitSocket;
+
+/**
+ *  @brief OscBundleSender collects the OSC messages produced during one frame
+ *  into a bundle, time-tagged with when the first of them was added, and
+ *  sends the bundle as one UDP datagram on flush().
+ *
+ *  Messages are packed with oscpack straight into a buffer that's allocated
+ *  once, in the constructor, so adding and sending them doesn't allocate
+ *  memory. If a message doesn't fit in what's left of the buffer, the bundle
+ *  so far is sent first; a message that doesn't fit in an empty bundle is
+ *  dropped.
+ *
+ *  Integers are sent as int32 arguments, and vectors as float32 arguments
+ *  (which is what OscInputStream reads).
+ */
+class OscBundleSender {
+  public:
+    /// Comfortably below the size of a UDP datagram.
+    static const size_t kDefaultCapacity = 4096;
+
+    explicit OscBundleSender(size_t capacity = kDefaultCapacity);
+    ~OscBundleSender();
+
+    /// @brief Send to `port` on `host` (a name or an IP address). Returns
+    /// false if the host can't be resolved or the socket can't be opened.
+    bool setup(const string& host, int port);
+    bool isSetup() const { return socket_ != nullptr; }
+
+    /// @brief Add a message with one int32 argument to the bundle.
+    void add(const char* address, int32_t value);
+    /// @brief Add a message with one float32 argument per value.
+    void add(const char* address, const vector<double>& values);
+
+    /// @brief Send the bundle, if it isn't empty. Returns false if it
+    /// couldn't be sent (e.g. setup() wasn't called or failed); the bundle
+    /// is dropped either way.
+    bool flush();
+
+    uint32_t getNumBundlesSent() const { return num_bundles_sent_; }
+    uint32_t getNumMessagesDropped() const { return num_messages_dropped_; }
+
+    /// @brief The current time as an OSC (NTP) time tag: seconds since 1900
+    /// in the upper 32 bits, and fractions of a second in the lower 32.
+    static uint64_t getTimeTag();
+
+  private:
+    // Make room for, and begin, a message of `num_arguments` 4-byte
+    // arguments, opening a bundle first if needed. False if it can't fit.
+    bool beginMessage(const char* address, size_t num_arguments);
+
+    vector<char> buffer_;
+    std::unique_ptr<osc::OutboundPacketStream> packet_;
+    std::unique_ptr<UdpTransmitSocket> socket_;
+    bool bundle_open_ = false;
+
+    uint32_t num_bundles_sent_ = 0;
+    uint32_t num_messages_dropped_ = 0;
+};
@@ -9,9 +9,10 @@
 #include <Windows.h>
 #endif
 
-#include <thread>
 #include "ofxTCPClient.h"
 
+#include <memory>
+
 #if __APPLE__
 #include <ApplicationServices/ApplicationServices.h>
 #endif
@@ -111,26 +112,91 @@ void MacOSMouseOStream::doubleClick(pair<uint32_t, uint32_t> mouse, int clickCou
 
 bool TcpOStream::start() {
     if (client_ == nullptr) {
-        client_ = new ofxTCPClient();
+        client_ = std::make_shared<ofxTCPClient>();
     }
     has_started_ = client_->setup(server_, port_);
     return has_started_;
 }
 
+void TcpOStream::stop() {
+    has_started_ = false;
+    IoReactor::Handle timer;
+    {
+        std::lock_guard<std::mutex> lock(retry_mutex_);
+        timer = retry_timer_;
+        retry_timer_ = IoReactor::kInvalidHandle;
+        // An attempt that is still connecting is dropped.
+        retry_token_.cancel();
+        retry_token_ = TaskScheduler::CancellationToken();
+        is_retry_pending_ = false;
+    }
+    IoReactor::instance().remove(timer);
+}
+
 void TcpOStream::sendString(const string& tosend) {
-    if (client_ != nullptr && client_->isConnected()) {
+    if (client_ == nullptr) return;
+    if (client_->isConnected()) {
         client_->sendRaw(tosend);
+        return;
     }
 
-    // If not connected, we start a new thread that tries to connect
-    if (!client_->isConnected() && !is_in_retry_) {
-        is_in_retry_ = true;
-        auto t = std::thread([this] () {
-            while (!this->client_->setup(server_, port_)) {
-                std::this_thread::sleep_for(std::chrono::seconds(1));
+    // If not connected, retry once a second until it works.
+    std::lock_guard<std::mutex> lock(retry_mutex_);
+    if (retry_timer_ == IoReactor::kInvalidHandle) {
+        retry_timer_ = IoReactor::instance().addTimer(
+            1000, [this]() { retryConnection(); });
+    }
+}
+
+void TcpOStream::retryConnection() {
+    // Connecting blocks until the server answers or ofxTCPClient's connect
+    // times out, which would hold up every stream on the reactor. So each
+    // attempt connects a new client on a worker, and one that connects is
+    // handed over to the main thread, which sends with client_.
+    TaskScheduler::CancellationToken token;
+    {
+        std::lock_guard<std::mutex> lock(retry_mutex_);
+        if (is_retry_pending_) return;
+        is_retry_pending_ = true;
+        token = retry_token_;
+    }
+
+    TaskScheduler::instance().submit(TaskScheduler::kNormal, [this, token] {
+        auto client = std::make_shared<ofxTCPClient>();
+        if (!client->setup(server_, port_)) client = nullptr;
+
+        TaskScheduler::instance().runOnMainThread([this, token, client] {
+            if (token.isCancelled()) return;
+            IoReactor::Handle timer = IoReactor::kInvalidHandle;
+            {
+                std::lock_guard<std::mutex> lock(retry_mutex_);
+                is_retry_pending_ = false;
+                if (client == nullptr) return;
+                timer = retry_timer_;
+                retry_timer_ = IoReactor::kInvalidHandle;
             }
-            is_in_retry_ = false;
+            IoReactor::instance().remove(timer);
+            client_ = client;
         });
-        t.detach();
-    }
+    }, token);
+}
+
+bool OscOStream::start() {
+    has_started_ = sender_.setup(host_, port_);
+    return has_started_;
+}
+
+void OscOStream::stop() {
+    has_started_ = false;
+    sender_.flush();
+}
+
+bool OscOStreamVector::start() {
+    has_started_ = sender_.setup(host_, port_);
+    return has_started_;
+}
+
+void OscOStreamVector::stop() {
+    has_started_ = false;
+    sender_.flush();
 }
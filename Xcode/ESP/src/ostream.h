@@ -8,6 +8,8 @@
  * MacOSMouseOStream ostream(3, 0, 0, 240, 240, 400, 400);
  * TcpOStream ostream("localhost", 9999, 3, "", "mouse 300, 300.", "mouse 400, 400.");
  * TcpOStream ostream("localhost", 5204, 3, "l", "r", " ");
+ * OscOStream ostream("localhost", 9000);
+ * TcpPredictionOStream ostream("localhost", 5205);
  * @endverbatim
  *
  */
@@ -22,7 +24,11 @@
 #include <string.h>
 
 #include "ofMain.h"
+#include "io-reactor.h"
+#include "osc-bundle-sender.h"
+#include "prediction-record.h"
 #include "stream.h"
+#include "task-scheduler.h"
 
 const uint64_t kGracePeriod = 500; // 0.5 second
 
@@ -43,6 +49,13 @@ class ofxTCPClient;
 class OStream : public virtual Stream {
   public:
     virtual void onReceive(uint32_t label) = 0;
+
+    // Called with the likelihood of each class after every prediction.
+    virtual void onReceiveLikelihoods(const vector<double>& likelihoods) {}
+
+    // Called once per frame, after all of the frame's results have been
+    // passed on. Streams that batch their output send it here.
+    virtual void flush() {}
 };
 
 /**
@@ -62,6 +75,26 @@ class OStreamVector : public OStream {
     virtual void onReceive(vector<double>) = 0;
 };
 
+/**
+ @brief Base class for output streams that forward a PredictionRecord for
+ every sample a classifier pipeline predicts.
+
+ Unlike an OStream, which only gets the predicted labels, a PredictionOStream
+ also gets the likelihoods, distances and null rejection state behind them,
+ so that downstream consumers can gate on confidence themselves.
+
+ To use a PredictionOStream instance in your application, pass it to
+ useOutputStream() in your setup() function.
+ */
+class PredictionOStream : public virtual Stream {
+  public:
+    virtual void onReceive(const PredictionRecord& record) = 0;
+
+    // Called once per frame, after all of the frame's records have been
+    // passed on. Streams that batch their output send it here.
+    virtual void flush() {}
+};
+
 /**
  @brief Emulate keyboard key presses corresponding to prediction results.
 
@@ -218,9 +251,10 @@ private:
  @brief Send strings over a TCP socket based on pipeline predictions.
 
  This class connects to a TCP server and sends it strings when predictions are
- made by the current machine learning pipeline.  The TCP connection is only
- made once, when ESP first starts, and is not restored if the other side
- disconnects.
+ made by the current machine learning pipeline. If the connection is lost, it
+ is retried every second until it succeeds; strings sent in the meantime are
+ dropped. Each attempt runs on a TaskScheduler worker, so a server that
+ doesn't answer doesn't hold up the input streams.
 
  To use an TcpOStream instance in your application, pass it to
  useOutputStream() in your setup() function.
@@ -237,7 +271,7 @@ class TcpOStream : public OStreamVector {
      */
     TcpOStream(string server, int port)
             : server_(server), port_(port),
-              use_tcp_stream_mapping_(false), is_in_retry_(false) {}
+              use_tcp_stream_mapping_(false) {}
 
     /**
      Create a TCPOStream instance.
@@ -254,8 +288,7 @@ class TcpOStream : public OStreamVector {
                std::map<uint32_t, string> tcp_stream_mapping)
             : server_(server), port_(port),
               use_tcp_stream_mapping_(true),
-              tcp_stream_mapping_(tcp_stream_mapping),
-              is_in_retry_(false) {
+              tcp_stream_mapping_(tcp_stream_mapping) {
     }
 
     /**
@@ -271,8 +304,7 @@ class TcpOStream : public OStreamVector {
      in the provided strings.
      */
     TcpOStream(string server, int port, uint32_t count, ...)
-        : server_(server), port_(port), use_tcp_stream_mapping_(true),
-          is_in_retry_(false) {
+        : server_(server), port_(port), use_tcp_stream_mapping_(true) {
         va_list args;
         va_start(args, count);
         for (uint32_t i = 1; i <= count; i++) {
@@ -302,10 +334,15 @@ class TcpOStream : public OStreamVector {
     }
 
     bool start();
+    void stop();
 
-private:
+    // Send `tosend` as is. If the connection is lost, it's dropped and the
+    // connection is retried.
     void sendString(const string& tosend);
 
+private:
+    void retryConnection();
+
     string getStreamString(uint32_t label) {
         if (use_tcp_stream_mapping_) return tcp_stream_mapping_[label];
         else return std::to_string(label) + "\n";
@@ -313,13 +350,162 @@ private:
 
     string server_;
     int port_;
-    ofxTCPClient *client_;
+    // Only used on the main thread. A reconnected client replaces it there.
+    std::shared_ptr<ofxTCPClient> client_;
 
     uint64_t elapsed_time_ = 0;
     std::map<uint32_t, string> tcp_stream_mapping_;
     bool use_tcp_stream_mapping_;
 
-    bool is_in_retry_;
+    std::mutex retry_mutex_;
+    IoReactor::Handle retry_timer_ = IoReactor::kInvalidHandle;
+    bool is_retry_pending_ = false;  // an attempt hasn't reported back yet
+    TaskScheduler::CancellationToken retry_token_;
+};
+
+/**
+ @brief Send OSC messages over UDP based on pipeline predictions.
+
+ Each predicted class label is sent as a message with one int32 argument,
+ and, if an address is given for them, the likelihoods of the classes as a
+ message with one float32 argument per class. The messages of each frame are
+ sent together, in one OSC bundle time-tagged with when they were produced.
+
+ To use an OscOStream instance in your application, pass it to
+ useOutputStream() in your setup() function.
+ */
+class OscOStream : public OStream {
+  public:
+    /**
+     Create an OscOStream instance.
+
+     @param host: the hostname or IP address to send the messages to
+     @param port: the UDP port to send the messages to
+     @param label_address: the OSC address of the predicted class labels
+     @param likelihoods_address: the OSC address of the class likelihoods;
+     empty (the default) not to send them
+     */
+    OscOStream(string host, int port, string label_address = "/esp/label",
+               string likelihoods_address = "")
+            : host_(host), port_(port), label_address_(label_address),
+              likelihoods_address_(likelihoods_address) {}
+
+    virtual void onReceive(uint32_t label) {
+        if (has_started_) sender_.add(label_address_.c_str(), label);
+    }
+
+    virtual void onReceiveLikelihoods(const vector<double>& likelihoods) {
+        if (has_started_ && !likelihoods_address_.empty()) {
+            sender_.add(likelihoods_address_.c_str(), likelihoods);
+        }
+    }
+
+    virtual void flush() { sender_.flush(); }
+
+    bool start();
+    void stop();
+
+  private:
+    string host_;
+    int port_;
+    string label_address_;
+    string likelihoods_address_;
+    OscBundleSender sender_;
+};
+
+/**
+ @brief Send OSC messages over UDP based on pipeline output.
+
+ Like OscOStream, but for signal processing pipelines too: their output is
+ sent as a message with one float32 argument per dimension, which an
+ OscInputStream (in another ESP, say) can read.
+
+ To use an OscOStreamVector instance in your application, pass it to
+ useOutputStream() in your setup() function.
+ */
+class OscOStreamVector : public OStreamVector {
+  public:
+    /**
+     Create an OscOStreamVector instance.
+
+     @param host: the hostname or IP address to send the messages to
+     @param port: the UDP port to send the messages to
+     @param vector_address: the OSC address of the pipeline output
+     @param label_address: the OSC address of the predicted class labels
+     @param likelihoods_address: the OSC address of the class likelihoods;
+     empty (the default) not to send them
+     */
+    OscOStreamVector(string host, int port,
+                     string vector_address = "/esp/vector",
+                     string label_address = "/esp/label",
+                     string likelihoods_address = "")
+            : host_(host), port_(port), vector_address_(vector_address),
+              label_address_(label_address),
+              likelihoods_address_(likelihoods_address) {}
+
+    virtual void onReceive(uint32_t label) {
+        if (has_started_) sender_.add(label_address_.c_str(), label);
+    }
+
+    virtual void onReceive(vector<double> data) {
+        if (has_started_) sender_.add(vector_address_.c_str(), data);
+    }
+
+    virtual void onReceiveLikelihoods(const vector<double>& likelihoods) {
+        if (has_started_ && !likelihoods_address_.empty()) {
+            sender_.add(likelihoods_address_.c_str(), likelihoods);
+        }
+    }
+
+    virtual void flush() { sender_.flush(); }
+
+    bool start();
+    void stop();
+
+  private:
+    string host_;
+    int port_;
+    string vector_address_;
+    string label_address_;
+    string likelihoods_address_;
+    OscBundleSender sender_;
+};
+
+/**
+ @brief Send a PredictionRecord over a TCP socket for every prediction.
+
+ The records are sent in their binary encoding (see PredictionRecord), back
+ to back, with those of each frame in a single write. If the server isn't
+ up yet, or the connection is lost, the connection is retried every second,
+ and records are dropped in the meantime.
+
+ To use a TcpPredictionOStream instance in your application, pass it to
+ useOutputStream() in your setup() function.
+ */
+class TcpPredictionOStream : public PredictionOStream {
+  public:
+    /**
+     @param server: the hostname or IP address of the TCP server to connect to
+     @param port: the port of the TCP server to connect to
+     */
+    TcpPredictionOStream(string server, int port) : tcp_(server, port) {}
+
+    virtual void onReceive(const PredictionRecord& record) {
+        if (has_started_) record.encode(&buffer_);
+    }
+
+    virtual void flush() {
+        if (buffer_.empty()) return;
+        tcp_.sendString(buffer_);
+        buffer_.clear();  // keeps its capacity for the next frame
+    }
+
+    bool start() { has_started_ = true; return tcp_.start(); }
+    void stop() { has_started_ = false; tcp_.stop(); }
+
+  private:
+    TcpOStream tcp_;
+    string buffer_;
 };
 
 #endif
@@ -0,0 +1,166 @@
+#include "parallel-trainer.h"
+#include "gtest/gtest.h"
+
+#include <cmath>
+#include <future>
+#include <random>
+#include <thread>
+
+static const uint32_t kDim = 2;
+
+// Noisy sine waves whose frequency depends on the class.
+static GRT::TimeSeriesClassificationData makeData(uint32_t samples_per_class,
+                                                  uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::normal_distribution<double> noise(0, 0.1);
+    GRT::TimeSeriesClassificationData data(kDim);
+    for (uint32_t i = 0; i < samples_per_class; i++) {
+        for (uint32_t label = 1; label <= 3; label++) {
+            GRT::MatrixDouble sample;
+            for (uint32_t t = 0; t < 40; t++) {
+                GRT::VectorDouble x(kDim);
+                x[0] = std::sin(0.1 * label * t) + noise(rng);
+                x[1] = std::cos(0.1 * label * t) + noise(rng);
+                sample.push_back(x);
+            }
+            data.addSample(label, sample);
+        }
+    }
+    return data;
+}
+
+static void makePipeline(GRT::GestureRecognitionPipeline* pipeline) {
+    pipeline->addPreProcessingModule(GRT::MovingAverageFilter(5, kDim));
+    pipeline->setClassifier(GRT::DTW());
+}
+
+TEST(ParallelTrainerTest, MatchesPipelineTrain) {
+    GRT::TimeSeriesClassificationData training = makeData(6, 1);
+    GRT::TimeSeriesClassificationData test = makeData(3, 2);
+
+    GRT::GestureRecognitionPipeline reference, parallel;
+    makePipeline(&reference);
+    makePipeline(&parallel);
+    ASSERT_TRUE(reference.train(training));
+    ParallelTrainer trainer;
+    ASSERT_TRUE(trainer.train(parallel, training));
+    ASSERT_TRUE(parallel.getTrained());
+    ASSERT_EQ(reference.getInputVectorDimensionsSize(),
+              parallel.getInputVectorDimensionsSize());
+    ASSERT_EQ(reference.getNumClasses(), parallel.getNumClasses());
+
+    for (uint32_t i = 0; i < test.getNumSamples(); i++) {
+        GRT::MatrixDouble sample = test[i].getData();
+        reference.reset();
+        parallel.reset();
+        for (uint32_t r = 0; r < sample.getNumRows(); r++) {
+            ASSERT_EQ(reference.predict(sample.getRowVector(r)),
+                      parallel.predict(sample.getRowVector(r)));
+            ASSERT_EQ(reference.getPredictedClassLabel(),
+                      parallel.getPredictedClassLabel());
+            ASSERT_EQ(reference.getClassLikelihoods(),
+                      parallel.getClassLikelihoods());
+        }
+    }
+}
+
+TEST(ParallelTrainerTest, SkipsSamplesWithoutFeatures) {
+    GRT::TimeSeriesClassificationData training = makeData(4, 5);
+    // Shorter than the feature extraction module's buffer.
+    GRT::MatrixDouble short_sample;
+    for (uint32_t t = 0; t < 10; t++) {
+        short_sample.push_back(GRT::VectorDouble(kDim, 0.5));
+    }
+    training.addSample(1, short_sample);
+
+    GRT::GestureRecognitionPipeline pipeline;
+    pipeline.addFeatureExtractionModule(GRT::TimeDomainFeatures(20, 2, kDim));
+    pipeline.setClassifier(GRT::DTW());
+
+    ParallelTrainer trainer;
+    vector<uint32_t> skipped;
+    ASSERT_TRUE(trainer.train(pipeline, training,
+                              TaskScheduler::CancellationToken(), &skipped));
+    ASSERT_TRUE(pipeline.getTrained());
+    ASSERT_EQ(kDim, pipeline.getInputVectorDimensionsSize());
+    ASSERT_EQ(vector<uint32_t>({ training.getNumSamples() - 1 }), skipped);
+    // Only the samples with features are cached.
+    ASSERT_EQ(training.getNumSamples() - 1, trainer.getNumCachedSamples());
+}
+
+TEST(ParallelTrainerTest, CachesFeatures) {
+    GRT::TimeSeriesClassificationData training = makeData(4, 1);
+    GRT::GestureRecognitionPipeline pipeline;
+    makePipeline(&pipeline);
+
+    ParallelTrainer trainer;
+    ASSERT_EQ(0, trainer.getNumCachedSamples());
+    ASSERT_TRUE(trainer.train(pipeline, training));
+    ASSERT_EQ(training.getNumSamples(), trainer.getNumCachedSamples());
+    uint64_t bytes = trainer.getMemoryUsage();
+    ASSERT_GT(bytes, 0);
+
+    // Retraining on the same samples featurizes nothing new.
+    ASSERT_TRUE(trainer.train(pipeline, training));
+    ASSERT_EQ(bytes, trainer.getMemoryUsage());
+
+    // Samples that are gone are pruned.
+    GRT::TimeSeriesClassificationData fewer = training;
+    fewer.removeSample(0);
+    trainer.prune(fewer);
+    ASSERT_EQ(fewer.getNumSamples(), trainer.getNumCachedSamples());
+    ASSERT_LT(trainer.getMemoryUsage(), bytes);
+
+    trainer.clear();
+    ASSERT_EQ(0, trainer.getNumCachedSamples());
+    ASSERT_EQ(0, trainer.getMemoryUsage());
+}
+
+TEST(ParallelTrainerTest, CancelledTrainingFails) {
+    GRT::TimeSeriesClassificationData training = makeData(4, 1);
+    GRT::GestureRecognitionPipeline pipeline;
+    makePipeline(&pipeline);
+
+    ParallelTrainer trainer;
+    TaskScheduler::CancellationToken token;
+    token.cancel();
+    ASSERT_FALSE(trainer.train(pipeline, training, token));
+    ASSERT_FALSE(pipeline.getTrained());
+    ASSERT_EQ(0, trainer.getNumCachedSamples());
+}
+
+TEST(ParallelTrainerTest, ClearDuringTrainingDropsItsFeatures) {
+    GRT::TimeSeriesClassificationData training = makeData(4, 1);
+    GRT::GestureRecognitionPipeline pipeline;
+    makePipeline(&pipeline);
+    ParallelTrainer trainer;
+
+    // Occupy every worker, so that training's tasks stay queued.
+    TaskScheduler& scheduler = TaskScheduler::instance();
+    std::promise<void> release;
+    std::shared_future<void> released = release.get_future().share();
+    vector<TaskScheduler::TaskHandle> blockers;
+    for (uint32_t i = 0; i < scheduler.getNumThreads(); i++) {
+        blockers.push_back(scheduler.submit(
+            TaskScheduler::kInteractive, [released] { released.wait(); }));
+    }
+    while (scheduler.getNumQueuedTasks() > 0) std::this_thread::yield();
+
+    bool trained = false;
+    std::thread thread([&] { trained = trainer.train(pipeline, training); });
+    // Once its tasks are queued, training has read the cache.
+    while (scheduler.getNumQueuedTasks() == 0) std::this_thread::yield();
+    trainer.clear();
+    release.set_value();
+    thread.join();
+    for (const TaskScheduler::TaskHandle& blocker : blockers) blocker.wait();
+
+    // The pipeline is trained, but its features aren't cached.
+    ASSERT_TRUE(trained);
+    ASSERT_TRUE(pipeline.getTrained());
+    ASSERT_EQ(0, trainer.getNumCachedSamples());
+    ASSERT_EQ(0, trainer.getMemoryUsage());
+
+    ASSERT_TRUE(trainer.train(pipeline, training));
+    ASSERT_EQ(training.getNumSamples(), trainer.getNumCachedSamples());
+}
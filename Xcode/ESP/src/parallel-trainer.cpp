@@ -0,0 +1,250 @@
+#include "parallel-trainer.h"
+
+#include <algorithm>
+#include <memory>
+#include <set>
+
+// Samples per featurization task. Each task copies the front end once.
+static const uint32_t kSamplesPerTask = 4;
+
+// A pipeline holding copies of `pipeline`'s pre-processing and feature
+// extraction modules only; copying the classifier would be wasted.
+static std::unique_ptr<GRT::GestureRecognitionPipeline> copyFrontEnd(
+        GRT::GestureRecognitionPipeline& pipeline) {
+    std::unique_ptr<GRT::GestureRecognitionPipeline> front_end(
+        new GRT::GestureRecognitionPipeline());
+    for (uint32_t i = 0; i < pipeline.getNumPreProcessingModules(); i++) {
+        front_end->addPreProcessingModule(*pipeline.getPreProcessingModule(i));
+    }
+    for (uint32_t i = 0; i < pipeline.getNumFeatureExtractionModules(); i++) {
+        front_end->addFeatureExtractionModule(
+            *pipeline.getFeatureExtractionModule(i));
+    }
+    return front_end;
+}
+
+// Run `sample` through the modules of `front_end` row by row, exactly as
+// GestureRecognitionPipeline::train() does: the modules are reset first, and
+// a row for which a feature extraction module has no data ready yet goes no
+// further and yields no features.
+static bool featurize(GRT::GestureRecognitionPipeline& front_end,
+                      const GRT::MatrixDouble& sample,
+                      GRT::MatrixDouble* features) {
+    const uint32_t num_pre = front_end.getNumPreProcessingModules();
+    const uint32_t num_feature = front_end.getNumFeatureExtractionModules();
+    for (uint32_t k = 0; k < num_pre; k++) {
+        front_end.getPreProcessingModule(k)->reset();
+    }
+    for (uint32_t k = 0; k < num_feature; k++) {
+        front_end.getFeatureExtractionModule(k)->reset();
+    }
+
+    features->clear();
+    for (uint32_t r = 0; r < sample.getNumRows(); r++) {
+        GRT::VectorDouble row = sample.getRowVector(r);
+        for (uint32_t k = 0; k < num_pre; k++) {
+            GRT::PreProcessing* module = front_end.getPreProcessingModule(k);
+            if (!module->process(row)) return false;
+            row = module->getProcessedData();
+        }
+        bool ready = true;
+        for (uint32_t k = 0; k < num_feature && ready; k++) {
+            GRT::FeatureExtraction* module =
+                front_end.getFeatureExtractionModule(k);
+            if (!module->computeFeatures(row)) return false;
+            ready = module->getFeatureDataReady();
+            row = module->getFeatureVector();
+        }
+        if (ready) features->push_back(row);
+    }
+    return true;
+}
+
+uint64_t ParallelTrainer::hash(const GRT::MatrixDouble& sample) {
+    // 64-bit FNV-1a over the shape and the bytes of every value.
+    uint64_t h = 14695981039346656037ULL;
+    auto mix = [&h](const void* bytes, size_t size) {
+        const unsigned char* p = static_cast<const unsigned char*>(bytes);
+        for (size_t i = 0; i < size; i++) {
+            h = (h ^ p[i]) * 1099511628211ULL;
+        }
+    };
+    const uint32_t rows = sample.getNumRows(), cols = sample.getNumCols();
+    mix(&rows, sizeof(rows));
+    mix(&cols, sizeof(cols));
+    for (uint32_t r = 0; r < rows; r++) mix(sample[r], cols * sizeof(double));
+    return h;
+}
+
+bool ParallelTrainer::train(GRT::GestureRecognitionPipeline& pipeline,
+                            const GRT::TimeSeriesClassificationData& data,
+                            TaskScheduler::CancellationToken token,
+                            vector<uint32_t>* skipped_samples) {
+    // Without a front end, or a classifier, there's nothing to gain.
+    GRT::Classifier* classifier = pipeline.getClassifier();
+    if (classifier == nullptr ||
+        (pipeline.getNumPreProcessingModules() == 0 &&
+         pipeline.getNumFeatureExtractionModules() == 0)) {
+        return pipeline.train(data);
+    }
+
+    auto samples = data.getData();
+    const uint32_t num_samples = samples.size();
+
+    // 1. Take what we can from the cache.
+    vector<uint64_t> keys(num_samples);
+    vector<Features> features(num_samples);
+    vector<uint32_t> missing;
+    uint64_t generation;
+    for (uint32_t i = 0; i < num_samples; i++) {
+        keys[i] = hash(samples[i].getData());
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        generation = generation_;
+        for (uint32_t i = 0; i < num_samples; i++) {
+            auto it = cache_.find(keys[i]);
+            if (it != cache_.end()) {
+                features[i] = it->second;
+            } else {
+                missing.push_back(i);
+            }
+        }
+    }
+
+    // 2. Featurize the rest in parallel, a few samples per task. The front
+    // ends are copied here, since copying modules isn't guaranteed to be
+    // thread-safe. A sample that a module fails on (which the module logs)
+    // is left without features.
+    vector<TaskScheduler::TaskHandle> tasks;
+    for (uint32_t first = 0; first < missing.size(); first += kSamplesPerTask) {
+        uint32_t last = std::min<uint32_t>(first + kSamplesPerTask,
+                                           missing.size());
+        std::shared_ptr<GRT::GestureRecognitionPipeline> front_end(
+            copyFrontEnd(pipeline));
+        tasks.push_back(TaskScheduler::instance().submit(
+            TaskScheduler::kNormal,
+            [&, first, last, front_end] {
+                for (uint32_t m = first; m < last; m++) {
+                    if (token.isCancelled()) return;
+                    uint32_t i = missing[m];
+                    if (!featurize(*front_end, samples[i].getData(),
+                                   &features[i])) {
+                        features[i].clear();
+                    }
+                }
+            }, token));
+    }
+    for (const TaskScheduler::TaskHandle& task : tasks) task.wait();
+    if (token.isCancelled()) return false;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        // If the cache was cleared meanwhile, these features may come from
+        // a front end that's since changed.
+        for (uint32_t i : missing) {
+            if (generation != generation_) break;
+            if (features[i].getNumRows() == 0) continue;
+            auto inserted = cache_.insert(std::make_pair(keys[i], features[i]));
+            if (inserted.second) {
+                cache_bytes_ += (uint64_t) features[i].getNumRows() *
+                                features[i].getNumCols() * sizeof(double);
+            }
+        }
+    }
+
+    // Samples without features, e.g. shorter than a feature extraction
+    // module's window, are left out rather than failing the training.
+    vector<uint32_t> usable;
+    for (uint32_t i = 0; i < num_samples; i++) {
+        if (features[i].getNumRows() > 0) {
+            usable.push_back(i);
+        } else if (skipped_samples != nullptr) {
+            skipped_samples->push_back(i);
+        }
+    }
+    if (usable.empty()) return false;
+
+    // 3. Train a copy of the classifier on the features, in the form it
+    // expects.
+    const uint32_t num_dimensions = features[usable[0]].getNumCols();
+    std::unique_ptr<GRT::Classifier> trained(classifier->createNewInstance());
+    if (trained == nullptr || !trained->deepCopyFrom(classifier)) return false;
+    if (classifier->getTimeseriesCompatible()) {
+        GRT::TimeSeriesClassificationData featurized(num_dimensions);
+        featurized.setAllowNullGestureClass(true);
+        for (uint32_t i : usable) {
+            featurized.addSample(samples[i].getClassLabel(), features[i]);
+        }
+        if (!trained->train(featurized)) return false;
+    } else {
+        GRT::ClassificationData featurized(num_dimensions);
+        featurized.setAllowNullGestureClass(true);
+        for (uint32_t i : usable) {
+            for (uint32_t r = 0; r < features[i].getNumRows(); r++) {
+                featurized.addSample(samples[i].getClassLabel(),
+                                     features[i].getRowVector(r));
+            }
+        }
+        if (!trained->train(featurized)) return false;
+    }
+
+    // 4. GRT only marks a pipeline as trained, for the dimensions of its
+    // input, in GestureRecognitionPipeline::train(). So the pipeline is
+    // trained through GRT on the first usable sample of each class, which is
+    // cheap, and its classifier then takes the model trained on all of them.
+    // Classifiers that can't be trained on so little are trained by GRT on
+    // all the usable samples instead.
+    GRT::TimeSeriesClassificationData seed(data.getNumDimensions());
+    GRT::TimeSeriesClassificationData all(data.getNumDimensions());
+    seed.setAllowNullGestureClass(true);
+    all.setAllowNullGestureClass(true);
+    std::set<uint32_t> seeded;
+    for (uint32_t i : usable) {
+        if (seeded.insert(samples[i].getClassLabel()).second) {
+            seed.addSample(samples[i].getClassLabel(), samples[i].getData());
+        }
+        all.addSample(samples[i].getClassLabel(), samples[i].getData());
+    }
+    if (!pipeline.train(seed)) return pipeline.train(all);
+    if (!pipeline.getClassifier()->deepCopyFrom(trained.get())) {
+        pipeline.clearModel();
+        return false;
+    }
+    pipeline.reset();
+    return true;
+}
+
+void ParallelTrainer::prune(const GRT::TimeSeriesClassificationData& data) {
+    auto samples = data.getData();
+    std::set<uint64_t> keep;
+    for (auto& sample : samples) keep.insert(hash(sample.getData()));
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto it = cache_.begin(); it != cache_.end();) {
+        if (keep.count(it->first) == 0) {
+            cache_bytes_ -= (uint64_t) it->second.getNumRows() *
+                            it->second.getNumCols() * sizeof(double);
+            it = cache_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void ParallelTrainer::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    cache_.clear();
+    cache_bytes_ = 0;
+    generation_++;
+}
+
+uint32_t ParallelTrainer::getNumCachedSamples() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return cache_.size();
+}
+
+uint64_t ParallelTrainer::getMemoryUsage() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return cache_bytes_;
+}
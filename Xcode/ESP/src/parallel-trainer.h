@@ -0,0 +1,87 @@
+/** @file parallel-trainer.h
+ *  @brief ParallelTrainer trains a pipeline with the pre-processing and
+ *  feature extraction of the training samples spread over the TaskScheduler
+ *  and cached between trainings.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <vector>
+
+#include <GRT/GRT.h>
+
+#include "task-scheduler.h"
+
+using std::vector;
+
+/**
+ *  @brief ParallelTrainer::train() is a drop-in replacement for
+ *  GRT::GestureRecognitionPipeline::train() on time series data.
+ *
+ *  GRT runs every sample through the pre-processing and feature extraction
+ *  modules one after the other, inside train(), before it fits the
+ *  classifier. For FFT, MFCC or wide Touche pipelines that takes most of the
+ *  training time. Since the modules are reset before each sample, samples
+ *  can be featurized independently: ParallelTrainer does so in tasks on the
+ *  TaskScheduler, each with its own copy of the pipeline's front end (its
+ *  pre-processing and feature extraction modules), and then trains only the
+ *  classifier on the features. The resulting pipeline is the same as the
+ *  one GRT would have trained, except that samples without any features
+ *  (e.g. shorter than a feature extraction module's window) are skipped
+ *  instead of failing the training.
+ *
+ *  The features of each sample are cached, keyed by a hash of the sample's
+ *  data, so retraining (and leave-one-out scoring, which trains once per
+ *  sample) only featurizes new samples. The cache must be cleared whenever
+ *  the front end changes, e.g. when the pipeline is reloaded or a tuneable
+ *  that a FeatureApply function reads changes.
+ *
+ *  train() may be called from several threads at once.
+ */
+class ParallelTrainer {
+  public:
+    ParallelTrainer() {}
+
+    /// @brief Train `pipeline` on `data`, as pipeline.train(data) would.
+    /// Gives up, returning false, if `token` is cancelled. The indices (into
+    /// `data`) of samples that yielded no features are appended to
+    /// `skipped_samples`, if given.
+    bool train(GRT::GestureRecognitionPipeline& pipeline,
+               const GRT::TimeSeriesClassificationData& data,
+               TaskScheduler::CancellationToken token =
+                   TaskScheduler::CancellationToken(),
+               vector<uint32_t>* skipped_samples = nullptr);
+
+    /// @brief Drop the cached features of samples that aren't in `data`.
+    void prune(const GRT::TimeSeriesClassificationData& data);
+
+    /// @brief Forget all cached features. A training already under way
+    /// finishes, but doesn't cache the features it computes: they may come
+    /// from the old front end.
+    void clear();
+
+    uint32_t getNumCachedSamples() const;
+
+    /// @brief Bytes held by the cached features.
+    uint64_t getMemoryUsage() const;
+
+  private:
+    // The front end's output for each row of a sample, leaving out rows
+    // for which a feature extraction module had no data ready yet.
+    typedef GRT::MatrixDouble Features;
+
+    static uint64_t hash(const GRT::MatrixDouble& sample);
+
+    mutable std::mutex mutex_;
+    std::map<uint64_t, Features> cache_;
+    uint64_t cache_bytes_ = 0;
+    // Bumped by clear(). train() only caches features if it's unchanged
+    // since train() read the cache.
+    uint64_t generation_ = 0;
+
+    ParallelTrainer(ParallelTrainer&) = delete;
+    void operator=(ParallelTrainer) = delete;
+};
@@ -0,0 +1,164 @@
+#include "parameter-store.h"
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+TEST(ParameterStoreTest, ValuesReachVariablesOnApply) {
+    int i = 3;
+    double d = 0.5;
+    bool b = false;
+    ParameterStore store;
+    ParameterStore::Id id_i = store.add(&i);
+    ParameterStore::Id id_d = store.add(&d);
+    ParameterStore::Id id_b = store.add(&b);
+    ASSERT_EQ(3, store.size());
+    ASSERT_EQ(3, store.get(id_i));
+
+    // Nothing changes before both publish() and apply().
+    ASSERT_FALSE(store.publish());
+    ASSERT_FALSE(store.apply());
+    store.set(id_i, 6.7);
+    store.set(id_d, 0.25);
+    store.set(id_b, 1);
+    ASSERT_EQ(7, store.get(id_i));
+    ASSERT_FALSE(store.apply());
+    ASSERT_EQ(3, i);
+    ASSERT_TRUE(store.publish());
+    ASSERT_EQ(3, i);
+    ASSERT_TRUE(store.apply());
+    ASSERT_EQ(7, i);
+    ASSERT_EQ(0.25, d);
+    ASSERT_TRUE(b);
+
+    // Changes are batched until the next publish(), and only the newest
+    // snapshot is applied.
+    store.set(id_i, 1);
+    store.set(id_i, 2);
+    ASSERT_TRUE(store.publish());
+    store.set(id_i, 4);
+    ASSERT_TRUE(store.publish());
+    ASSERT_TRUE(store.apply());
+    ASSERT_EQ(4, i);
+    ASSERT_FALSE(store.apply());
+
+    // Setting the same value again isn't a change.
+    store.set(id_i, 4);
+    ASSERT_FALSE(store.publish());
+}
+
+TEST(ParameterStoreTest, ReaderSeesConsistentSnapshots) {
+    // The writer keeps a == b in every snapshot; the reader must never see
+    // them differ, or go backwards.
+    int a = 0, b = 0;
+    ParameterStore store;
+    ParameterStore::Id id_a = store.add(&a);
+    ParameterStore::Id id_b = store.add(&b);
+
+    const int kLast = 20000;
+    std::atomic<bool> consistent(true);
+    std::thread reader([&] {
+        int last = 0;
+        while (last < kLast) {
+            if (!store.apply()) continue;
+            if (a != b || a < last) consistent = false;
+            last = a;
+        }
+    });
+    for (int v = 1; v <= kLast; v++) {
+        store.set(id_a, v);
+        store.set(id_b, v);
+        store.publish();
+    }
+    reader.join();
+    ASSERT_TRUE(consistent);
+    ASSERT_EQ(kLast, a);
+}
+
+TEST(ParameterStoreTest, LeasesDeferApply) {
+    int a = 0;
+    ParameterStore store;
+    ParameterStore::Id id_a = store.add(&a);
+
+    ParameterStore::Lease lease = store.lease();
+    {
+        ParameterStore::Lease copy = lease;
+        ASSERT_EQ(2, store.getNumLeases());
+    }
+    ASSERT_EQ(1, store.getNumLeases());
+
+    store.set(id_a, 1);
+    ASSERT_TRUE(store.publish());
+    ASSERT_FALSE(store.apply());
+    ASSERT_TRUE(store.hasUnapplied());
+    ASSERT_EQ(0, a);
+}
+
+TEST(ParameterStoreTest, WaitForLeasesReturnsOnceReleased) {
+    int a = 0;
+    ParameterStore store;
+    ParameterStore::Id id_a = store.add(&a);
+
+    // The worker's copy of the lease goes when the worker is done.
+    std::atomic<bool> done(false);
+    std::thread worker;
+    {
+        ParameterStore::Lease lease = store.lease();
+        worker = std::thread([lease, &done] {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            done = true;
+        });
+    }
+
+    store.set(id_a, 1);
+    ASSERT_TRUE(store.publish());
+    store.waitForLeases();
+    ASSERT_TRUE(done);
+    ASSERT_EQ(0, store.getNumLeases());
+    ASSERT_TRUE(store.apply());
+    ASSERT_EQ(1, a);
+    worker.join();
+}
+
+TEST(ParameterStoreTest, WorkersWithLeasesSeeFixedValues) {
+    // Workers read the variables, as FeatureApply functions in pipeline
+    // copies do, while the GUI thread keeps changing them. A worker must see
+    // the same values from start to finish.
+    int a = 0;
+    double b = 0;
+    ParameterStore store;
+    ParameterStore::Id id_a = store.add(&a);
+    ParameterStore::Id id_b = store.add(&b);
+
+    const int kNumTasks = 200;
+    std::atomic<bool> consistent(true);
+    int num_applied = 0;
+    for (int task = 0; task < kNumTasks; task++) {
+        // Each frame: stage and publish a change, apply it if no worker is
+        // running, and start a worker.
+        store.set(id_a, task + 1);
+        store.set(id_b, task + 1);
+        store.publish();
+        if (store.apply()) num_applied++;
+
+        ParameterStore::Lease lease = store.lease();
+        std::thread worker([&consistent, &a, &b, lease] {
+            int first = a;
+            for (int i = 0; i < 1000; i++) {
+                if (a != first || b != first) consistent = false;
+            }
+        });
+        // More frames while the worker runs; none of them may apply.
+        for (int frame = 0; frame < 10; frame++) {
+            store.set(id_a, -frame);
+            store.set(id_b, -frame);
+            store.publish();
+            if (store.apply()) consistent = false;
+        }
+        worker.join();
+    }
+    ASSERT_TRUE(consistent);
+    ASSERT_EQ(kNumTasks, num_applied);
+    ASSERT_EQ(0, store.getNumLeases());
+}
@@ -0,0 +1,94 @@
+#include "parameter-store.h"
+
+#include <cmath>
+
+const uint32_t ParameterStore::kFresh;
+
+ParameterStore::ParameterStore()
+        : dirty_(false), write_index_(0), published_(1), read_index_(2),
+          num_leases_(0) {
+}
+
+ParameterStore::Id ParameterStore::add(int* variable) {
+    return add(kInt, variable, *variable);
+}
+
+ParameterStore::Id ParameterStore::add(double* variable) {
+    return add(kDouble, variable, *variable);
+}
+
+ParameterStore::Id ParameterStore::add(bool* variable) {
+    return add(kBool, variable, *variable ? 1.0 : 0.0);
+}
+
+ParameterStore::Id ParameterStore::add(Type type, void* address,
+                                       double value) {
+    variables_.push_back({ type, address });
+    staged_.push_back(value);
+    for (vector<double>& buffer : buffers_) buffer.push_back(value);
+    return variables_.size() - 1;
+}
+
+void ParameterStore::set(Id id, double value) {
+    if (id >= variables_.size()) return;
+    switch (variables_[id].type) {
+      case kInt: value = std::round(value); break;
+      case kBool: value = value != 0.0 ? 1.0 : 0.0; break;
+      default: break;
+    }
+    if (staged_[id] != value) {
+        staged_[id] = value;
+        dirty_ = true;
+    }
+}
+
+bool ParameterStore::publish() {
+    if (!dirty_) return false;
+    buffers_[write_index_] = staged_;  // same size, so no allocation
+    write_index_ = published_.exchange(write_index_ | kFresh,
+                                       std::memory_order_acq_rel) & ~kFresh;
+    dirty_ = false;
+    return true;
+}
+
+bool ParameterStore::apply() {
+    if (!hasUnapplied()) return false;
+
+    // Other threads are reading the variables; leave the snapshot for later.
+    std::lock_guard<std::mutex> lock(lease_mutex_);
+    if (num_leases_ > 0) return false;
+
+    read_index_ = published_.exchange(read_index_,
+                                      std::memory_order_acq_rel) & ~kFresh;
+
+    const vector<double>& values = buffers_[read_index_];
+    for (Id id = 0; id < variables_.size(); id++) {
+        void* address = variables_[id].address;
+        switch (variables_[id].type) {
+          case kInt: *static_cast<int*>(address) = (int) values[id]; break;
+          case kDouble: *static_cast<double*>(address) = values[id]; break;
+          case kBool: *static_cast<bool*>(address) = values[id] != 0.0; break;
+        }
+    }
+    return true;
+}
+
+ParameterStore::Lease::Lease(ParameterStore* store) : store_(store) {
+    std::lock_guard<std::mutex> lock(store_->lease_mutex_);
+    store_->num_leases_++;
+}
+
+ParameterStore::Lease::~Lease() {
+    std::lock_guard<std::mutex> lock(store_->lease_mutex_);
+    if (--store_->num_leases_ == 0) store_->leases_released_.notify_all();
+}
+
+uint32_t ParameterStore::getNumLeases() const {
+    std::lock_guard<std::mutex> lock(lease_mutex_);
+    return num_leases_;
+}
+
+void ParameterStore::waitForLeases() {
+    std::unique_lock<std::mutex> lock(lease_mutex_);
+    leases_released_.wait(lock, [this] { return num_leases_ == 0; });
+}
@@ -0,0 +1,139 @@
+/** @file parameter-store.h
+ *  @brief ParameterStore hands tuneable values from the GUI to the code that
+ *  processes the data, without locks on the processing side.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+using std::vector;
+
+/**
+ *  @brief ParameterStore owns the values of a set of int, double and bool
+ *  variables (the ones behind Tuneables) and decides when those variables
+ *  change.
+ *
+ *  The GUI thread (the writer) stages new values with set() and makes all
+ *  staged changes visible at once with publish(), typically once per frame,
+ *  so that a slider drag that fires many events publishes only once. The
+ *  processing thread (the reader) calls apply() once per frame, before
+ *  running the pipeline; it copies the newest published snapshot into the
+ *  variables. Pipeline code (e.g. a FeatureApply function) then reads the
+ *  plain variables and always sees a consistent set of values that doesn't
+ *  change in the middle of a frame.
+ *
+ *  Snapshots are passed through a triple buffer: publish() and apply() each
+ *  exchange one atomic index and never wait for each other. When nothing was
+ *  published, apply() costs a single atomic load.
+ *
+ *  There is one writer and one reader thread. Variables are added with add()
+ *  while neither publish() nor apply() can run, i.e. during setup.
+ *
+ *  Other threads may read the variables too, e.g. copies of the pipeline
+ *  trained on TaskScheduler workers, as long as they hold a Lease. While any
+ *  Lease is held, apply() leaves the variables alone and keeps the snapshot
+ *  for a later call, so those threads see the same values from start to
+ *  finish. Take the Lease on the reader thread, before handing the work over.
+ */
+class ParameterStore {
+  public:
+    typedef uint32_t Id;
+
+    ParameterStore();
+
+    /// @brief Take over `variable`. Its current value is the initial value.
+    Id add(int* variable);
+    Id add(double* variable);
+    Id add(bool* variable);
+
+    uint32_t size() const { return variables_.size(); }
+
+    // =================================================
+    //  Writer
+    // =================================================
+
+    /// @brief Stage a new value; it reaches the variable after publish() and
+    /// then apply(). Ints are rounded.
+    void set(Id id, double value);
+
+    /// @brief The newest value, staged or not.
+    double get(Id id) const { return staged_[id]; }
+
+    /// @brief Publish everything staged since the last call as one snapshot.
+    /// Returns false if there was nothing to publish.
+    bool publish();
+
+    // =================================================
+    //  Reader
+    // =================================================
+
+    /// @brief Copy the newest published snapshot into the variables. Returns
+    /// false if nothing was published since the last call, or if a Lease is
+    /// held; then hasUnapplied() tells the two apart.
+    bool apply();
+
+    /// @brief Whether a published snapshot is waiting for apply().
+    bool hasUnapplied() const {
+        return published_.load(std::memory_order_acquire) & kFresh;
+    }
+
+    /// @brief Keeps apply() from changing the variables while it exists.
+    /// Copies hold the lease too.
+    class Lease {
+      public:
+        explicit Lease(ParameterStore* store);
+        Lease(const Lease& rhs) : Lease(rhs.store_) {}
+        ~Lease();
+
+      private:
+        ParameterStore* store_;
+        void operator=(const Lease&) = delete;
+    };
+
+    Lease lease() { return Lease(this); }
+
+    /// @brief Number of leases currently held.
+    uint32_t getNumLeases() const;
+
+    /// @brief Block until no lease is held, e.g. so that apply() can't be
+    /// deferred. Only the reader thread takes leases, so none is taken
+    /// meanwhile if it's the one waiting.
+    void waitForLeases();
+
+  private:
+    enum Type { kInt, kDouble, kBool };
+    struct Variable {
+        Type type;
+        void* address;
+    };
+
+    Id add(Type type, void* address, double value);
+
+    vector<Variable> variables_;
+
+    // Writer side.
+    vector<double> staged_;
+    bool dirty_;
+    uint32_t write_index_;
+
+    // The three snapshot buffers. The writer fills buffers_[write_index_],
+    // the reader reads buffers_[read_index_], and `published_` holds the
+    // index of the third, plus kFresh if the reader hasn't taken it yet.
+    static const uint32_t kFresh = 4;
+    vector<double> buffers_[3];
+    std::atomic<uint32_t> published_;
+
+    // Reader side.
+    uint32_t read_index_;
+
+    // apply() writes the variables with lease_mutex_ held, and only when no
+    // lease is held, so leases order the writes against other readers.
+    mutable std::mutex lease_mutex_;
+    std::condition_variable leases_released_;
+    uint32_t num_leases_;
+};
@@ -215,6 +215,12 @@ class Plotter : public InteractivePlot {
     bool setRanges(float minY, float maxY, bool lockRanges = false);
     std::pair<float, float> getRanges();
 
+    // Bytes held by the plotted data.
+    uint64_t getMemoryUsage() const {
+        return (uint64_t) data_.getNumRows() * data_.getNumCols() *
+               sizeof(double);
+    }
+
     bool setColorPalette(const vector<ofColor>& colors);
 
     bool setTitle(const string& title);
@@ -308,6 +314,14 @@ class InteractiveTimeSeriesPlot : public ofxGrtTimeseriesPlot,
                               dataBuffer[x_idx].end());
     }
 
+    // Bytes held by the plotted data (stored as floats by
+    // ofxGrtTimeseriesPlot).
+    uint64_t getMemoryUsage() {
+        if (dataBuffer.getSize() == 0) return 0;
+        return (uint64_t) dataBuffer.getSize() * dataBuffer[0].size() *
+               sizeof(float);
+    }
+
   protected:
     virtual uint32_t mouseCoordinateToIndex(uint32_t x) {
         float x_step = w_ * 1.0 / timeseriesLength;
@@ -0,0 +1,103 @@
+#include "prediction-record.h"
+#include "gtest/gtest.h"
+
+static PredictionRecord makeRecord() {
+    PredictionRecord record;
+    record.timestamp_us = 1500000000123456ULL;
+    record.sequence = 42;
+    record.label = 2;
+    record.classifier_label = 2;
+    record.null_rejection_enabled = true;
+    record.class_labels = { 1, 2, 3 };
+    record.likelihoods = { 0.125, 0.75, 0.125 };
+    record.distances = { 8.5, 1.25, 9 };
+    return record;
+}
+
+static void expectEqual(const PredictionRecord& expected,
+                        const PredictionRecord& actual) {
+    EXPECT_EQ(expected.timestamp_us, actual.timestamp_us);
+    EXPECT_EQ(expected.sequence, actual.sequence);
+    EXPECT_EQ(expected.label, actual.label);
+    EXPECT_EQ(expected.classifier_label, actual.classifier_label);
+    EXPECT_EQ(expected.null_rejection_enabled, actual.null_rejection_enabled);
+    EXPECT_EQ(expected.class_labels, actual.class_labels);
+    EXPECT_EQ(expected.likelihoods, actual.likelihoods);
+    EXPECT_EQ(expected.distances, actual.distances);
+}
+
+TEST(PredictionRecordTest, Layout) {
+    PredictionRecord record;
+    record.timestamp_us = 0x0102030405060708ULL;
+    record.sequence = 7;
+    record.label = 0;
+    record.classifier_label = 0;
+    record.null_rejection_enabled = true;
+    record.class_labels = { 1 };
+    record.likelihoods = { 1.0 };
+
+    string encoded;
+    record.encode(&encoded);
+    ASSERT_EQ(record.getEncodedSize(), encoded.size());
+    ASSERT_EQ(36, encoded.size());
+    const string expected(
+        "\x01\x03\x01\x00"                   // version, flags, 1 class
+        "\x07\x00\x00\x00"                   // sequence
+        "\x08\x07\x06\x05\x04\x03\x02\x01"   // timestamp
+        "\x00\x00\x00\x00"                   // label
+        "\x00\x00\x00\x00"                   // classifier label
+        "\x01\x00\x00\x00"                   // class 1
+        "\x00\x00\x80\x3F"                   // likelihood 1.0f
+        "\x00\x00\x00\x00",                  // distance (missing)
+        36);
+    ASSERT_EQ(expected, encoded);
+    ASSERT_TRUE(record.isRejected());
+}
+
+TEST(PredictionRecordTest, RoundTrip) {
+    PredictionRecord record = makeRecord();
+    ASSERT_FALSE(record.isRejected());
+    string encoded;
+    record.encode(&encoded);
+
+    PredictionRecord decoded;
+    ASSERT_EQ(encoded.size(),
+              PredictionRecord::decode(encoded.data(), encoded.size(),
+                                       &decoded));
+    expectEqual(record, decoded);
+}
+
+TEST(PredictionRecordTest, BackToBack) {
+    PredictionRecord first = makeRecord(), second = makeRecord();
+    second.sequence++;
+    second.label = 0;
+    second.class_labels.clear();
+    second.likelihoods.clear();
+    second.distances.clear();
+
+    string encoded;
+    first.encode(&encoded);
+    second.encode(&encoded);
+
+    PredictionRecord decoded;
+    size_t read = PredictionRecord::decode(encoded.data(), encoded.size(),
+                                           &decoded);
+    ASSERT_EQ(first.getEncodedSize(), read);
+    expectEqual(first, decoded);
+    ASSERT_EQ(second.getEncodedSize(),
+              PredictionRecord::decode(encoded.data() + read,
+                                       encoded.size() - read, &decoded));
+    expectEqual(second, decoded);
+}
+
+TEST(PredictionRecordTest, Incomplete) {
+    string encoded;
+    makeRecord().encode(&encoded);
+    PredictionRecord decoded;
+    for (size_t size = 0; size < encoded.size(); size++) {
+        ASSERT_EQ(0, PredictionRecord::decode(encoded.data(), size, &decoded));
+    }
+    encoded[0] = 2;  // an unknown version
+    ASSERT_EQ(0, PredictionRecord::decode(encoded.data(), encoded.size(),
+                                          &decoded));
+}
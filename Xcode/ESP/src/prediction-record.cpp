@@ -0,0 +1,78 @@
+#include "prediction-record.h"
+
+#include <cstring>
+
+static const uint8_t kNullRejectionEnabled = 1;
+static const uint8_t kRejected = 2;
+
+template<typename T>
+static void put(string* out, T value) {
+    for (size_t i = 0; i < sizeof(T); i++) {
+        out->push_back((char) ((value >> (8 * i)) & 0xFF));
+    }
+}
+
+static void putFloat(string* out, double value) {
+    float f = value;
+    uint32_t bits;
+    memcpy(&bits, &f, sizeof(bits));
+    put(out, bits);
+}
+
+template<typename T>
+static T get(const char* data) {
+    T value = 0;
+    for (size_t i = 0; i < sizeof(T); i++) {
+        value |= (T) (uint8_t) data[i] << (8 * i);
+    }
+    return value;
+}
+
+static double getFloat(const char* data) {
+    uint32_t bits = get<uint32_t>(data);
+    float f;
+    memcpy(&f, &bits, sizeof(f));
+    return f;
+}
+
+void PredictionRecord::encode(string* out) const {
+    out->reserve(out->size() + getEncodedSize());
+    uint8_t flags = (null_rejection_enabled ? kNullRejectionEnabled : 0) |
+                    (isRejected() ? kRejected : 0);
+    put<uint8_t>(out, kVersion);
+    put<uint8_t>(out, flags);
+    put<uint16_t>(out, class_labels.size());
+    put<uint32_t>(out, sequence);
+    put<uint64_t>(out, timestamp_us);
+    put<uint32_t>(out, label);
+    put<uint32_t>(out, classifier_label);
+    for (size_t i = 0; i < class_labels.size(); i++) {
+        put<uint32_t>(out, class_labels[i]);
+        putFloat(out, i < likelihoods.size() ? likelihoods[i] : 0);
+        putFloat(out, i < distances.size() ? distances[i] : 0);
+    }
+}
+
+size_t PredictionRecord::decode(const char* data, size_t size,
+                                PredictionRecord* record) {
+    if (size < kHeaderSize || (uint8_t) data[0] != kVersion) return 0;
+    size_t num_classes = get<uint16_t>(data + 2);
+    size_t record_size = kHeaderSize + kClassSize * num_classes;
+    if (size < record_size) return 0;
+
+    record->null_rejection_enabled = data[1] & kNullRejectionEnabled;
+    record->sequence = get<uint32_t>(data + 4);
+    record->timestamp_us = get<uint64_t>(data + 8);
+    record->label = get<uint32_t>(data + 16);
+    record->classifier_label = get<uint32_t>(data + 20);
+    record->class_labels.resize(num_classes);
+    record->likelihoods.resize(num_classes);
+    record->distances.resize(num_classes);
+    for (size_t i = 0; i < num_classes; i++) {
+        const char* c = data + kHeaderSize + kClassSize * i;
+        record->class_labels[i] = get<uint32_t>(c);
+        record->likelihoods[i] = getFloat(c + 4);
+        record->distances[i] = getFloat(c + 8);
+    }
+    return record_size;
+}
@@ -0,0 +1,75 @@
+/** @file prediction-record.h
+ *  @brief PredictionRecord holds what a classifier pipeline concluded about
+ *  one sample, and encodes it compactly for PredictionOStream consumers.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using std::string;
+using std::vector;
+
+/**
+ *  @brief PredictionRecord is everything a consumer needs to gate on the
+ *  confidence of a prediction itself: besides the label, the likelihood of
+ *  and distance to every class, and whether null rejection was involved.
+ *
+ *  Records are encoded in little-endian byte order as:
+ *
+ *  | offset | type | field                                              |
+ *  |--------|------|----------------------------------------------------|
+ *  | 0      | u8   | version (1)                                        |
+ *  | 1      | u8   | flags: 1 = null rejection enabled, 2 = rejected    |
+ *  | 2      | u16  | number of classes, n                               |
+ *  | 4      | u32  | sequence                                           |
+ *  | 8      | u64  | timestamp, in microseconds since the Unix epoch    |
+ *  | 16     | u32  | label                                              |
+ *  | 20     | u32  | classifier label                                   |
+ *  | 24     | 12n  | per class: u32 label, f32 likelihood, f32 distance |
+ *
+ *  so a record of 4 classes takes 72 bytes. Records are self-delimiting, so
+ *  they can be sent back to back over a byte stream.
+ */
+struct PredictionRecord {
+    static const uint8_t kVersion = 1;
+    static const size_t kHeaderSize = 24;
+    static const size_t kClassSize = 12;
+
+    uint64_t timestamp_us = 0;
+    // Counts the predictions since ESP started; a gap means records were
+    // lost.
+    uint32_t sequence = 0;
+    // The predicted label after post-processing; 0 for none.
+    uint32_t label = 0;
+    // The label the classifier predicted, before post-processing.
+    uint32_t classifier_label = 0;
+    bool null_rejection_enabled = false;
+
+    // The likelihoods and distances are in the order of `class_labels`.
+    // Missing ones are encoded as 0.
+    vector<uint32_t> class_labels;
+    vector<double> likelihoods;
+    vector<double> distances;
+
+    // Whether the classifier rejected the sample as none of the classes.
+    bool isRejected() const {
+        return null_rejection_enabled && classifier_label == 0;
+    }
+
+    size_t getEncodedSize() const {
+        return kHeaderSize + kClassSize * class_labels.size();
+    }
+
+    // Append the encoding of this record to `out`.
+    void encode(string* out) const;
+
+    // Decode the record at the front of `data`. Returns the number of bytes
+    // read, or 0 if `data` doesn't start with a whole record of a known
+    // version.
+    static size_t decode(const char* data, size_t size,
+                         PredictionRecord* record);
+};
@@ -0,0 +1,85 @@
+#include "rewind-buffer.h"
+#include "gtest/gtest.h"
+
+static const uint32_t kDim = 2;
+static const uint32_t kCapacity = 4;
+
+class RewindBufferTest : public ::testing::Test {
+  protected:
+    virtual void SetUp() {
+        buffer.setup(kDim, kDim, kCapacity);
+    }
+
+    // Push frame `i` with raw data {i, -i}, calibrated data {10 * i, 0} and
+    // timestamp 100 * i.
+    void pushFrame(uint32_t i) {
+        double v = i;
+        buffer.push({v, -v}, {10 * v, 0}, 100 * i);
+    }
+
+    RewindBuffer buffer;
+};
+
+TEST_F(RewindBufferTest, RejectsMismatchedDimensions) {
+    ASSERT_FALSE(buffer.push({1}, {1, 2}, 0));
+    ASSERT_FALSE(buffer.push({1, 2}, {1, 2, 3}, 0));
+    ASSERT_EQ(0, buffer.size());
+}
+
+TEST_F(RewindBufferTest, GetRangeBeforeWrapping) {
+    pushFrame(1);
+    pushFrame(2);
+    pushFrame(3);
+    ASSERT_EQ(3, buffer.size());
+
+    GRT::MatrixDouble m = buffer.getRange(1, 3);
+    ASSERT_EQ(2, m.getNumRows());
+    ASSERT_EQ(kDim, m.getNumCols());
+    ASSERT_EQ(20, m[0][0]);
+    ASSERT_EQ(30, m[1][0]);
+
+    GRT::MatrixDouble raw = buffer.getRange(0, 1, false);
+    ASSERT_EQ(1, raw.getNumRows());
+    ASSERT_EQ(1, raw[0][0]);
+    ASSERT_EQ(-1, raw[0][1]);
+}
+
+TEST_F(RewindBufferTest, GetRangeAcrossWrapAround) {
+    for (uint32_t i = 1; i <= 6; i++) pushFrame(i);
+
+    // Only the last kCapacity frames (3, 4, 5, 6) are kept.
+    ASSERT_EQ(kCapacity, buffer.size());
+    ASSERT_EQ(300, buffer.getTimestamp(0));
+
+    GRT::MatrixDouble m = buffer.getRange(0, 10, false);
+    ASSERT_EQ(kCapacity, m.getNumRows());
+    for (uint32_t i = 0; i < kCapacity; i++) {
+        ASSERT_EQ(i + 3, m[i][0]);
+        ASSERT_EQ(-double(i + 3), m[i][1]);
+    }
+}
+
+TEST_F(RewindBufferTest, GetRecent) {
+    for (uint32_t i = 1; i <= 5; i++) pushFrame(i);
+
+    // The two frames before the newest one.
+    GRT::MatrixDouble m = buffer.getRecent(1, 2);
+    ASSERT_EQ(2, m.getNumRows());
+    ASSERT_EQ(30, m[0][0]);
+    ASSERT_EQ(40, m[1][0]);
+
+    ASSERT_EQ(0, buffer.getRecent(kCapacity, 1).getNumRows());
+
+    // Scrolled back further than there are frames before: what's left.
+    m = buffer.getRecent(2, 4);
+    ASSERT_EQ(2, m.getNumRows());
+    ASSERT_EQ(20, m[0][0]);
+    ASSERT_EQ(30, m[1][0]);
+}
+
+TEST_F(RewindBufferTest, Clear) {
+    pushFrame(1);
+    buffer.clear();
+    ASSERT_EQ(0, buffer.size());
+    ASSERT_EQ(0, buffer.getRange(0, 1).getNumRows());
+}
@@ -0,0 +1,105 @@
+#include "rewind-buffer.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+RewindBuffer::RewindBuffer()
+        : raw_dim_(0), calibrated_dim_(0), capacity_(0), head_(0), size_(0) {
+}
+
+bool RewindBuffer::setup(uint32_t raw_dim, uint32_t calibrated_dim,
+                         uint32_t capacity) {
+    if (raw_dim == 0 || calibrated_dim == 0 || capacity == 0) { return false; }
+
+    raw_dim_ = raw_dim;
+    calibrated_dim_ = calibrated_dim;
+    capacity_ = capacity;
+
+    // Release the old storage before allocating, the buffers can be large.
+    vector<double>().swap(raw_);
+    vector<double>().swap(calibrated_);
+    vector<uint64_t>().swap(timestamps_);
+    raw_.resize(static_cast<size_t>(capacity) * raw_dim);
+    calibrated_.resize(static_cast<size_t>(capacity) * calibrated_dim);
+    timestamps_.resize(capacity);
+
+    clear();
+    return true;
+}
+
+void RewindBuffer::clear() {
+    head_ = 0;
+    size_ = 0;
+}
+
+bool RewindBuffer::push(const vector<double>& raw,
+                        const vector<double>& calibrated, uint64_t timestamp) {
+    if (capacity_ == 0 || raw.size() != raw_dim_ ||
+        calibrated.size() != calibrated_dim_) {
+        return false;
+    }
+
+    uint32_t tail;
+    if (size_ < capacity_) {
+        tail = physicalIndex(size_);
+        size_++;
+    } else {
+        // Full: overwrite the oldest frame.
+        tail = head_;
+        head_ = physicalIndex(1);
+    }
+
+    std::memcpy(&raw_[static_cast<size_t>(tail) * raw_dim_], raw.data(),
+                raw_dim_ * sizeof(double));
+    std::memcpy(&calibrated_[static_cast<size_t>(tail) * calibrated_dim_],
+                calibrated.data(), calibrated_dim_ * sizeof(double));
+    timestamps_[tail] = timestamp;
+    return true;
+}
+
+uint64_t RewindBuffer::getMemoryUsage() const {
+    return raw_.capacity() * sizeof(double) +
+           calibrated_.capacity() * sizeof(double) +
+           timestamps_.capacity() * sizeof(uint64_t);
+}
+
+uint64_t RewindBuffer::getTimestamp(uint32_t index) const {
+    assert(index < size_ && "Index exceeds the available frames");
+    return timestamps_[physicalIndex(index)];
+}
+
+GRT::MatrixDouble RewindBuffer::getRange(uint32_t start, uint32_t end,
+                                         bool calibrated) const {
+    end = std::min(end, size_);
+    if (start >= end) { return GRT::MatrixDouble(); }
+
+    const uint32_t dim = calibrated ? calibrated_dim_ : raw_dim_;
+    const double* src = calibrated ? calibrated_.data() : raw_.data();
+    const uint32_t num_rows = end - start;
+
+    // GRT matrices keep their rows in a single contiguous block, so the ring
+    // can be copied in (at most) two pieces.
+    GRT::MatrixDouble m(num_rows, dim);
+    double* dst = &m[0][0];
+
+    uint32_t first = physicalIndex(start);
+    uint32_t first_rows = std::min(num_rows, capacity_ - first);
+    std::memcpy(dst, src + static_cast<size_t>(first) * dim,
+                static_cast<size_t>(first_rows) * dim * sizeof(double));
+    if (first_rows < num_rows) {
+        std::memcpy(dst + static_cast<size_t>(first_rows) * dim, src,
+                    static_cast<size_t>(num_rows - first_rows) * dim *
+                    sizeof(double));
+    }
+    return m;
+}
+
+GRT::MatrixDouble RewindBuffer::getRecent(uint32_t frames_ago,
+                                          uint32_t num_frames,
+                                          bool calibrated) const {
+    if (frames_ago >= size_) { return GRT::MatrixDouble(); }
+    uint32_t end = size_ - frames_ago;
+    uint32_t start = end > num_frames ? end - num_frames : 0;
+    return getRange(start, end, calibrated);
+}
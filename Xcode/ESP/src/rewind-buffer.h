@@ -0,0 +1,87 @@
+/** @file rewind-buffer.h
+ *  @brief RewindBuffer keeps a long, full-precision history of the live input
+ *  so that training samples can be extracted from far back in time.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <GRT/GRT.h>
+
+using std::vector;
+
+/**
+ *  @brief RewindBuffer is a fixed-capacity ring of input frames. Each frame
+ *  holds the raw input, the calibrated input and the time (in milliseconds)
+ *  at which it arrived.
+ *
+ *  Unlike the live plots, which keep `buffer_size_` points as floats, the
+ *  rewind buffer stores doubles in two contiguous arrays (one for raw and one
+ *  for calibrated data) and is sized independently of the GUI. Extracting a
+ *  range is at most two memcpy calls per array.
+ *
+ *  Frames are addressed by index, where 0 is the oldest frame still held and
+ *  `size() - 1` the newest. Timestamps have millisecond resolution, too coarse
+ *  to tell apart frames at audio rates, so they are only for display.
+ */
+class RewindBuffer {
+  public:
+    RewindBuffer();
+
+    /// @brief Allocate storage for `capacity` frames. Previous content is
+    /// discarded. Returns false if any of the arguments is zero.
+    bool setup(uint32_t raw_dim, uint32_t calibrated_dim, uint32_t capacity);
+
+    /// @brief Drop all frames, keeping the allocated storage.
+    void clear();
+
+    /// @brief Append a frame, overwriting the oldest one when full. Returns
+    /// false (and stores nothing) if a vector does not match its dimension.
+    bool push(const vector<double>& raw, const vector<double>& calibrated,
+              uint64_t timestamp);
+
+    uint32_t size() const { return size_; }
+    uint32_t capacity() const { return capacity_; }
+    uint32_t getRawDimension() const { return raw_dim_; }
+    uint32_t getCalibratedDimension() const { return calibrated_dim_; }
+
+    /// @brief Number of bytes allocated for frame storage.
+    uint64_t getMemoryUsage() const;
+
+    /// @brief Timestamp of the frame at `index` (0 is the oldest).
+    uint64_t getTimestamp(uint32_t index) const;
+
+    /// @brief Copy frames [start, end) into a matrix with one row per frame.
+    /// The range is clipped to the frames currently held.
+    GRT::MatrixDouble getRange(uint32_t start, uint32_t end,
+                               bool calibrated = true) const;
+
+    /// @brief Copy the `num_frames` frames that end `frames_ago` frames
+    /// before the newest one. This is how a selection on a live plot that is
+    /// updated in lockstep with this buffer, or has been scrolled back through
+    /// it, maps onto it.
+    GRT::MatrixDouble getRecent(uint32_t frames_ago, uint32_t num_frames,
+                                bool calibrated = true) const;
+
+  private:
+    // Position in the underlying arrays of the frame at `index`.
+    inline uint32_t physicalIndex(uint32_t index) const {
+        uint32_t i = head_ + index;
+        return i >= capacity_ ? i - capacity_ : i;
+    }
+
+    uint32_t raw_dim_;
+    uint32_t calibrated_dim_;
+    uint32_t capacity_;
+
+    // Position of the oldest frame and the number of frames held.
+    uint32_t head_;
+    uint32_t size_;
+
+    // Row-major frame storage, `capacity_` rows each.
+    vector<double> raw_;
+    vector<double> calibrated_;
+    vector<uint64_t> timestamps_;
+};
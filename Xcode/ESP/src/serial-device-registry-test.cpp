@@ -0,0 +1,143 @@
+#include "serial-device-registry.h"
+#include "gtest/gtest.h"
+
+#include <condition_variable>
+#include <cstdlib>
+#include <fstream>
+#include <mutex>
+#include <thread>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// A fake /dev and /sys/class/tty, with USB devices that are added the way
+// the kernel lays them out.
+class SerialDeviceRegistryTest : public ::testing::Test {
+  protected:
+    void SetUp() override {
+        char dir[] = "/tmp/serial-registry-XXXXXX";
+        root_ = mkdtemp(dir);
+        dev_ = root_ + "/dev";
+        tty_ = root_ + "/tty";
+        mkdir(dev_.c_str(), 0755);
+        mkdir(tty_.c_str(), 0755);
+        mkdir((root_ + "/usb").c_str(), 0755);
+    }
+
+    void TearDown() override {
+        std::system(("rm -rf " + root_).c_str());
+    }
+
+    void write(const string& filename, const string& line) {
+        std::ofstream(filename) << line << std::endl;
+    }
+
+    // /dev/<name>, and a USB device on `usb_port` behind it.
+    void addUsbDevice(const string& name, const string& usb_port,
+                      const string& vid, const string& pid,
+                      const string& serial, const string& product) {
+        string usb = root_ + "/usb/" + usb_port;
+        mkdir(usb.c_str(), 0755);
+        mkdir((usb + "/" + usb_port + ":1.0").c_str(), 0755);
+        write(usb + "/idVendor", vid);
+        write(usb + "/idProduct", pid);
+        if (!serial.empty()) write(usb + "/serial", serial);
+        write(usb + "/product", product);
+
+        mkdir((tty_ + "/" + name).c_str(), 0755);
+        symlink((usb + "/" + usb_port + ":1.0").c_str(),
+                (tty_ + "/" + name + "/device").c_str());
+        write(dev_ + "/" + name, "");
+    }
+
+    string root_, dev_, tty_;
+};
+
+TEST_F(SerialDeviceRegistryTest, ReadsUsbFingerprints) {
+    addUsbDevice("ttyACM1", "1-2", "2341", "0043", "7573", "Arduino Uno");
+    addUsbDevice("ttyUSB0", "1-1.3", "0403", "6001", "", "FT232R");
+    write(dev_ + "/ttyS0", "");  // a UART, not on USB
+    write(dev_ + "/null", "");
+
+    SerialDeviceRegistry registry(tty_, dev_);
+    auto devices = registry.getDevices();
+    ASSERT_EQ(3, devices.size());
+
+    // Sorted by name, as ofSerial lists them.
+    ASSERT_EQ(dev_ + "/ttyACM1", devices[0].path);
+    ASSERT_EQ("2341:0043:7573", devices[0].getFingerprint());
+    ASSERT_EQ(dev_ + "/ttyACM1 (Arduino Uno)", devices[0].getDescription());
+    ASSERT_EQ(dev_ + "/ttyS0", devices[1].path);
+    ASSERT_EQ(dev_ + "/ttyS0", devices[1].getFingerprint());
+    // Without a serial number, the USB port tells adapters apart.
+    ASSERT_EQ("0403:6001@1-1.3", devices[2].getFingerprint());
+
+    ASSERT_EQ(dev_ + "/ttyS0", registry.getPath(1));
+    ASSERT_EQ("", registry.getPath(3));
+    ASSERT_EQ(2, registry.find("0403:6001@1-1.3"));
+    ASSERT_EQ(-1, registry.find("0403:6001@1-1.4"));
+}
+
+TEST_F(SerialDeviceRegistryTest, ScansOnceUntilRescan) {
+    SerialDeviceRegistry registry(tty_, dev_);
+    ASSERT_EQ(0, registry.getDevices().size());
+    addUsbDevice("ttyACM0", "1-2", "2341", "0043", "7573", "Arduino Uno");
+    ASSERT_EQ(0, registry.getDevices().size());
+    registry.rescan();
+    ASSERT_EQ(1, registry.getDevices().size());
+}
+
+TEST_F(SerialDeviceRegistryTest, RemembersTheDeviceAcrossRenumbering) {
+    addUsbDevice("ttyACM0", "1-2", "2341", "0043", "7573", "Arduino Uno");
+    {
+        SerialDeviceRegistry registry(tty_, dev_);
+        registry.setMemoryFile(root_ + "/last-device");
+        ASSERT_EQ(-1, registry.findRemembered());
+        registry.remember(registry.getDevices()[0]);
+    }
+
+    // Next time, another device took its place and it came up as ttyACM1.
+    std::system(("rm -rf " + dev_ + "/ttyACM0 " + tty_ + "/ttyACM0 " +
+                 root_ + "/usb/1-2").c_str());
+    addUsbDevice("ttyACM0", "1-3", "1a86", "7523", "", "USB Serial");
+    addUsbDevice("ttyACM1", "1-2", "2341", "0043", "7573", "Arduino Uno");
+    SerialDeviceRegistry registry(tty_, dev_);
+    registry.setMemoryFile(root_ + "/last-device");
+    ASSERT_EQ(1, registry.findRemembered());
+}
+
+TEST_F(SerialDeviceRegistryTest, RescansOnHotplug) {
+    SerialDeviceRegistry registry(tty_, dev_);
+    ASSERT_EQ(0, registry.getDevices().size());
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    int changes = 0;
+    ASSERT_TRUE(registry.watchForHotplug([&] {
+        std::lock_guard<std::mutex> lock(mutex);
+        changes++;
+        cv.notify_all();
+    }));
+
+    // Files that aren't serial devices are ignored.
+    write(dev_ + "/null", "");
+    addUsbDevice("ttyACM0", "1-2", "2341", "0043", "7573", "Arduino Uno");
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        ASSERT_TRUE(cv.wait_for(lock, std::chrono::seconds(5),
+                                [&] { return changes > 0; }));
+    }
+    ASSERT_EQ(1, registry.getDevices().size());
+    ASSERT_EQ("2341:0043:7573", registry.getDevices()[0].getFingerprint());
+
+    // Nothing is called back once stopped.
+    registry.stopWatching();
+    int changes_when_stopped;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        changes_when_stopped = changes;
+    }
+    addUsbDevice("ttyACM1", "1-3", "1a86", "7523", "", "USB Serial");
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    std::lock_guard<std::mutex> lock(mutex);
+    ASSERT_EQ(changes_when_stopped, changes);
+}
@@ -0,0 +1,234 @@
+#include "serial-device-registry.h"
+
+#include <algorithm>
+#include <fstream>
+
+#if defined(__linux__)
+#include <dirent.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stdlib.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#else
+#include "ofMain.h"
+#endif
+
+namespace {
+
+// The first line of `filename`, or "" if it can't be read.
+string readLine(const string& filename) {
+    std::ifstream file(filename);
+    string line;
+    std::getline(file, line);
+    return line;
+}
+
+}  // namespace
+
+string SerialDeviceRegistry::Device::getFingerprint() const {
+    if (vendor_id.empty()) return path;
+    string fingerprint = vendor_id + ":" + product_id;
+    // Identical adapters without serial numbers are told apart by the USB
+    // port they're plugged into.
+    return serial_number.empty() ? fingerprint + "@" + usb_port
+                                 : fingerprint + ":" + serial_number;
+}
+
+string SerialDeviceRegistry::Device::getDescription() const {
+    if (!product.empty()) return path + " (" + product + ")";
+    if (!vendor_id.empty()) {
+        return path + " (" + vendor_id + ":" + product_id + ")";
+    }
+    return path;
+}
+
+SerialDeviceRegistry& SerialDeviceRegistry::instance() {
+    // The reactor must outlive the registry, whose destructor stops the
+    // hotplug watch; statics are destroyed in reverse order of construction.
+    IoReactor::instance();
+    static SerialDeviceRegistry registry;
+    return registry;
+}
+
+SerialDeviceRegistry::SerialDeviceRegistry(const string& sysfs_tty_root,
+                                           const string& dev_root)
+        : sysfs_tty_root_(sysfs_tty_root), dev_root_(dev_root) {
+}
+
+SerialDeviceRegistry::~SerialDeviceRegistry() {
+    stopWatching();
+}
+
+vector<SerialDeviceRegistry::Device> SerialDeviceRegistry::getDevices() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!scanned_) {
+        devices_ = scan();
+        scanned_ = true;
+    }
+    return devices_;
+}
+
+string SerialDeviceRegistry::getPath(uint32_t index) {
+    vector<Device> devices = getDevices();
+    return index < devices.size() ? devices[index].path : "";
+}
+
+int SerialDeviceRegistry::find(const string& fingerprint) {
+    if (fingerprint.empty()) return -1;
+    vector<Device> devices = getDevices();
+    for (uint32_t i = 0; i < devices.size(); i++) {
+        if (devices[i].getFingerprint() == fingerprint) return i;
+    }
+    return -1;
+}
+
+void SerialDeviceRegistry::rescan() {
+    vector<Device> devices = scan();
+    std::lock_guard<std::mutex> lock(mutex_);
+    devices_ = devices;
+    scanned_ = true;
+}
+
+void SerialDeviceRegistry::remember(const Device& device) {
+    if (memory_file_.empty()) return;
+    std::ofstream file(memory_file_);
+    file << device.getFingerprint() << std::endl;
+}
+
+int SerialDeviceRegistry::findRemembered() {
+    if (memory_file_.empty()) return -1;
+    return find(readLine(memory_file_));
+}
+
+bool SerialDeviceRegistry::isSerialDeviceName(const string& name) {
+    // The prefixes ofSerial lists.
+#if defined(__linux__)
+    static const char* kPrefixes[] = {
+        "ttyS", "ttyUSB", "ttyACM", "ttyAMA", "rfcomm"
+    };
+#else
+    static const char* kPrefixes[] = { "cu.", "tty." };
+#endif
+    for (const char* prefix : kPrefixes) {
+        if (name.compare(0, string(prefix).size(), prefix) == 0) return true;
+    }
+    return false;
+}
+
+#if defined(__linux__)
+
+vector<SerialDeviceRegistry::Device> SerialDeviceRegistry::scan() const {
+    vector<string> names;
+    if (DIR* dir = opendir(dev_root_.c_str())) {
+        while (dirent* entry = readdir(dir)) {
+            if (isSerialDeviceName(entry->d_name)) names.push_back(entry->d_name);
+        }
+        closedir(dir);
+    }
+    std::sort(names.begin(), names.end());
+
+    vector<Device> devices;
+    for (const string& name : names) {
+        Device device;
+        device.path = dev_root_ + "/" + name;
+
+        // /sys/class/tty/<name>/device links to the USB interface (or, for
+        // a UART, to the platform device). The USB device that holds the IDs
+        // is a parent of the interface.
+        char resolved[PATH_MAX];
+        string link = sysfs_tty_root_ + "/" + name + "/device";
+        if (realpath(link.c_str(), resolved) != nullptr) {
+            string dir = resolved;
+            for (int depth = 0; depth < 4 && dir.size() > 1; depth++) {
+                string vendor_id = readLine(dir + "/idVendor");
+                if (!vendor_id.empty()) {
+                    device.vendor_id = vendor_id;
+                    device.product_id = readLine(dir + "/idProduct");
+                    device.serial_number = readLine(dir + "/serial");
+                    device.product = readLine(dir + "/product");
+                    device.usb_port = dir.substr(dir.rfind('/') + 1);
+                    break;
+                }
+                dir = dir.substr(0, dir.rfind('/'));
+            }
+        }
+        devices.push_back(device);
+    }
+    return devices;
+}
+
+bool SerialDeviceRegistry::watchForHotplug(ChangeCallback callback) {
+    stopWatching();
+    inotify_fd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (inotify_fd_ < 0) return false;
+    if (inotify_add_watch(inotify_fd_, dev_root_.c_str(),
+                          IN_CREATE | IN_DELETE | IN_MOVED_FROM |
+                          IN_MOVED_TO) < 0) {
+        close(inotify_fd_);
+        inotify_fd_ = -1;
+        return false;
+    }
+
+    callback_ = callback;
+    watch_handle_ = IoReactor::instance().addFd(inotify_fd_, [this](int fd) {
+        // Drain all pending events; one rescan covers them.
+        bool changed = false;
+        alignas(inotify_event) char buffer[4096];
+        ssize_t size;
+        while ((size = read(fd, buffer, sizeof(buffer))) > 0) {
+            for (char* p = buffer; p < buffer + size;) {
+                inotify_event* event = reinterpret_cast<inotify_event*>(p);
+                if (event->len > 0 && isSerialDeviceName(event->name)) {
+                    changed = true;
+                }
+                p += sizeof(inotify_event) + event->len;
+            }
+        }
+        if (!changed) return;
+        rescan();
+        if (callback_ != nullptr) callback_();
+    });
+    if (watch_handle_ == IoReactor::kInvalidHandle) {
+        close(inotify_fd_);
+        inotify_fd_ = -1;
+        return false;
+    }
+    return true;
+}
+
+void SerialDeviceRegistry::stopWatching() {
+    if (watch_handle_ != IoReactor::kInvalidHandle) {
+        IoReactor::instance().remove(watch_handle_);
+        watch_handle_ = IoReactor::kInvalidHandle;
+    }
+    // The handler isn't running any more, so the callback can go, along with
+    // whatever it captured.
+    callback_ = nullptr;
+    if (inotify_fd_ >= 0) {
+        close(inotify_fd_);
+        inotify_fd_ = -1;
+    }
+}
+
+#else
+
+vector<SerialDeviceRegistry::Device> SerialDeviceRegistry::scan() const {
+    ofSerial serial;
+    vector<Device> devices;
+    for (ofSerialDeviceInfo& info : serial.getDeviceList()) {
+        Device device;
+        device.path = info.getDevicePath();
+        devices.push_back(device);
+    }
+    return devices;
+}
+
+bool SerialDeviceRegistry::watchForHotplug(ChangeCallback callback) {
+    return false;
+}
+
+void SerialDeviceRegistry::stopWatching() {
+}
+
+#endif
@@ -0,0 +1,123 @@
+/** @file serial-device-registry.h
+ *  @brief SerialDeviceRegistry lists the serial ports once, identifies them
+ *  by their USB fingerprint and remembers which one was used last.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "io-reactor.h"
+
+using std::string;
+using std::vector;
+
+/**
+ *  @brief SerialDeviceRegistry is the one place where serial ports are
+ *  enumerated. Streams and the port selection dropdown ask it for the list
+ *  instead of each calling ofSerial::listDevices(), which enumerates (and on
+ *  macOS, queries IOKit) every time; with many USB-serial adapters that
+ *  added seconds to startup.
+ *
+ *  The ports are scanned on first use and cached. On Linux, USB ports are
+ *  identified by a fingerprint made of the USB vendor and product IDs and
+ *  the serial number (or, for adapters without one, the physical USB port),
+ *  read from sysfs, so the device used last time can be found again even
+ *  when it comes up as a different /dev/ttyACM* node or at a different
+ *  index. watchForHotplug() rescans only when a tty node appears in or
+ *  disappears from /dev, using an inotify watch on the IoReactor thread.
+ *  Elsewhere, the list comes from ofSerial, a port's fingerprint is its path,
+ *  and rescan() must be called to pick up new devices.
+ *
+ *  Devices are listed by path, in the same order as ofSerial lists them, so
+ *  port indices passed to stream constructors keep their meaning.
+ */
+class SerialDeviceRegistry {
+  public:
+    struct Device {
+        string path;           // e.g. /dev/ttyACM0
+        string vendor_id;      // USB IDs as 4 hex digits; empty if not USB
+        string product_id;
+        string serial_number;  // may be empty even for USB devices
+        string product;        // USB product name, e.g. "Arduino Uno"
+        string usb_port;       // sysfs name of the USB port, e.g. 1-1.2
+
+        /// @brief Identifies the device across reboots and replugging.
+        string getFingerprint() const;
+
+        /// @brief For menus, e.g. "/dev/ttyACM0 (Arduino Uno)".
+        string getDescription() const;
+    };
+
+    typedef std::function<void()> ChangeCallback;
+
+    /// @brief The registry of the system's serial ports.
+    static SerialDeviceRegistry& instance();
+
+    /// @brief A registry that reads sysfs from `sysfs_tty_root` and watches
+    /// `dev_root` (Linux only; tests use temporary directories).
+    SerialDeviceRegistry(const string& sysfs_tty_root = "/sys/class/tty",
+                         const string& dev_root = "/dev");
+    ~SerialDeviceRegistry();
+
+    /// @brief The ports, from the last scan. Scans the first time.
+    vector<Device> getDevices();
+
+    /// @brief The path of the `index`-th port, or "" if there is none.
+    string getPath(uint32_t index);
+
+    /// @brief The index of the port with `fingerprint`, or -1.
+    int find(const string& fingerprint);
+
+    /// @brief Enumerate the ports again.
+    void rescan();
+
+    // =================================================
+    //  The previously used device
+    // =================================================
+
+    /// @brief Store the fingerprint of the device last used in `filename`,
+    /// so it's remembered across runs.
+    void setMemoryFile(const string& filename) { memory_file_ = filename; }
+
+    /// @brief Remember `device` as the one to select next time.
+    void remember(const Device& device);
+
+    /// @brief The index of the device used last time, if it's present, or -1.
+    int findRemembered();
+
+    // =================================================
+    //  Hotplug
+    // =================================================
+
+    /// @brief Rescan when a serial device is plugged in or out, and then call
+    /// `callback`, on the IoReactor thread. Returns false where hotplug isn't
+    /// supported (anywhere but Linux).
+    bool watchForHotplug(ChangeCallback callback);
+    /// @brief Stop watching and drop the callback. Once this returns, the
+    /// callback isn't running and won't be called again.
+    void stopWatching();
+
+  private:
+    vector<Device> scan() const;
+    static bool isSerialDeviceName(const string& name);
+
+    const string sysfs_tty_root_;
+    const string dev_root_;
+    string memory_file_;
+
+    std::mutex mutex_;
+    bool scanned_ = false;
+    vector<Device> devices_;
+
+    int inotify_fd_ = -1;
+    IoReactor::Handle watch_handle_ = IoReactor::kInvalidHandle;
+    ChangeCallback callback_;
+
+    SerialDeviceRegistry(SerialDeviceRegistry&) = delete;
+    void operator=(SerialDeviceRegistry) = delete;
+};
@@ -0,0 +1,177 @@
+#include "spectrogram-plot.h"
+
+#include <algorithm>
+#include <cmath>
+
+// A dark-to-bright heat colormap (black, blue, magenta, orange, yellow,
+// white), sampled at 256 levels the first time it's needed.
+static const unsigned char* colormap() {
+    static unsigned char lut[256 * 3];
+    static bool initialized = false;
+    if (initialized) return lut;
+
+    const float stops[][3] = {
+        {0, 0, 0}, {0, 0, 160}, {160, 0, 160},
+        {255, 100, 0}, {255, 230, 0}, {255, 255, 255},
+    };
+    const int num_segments = sizeof(stops) / sizeof(stops[0]) - 1;
+    for (int i = 0; i < 256; i++) {
+        float t = i / 255.0f * num_segments;
+        int s = std::min((int) t, num_segments - 1);
+        float f = t - s;
+        for (int c = 0; c < 3; c++) {
+            lut[i * 3 + c] = (unsigned char)
+                (stops[s][c] + f * (stops[s + 1][c] - stops[s][c]) + 0.5f);
+        }
+    }
+    initialized = true;
+    return lut;
+}
+
+void SpectrogramPlot::setup(uint32_t history_length, uint32_t num_dimensions,
+                            const string& title) {
+    history_length_ = history_length;
+    num_dimensions_ = num_dimensions;
+    title_ = title;
+    pixels_.assign((size_t) history_length_ * num_dimensions_ * 4, 0);
+    head_ = 0;
+    num_pending_ = 0;
+    num_rows_ = 0;
+    has_range_ = lock_ranges_;
+    texture_.clear();
+}
+
+void SpectrogramPlot::clear() {
+    std::fill(pixels_.begin(), pixels_.end(), 0);
+    head_ = 0;
+    num_rows_ = 0;
+    // Re-upload everything so the texture is cleared too.
+    num_pending_ = history_length_;
+    if (!lock_ranges_) has_range_ = false;
+}
+
+void SpectrogramPlot::setRanges(float min, float max, bool lock_ranges) {
+    min_ = min;
+    max_ = max;
+    lock_ranges_ = lock_ranges;
+    has_range_ = true;
+}
+
+void SpectrogramPlot::update(const vector<double>& data) {
+    if (history_length_ == 0 || data.size() != num_dimensions_) return;
+
+    if (!lock_ranges_) {
+        for (double v : data) {
+            if (!std::isfinite(v)) continue;
+            if (!has_range_) {
+                min_ = max_ = v;
+                has_range_ = true;
+            }
+            min_ = std::min(min_, (float) v);
+            max_ = std::max(max_, (float) v);
+        }
+    }
+
+    const unsigned char* lut = colormap();
+    const float scale = max_ > min_ ? 255.0f / (max_ - min_) : 0;
+    unsigned char* row = &pixels_[(size_t) head_ * num_dimensions_ * 4];
+    for (uint32_t i = 0; i < num_dimensions_; i++) {
+        float level = std::isfinite(data[i]) ? (data[i] - min_) * scale : 0;
+        int index = std::min(255, std::max(0, (int) level));
+        row[i * 4 + 0] = lut[index * 3 + 0];
+        row[i * 4 + 1] = lut[index * 3 + 1];
+        row[i * 4 + 2] = lut[index * 3 + 2];
+        row[i * 4 + 3] = 0xFF;
+    }
+
+    head_ = (head_ + 1) % history_length_;
+    num_pending_ = std::min(num_pending_ + 1, history_length_);
+    num_rows_ = std::min(num_rows_ + 1, history_length_);
+}
+
+void SpectrogramPlot::allocateTexture() {
+    // A GL_TEXTURE_2D (not the rectangle textures openFrameworks uses by
+    // default) so that texture coordinates can wrap around the ring.
+    ofTextureData data;
+    data.width = num_dimensions_;
+    data.height = history_length_;
+    data.textureTarget = GL_TEXTURE_2D;
+    data.glInternalFormat = GL_RGBA8;
+    texture_.allocate(data, GL_RGBA, GL_UNSIGNED_BYTE);
+    texture_.setTextureWrap(GL_CLAMP_TO_EDGE, GL_REPEAT);
+    texture_.setTextureMinMagFilter(GL_NEAREST, GL_NEAREST);
+    num_pending_ = history_length_;
+}
+
+void SpectrogramPlot::uploadRows(uint32_t start, uint32_t count) {
+    if (count == 0) return;
+    const ofTextureData& data = texture_.getTextureData();
+    glBindTexture(data.textureTarget, data.textureID);
+    // RGBA rows are always 4-byte aligned, the default unpack alignment.
+    glTexSubImage2D(data.textureTarget, 0, 0, start, num_dimensions_, count,
+                    GL_RGBA, GL_UNSIGNED_BYTE,
+                    &pixels_[(size_t) start * num_dimensions_ * 4]);
+    glBindTexture(data.textureTarget, 0);
+}
+
+void SpectrogramPlot::draw(uint32_t x, uint32_t y, uint32_t w, uint32_t h) {
+    if (history_length_ == 0 || num_dimensions_ == 0) return;
+
+    if (!texture_.isAllocated()) allocateTexture();
+
+    // The pending rows end just before head_ and may wrap past the end of
+    // the ring, in which case they take two uploads.
+    if (num_pending_ > 0) {
+        uint32_t start = (head_ + history_length_ - num_pending_) %
+                         history_length_;
+        uint32_t first = std::min(num_pending_, history_length_ - start);
+        uploadRows(start, first);
+        uploadRows(0, num_pending_ - first);
+        num_pending_ = 0;
+    }
+
+    ofPushMatrix();
+    ofPushStyle();
+    ofEnableAlphaBlending();
+    ofTranslate(x, y);
+
+    ofSetColor(background_color_);
+    ofFill();
+    ofDrawRectangle(0, 0, w, h);
+
+    // One quad for the whole history. The texture's rows are time steps and
+    // its columns dimensions, so the quad maps texture v to screen x, from
+    // the oldest row (head_) at the left to the newest at the right. v runs
+    // past 1 and GL_REPEAT wraps it back to the start of the ring. Rows not
+    // written yet are transparent.
+    float v0 = (float) head_ / history_length_;
+    ofMesh quad;
+    quad.setMode(OF_PRIMITIVE_TRIANGLE_STRIP);
+    quad.addVertex(ofPoint(0, h));
+    quad.addTexCoord(ofVec2f(0, v0));
+    quad.addVertex(ofPoint(0, 0));
+    quad.addTexCoord(ofVec2f(1, v0));
+    quad.addVertex(ofPoint(w, h));
+    quad.addTexCoord(ofVec2f(0, v0 + 1));
+    quad.addVertex(ofPoint(w, 0));
+    quad.addTexCoord(ofVec2f(1, v0 + 1));
+
+    ofSetColor(0xFF);
+    texture_.bind();
+    quad.draw();
+    texture_.unbind();
+
+    // Title and range
+    ofSetColor(text_color_);
+    int ofBitmapFontHeight = 14;
+    if (title_ != "") {
+        ofDrawBitmapString(title_, 10, ofBitmapFontHeight + 5);
+    }
+    if (has_range_) {
+        ofDrawBitmapString(ofToString(min_, 2) + " - " + ofToString(max_, 2),
+                           10, 2 * ofBitmapFontHeight + 5);
+    }
+
+    ofPopStyle();
+    ofPopMatrix();
+}
@@ -0,0 +1,95 @@
+/** @file spectrogram-plot.h
+ *  @brief SpectrogramPlot draws a scrolling heatmap of high-dimensional data.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "ofMain.h"
+
+using std::string;
+using std::vector;
+
+/**
+ *  @brief SpectrogramPlot shows the recent history of a vector-valued signal
+ *  (e.g. an FFT or a large sensor array) as a heatmap: time runs left to
+ *  right, dimension 0 is at the bottom, and each value is mapped to a color.
+ *
+ *  The history lives in a GPU texture used as a ring buffer, with one texture
+ *  row per time step. update() only colors the new vector into a CPU-side
+ *  copy of the ring; draw() uploads the rows written since the last draw
+ *  with at most two sub-texture updates and then draws a single quad whose
+ *  texture coordinates start at the oldest row and wrap around (GL_REPEAT).
+ *  The per-frame cost is therefore independent of the history length, and
+ *  no CPU work is spent on vertices for every value the way a line plot of
+ *  the same data would.
+ *
+ *  Colors are computed with the range in effect when the vector arrives;
+ *  vectors already in the history keep their colors when the range changes.
+ */
+class SpectrogramPlot {
+  public:
+    SpectrogramPlot() {}
+
+    /// @brief Allocate the ring for `history_length` vectors of
+    /// `num_dimensions` values each. Clears the history.
+    void setup(uint32_t history_length, uint32_t num_dimensions,
+               const string& title);
+
+    /// @brief Add a vector to the history. Vectors of the wrong size are
+    /// ignored.
+    void update(const vector<double>& data);
+
+    /// @brief Map [min, max] onto the colormap. Unless ranges are locked,
+    /// the range grows to include every value seen.
+    void setRanges(float min, float max, bool lock_ranges = false);
+    std::pair<float, float> getRanges() const {
+        return std::make_pair(min_, max_);
+    }
+
+    void setTitle(const string& title) { title_ = title; }
+    const string& getTitle() const { return title_; }
+
+    void clear();
+
+    void draw(uint32_t x, uint32_t y, uint32_t w, uint32_t h);
+
+    uint32_t getHistoryLength() const { return history_length_; }
+    uint32_t getNumDimensions() const { return num_dimensions_; }
+
+    /// @brief Bytes held by the CPU copy of the ring. The texture holds the
+    /// same amount again in GPU memory.
+    uint64_t getMemoryUsage() const { return pixels_.size(); }
+
+    void setBackgroundColor(ofColor color) { background_color_ = color; }
+    void setTextColor(ofColor color) { text_color_ = color; }
+
+  private:
+    void allocateTexture();
+    void uploadRows(uint32_t start, uint32_t count);
+
+    uint32_t history_length_ = 0;
+    uint32_t num_dimensions_ = 0;
+    string title_;
+
+    bool lock_ranges_ = false;
+    bool has_range_ = false;
+    float min_ = 0;
+    float max_ = 0;
+
+    // RGBA pixels, one row of `num_dimensions_` pixels per time step.
+    vector<unsigned char> pixels_;
+    // The row the next vector is written to, i.e. the oldest one.
+    uint32_t head_ = 0;
+    // Rows written since the last upload, ending just before head_.
+    uint32_t num_pending_ = 0;
+    uint32_t num_rows_ = 0;
+
+    ofTexture texture_;
+
+    ofColor background_color_ = ofColor(0, 0, 0);
+    ofColor text_color_ = ofColor(0xFF, 0xFF, 0xFF);
+};
@@ -0,0 +1,129 @@
+#include "task-scheduler.h"
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <chrono>
+
+typedef TaskScheduler::TaskHandle TaskHandle;
+typedef TaskScheduler::CancellationToken CancellationToken;
+
+TEST(TaskSchedulerTest, RunsEverything) {
+    TaskScheduler scheduler(4);
+    ASSERT_EQ(4, scheduler.getNumThreads());
+
+    std::atomic<int> count(0);
+    vector<TaskHandle> handles;
+    for (int i = 0; i < 1000; i++) {
+        handles.push_back(scheduler.submit(
+            TaskScheduler::Priority(i % TaskScheduler::kNumPriorities),
+            [&count] { count++; }));
+    }
+    for (const TaskHandle& handle : handles) handle.wait();
+    ASSERT_EQ(1000, count);
+    for (const TaskHandle& handle : handles) {
+        ASSERT_TRUE(handle.isDone());
+        ASSERT_FALSE(handle.wasCancelled());
+    }
+
+    // Waiting on a worker runs other tasks instead of blocking it, so tasks
+    // can wait for their own subtasks even on a single thread.
+    TaskScheduler single(1);
+    std::atomic<int> sum(0);
+    single.submit(TaskScheduler::kNormal, [&single, &sum] {
+        vector<TaskHandle> parts;
+        for (int i = 1; i <= 10; i++) {
+            parts.push_back(single.submit(TaskScheduler::kNormal,
+                                          [&sum, i] { sum += i; }));
+        }
+        for (const TaskHandle& part : parts) part.wait();
+    }).wait();
+    ASSERT_EQ(55, sum);
+}
+
+TEST(TaskSchedulerTest, Priorities) {
+    TaskScheduler scheduler(1);
+
+    // Hold the only worker so everything below queues up behind it.
+    std::atomic<bool> release(false);
+    TaskHandle blocker = scheduler.submit(TaskScheduler::kNormal, [&release] {
+        while (!release) std::this_thread::yield();
+    });
+    while (scheduler.getNumQueuedTasks() > 0) std::this_thread::yield();
+
+    std::mutex mutex;
+    vector<int> order;
+    auto record = [&mutex, &order](int i) {
+        return [&mutex, &order, i] {
+            std::lock_guard<std::mutex> lock(mutex);
+            order.push_back(i);
+        };
+    };
+    vector<TaskHandle> handles = {
+        scheduler.submit(TaskScheduler::kBulk, record(3)),
+        scheduler.submit(TaskScheduler::kNormal, record(2)),
+        scheduler.submit(TaskScheduler::kInteractive, record(1)),
+    };
+    release = true;
+    for (const TaskHandle& handle : handles) handle.wait();
+    ASSERT_EQ(vector<int>({1, 2, 3}), order);
+}
+
+TEST(TaskSchedulerTest, DependenciesAndCancellation) {
+    TaskScheduler scheduler(4);
+
+    std::atomic<int> stage(0);
+    TaskHandle first = scheduler.submit(TaskScheduler::kNormal, [&stage] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        stage = 1;
+    });
+    std::atomic<int> seen_by_second(-1), seen_by_third(-1);
+    TaskHandle second = scheduler.submit(TaskScheduler::kNormal,
+        [&] { seen_by_second = stage.load(); stage = 2; },
+        CancellationToken(), {first});
+    TaskHandle third = scheduler.submit(TaskScheduler::kInteractive,
+        [&] { seen_by_third = stage.load(); },
+        CancellationToken(), {second, TaskHandle()});
+    third.wait();
+    ASSERT_EQ(1, seen_by_second);
+    ASSERT_EQ(2, seen_by_third);
+
+    // A cancelled task is skipped, and so is everything that depends on it.
+    CancellationToken token;
+    std::atomic<bool> ran(false);
+    std::atomic<bool> release(false);
+    TaskHandle slow = scheduler.submit(TaskScheduler::kNormal, [&release] {
+        while (!release) std::this_thread::yield();
+    });
+    TaskHandle cancelled = scheduler.submit(TaskScheduler::kNormal,
+        [&ran] { ran = true; }, token, {slow});
+    TaskHandle dependent = scheduler.submit(TaskScheduler::kNormal,
+        [&ran] { ran = true; }, CancellationToken(), {cancelled});
+    token.cancel();
+    release = true;
+    dependent.wait();
+    ASSERT_FALSE(ran);
+    ASSERT_FALSE(slow.wasCancelled());
+    ASSERT_TRUE(cancelled.wasCancelled());
+    ASSERT_TRUE(dependent.wasCancelled());
+
+    // Depending on an already cancelled task skips right away.
+    TaskHandle late = scheduler.submit(TaskScheduler::kNormal,
+        [&ran] { ran = true; }, CancellationToken(), {cancelled});
+    late.wait();
+    ASSERT_FALSE(ran);
+    ASSERT_TRUE(late.wasCancelled());
+}
+
+TEST(TaskSchedulerTest, MainThreadTasks) {
+    TaskScheduler scheduler(2);
+    vector<int> order;
+    scheduler.submit(TaskScheduler::kNormal, [&scheduler, &order] {
+        scheduler.runOnMainThread([&order] { order.push_back(1); });
+        scheduler.runOnMainThread([&order] { order.push_back(2); });
+    }).wait();
+    ASSERT_TRUE(order.empty());
+    scheduler.runMainThreadTasks();
+    ASSERT_EQ(vector<int>({1, 2}), order);
+    scheduler.runMainThreadTasks();
+    ASSERT_EQ(2, order.size());
+}
@@ -0,0 +1,241 @@
+#include "task-scheduler.h"
+
+#include <algorithm>
+#include <chrono>
+
+struct TaskScheduler::Task {
+    TaskScheduler* scheduler;
+    Priority priority;
+    std::function<void()> fn;
+    CancellationToken token;
+
+    // Unfinished dependencies, plus one while submit() is still adding them.
+    std::atomic<uint32_t> remaining;
+    std::atomic<bool> dependency_cancelled;
+
+    std::mutex mutex;
+    std::condition_variable finished;
+    bool done = false;
+    bool cancelled = false;
+    vector<std::shared_ptr<Task>> successors;
+};
+
+// Which scheduler, and which of its workers, the current thread is.
+static thread_local const TaskScheduler* current_scheduler = nullptr;
+static thread_local int current_worker = -1;
+
+bool TaskScheduler::TaskHandle::isDone() const {
+    if (task_ == nullptr) return true;
+    std::lock_guard<std::mutex> lock(task_->mutex);
+    return task_->done;
+}
+
+bool TaskScheduler::TaskHandle::wasCancelled() const {
+    if (task_ == nullptr) return false;
+    std::lock_guard<std::mutex> lock(task_->mutex);
+    return task_->cancelled;
+}
+
+void TaskScheduler::TaskHandle::wait() const {
+    if (task_ == nullptr) return;
+
+    TaskScheduler* scheduler = task_->scheduler;
+    int index = scheduler->getWorkerIndex();
+    if (index >= 0) {
+        // Blocking a worker could deadlock the pool if the task we wait for
+        // is queued behind us, so help out instead.
+        while (!isDone()) {
+            std::shared_ptr<Task> task = scheduler->takeTask(index);
+            if (task != nullptr) {
+                scheduler->execute(task);
+            } else {
+                std::unique_lock<std::mutex> lock(task_->mutex);
+                task_->finished.wait_for(lock, std::chrono::milliseconds(1),
+                                         [this] { return task_->done; });
+            }
+        }
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock(task_->mutex);
+    task_->finished.wait(lock, [this] { return task_->done; });
+}
+
+TaskScheduler::TaskScheduler(uint32_t num_threads)
+        : next_worker_(0), num_queued_(0), stopping_(false) {
+    if (num_threads == 0) {
+        num_threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    for (uint32_t i = 0; i < num_threads; i++) {
+        workers_.emplace_back(new Worker());
+    }
+    // Start the threads only once every worker exists, since they steal
+    // from each other.
+    for (uint32_t i = 0; i < num_threads; i++) {
+        workers_[i]->thread = std::thread(&TaskScheduler::run, this, i);
+    }
+}
+
+TaskScheduler::~TaskScheduler() {
+    {
+        std::lock_guard<std::mutex> lock(sleep_mutex_);
+        stopping_ = true;
+    }
+    work_available_.notify_all();
+    for (auto& worker : workers_) worker->thread.join();
+
+    // Skip what's left, so that nobody waits for it forever.
+    for (auto& worker : workers_) {
+        for (auto& queue : worker->queues) {
+            while (!queue.empty()) {
+                std::shared_ptr<Task> task = queue.front();
+                queue.pop_front();
+                num_queued_--;
+                execute(task);
+            }
+        }
+    }
+}
+
+TaskScheduler& TaskScheduler::instance() {
+    static TaskScheduler scheduler;
+    return scheduler;
+}
+
+int TaskScheduler::getWorkerIndex() const {
+    return current_scheduler == this ? current_worker : -1;
+}
+
+TaskScheduler::TaskHandle TaskScheduler::submit(
+        Priority priority, std::function<void()> fn, CancellationToken token,
+        const vector<TaskHandle>& dependencies) {
+    std::shared_ptr<Task> task = std::make_shared<Task>();
+    task->scheduler = this;
+    task->priority = priority;
+    task->fn = fn;
+    task->token = token;
+    task->remaining = dependencies.size() + 1;
+    task->dependency_cancelled = false;
+
+    for (const TaskHandle& dependency : dependencies) {
+        Task* d = dependency.task_.get();
+        if (d == nullptr) {
+            task->remaining--;
+            continue;
+        }
+        std::lock_guard<std::mutex> lock(d->mutex);
+        if (d->done) {
+            if (d->cancelled) task->dependency_cancelled = true;
+            task->remaining--;
+        } else {
+            d->successors.push_back(task);
+        }
+    }
+    if (--task->remaining == 0) enqueue(task);
+    return TaskHandle(task);
+}
+
+void TaskScheduler::enqueue(std::shared_ptr<Task> task) {
+    if (stopping_) {
+        execute(task);  // skips it
+        return;
+    }
+
+    int index = getWorkerIndex();
+    if (index < 0) index = next_worker_++ % workers_.size();
+    // Count the task before it can be taken, so the count never goes
+    // negative; a worker may spin briefly until the push below.
+    num_queued_++;
+    {
+        Worker& worker = *workers_[index];
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        worker.queues[task->priority].push_back(task);
+    }
+    {
+        // Taking the lock orders this with a worker that is about to sleep.
+        std::lock_guard<std::mutex> lock(sleep_mutex_);
+    }
+    work_available_.notify_one();
+}
+
+std::shared_ptr<TaskScheduler::Task> TaskScheduler::takeTask(uint32_t index) {
+    const uint32_t n = workers_.size();
+    for (int p = 0; p < kNumPriorities; p++) {
+        // Newest first from our own queue...
+        {
+            Worker& worker = *workers_[index];
+            std::lock_guard<std::mutex> lock(worker.mutex);
+            if (!worker.queues[p].empty()) {
+                std::shared_ptr<Task> task = worker.queues[p].back();
+                worker.queues[p].pop_back();
+                num_queued_--;
+                return task;
+            }
+        }
+        // ...then oldest first from the others.
+        for (uint32_t k = 1; k < n; k++) {
+            Worker& victim = *workers_[(index + k) % n];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (!victim.queues[p].empty()) {
+                std::shared_ptr<Task> task = victim.queues[p].front();
+                victim.queues[p].pop_front();
+                num_queued_--;
+                return task;
+            }
+        }
+    }
+    return nullptr;
+}
+
+void TaskScheduler::execute(std::shared_ptr<Task> task) {
+    bool skip = stopping_ || task->token.isCancelled() ||
+                task->dependency_cancelled;
+    if (!skip) task->fn();
+    task->fn = nullptr;  // release whatever it captured
+
+    vector<std::shared_ptr<Task>> successors;
+    {
+        std::lock_guard<std::mutex> lock(task->mutex);
+        task->done = true;
+        task->cancelled = skip;
+        successors.swap(task->successors);
+    }
+    task->finished.notify_all();
+
+    for (auto& successor : successors) {
+        if (skip) successor->dependency_cancelled = true;
+        if (--successor->remaining == 0) enqueue(successor);
+    }
+}
+
+void TaskScheduler::run(uint32_t index) {
+    current_scheduler = this;
+    current_worker = index;
+    while (true) {
+        std::shared_ptr<Task> task = takeTask(index);
+        if (task != nullptr) {
+            execute(task);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(sleep_mutex_);
+        work_available_.wait(lock, [this] {
+            return stopping_ || num_queued_ > 0;
+        });
+        if (stopping_) return;
+    }
+}
+
+void TaskScheduler::runOnMainThread(std::function<void()> fn) {
+    std::lock_guard<std::mutex> lock(main_thread_mutex_);
+    main_thread_tasks_.push_back(fn);
+}
+
+void TaskScheduler::runMainThreadTasks() {
+    vector<std::function<void()>> tasks;
+    {
+        std::lock_guard<std::mutex> lock(main_thread_mutex_);
+        tasks.swap(main_thread_tasks_);
+    }
+    for (auto& fn : tasks) fn();
+}
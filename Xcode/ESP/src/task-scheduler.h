@@ -0,0 +1,142 @@
+/** @file task-scheduler.h
+ *  @brief TaskScheduler runs ESP's background work (training, scoring,
+ *  feature computation, imports) on a shared pool of threads.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using std::vector;
+
+/**
+ *  @brief TaskScheduler is a work-stealing thread pool with three priority
+ *  classes.
+ *
+ *  Each worker has its own queue per priority. Tasks submitted from a worker
+ *  go to the back of that worker's queue and are taken from the back (so a
+ *  task's subtasks run while their data is still in cache); tasks submitted
+ *  from other threads are spread over the workers. A worker that runs out of
+ *  work steals from the front of the other workers' queues. Priority comes
+ *  first: a worker runs any kInteractive task, its own or stolen, before a
+ *  kNormal one, and any kNormal task before a kBulk one. Running tasks are
+ *  never preempted.
+ *
+ *  A task may depend on other tasks, and then starts only after all of them
+ *  have finished. Tasks can be cancelled with a CancellationToken: a task
+ *  whose token is cancelled before it starts is skipped, and so is every
+ *  task that depends on a skipped task. Long tasks should also check
+ *  isCancelled() as they go.
+ *
+ *  Results meant for the GUI are handed back with runOnMainThread(); ofApp
+ *  calls runMainThreadTasks() once per frame.
+ */
+class TaskScheduler {
+  public:
+    enum Priority {
+        kInteractive = 0,  // the user is waiting, e.g. features of a sample
+                           // that is on screen
+        kNormal,           // e.g. training and scoring
+        kBulk,             // e.g. test set evaluation, parameter sweeps
+    };
+    static const int kNumPriorities = 3;
+
+    /// @brief Shared cancellation flag. Copies refer to the same flag.
+    class CancellationToken {
+      public:
+        CancellationToken()
+            : cancelled_(std::make_shared<std::atomic<bool>>(false)) {}
+        void cancel() { *cancelled_ = true; }
+        bool isCancelled() const { return *cancelled_; }
+
+      private:
+        std::shared_ptr<std::atomic<bool>> cancelled_;
+    };
+
+    struct Task;
+
+    /// @brief Refers to a submitted task. A default-constructed handle refers
+    /// to no task and counts as done.
+    class TaskHandle {
+      public:
+        TaskHandle() {}
+
+        bool isValid() const { return task_ != nullptr; }
+
+        /// @brief Whether the task has run or was skipped.
+        bool isDone() const;
+
+        /// @brief Whether the task was skipped because it or one of its
+        /// dependencies was cancelled.
+        bool wasCancelled() const;
+
+        /// @brief Block until the task is done. On a worker thread, other
+        /// tasks are run while waiting.
+        void wait() const;
+
+      private:
+        friend class TaskScheduler;
+        explicit TaskHandle(std::shared_ptr<Task> task) : task_(task) {}
+        std::shared_ptr<Task> task_;
+    };
+
+    /// @brief Start `num_threads` workers; zero for one per hardware thread.
+    explicit TaskScheduler(uint32_t num_threads = 0);
+
+    /// @brief Tasks that haven't started are skipped; running ones finish.
+    ~TaskScheduler();
+
+    /// @brief The scheduler shared by ESP.
+    static TaskScheduler& instance();
+
+    /// @brief Run `fn` on a worker once all `dependencies` are done, unless
+    /// `token` is cancelled first.
+    TaskHandle submit(Priority priority, std::function<void()> fn,
+                      CancellationToken token = CancellationToken(),
+                      const vector<TaskHandle>& dependencies = {});
+
+    /// @brief Queue `fn` for the next runMainThreadTasks().
+    void runOnMainThread(std::function<void()> fn);
+
+    /// @brief Run the functions queued with runOnMainThread(), in order.
+    void runMainThreadTasks();
+
+    uint32_t getNumThreads() const { return workers_.size(); }
+
+    /// @brief Number of tasks queued and not yet started.
+    uint32_t getNumQueuedTasks() const { return num_queued_; }
+
+  private:
+    struct Worker {
+        std::mutex mutex;
+        std::deque<std::shared_ptr<Task>> queues[kNumPriorities];
+        std::thread thread;
+    };
+
+    void run(uint32_t index);
+    // Take the most urgent task, preferring worker `index`'s own queues.
+    std::shared_ptr<Task> takeTask(uint32_t index);
+    // Run (or skip) the task and release the tasks that depend on it.
+    void execute(std::shared_ptr<Task> task);
+    void enqueue(std::shared_ptr<Task> task);
+    // The index of the calling worker thread of this scheduler, or -1.
+    int getWorkerIndex() const;
+
+    vector<std::unique_ptr<Worker>> workers_;
+    std::atomic<uint32_t> next_worker_;
+    std::atomic<uint32_t> num_queued_;
+    std::atomic<bool> stopping_;
+    std::mutex sleep_mutex_;
+    std::condition_variable work_available_;
+
+    std::mutex main_thread_mutex_;
+    vector<std::function<void()>> main_thread_tasks_;
+};
@@ -0,0 +1,118 @@
+#include "template-condenser.h"
+#include "gtest/gtest.h"
+
+#include <map>
+
+// Samples of `label` whose single dimension is a ramp starting at `offset`.
+// Their lengths vary, which resampling to a common shape undoes.
+static void addSamples(GRT::TimeSeriesClassificationData& data, uint32_t label,
+                       double offset, const vector<double>& jitters) {
+    for (uint32_t i = 0; i < jitters.size(); i++) {
+        GRT::MatrixDouble sample(8 + i % 3, 1);
+        for (uint32_t r = 0; r < sample.getNumRows(); r++) {
+            sample[r][0] = offset + jitters[i] +
+                           double(r) / (sample.getNumRows() - 1);
+        }
+        data.addSample(label, sample);
+    }
+}
+
+// Three clusters per class, at offsets 0, 10 and 20 (plus 100 for class 2).
+// Within each cluster, the sample with no jitter is the most central one.
+static GRT::TimeSeriesClassificationData clusteredData() {
+    GRT::TimeSeriesClassificationData data;
+    data.setNumDimensions(1);
+    for (uint32_t label = 1; label <= 2; label++) {
+        for (double offset : { 0, 10, 20 }) {
+            addSamples(data, label, offset + 100 * (label - 1),
+                       { -0.2, -0.1, 0, 0.1, 0.2 });
+        }
+    }
+    return data;
+}
+
+static std::map<uint32_t, uint32_t> countPerLabel(
+    const GRT::TimeSeriesClassificationData& data,
+    const vector<uint32_t>& selected) {
+    auto samples = data.getData();
+    std::map<uint32_t, uint32_t> counts;
+    for (uint32_t i : selected) counts[samples[i].getClassLabel()]++;
+    return counts;
+}
+
+TEST(TemplateCondenserTest, DisabledKeepsEverything) {
+    GRT::TimeSeriesClassificationData data = clusteredData();
+    TemplateCondenser condenser;
+    ASSERT_FALSE(condenser.isEnabled());
+
+    vector<uint32_t> selected = condenser.select(data);
+    ASSERT_EQ(data.getNumSamples(), selected.size());
+    for (uint32_t i = 0; i < selected.size(); i++) ASSERT_EQ(i, selected[i]);
+    ASSERT_EQ(data.getNumSamples(), condenser.condense(data).getNumSamples());
+}
+
+TEST(TemplateCondenserTest, CapsTemplatesPerClass) {
+    GRT::TimeSeriesClassificationData data = clusteredData();
+    for (auto method : { TemplateCondenser::Method::kMedoids,
+                         TemplateCondenser::Method::kCondensedNearestNeighbour }) {
+        for (uint32_t cap : { 1, 2, 4 }) {
+            TemplateCondenser condenser(cap, method);
+            vector<uint32_t> selected = condenser.select(data);
+            std::map<uint32_t, uint32_t> counts = countPerLabel(data, selected);
+
+            // Every class is represented, by at most `cap` templates.
+            ASSERT_EQ(2, counts.size());
+            for (const auto& entry : counts) {
+                ASSERT_GE(entry.second, 1);
+                ASSERT_LE(entry.second, cap);
+            }
+            ASSERT_TRUE(std::is_sorted(selected.begin(), selected.end()));
+        }
+    }
+
+    // A class with fewer samples than the cap is kept whole.
+    TemplateCondenser condenser(100);
+    ASSERT_EQ(data.getNumSamples(), condenser.select(data).size());
+}
+
+TEST(TemplateCondenserTest, KeepsOneMedoidPerCluster) {
+    GRT::TimeSeriesClassificationData data = clusteredData();
+    auto samples = data.getData();
+
+    // The no-jitter sample of each cluster: 2, 7 and 12 for class 1, and
+    // 17, 22 and 27 for class 2.
+    TemplateCondenser condenser(3);
+    ASSERT_EQ(vector<uint32_t>({ 2, 7, 12, 17, 22, 27 }),
+              condenser.select(data));
+
+    // With a single template, it's the center of the middle cluster.
+    condenser.setMaxTemplatesPerClass(1);
+    ASSERT_EQ(vector<uint32_t>({ 7, 22 }), condenser.select(data));
+
+    GRT::TimeSeriesClassificationData condensed = condenser.condense(data);
+    ASSERT_EQ(2, condensed.getNumSamples());
+    ASSERT_EQ(1, condensed[0].getClassLabel());
+    ASSERT_EQ(2, condensed[1].getClassLabel());
+    ASSERT_EQ(samples[7].getData().getNumRows(),
+              condensed[0].getData().getNumRows());
+    ASSERT_EQ(samples[7].getData()[0][0], condensed[0].getData()[0][0]);
+}
+
+TEST(TemplateCondenserTest, CondensedNearestNeighbourAddsOnlyWhatIsNeeded) {
+    // Classes far apart: their medoids alone classify every sample correctly.
+    GRT::TimeSeriesClassificationData data = clusteredData();
+    TemplateCondenser condenser(
+        10, TemplateCondenser::Method::kCondensedNearestNeighbour);
+    ASSERT_EQ(vector<uint32_t>({ 7, 22 }), condenser.select(data));
+
+    // A stray sample of class 2 lies among class 1's: the medoids misclassify
+    // it, so it's added. (It also pulls class 2's medoid, which minimizes the
+    // summed squared distance, to the edge of its cluster: sample 5.)
+    GRT::TimeSeriesClassificationData overlapping;
+    overlapping.setNumDimensions(1);
+    addSamples(overlapping, 1, 0, { -0.2, -0.1, 0, 0.1, 0.2 });
+    addSamples(overlapping, 2, 100, { -0.2, -0.1, 0, 0.1, 0.2 });
+    addSamples(overlapping, 2, 0.5, { 0 });
+    vector<uint32_t> selected = condenser.select(overlapping);
+    ASSERT_EQ(vector<uint32_t>({ 2, 5, 10 }), selected);
+}
@@ -0,0 +1,306 @@
+#include "template-condenser.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <limits>
+#include <map>
+#include <sstream>
+
+#include "cross-validation.h"
+
+// Number of rows every sample is resampled to before comparing shapes.
+static const uint32_t kShapeLength = 32;
+
+// Upper bound on k-medoids refinement rounds; it usually converges in a few.
+static const uint32_t kMaxMedoidIterations = 10;
+
+namespace {
+
+// Linearly resample `m` to kShapeLength rows and flatten it.
+vector<double> toShape(const GRT::MatrixDouble& m) {
+    const uint32_t rows = m.getNumRows(), cols = m.getNumCols();
+    vector<double> shape(kShapeLength * cols, 0.0);
+    if (rows == 0) return shape;
+
+    for (uint32_t j = 0; j < kShapeLength; j++) {
+        double t = rows == 1 ? 0.0 : double(j) * (rows - 1) / (kShapeLength - 1);
+        uint32_t i = std::min(static_cast<uint32_t>(t), rows - 1);
+        uint32_t next = std::min(i + 1, rows - 1);
+        double frac = t - i;
+        for (uint32_t c = 0; c < cols; c++) {
+            shape[j * cols + c] = m[i][c] * (1 - frac) + m[next][c] * frac;
+        }
+    }
+    return shape;
+}
+
+double distance(const vector<double>& a, const vector<double>& b) {
+    double sum = 0.0;
+    for (size_t i = 0; i < a.size(); i++) {
+        double d = a[i] - b[i];
+        sum += d * d;
+    }
+    return sum;
+}
+
+// Index (into `members`) of the member with the smallest total distance to
+// the other members.
+uint32_t medoidOf(const vector<uint32_t>& members,
+                  const vector<vector<double>>& dist) {
+    uint32_t best = 0;
+    double best_sum = std::numeric_limits<double>::max();
+    for (uint32_t i = 0; i < members.size(); i++) {
+        double sum = 0.0;
+        for (uint32_t j : members) sum += dist[members[i]][j];
+        if (sum < best_sum) {
+            best_sum = sum;
+            best = i;
+        }
+    }
+    return best;
+}
+
+// k-medoids over `shapes`, returning the indices of the k medoids.
+vector<uint32_t> kMedoids(const vector<vector<double>>& shapes, uint32_t k) {
+    const uint32_t n = shapes.size();
+    vector<vector<double>> dist(n, vector<double>(n, 0.0));
+    for (uint32_t i = 0; i < n; i++) {
+        for (uint32_t j = i + 1; j < n; j++) {
+            dist[i][j] = dist[j][i] = distance(shapes[i], shapes[j]);
+        }
+    }
+
+    vector<uint32_t> all(n);
+    for (uint32_t i = 0; i < n; i++) all[i] = i;
+
+    // Deterministic farthest-first initialization, seeded with the medoid of
+    // the whole class.
+    vector<uint32_t> medoids = {medoidOf(all, dist)};
+    vector<double> nearest(n);
+    for (uint32_t i = 0; i < n; i++) nearest[i] = dist[i][medoids[0]];
+    while (medoids.size() < k) {
+        uint32_t farthest = std::max_element(nearest.begin(), nearest.end()) -
+                            nearest.begin();
+        medoids.push_back(farthest);
+        for (uint32_t i = 0; i < n; i++) {
+            nearest[i] = std::min(nearest[i], dist[i][farthest]);
+        }
+    }
+
+    // Alternate between assigning samples to the closest medoid and moving
+    // each medoid to the center of its cluster.
+    for (uint32_t iter = 0; iter < kMaxMedoidIterations; iter++) {
+        vector<vector<uint32_t>> clusters(k);
+        for (uint32_t i = 0; i < n; i++) {
+            uint32_t c = 0;
+            for (uint32_t m = 1; m < k; m++) {
+                if (dist[i][medoids[m]] < dist[i][medoids[c]]) c = m;
+            }
+            clusters[c].push_back(i);
+        }
+
+        bool changed = false;
+        for (uint32_t m = 0; m < k; m++) {
+            if (clusters[m].empty()) continue;
+            uint32_t medoid = clusters[m][medoidOf(clusters[m], dist)];
+            if (medoid != medoids[m]) {
+                medoids[m] = medoid;
+                changed = true;
+            }
+        }
+        if (!changed) break;
+    }
+
+    std::sort(medoids.begin(), medoids.end());
+    medoids.erase(std::unique(medoids.begin(), medoids.end()), medoids.end());
+    return medoids;
+}
+
+}  // namespace
+
+TemplateCondenser::TemplateCondenser(uint32_t max_templates_per_class,
+                                     Method method)
+        : max_templates_per_class_(max_templates_per_class), method_(method) {
+}
+
+vector<uint32_t> TemplateCondenser::select(
+    const GRT::TimeSeriesClassificationData& data) const {
+    auto samples = data.getData();
+    const uint32_t num_samples = samples.size();
+
+    vector<uint32_t> selected;
+    if (!isEnabled()) {
+        for (uint32_t i = 0; i < num_samples; i++) selected.push_back(i);
+        return selected;
+    }
+
+    std::map<uint32_t, vector<uint32_t>> by_label;
+    vector<vector<double>> shapes(num_samples);
+    for (uint32_t i = 0; i < num_samples; i++) {
+        by_label[samples[i].getClassLabel()].push_back(i);
+        shapes[i] = toShape(samples[i].getData());
+    }
+
+    if (method_ == Method::kMedoids) {
+        for (const auto& entry : by_label) {
+            const vector<uint32_t>& members = entry.second;
+            if (members.size() <= max_templates_per_class_) {
+                selected.insert(selected.end(), members.begin(), members.end());
+                continue;
+            }
+            vector<vector<double>> class_shapes;
+            for (uint32_t i : members) class_shapes.push_back(shapes[i]);
+            for (uint32_t m : kMedoids(class_shapes, max_templates_per_class_)) {
+                selected.push_back(members[m]);
+            }
+        }
+    } else {
+        // Hart's condensed nearest neighbour, seeded with one medoid per class
+        // so that every class is represented.
+        std::map<uint32_t, uint32_t> kept_per_label;
+        vector<bool> kept(num_samples, false);
+        for (const auto& entry : by_label) {
+            vector<vector<double>> class_shapes;
+            for (uint32_t i : entry.second) class_shapes.push_back(shapes[i]);
+            uint32_t medoid = entry.second[kMedoids(class_shapes, 1)[0]];
+            kept[medoid] = true;
+            kept_per_label[entry.first] = 1;
+        }
+
+        bool added = true;
+        while (added) {
+            added = false;
+            for (uint32_t i = 0; i < num_samples; i++) {
+                uint32_t label = samples[i].getClassLabel();
+                if (kept[i] || kept_per_label[label] >= max_templates_per_class_) {
+                    continue;
+                }
+                uint32_t nearest = i;
+                double nearest_dist = std::numeric_limits<double>::max();
+                for (uint32_t j = 0; j < num_samples; j++) {
+                    if (!kept[j]) continue;
+                    double d = distance(shapes[i], shapes[j]);
+                    if (d < nearest_dist) {
+                        nearest_dist = d;
+                        nearest = j;
+                    }
+                }
+                if (samples[nearest].getClassLabel() != label) {
+                    kept[i] = true;
+                    kept_per_label[label]++;
+                    added = true;
+                }
+            }
+        }
+        for (uint32_t i = 0; i < num_samples; i++) {
+            if (kept[i]) selected.push_back(i);
+        }
+    }
+
+    std::sort(selected.begin(), selected.end());
+    return selected;
+}
+
+GRT::TimeSeriesClassificationData TemplateCondenser::condense(
+    const GRT::TimeSeriesClassificationData& data) const {
+    if (!isEnabled()) return data;
+
+    auto samples = data.getData();
+    GRT::TimeSeriesClassificationData condensed;
+    condensed.setNumDimensions(data.getNumDimensions());
+    condensed.setDatasetName(data.getDatasetName());
+    for (uint32_t i : select(data)) {
+        condensed.addSample(samples[i].getClassLabel(), samples[i].getData());
+    }
+    return condensed;
+}
+
+vector<TemplateCondenser::Result> TemplateCondenser::crossValidate(
+    const GRT::GestureRecognitionPipeline& pipeline,
+    const GRT::TimeSeriesClassificationData& data,
+    const vector<uint32_t>& max_templates_per_class,
+    uint32_t num_folds) const {
+    CrossValidation folds(data, num_folds);
+    num_folds = folds.getNumFolds();
+
+    struct FoldResult {
+        uint32_t num_templates = 0;
+        uint32_t num_correct = 0;
+        uint32_t num_tested = 0;
+        uint32_t num_frames = 0;
+        double training_ms = 0.0;
+        double prediction_us = 0.0;
+    };
+    const uint32_t num_jobs = max_templates_per_class.size() * num_folds;
+    vector<FoldResult> fold_results(num_jobs);
+
+    CrossValidation::runJobs(num_jobs, [&](uint32_t job) {
+        uint32_t fold = job % num_folds;
+        TemplateCondenser condenser(max_templates_per_class[job / num_folds],
+                                    method_);
+
+        using Clock = std::chrono::steady_clock;
+        FoldResult& result = fold_results[job];
+        GRT::GestureRecognitionPipeline p(pipeline);
+
+        auto start = Clock::now();
+        GRT::TimeSeriesClassificationData train =
+            condenser.condense(folds.getTrainingData(fold));
+        result.num_templates = train.getNumSamples();
+        if (!p.train(train)) return;
+        result.training_ms = std::chrono::duration<double, std::milli>(
+            Clock::now() - start).count();
+
+        for (const auto& sample : folds.getTestSamples(fold)) {
+            start = Clock::now();
+            uint32_t predicted = CrossValidation::classify(p, sample.getData());
+            result.prediction_us += std::chrono::duration<double, std::micro>(
+                Clock::now() - start).count();
+            result.num_frames += sample.getData().getNumRows();
+            result.num_tested++;
+            if (predicted == sample.getClassLabel()) result.num_correct++;
+        }
+    });
+
+    vector<Result> results;
+    for (uint32_t c = 0; c < max_templates_per_class.size(); c++) {
+        Result r = { max_templates_per_class[c], 0, 0, 0, 0 };
+        uint32_t correct = 0, tested = 0, frames = 0;
+        double prediction_us = 0;
+        for (uint32_t f = 0; f < num_folds; f++) {
+            const FoldResult& fr = fold_results[c * num_folds + f];
+            r.num_templates += double(fr.num_templates) / num_folds;
+            r.training_ms += fr.training_ms / num_folds;
+            correct += fr.num_correct;
+            tested += fr.num_tested;
+            frames += fr.num_frames;
+            prediction_us += fr.prediction_us;
+        }
+        r.accuracy = tested == 0 ? 0 : double(correct) / tested;
+        r.prediction_us = frames == 0 ? 0 : prediction_us / frames;
+        results.push_back(r);
+    }
+    return results;
+}
+
+std::string TemplateCondenser::formatResults(const vector<Result>& results) {
+    std::ostringstream ss;
+    ss << std::setw(10) << "max/class" << std::setw(11) << "templates"
+       << std::setw(10) << "accuracy" << std::setw(13) << "train (ms)"
+       << std::setw(17) << "predict (us/fr)" << std::endl;
+    ss << std::fixed;
+    for (const Result& r : results) {
+        if (r.max_templates_per_class == 0) {
+            ss << std::setw(10) << "all";
+        } else {
+            ss << std::setw(10) << r.max_templates_per_class;
+        }
+        ss << std::setprecision(1) << std::setw(11) << r.num_templates
+           << std::setprecision(3) << std::setw(10) << r.accuracy
+           << std::setprecision(1) << std::setw(13) << r.training_ms
+           << std::setprecision(2) << std::setw(17) << r.prediction_us
+           << std::endl;
+    }
+    return ss.str();
+}
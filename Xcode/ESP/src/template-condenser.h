@@ -0,0 +1,87 @@
+/** @file template-condenser.h
+ *  @brief TemplateCondenser selects a few representative training samples
+ *  (templates) per class before the classifier is trained.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <GRT/GRT.h>
+
+using std::vector;
+
+/**
+ *  @brief TemplateCondenser reduces the number of training samples per class
+ *  to at most `max_templates_per_class`.
+ *
+ *  Template-based classifiers (DTW, KNN) do work proportional to the number
+ *  of stored samples: GRT's DTW compares every pair of samples of a class when
+ *  picking its template, and leave-one-out scoring retrains once per sample.
+ *  Users often record 30 or more samples per class, most of them near
+ *  duplicates, so keeping a handful of prototypes is much cheaper and rarely
+ *  less accurate.
+ *
+ *  Samples are compared with a cheap shape distance: each sample is linearly
+ *  resampled to a fixed number of rows and the Euclidean distance between the
+ *  resampled samples is used. Two selection methods are available:
+ *    1. kMedoids: cluster the samples of each class with k-medoids and keep
+ *       the medoid of each cluster.
+ *    2. kCondensedNearestNeighbour: start with the medoid of each class and
+ *       add samples that the kept ones misclassify (Hart's CNN), up to the
+ *       cap.
+ */
+class TemplateCondenser {
+  public:
+    enum class Method {
+        kMedoids,
+        kCondensedNearestNeighbour,
+    };
+
+    /// @brief A zero `max_templates_per_class` disables condensation.
+    TemplateCondenser(uint32_t max_templates_per_class = 0,
+                      Method method = Method::kMedoids);
+
+    void setMaxTemplatesPerClass(uint32_t n) { max_templates_per_class_ = n; }
+    uint32_t getMaxTemplatesPerClass() const { return max_templates_per_class_; }
+
+    void setMethod(Method method) { method_ = method; }
+    Method getMethod() const { return method_; }
+
+    bool isEnabled() const { return max_templates_per_class_ > 0; }
+
+    /// @brief Return the indices (into `data`) of the samples to keep, in
+    /// increasing order. All indices are returned when disabled.
+    vector<uint32_t> select(const GRT::TimeSeriesClassificationData& data) const;
+
+    /// @brief Return a copy of `data` holding only the selected samples.
+    GRT::TimeSeriesClassificationData condense(
+        const GRT::TimeSeriesClassificationData& data) const;
+
+    /// @brief One row of the accuracy-versus-speed report.
+    struct Result {
+        uint32_t max_templates_per_class;  // 0 means all samples were kept
+        double num_templates;              // average over folds
+        double accuracy;                   // fraction of test samples correct
+        double training_ms;                // average per fold
+        double prediction_us;              // average per predicted frame
+    };
+
+    /// @brief Cross-validate `pipeline` on `data` for each cap in
+    /// `max_templates_per_class` (0 stands for no condensation), on the folds
+    /// of CrossValidation; (cap, fold) pairs run in parallel on copies of the
+    /// pipeline.
+    vector<Result> crossValidate(
+        const GRT::GestureRecognitionPipeline& pipeline,
+        const GRT::TimeSeriesClassificationData& data,
+        const vector<uint32_t>& max_templates_per_class,
+        uint32_t num_folds = 5) const;
+
+    /// @brief Format the output of crossValidate() as a table.
+    static std::string formatResults(const vector<Result>& results);
+
+  private:
+    uint32_t max_templates_per_class_;
+    Method method_;
+};
@@ -90,6 +90,60 @@ TEST_F(TrainingDataManagerTest, TestTrimSample) {
     ASSERT_EQ(4, new_sample[2][0]);
 }
 
+TEST_F(TrainingDataManagerTest, TestUntrimSample) {
+    uint32_t num_point = 10;
+    GRT::MatrixDouble sample(num_point, kSampleDim);
+    for (uint32_t i = 0; i < num_point; i++) {
+        sample[i][0] = i;
+    }
+    manager->addSample(1, sample);
+
+    // Trimming twice narrows the range relative to the trimmed sample:
+    // [0, ..., 9] -> [2, ..., 7] -> [3, 4]
+    ASSERT_TRUE(manager->trimSample(1, 3, 2, 7));
+    ASSERT_TRUE(manager->trimSample(1, 3, 1, 2));
+    GRT::MatrixDouble trimmed = manager->getSample(1, 3);
+    ASSERT_EQ(2, trimmed.getNumRows());
+    ASSERT_EQ(3, trimmed[0][0]);
+    ASSERT_EQ(4, trimmed[1][0]);
+
+    // Out-of-range trimming is rejected.
+    ASSERT_FALSE(manager->trimSample(1, 3, 0, 2));
+
+    // The recorded data is still all there.
+    ASSERT_EQ(num_point, manager->getUntrimmedSample(1, 3).getNumRows());
+    ASSERT_TRUE(manager->untrimSample(1, 3));
+    ASSERT_EQ(num_point, manager->getSample(1, 3).getNumRows());
+}
+
+TEST_F(TrainingDataManagerTest, TestGetAllDataAppliesTrimAndLength) {
+    uint32_t num_point = 10;
+    GRT::MatrixDouble sample(num_point, kSampleDim);
+    for (uint32_t i = 0; i < num_point; i++) {
+        sample[i][0] = i;
+    }
+    manager->addSample(3, sample);
+    manager->trimSample(3, 0, 4, 8);
+
+    GRT::TimeSeriesClassificationData data = manager->getAllData();
+    GRT::MatrixDouble trimmed = data.getClassData(3)[0].getData();
+    ASSERT_EQ(5, trimmed.getNumRows());
+    ASSERT_EQ(4, trimmed[0][0]);
+
+    // Resampling the trimmed [4, ..., 8] to 3 rows gives [4, 6, 8].
+    manager->setTargetSampleLength(3);
+    data = manager->getAllData();
+    GRT::MatrixDouble resampled = data.getClassData(3)[0].getData();
+    ASSERT_EQ(3, resampled.getNumRows());
+    ASSERT_EQ(4, resampled[0][0]);
+    ASSERT_EQ(6, resampled[1][0]);
+    ASSERT_EQ(8, resampled[2][0]);
+
+    // Single-row samples are stretched too.
+    ASSERT_EQ(3, data.getClassData(1)[0].getData().getNumRows());
+    ASSERT_EQ(1, data.getClassData(1)[0].getData()[2][0]);
+}
+
 TEST_F(TrainingDataManagerTest, TestRelabelSample) {
     // Relabel label 1 index 1 (the middle sample) to 2
     // We are expecting the following change
@@ -105,6 +159,25 @@ TEST_F(TrainingDataManagerTest, TestRelabelSample) {
     ASSERT_EQ(2, manager->getSample(2, 1)[0][0]);
 }
 
+TEST_F(TrainingDataManagerTest, TestVersion) {
+    // Changes to the samples bump the version, names and scores don't.
+    uint64_t version = manager->getVersion();
+    manager->setSampleName(1, 0, "first");
+    manager->setSampleScore(1, 0, 1.0);
+    ASSERT_EQ(version, manager->getVersion());
+
+    manager->trimSample(1, 0, 0, 0);
+    ASSERT_NE(version, manager->getVersion());
+    version = manager->getVersion();
+
+    manager->relabelSample(1, 0, 3);
+    ASSERT_NE(version, manager->getVersion());
+    version = manager->getVersion();
+
+    manager->deleteSample(3, 0);
+    ASSERT_NE(version, manager->getVersion());
+}
+
 TEST_F(TrainingDataManagerTest, TestAssignName) {
     // Default name
     ASSERT_STREQ("Label 1 [1]", manager->getSampleName(1, 1).c_str());
@@ -178,3 +251,18 @@ TEST_F(TrainingDataManagerTest, TestSaveLoad) {
     ASSERT_STREQ("Label 1 [1]", manager->getSampleName(1, 1).c_str());
     ASSERT_STREQ("Special 2 [0]", manager->getSampleName(2, 0).c_str());
 }
+
+TEST_F(TrainingDataManagerTest, TestMemoryUsage) {
+    // Four one-row samples (see TrainingDataManagerTest::SetUp()).
+    ASSERT_EQ(4 * kSampleDim * sizeof(double),
+              manager->getSampleMemoryUsage());
+
+    manager->deleteSample(1, 0);
+    ASSERT_EQ(3 * kSampleDim * sizeof(double),
+              manager->getSampleMemoryUsage());
+
+    uint64_t scores = manager->getScoreMemoryUsage();
+    manager->setSampleClassLikelihoods(1, 0, vector<double>(kNumClasses));
+    ASSERT_GE(manager->getScoreMemoryUsage(),
+              scores + kNumClasses * sizeof(double));
+}
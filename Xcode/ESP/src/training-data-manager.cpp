@@ -1,5 +1,6 @@
 #include "training-data-manager.h"
 
+#include <algorithm>
 #include <sstream>
 
 const char kDefaultTrainingDataName[] = "Default";
@@ -19,6 +20,7 @@ TrainingDataManager::TrainingDataManager(uint32_t num_classes)
     training_sample_names_.resize(num_classes + 1);
     training_sample_scores_.resize(num_classes + 1);
     training_sample_class_likelihoods_.resize(num_classes + 1);
+    training_sample_ranges_.resize(num_classes + 1);
     num_samples_per_label_.resize(num_classes + 1, 0);
 
     for (uint32_t i = 0; i <= num_classes; i++) {
@@ -75,7 +77,10 @@ bool TrainingDataManager::addSample(
             std::make_pair(false, std::string()));
         training_sample_scores_[label].push_back(std::make_pair(false, 0.0));
         training_sample_class_likelihoods_[label].push_back(std::make_pair(false, std::vector<double>()));
+        training_sample_ranges_[label].push_back(
+            Range(0, sample.getNumRows()));
         num_samples_per_label_[label]++;
+        version_++;
 
         return true;
     }
@@ -95,12 +100,78 @@ bool TrainingDataManager::setNameForLabel(const std::string name, uint32_t label
     return true;
 }
 
+// Copy rows [range.first, range.second) of `m`.
+static GRT::MatrixDouble sliceRows(const GRT::MatrixDouble& m,
+                                   std::pair<uint32_t, uint32_t> range) {
+    if (range.first == 0 && range.second == m.getNumRows()) return m;
+
+    const uint32_t cols = m.getNumCols();
+    GRT::MatrixDouble slice(range.second - range.first, cols);
+    for (uint32_t row = range.first; row < range.second; row++) {
+        std::copy(m[row], m[row] + cols, slice[row - range.first]);
+    }
+    return slice;
+}
+
+// Linearly resample `m` to `length` rows.
+static GRT::MatrixDouble resampleRows(const GRT::MatrixDouble& m,
+                                      uint32_t length) {
+    const uint32_t rows = m.getNumRows(), cols = m.getNumCols();
+    if (rows == 0 || rows == length) return m;
+
+    GRT::MatrixDouble resampled(length, cols);
+    for (uint32_t i = 0; i < length; i++) {
+        double t = length == 1 ? 0.0 : double(i) * (rows - 1) / (length - 1);
+        uint32_t row = std::min(static_cast<uint32_t>(t), rows - 1);
+        uint32_t next = std::min(row + 1, rows - 1);
+        double frac = t - row;
+        for (uint32_t j = 0; j < cols; j++) {
+            resampled[i][j] = m[row][j] * (1 - frac) + m[next][j] * frac;
+        }
+    }
+    return resampled;
+}
+
 GRT::MatrixDouble TrainingDataManager::getSample(uint32_t label, uint32_t index) {
     CHECK_LABEL(label);
     CHECK_INDEX(label, index);
+    return sliceRows(data_.getClassData(label)[index].getData(),
+                     training_sample_ranges_[label][index]);
+}
+
+GRT::MatrixDouble TrainingDataManager::getUntrimmedSample(uint32_t label,
+                                                          uint32_t index) {
+    CHECK_LABEL(label);
+    CHECK_INDEX(label, index);
     return data_.getClassData(label)[index].getData();
 }
 
+GRT::TimeSeriesClassificationData TrainingDataManager::getAllData() {
+    return getTrimmedData(true);
+}
+
+GRT::TimeSeriesClassificationData TrainingDataManager::getTrimmedData(
+    bool resample) {
+    resample = resample && target_sample_length_ > 0;
+
+    GRT::TimeSeriesClassificationData data = data_;
+    vector<uint32_t> index_for_label(num_classes_ + 1, 0);
+    for (uint32_t i = 0; i < data.getNumSamples(); i++) {
+        // Samples of the same label appear in data_ in index order.
+        uint32_t label = data[i].getClassLabel();
+        const Range& range = training_sample_ranges_[label][index_for_label[label]++];
+        const GRT::MatrixDouble& sample = data[i].getData();
+        if (!resample && range.first == 0 && range.second == sample.getNumRows()) {
+            continue;
+        }
+
+        GRT::MatrixDouble trimmed = sliceRows(sample, range);
+        if (resample) trimmed = resampleRows(trimmed, target_sample_length_);
+        data[i].setTrainingSample(label, trimmed);
+    }
+    return data;
+}
+
 uint32_t TrainingDataManager::getNumSampleForLabel(uint32_t label) {
     CHECK_LABEL(label);
     assert(num_samples_per_label_[label] ==
@@ -127,6 +198,9 @@ bool TrainingDataManager::deleteSample(uint32_t label, uint32_t index) {
     auto& names = training_sample_names_[label];
     names.erase(names.begin() + index);
 
+    auto& ranges = training_sample_ranges_[label];
+    ranges.erase(ranges.begin() + index);
+
     auto& scores = training_sample_scores_[label];
     scores.erase(scores.begin() + index);
 
@@ -134,6 +208,7 @@ bool TrainingDataManager::deleteSample(uint32_t label, uint32_t index) {
     likelihoods.erase(likelihoods.begin() + index);
 
     num_samples_per_label_[label]--;
+    version_++;
 
     return true;
 }
@@ -146,7 +221,9 @@ bool TrainingDataManager::deleteAllSamples() {
         scores.erase(scores.begin(), scores.end());
         auto& likelihoods = training_sample_class_likelihoods_[i + 1];
         likelihoods.erase(likelihoods.begin(), likelihoods.end());
+        training_sample_ranges_[i + 1].clear();
     }
+    version_++;
     return true;
 }
 
@@ -158,6 +235,8 @@ bool TrainingDataManager::deleteAllSamplesWithLabel(uint32_t label) {
     scores.erase(scores.begin(), scores.end());
     auto& likelihoods = training_sample_class_likelihoods_[label];
     likelihoods.erase(likelihoods.begin(), likelihoods.end());
+    training_sample_ranges_[label].clear();
+    version_++;
     return true;
 }
 
@@ -167,9 +246,12 @@ bool TrainingDataManager::relabelSample(
     CHECK_LABEL(new_label);
     CHECK_INDEX(label, index);
 
-    GRT::MatrixDouble data = getSample(label, index);
+    // Move the recorded sample along with its trimming.
+    GRT::MatrixDouble data = getUntrimmedSample(label, index);
+    Range range = training_sample_ranges_[label][index];
     deleteSample(label, index);
     addSample(new_label, data);
+    training_sample_ranges_[new_label].back() = range;
 
     return true;
 }
@@ -179,25 +261,29 @@ bool TrainingDataManager::trimSample(
     CHECK_LABEL(label);
     CHECK_INDEX(label, index);
 
-    GRT::TimeSeriesClassificationData data = data_.getClassData(label);
-    data_.eraseAllSamplesWithClassLabel(label);
+    // Only the range changes, the recorded data stays as it is.
+    Range& range = training_sample_ranges_[label][index];
+    if (start > end || end >= range.second - range.first) return false;
 
-    for (uint32_t i = 0; i < data.getNumSamples(); i++) {
-        if (i == index) {
-            GRT::MatrixDouble sample = data[i].getData();
-            GRT::MatrixDouble new_sample;
-
-            for (uint32_t row = start; row <= end; row++) {
-                new_sample.push_back(sample.getRowVector(row));
-            }
-            data_.addSample(label, new_sample);
-        } else {
-            data_.addSample(label, data[i].getData());
-        }
-    }
+    range = Range(range.first + start, range.first + end + 1);
+    version_++;
+    return true;
+}
+
+bool TrainingDataManager::untrimSample(uint32_t label, uint32_t index) {
+    CHECK_LABEL(label);
+    CHECK_INDEX(label, index);
+
+    training_sample_ranges_[label][index] =
+        Range(0, data_.getClassData(label)[index].getLength());
+    version_++;
     return true;
 }
 
+bool TrainingDataManager::save(const std::string& filename) {
+    return getTrimmedData(false).save(filename);
+}
+
 bool TrainingDataManager::hasSampleScore(uint32_t label, uint32_t index) {
     if (!(label > 0 && label <= num_classes_)) return false;
     if (!(index < num_samples_per_label_[label])) return false;
@@ -258,6 +344,27 @@ bool TrainingDataManager::setSampleClassLikelihoods(
     return true;
 }
 
+uint64_t TrainingDataManager::getSampleMemoryUsage() {
+    uint64_t rows = 0;
+    for (uint32_t i = 0; i < data_.getNumSamples(); i++) {
+        rows += data_[i].getLength();
+    }
+    return rows * data_.getNumDimensions() * sizeof(double);
+}
+
+uint64_t TrainingDataManager::getScoreMemoryUsage() {
+    uint64_t bytes = 0;
+    for (uint32_t i = 0; i <= num_classes_; i++) {
+        bytes += training_sample_scores_[i].capacity() * sizeof(Score);
+        bytes += training_sample_class_likelihoods_[i].capacity() *
+                 sizeof(ClassLikelihoods);
+        for (const ClassLikelihoods& l : training_sample_class_likelihoods_[i]) {
+            bytes += l.second.capacity() * sizeof(double);
+        }
+    }
+    return bytes;
+}
+
 bool TrainingDataManager::load(const std::string& filename) {
     if (!data_.load(filename)) {
         return false;
@@ -275,6 +382,7 @@ bool TrainingDataManager::load(const std::string& filename) {
     num_samples_per_label_.resize(num_classes_ + 1);
     training_sample_scores_.resize(num_classes_ + 1);
     training_sample_class_likelihoods_.resize(num_classes_ + 1);
+    training_sample_ranges_.resize(num_classes_ + 1);
 
     for (uint32_t i = 1; i <= num_classes_; i++) {
         const string class_name = data_.getClassNameForCorrespondingClassLabel(i);
@@ -290,6 +398,8 @@ bool TrainingDataManager::load(const std::string& filename) {
         training_sample_names_[i].clear();
         training_sample_scores_[i].clear();
         training_sample_class_likelihoods_[i].clear();
+        training_sample_ranges_[i].clear();
+        GRT::TimeSeriesClassificationData class_data = data_.getClassData(i);
         for (uint32_t j = 0; j < num_samples; j++) {
             // Since we don't yet have per-sample name saved, we will use
             // default names (marking the pair as <false, "">).
@@ -298,8 +408,11 @@ bool TrainingDataManager::load(const std::string& filename) {
             training_sample_scores_[i].push_back(std::make_pair(false, 0.0));
             training_sample_class_likelihoods_[i].push_back(
                 std::make_pair(false, vector<double>()));
+            training_sample_ranges_[i].push_back(
+                Range(0, class_data[j].getLength()));
         }
     }
+    version_++;
 
     return true;
 }
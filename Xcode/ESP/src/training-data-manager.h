@@ -32,6 +32,11 @@ using std::vector;
  *    1. Edit (relabel, delete or trim individual samples).
  *    2. Name individual sample.
  *
+ *  Trimming is non-destructive: each sample keeps the rows it was recorded
+ *  with, plus the range of rows currently in use. getSample() and getAllData()
+ *  only return the rows in that range, and untrimSample() restores the whole
+ *  recording.
+ *
  *  Each individual sample is addressable by (label, index) tuple. Label starts
  *  from 1 and index starts from 0.
  */
@@ -49,7 +54,9 @@ class TrainingDataManager {
     // Set the name of the training data
     bool setDatasetName(const char* const name);
 
-    GRT::TimeSeriesClassificationData getAllData() { return data_; }
+    /// @brief Get all samples (trimmed, and resampled if a target sample
+    /// length is set) as used for training.
+    GRT::TimeSeriesClassificationData getAllData();
 
     uint32_t getNumLabels() { return num_classes_; }
 
@@ -83,6 +90,9 @@ class TrainingDataManager {
     /// @brief Get the sample by label and index.
     GRT::MatrixDouble getSample(uint32_t label, uint32_t index);
 
+    /// @brief Get the sample as it was recorded, ignoring any trimming.
+    GRT::MatrixDouble getUntrimmedSample(uint32_t label, uint32_t index);
+
     /// @brief Remove sample by label and the index.
     bool deleteSample(uint32_t label, uint32_t index);
 
@@ -95,10 +105,23 @@ class TrainingDataManager {
     /// @brief Relabel a sample from `label` to `new_label`.
     bool relabelSample(uint32_t label, uint32_t index, uint32_t new_label);
 
-    /// @brief Trim sample. What's left will be [start, end], closed interval.
+    /// @brief Trim sample. What's left will be [start, end], closed interval,
+    /// with indices relative to the sample as returned by getSample(). Returns
+    /// false if the range is empty or out of bounds.
     bool trimSample(uint32_t label, uint32_t index, uint32_t start,
                     uint32_t end);
 
+    /// @brief Undo all trimming of a sample.
+    bool untrimSample(uint32_t label, uint32_t index);
+
+    /// @brief If non-zero, getAllData() linearly resamples every sample to
+    /// this many rows, which bounds the cost of template-based classifiers
+    /// like DTW. Samples returned by getSample() are not affected.
+    void setTargetSampleLength(uint32_t length) {
+        target_sample_length_ = length;
+    }
+    uint32_t getTargetSampleLength() { return target_sample_length_; }
+
     // =================================================
     //  Functions that manage per-sample scores
     // =================================================
@@ -112,16 +135,32 @@ class TrainingDataManager {
     bool setSampleClassLikelihoods(uint32_t label, uint32_t index,
                                    vector<double> likelihoods);
 
+    // =================================================
+    //  Memory accounting
+    // =================================================
+
+    /// @brief Bytes held by the recorded samples, including rows that are
+    /// trimmed off.
+    uint64_t getSampleMemoryUsage();
+
+    /// @brief Bytes held by per-sample scores and class likelihoods.
+    uint64_t getScoreMemoryUsage();
+
     // =================================================
     //  Functions for saving/loading training data
     // =================================================
 
-    inline bool save(const std::string& filename) {
-        return data_.save(filename);
-    }
+    /// @brief Save the training data. The file format has no room for the
+    /// trimming ranges, so samples are saved as trimmed.
+    bool save(const std::string& filename);
 
     bool load(const std::string& filename);
 
+    /// @brief A number that changes whenever samples are added, removed,
+    /// relabeled or trimmed, so that results computed in the background can
+    /// tell whether they are still about the current data.
+    uint64_t getVersion() const { return version_; }
+
   private:
     uint32_t num_classes_;
 
@@ -150,6 +189,20 @@ class TrainingDataManager {
     // num_samples_per_label_.
     vector<uint32_t> num_samples_per_label_;
 
+    // Rows [first, second) of the recorded sample that are in use. Trimming
+    // only changes this range; the recorded data is left untouched.
+    using Range = std::pair<uint32_t, uint32_t>;
+    vector<vector<Range>> training_sample_ranges_;
+
+    // See setTargetSampleLength(). Zero disables resampling.
+    uint32_t target_sample_length_ = 0;
+
+    uint64_t version_ = 0;
+
+    // Copy of data_ with the ranges applied and, if `resample` is true, every
+    // sample resampled to target_sample_length_ rows.
+    GRT::TimeSeriesClassificationData getTrimmedData(bool resample);
+
     // The underlying data store backed up by GRT's TimeSeriesClassificationData
     GRT::TimeSeriesClassificationData data_;
 
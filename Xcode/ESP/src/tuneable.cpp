@@ -6,55 +6,90 @@
 
 static std::map<void*, Tuneable*> allTuneables;
 
+void Tuneable::attach(ParameterStore* store) {
+    store_ = store;
+    switch (type_) {
+      case INT_RANGE: id_ = store->add(static_cast<int*>(value_ptr_)); break;
+      case DOUBLE_RANGE: id_ = store->add(static_cast<double*>(value_ptr_)); break;
+      case BOOL: id_ = store->add(static_cast<bool*>(value_ptr_)); break;
+      default: store_ = nullptr; break;
+    }
+}
+
+double Tuneable::getValue() const {
+    if (store_ != nullptr) return store_->get(id_);
+    switch (type_) {
+      case INT_RANGE: return *static_cast<int*>(value_ptr_);
+      case DOUBLE_RANGE: return *static_cast<double*>(value_ptr_);
+      case BOOL: return *static_cast<bool*>(value_ptr_) ? 1.0 : 0.0;
+      default: return 0.0;
+    }
+}
+
+void Tuneable::setValue(double value) {
+    if (store_ != nullptr) {
+        store_->set(id_, value);
+        return;
+    }
+    switch (type_) {
+      case INT_RANGE: *static_cast<int*>(value_ptr_) = std::round(value); break;
+      case DOUBLE_RANGE: *static_cast<double*>(value_ptr_) = value; break;
+      case BOOL: *static_cast<bool*>(value_ptr_) = value != 0.0; break;
+      default: break;
+    }
+}
+
+bool Tuneable::notifyUserChange() {
+    if (!user_changed_) return false;
+    user_changed_ = false;
+
+    switch (type_) {
+      case INT_RANGE:
+        if (int_cb_ == nullptr) return true;
+        int_cb_(*static_cast<int*>(value_ptr_));
+        break;
+      case DOUBLE_RANGE:
+        if (double_cb_ == nullptr) return true;
+        double_cb_(*static_cast<double*>(value_ptr_));
+        break;
+      case BOOL:
+        if (bool_cb_ == nullptr) return true;
+        bool_cb_(*static_cast<bool*>(value_ptr_));
+        break;
+      default: break;
+    }
+    return false;
+}
+
 void Tuneable::onSliderEvent(ofxDatGuiSliderEvent e) {
     for (const auto& t : allTuneables) {
-        void* data_ptr = t.second->getDataAddress();
         void* ui_ptr = t.second->getUIAddress();
         if (e.target == ui_ptr) {
             if (t.second->getType() == Tuneable::INT_RANGE) {
-                int* value = static_cast<int*>(data_ptr);
                 int set_value = std::round(e.value);
-                *value = set_value;
 
                 // Because slider only supports double, we have to manually
                 // round it to match integer semantics.
                 e.target->setValue(set_value);
-
-                if (t.second->int_cb_ != nullptr) {
-                    t.second->int_cb_(*value);
-                } else {
-                    ((ofApp *) ofGetAppPtr())->reloadPipelineModules();
-                }
-
-                ESP_EVENT("Tune " + t.second->title_ + " " + t.second->toString());
+                t.second->setValue(set_value);
             } else {
-                double* value = static_cast<double*>(data_ptr);
-                *value = e.value;
-
-                if (t.second->double_cb_ != nullptr) {
-                    t.second->double_cb_(*value);
-                } else {
-                    ((ofApp *) ofGetAppPtr())->reloadPipelineModules();
-                }
-                ESP_EVENT("Tune " + t.second->title_ + " " + t.second->toString());
+                t.second->setValue(e.value);
             }
+
+            // The callback, or reloading the pipeline, waits until the value
+            // is applied; see notifyUserChange().
+            t.second->user_changed_ = true;
+            ESP_EVENT("Tune " + t.second->title_ + " " + t.second->toString());
         }
     }
 }
 
 void Tuneable::onToggleEvent(ofxDatGuiButtonEvent e) {
     for (const auto& t : allTuneables) {
-        void* data_ptr = t.second->getDataAddress();
         void* ui_ptr = t.second->getUIAddress();
         if (e.target == ui_ptr) {
-            bool* value = static_cast<bool*>(data_ptr);
-            *value = e.enabled;
-
-            if (t.second->bool_cb_ != nullptr) {
-                t.second->bool_cb_(*value);
-            } else {
-                ((ofApp *) ofGetAppPtr())->reloadPipelineModules();
-            }
+            t.second->setValue(e.enabled);
+            t.second->user_changed_ = true;
             ESP_EVENT("Tune " + t.second->title_ + " " + t.second->toString());
         }
     }
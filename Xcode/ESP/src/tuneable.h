@@ -5,7 +5,9 @@
  For each tuneable parameter, a corresponding slider or checkbox is created in
  the interface to allow the user to modify the value of that parameter.
 
- There are two possible behaviors when UI event happens:
+ The variables are owned by ofApp's ParameterStore: a UI event only stages the
+ new value, and the variable changes between frames, when the value is applied
+ (see ofApp::applyTuneables()). Then one of two things happens:
  1. If a corresponding callback is provided, it's called
  2. If there is no callback provided, we proceed to reload the pipeline
 **/
@@ -15,6 +17,7 @@
 #include <string>
 
 #include "ofxDatGui.h"
+#include "parameter-store.h"
 
 using std::string;
 
@@ -51,12 +54,24 @@ class Tuneable {
           int_cb_(nullptr), double_cb_(nullptr), bool_cb_(cb) {
     }
 
+    // Let `store` own the variable from now on. Values set from the GUI or
+    // fromString() go through the store.
+    void attach(ParameterStore* store);
+
+    // The current value as the GUI sees it, which may not have been applied
+    // to the variable yet.
+    double getValue() const;
+
+    // Call the callback with the applied value if the user changed it since
+    // the last call. Returns true if the pipeline needs to be reloaded
+    // instead, because there is no callback.
+    bool notifyUserChange();
+
     void addToGUI(ofxDatGui& gui) {
         switch (type_) {
           case INT_RANGE: {
-            int* value = static_cast<int*>(value_ptr_);
             ofxDatGuiSlider *slider = gui.addSlider(title_, min_, max_);
-            slider->setValue(*value);
+            slider->setValue(getValue());
             ui_ptr_ = static_cast<void*>(slider);
             gui.onSliderEvent(this, &Tuneable::onSliderEvent);
             gui.addTextBlock(description_);
@@ -64,9 +79,8 @@ class Tuneable {
           }
 
           case DOUBLE_RANGE: {
-            double* value = static_cast<double*>(value_ptr_);
             ofxDatGuiSlider *slider = gui.addSlider(title_, min_, max_);
-            slider->setValue(*value);
+            slider->setValue(getValue());
             ui_ptr_ = static_cast<void*>(slider);
             gui.onSliderEvent(this, &Tuneable::onSliderEvent);
             gui.addTextBlock(description_);
@@ -74,8 +88,7 @@ class Tuneable {
           }
 
           case BOOL: {
-            bool* value = static_cast<bool*>(value_ptr_);
-            ofxDatGuiToggle *toggle = gui.addToggle(title_, *value);
+            ofxDatGuiToggle *toggle = gui.addToggle(title_, getValue() != 0.0);
             ui_ptr_ = static_cast<void*>(toggle);
             gui.onButtonEvent(this, &Tuneable::onToggleEvent);
             gui.addTextBlock(description_);
@@ -89,16 +102,13 @@ class Tuneable {
     std::string toString() {
         switch (type_) {
           case INT_RANGE: {
-            int* value = static_cast<int*>(value_ptr_);
-            return "INT " + std::to_string(*value);
+            return "INT " + std::to_string((int) getValue());
           }
           case DOUBLE_RANGE: {
-            double* value = static_cast<double*>(value_ptr_);
-            return "DOUBLE " + std::to_string(*value);
+            return "DOUBLE " + std::to_string(getValue());
           }
           case BOOL: {
-            bool* value = static_cast<bool*>(value_ptr_);
-            return std::string("BOOL ") + (*value ? "true" : "false");
+            return std::string("BOOL ") + (getValue() != 0.0 ? "true" : "false");
           }
           default: {
             ofLog(OF_LOG_ERROR) << "Unknown type";
@@ -108,31 +118,54 @@ class Tuneable {
         return "";
     }
 
-    // Return value indicates success or not.
-    bool fromString(std::string str) {
+    // Read a value written by toString() into `value`. Fails if `str` is
+    // malformed or holds a value of another type.
+    bool parse(const std::string& str, double* value) const {
         std::istringstream iss(str);
         std::string word;
 
         iss >> word;
-        if (word == "INT") {
-            int* p = static_cast<int*>(value_ptr_);
-            iss >> *p;
-            ofxDatGuiSlider *slider = static_cast<ofxDatGuiSlider*>(ui_ptr_);
-            slider->setValue(*p);
-        } else if (word == "DOUBLE") {
-            double* p = static_cast<double*>(value_ptr_);
-            iss >> *p;
-            ofxDatGuiSlider *slider = static_cast<ofxDatGuiSlider*>(ui_ptr_);
-            slider->setValue(*p);
-        } else if (word == "BOOL") {
-            bool* p = static_cast<bool*>(value_ptr_);
+        if (word == "INT" && type_ == INT_RANGE) {
+            int i;
+            if (!(iss >> i)) return false;
+            *value = i;
+        } else if (word == "DOUBLE" && type_ == DOUBLE_RANGE) {
+            if (!(iss >> *value)) return false;
+        } else if (word == "BOOL" && type_ == BOOL) {
             iss >> word;
-            *p = (word == "true") ? true : false;
-            ofxDatGuiToggle *toggle = static_cast<ofxDatGuiToggle*>(ui_ptr_);
-            toggle->setEnabled(*p);
+            if (word != "true" && word != "false") return false;
+            *value = (word == "true") ? 1.0 : 0.0;
+        } else {
+            return false;
         }
+        return true;
+    }
+
+    // Set the value, and the GUI, from a string written by toString(). Like
+    // a change in the GUI, it takes effect when the value is applied, and
+    // then calls the callback or reloads the pipeline.
+    // Return value indicates success or not.
+    bool fromString(std::string str) {
+        double value;
+        if (!parse(str, &value)) return false;
 
-        return false;
+        setValue(value);
+        user_changed_ = true;
+        switch (type_) {
+          case INT_RANGE:
+          case DOUBLE_RANGE: {
+            ofxDatGuiSlider *slider = static_cast<ofxDatGuiSlider*>(ui_ptr_);
+            if (slider != nullptr) slider->setValue(value);
+            break;
+          }
+          case BOOL: {
+            ofxDatGuiToggle *toggle = static_cast<ofxDatGuiToggle*>(ui_ptr_);
+            if (toggle != nullptr) toggle->setEnabled(value != 0.0);
+            break;
+          }
+          default: break;
+        }
+        return true;
     }
 
     void* getUIAddress() const {
@@ -150,8 +183,12 @@ class Tuneable {
   private:
     void onSliderEvent(ofxDatGuiSliderEvent e);
     void onToggleEvent(ofxDatGuiButtonEvent e);
+    void setValue(double value);
 
     void* value_ptr_;
+    ParameterStore* store_ = nullptr;
+    ParameterStore::Id id_ = 0;
+    bool user_changed_ = false;
     void* ui_ptr_;
     Type type_;
 
@@ -174,7 +211,8 @@ class Tuneable {
  parameter is stored. The initial value of the tuneable parameter will be taken
  from the value of this variable when this function is called. When the user
  changes the value of the tuneable parameter, the variable referenced by this
- parameter will be set to the new value.
+ parameter will be set to the new value. This happens between frames, so the
+ pipeline never sees the value change while it processes a frame.
  @param min: the minimum value of the parameter, used to contrain the range of
  values to which the user can set the tuneable parameter.
  @param max: the maximum value of the parameter, used to contrain the range of
@@ -197,7 +235,8 @@ void registerTuneable(int& value, int min, int max,
  parameter is stored. The initial value of the tuneable parameter will be taken
  from the value of this variable when this function is called. When the user
  changes the value of the tuneable parameter, the variable referenced by this
- parameter will be set to the new value.
+ parameter will be set to the new value. This happens between frames, so the
+ pipeline never sees the value change while it processes a frame.
  @param min: the minimum value of the parameter, used to contrain the range of
  values to which the user can set the tuneable parameter.
  @param max: the maximum value of the parameter, used to contrain the range of
@@ -222,7 +261,8 @@ void registerTuneable(double& value, double min, double max,
  parameter is stored. The initial value of the tuneable parameter will be taken
  from the value of this variable when this function is called. When the user
  changes the value of the tuneable parameter, the variable referenced by this
- parameter will be set to the new value.
+ parameter will be set to the new value. This happens between frames, so the
+ pipeline never sees the value change while it processes a frame.
  @param name: the name of the tuneable parameter. Will be shown to the user.
  @param description: the description of the tuneable parameter. Shown to the
  user.